@@ -24,6 +24,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_Aes.h"
+#include "WjCryptLib_Stats.h"
 #include <stdint.h>
 #include <memory.h>
 
@@ -711,6 +712,8 @@ int
     uint32_t*       rk;
     uint32_t*       rrk;
 
+    STATS_BEGIN( startCycles );
+
     #define SETUP_MIX( Value ) \
         ( (Te4_3[BYTE(Value, 2)]) ^ (Te4_2[BYTE(Value, 1)]) ^ (Te4_1[BYTE(Value, 0)]) ^ (Te4_0[BYTE(Value, 3)]) )
 
@@ -825,6 +828,7 @@ int
     *rk   = *rrk;
 
     #undef SETUP_MIX
+    STATS_END( STATS_AES_KEY_SETUP, startCycles, KeySize );
     return 0;
 }
 
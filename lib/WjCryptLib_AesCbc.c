@@ -17,6 +17,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_AesCbc.h"
+#include "WjCryptLib_Stats.h"
 #include "WjCryptLib_Aes.h"
 #include <stdint.h>
 #include <memory.h>
@@ -133,6 +134,7 @@ int
         return -1;
     }
 
+    STATS_BEGIN( startCycles );
     for( i=0; i<numBlocks; i++ )
     {
         // XOR on the next block of data onto the previous cipher block
@@ -147,6 +149,7 @@ int
         offset += AES_BLOCK_SIZE;
     }
 
+    STATS_END( STATS_AES_CBC, startCycles, Size );
     return 0;
 }
 
@@ -178,6 +181,7 @@ int
         return -1;
     }
 
+    STATS_BEGIN( startCycles );
     for( i=0; i<numBlocks; i++ )
     {
         // Copy previous cipher block and place current one in context
@@ -193,6 +197,7 @@ int
         offset += AES_BLOCK_SIZE;
     }
 
+    STATS_END( STATS_AES_CBC, startCycles, Size );
     return 0;
 }
 
@@ -0,0 +1,462 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesCcm
+//
+//  Implementation of AES CCM authenticated encryption (RFC 3610 / NIST SP 800-38C).
+//
+//  Depends on: CryptoLib_Aes
+//
+//  AES CCM combines AES in counter mode for confidentiality with an AES CBC-MAC for authenticity. Both the MAC and
+//  the keystream are computed in a single pass over the data. The message length must be known in advance, so this
+//  module provides one-call encrypt and decrypt functions rather than a streaming interface.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_AesCcm.h"
+#include "WjCryptLib_Stats.h"
+#include "WjCryptLib_Aes.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <memory.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  XorAesBlock
+//
+//  Takes two source blocks (size AES_BLOCK_SIZE) and XORs them together and puts the result in first block
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    XorAesBlock
+    (
+        uint8_t*            Block1,          // [in out]
+        uint8_t const*      Block2           // [in]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<AES_BLOCK_SIZE; i++ )
+    {
+        Block1[i] ^= Block2[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ValidateParameters
+//
+//  Checks the nonce size, tag size, and that the message size can be represented in the length field.
+//  Returns 0 if valid, or -1 if not.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    ValidateParameters
+    (
+        uint32_t            NonceSize,              // [in]
+        uint32_t            Size,                   // [in]
+        uint32_t            TagSize                 // [in]
+    )
+{
+    uint32_t    lengthSize;
+
+    if(     NonceSize < AES_CCM_NONCE_SIZE_MIN
+        ||  NonceSize > AES_CCM_NONCE_SIZE_MAX
+        ||  TagSize < AES_CCM_TAG_SIZE_MIN
+        ||  TagSize > AES_CCM_TAG_SIZE_MAX
+        ||  0 != TagSize % 2 )
+    {
+        return -1;
+    }
+
+    // A length field of 4 or more bytes can hold any uint32_t size.
+    lengthSize = AES_BLOCK_SIZE - 1 - NonceSize;
+    if( lengthSize < 4 && 0 != ( Size >> (8 * lengthSize) ) )
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StoreLengthField
+//
+//  Stores Value in Network byte order (Big Endian) in the last FieldSize bytes of Block.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    StoreLengthField
+    (
+        uint8_t             Block [AES_BLOCK_SIZE], // [out]
+        uint32_t            FieldSize,              // [in]
+        uint32_t            Value                   // [in]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<FieldSize; i++ )
+    {
+        Block[AES_BLOCK_SIZE - 1 - i] = ( i < 4 ) ? (uint8_t)( Value >> (8*i) ) : 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CbcMacAbsorb
+//
+//  XORs Data onto the CBC-MAC block starting at *pPosition, encrypting the block each time it becomes full.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    CbcMacAbsorb
+    (
+        AesContext const*   Aes,                    // [in]
+        uint8_t             MacBlock [AES_BLOCK_SIZE], // [in out]
+        uint32_t*           pPosition,              // [in out]
+        uint8_t const*      Data,                   // [in]
+        uint32_t            Size                    // [in]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<Size; i++ )
+    {
+        MacBlock[*pPosition] ^= Data[i];
+        *pPosition += 1;
+        if( AES_BLOCK_SIZE == *pPosition )
+        {
+            AesEncryptInPlace( Aes, MacBlock );
+            *pPosition = 0;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CbcMacStart
+//
+//  Starts the CBC-MAC by processing the B0 block (flags, nonce, and message length) followed by the encoded
+//  additional data, zero padded to a block boundary.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    CbcMacStart
+    (
+        AesContext const*   Aes,                    // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        uint8_t const*      AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        uint32_t            Size,                   // [in]
+        uint32_t            TagSize,                // [in]
+        uint8_t             MacBlock [AES_BLOCK_SIZE] // [out]
+    )
+{
+    uint32_t    lengthSize = AES_BLOCK_SIZE - 1 - NonceSize;
+    uint8_t     header [6];
+    uint32_t    headerSize;
+    uint32_t    position = 0;
+
+    // B0 = Flags || Nonce || Message length
+    MacBlock[0] = (uint8_t)( ( ADataSize > 0 ? 0x40 : 0 ) | ( ((TagSize - 2) / 2) << 3 ) | ( lengthSize - 1 ) );
+    memcpy( MacBlock + 1, Nonce, NonceSize );
+    StoreLengthField( MacBlock, lengthSize, Size );
+    AesEncryptInPlace( Aes, MacBlock );
+
+    if( ADataSize > 0 )
+    {
+        // The additional data is prefixed with its length. Short lengths use two bytes, longer ones use the
+        // 0xff 0xfe marker followed by a 32 bit length.
+        if( ADataSize < 0xff00 )
+        {
+            header[0] = (uint8_t)( ADataSize >> 8 );
+            header[1] = (uint8_t)( ADataSize );
+            headerSize = 2;
+        }
+        else
+        {
+            header[0] = 0xff;
+            header[1] = 0xfe;
+            header[2] = (uint8_t)( ADataSize >> 24 );
+            header[3] = (uint8_t)( ADataSize >> 16 );
+            header[4] = (uint8_t)( ADataSize >> 8 );
+            header[5] = (uint8_t)( ADataSize );
+            headerSize = 6;
+        }
+
+        CbcMacAbsorb( Aes, MacBlock, &position, header, headerSize );
+        CbcMacAbsorb( Aes, MacBlock, &position, AData, ADataSize );
+
+        // Zero padding to the block boundary leaves the block unchanged apart from the final encryption.
+        if( 0 != position )
+        {
+            AesEncryptInPlace( Aes, MacBlock );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CcmProcess
+//
+//  Performs the combined CTR encryption/decryption and CBC-MAC over the data and produces the full 16 byte tag.
+//  The MAC is always computed over the plaintext, so when decrypting the keystream must be available before the MAC
+//  can absorb a block. The loop therefore generates the keystream one block ahead, which gives every iteration two
+//  independent AES operations: the CBC-MAC chain and the next counter block. This allows the processor to overlap
+//  them while the data block is still in L1 cache.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    CcmProcess
+    (
+        AesContext const*   Aes,                    // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        uint8_t const*      AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        uint8_t const*      InBuffer,               // [in]
+        uint8_t*            OutBuffer,              // [out]
+        uint32_t            Size,                   // [in]
+        uint32_t            TagSize,                // [in]
+        bool                Decrypting,             // [in]
+        uint8_t             FullTag [AES_BLOCK_SIZE] // [out]
+    )
+{
+    uint32_t    lengthSize = AES_BLOCK_SIZE - 1 - NonceSize;
+    uint32_t    numBlocks = ( Size / AES_BLOCK_SIZE ) + ( 0 != Size % AES_BLOCK_SIZE ? 1 : 0 );
+    uint32_t    i;
+    uint32_t    j;
+    uint32_t    offset;
+    uint32_t    chunkSize;
+    uint8_t     macBlock [AES_BLOCK_SIZE];
+    uint8_t     counterBlock [AES_BLOCK_SIZE];
+    uint8_t     keyStream [AES_BLOCK_SIZE];
+    uint8_t     plainBlock [AES_BLOCK_SIZE];
+
+    CbcMacStart( Aes, Nonce, NonceSize, AData, ADataSize, Size, TagSize, macBlock );
+
+    // Counter block A_i = Flags || Nonce || i
+    counterBlock[0] = (uint8_t)( lengthSize - 1 );
+    memcpy( counterBlock + 1, Nonce, NonceSize );
+
+    // Generate the keystream for the first data block (A_1)
+    if( numBlocks > 0 )
+    {
+        StoreLengthField( counterBlock, lengthSize, 1 );
+        AesEncrypt( Aes, counterBlock, keyStream );
+    }
+
+    for( i=0; i<numBlocks; i++ )
+    {
+        offset = i * AES_BLOCK_SIZE;
+        chunkSize = MIN( Size - offset, AES_BLOCK_SIZE );
+
+        // Recover the plaintext block (zero padded for the MAC) and write out the result. Reading the whole input
+        // chunk before writing allows InBuffer and OutBuffer to be the same.
+        memset( plainBlock, 0, AES_BLOCK_SIZE );
+        for( j=0; j<chunkSize; j++ )
+        {
+            if( Decrypting )
+            {
+                plainBlock[j] = InBuffer[offset+j] ^ keyStream[j];
+                OutBuffer[offset+j] = plainBlock[j];
+            }
+            else
+            {
+                plainBlock[j] = InBuffer[offset+j];
+                OutBuffer[offset+j] = plainBlock[j] ^ keyStream[j];
+            }
+        }
+
+        // Advance both chains. These two AES operations do not depend on each other.
+        XorAesBlock( macBlock, plainBlock );
+        AesEncryptInPlace( Aes, macBlock );
+        if( i + 1 < numBlocks )
+        {
+            StoreLengthField( counterBlock, lengthSize, i + 2 );
+            AesEncrypt( Aes, counterBlock, keyStream );
+        }
+    }
+
+    // The tag is the CBC-MAC encrypted with the keystream block A_0
+    StoreLengthField( counterBlock, lengthSize, 0 );
+    AesEncryptInPlace( Aes, counterBlock );
+    for( i=0; i<AES_BLOCK_SIZE; i++ )
+    {
+        FullTag[i] = macBlock[i] ^ counterBlock[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCcmEncrypt
+//
+//  Encrypts and authenticates a buffer using an already initialised AesContext. AData is additional data that is
+//  authenticated but not encrypted, it may be NULL if ADataSize is 0. The authentication tag of TagSize bytes is
+//  written to Tag.
+//  InBuffer and OutBuffer can point to the same location for in-place encrypting.
+//  Returns 0 if successful, or -1 if NonceSize or TagSize is invalid or Size is too large for the nonce size.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCcmEncrypt
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        void const*         AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size,                   // [in]
+        uint8_t*            Tag,                    // [out]
+        uint32_t            TagSize                 // [in]
+    )
+{
+    uint8_t     fullTag [AES_BLOCK_SIZE];
+
+    if( 0 != ValidateParameters( NonceSize, Size, TagSize ) )
+    {
+        return -1;
+    }
+
+    STATS_BEGIN( startCycles );
+    CcmProcess( InitialisedAesContext, Nonce, NonceSize, AData, ADataSize, InBuffer, OutBuffer, Size,
+        TagSize, false, fullTag );
+    memcpy( Tag, fullTag, TagSize );
+    STATS_END( STATS_AES_CCM, startCycles, (uint64_t)ADataSize + Size );
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCcmDecrypt
+//
+//  Decrypts and verifies a buffer using an already initialised AesContext. The tag computed over the decrypted data
+//  is compared against Tag. If they do not match OutBuffer is cleared to zero and the function fails.
+//  InBuffer and OutBuffer can point to the same location for in-place decrypting.
+//  Returns 0 if successful, or -1 if the parameters are invalid or the data failed authentication.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCcmDecrypt
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        void const*         AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size,                   // [in]
+        uint8_t const*      Tag,                    // [in]
+        uint32_t            TagSize                 // [in]
+    )
+{
+    uint8_t     fullTag [AES_BLOCK_SIZE];
+    uint8_t     difference = 0;
+    uint32_t    i;
+
+    if( 0 != ValidateParameters( NonceSize, Size, TagSize ) )
+    {
+        return -1;
+    }
+
+    STATS_BEGIN( startCycles );
+    CcmProcess( InitialisedAesContext, Nonce, NonceSize, AData, ADataSize, InBuffer, OutBuffer, Size,
+        TagSize, true, fullTag );
+    STATS_END( STATS_AES_CCM, startCycles, (uint64_t)ADataSize + Size );
+
+    // Compare the tags in constant time
+    for( i=0; i<TagSize; i++ )
+    {
+        difference |= fullTag[i] ^ Tag[i];
+    }
+
+    if( 0 != difference )
+    {
+        // Do not release unauthenticated plaintext
+        memset( OutBuffer, 0, Size );
+        return -1;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCcmEncryptWithKey
+//
+//  This function combines AesInitialise and AesCcmEncrypt. This is suitable when encrypting data in one go with a
+//  key that is not going to be reused.
+//  Returns 0 if successful, or -1 if invalid KeySize provided or the other parameters are invalid.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCcmEncryptWithKey
+    (
+        uint8_t const*      Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        void const*         AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            BufferSize,             // [in]
+        uint8_t*            Tag,                    // [out]
+        uint32_t            TagSize                 // [in]
+    )
+{
+    AesContext      aes;
+
+    if( 0 != AesInitialise( &aes, Key, KeySize ) )
+    {
+        return -1;
+    }
+
+    return AesCcmEncrypt( &aes, Nonce, NonceSize, AData, ADataSize, InBuffer, OutBuffer, BufferSize, Tag, TagSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCcmDecryptWithKey
+//
+//  This function combines AesInitialise and AesCcmDecrypt. This is suitable when decrypting data in one go with a
+//  key that is not going to be reused.
+//  Returns 0 if successful, or -1 if invalid KeySize provided, the other parameters are invalid, or the data failed
+//  authentication.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCcmDecryptWithKey
+    (
+        uint8_t const*      Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        void const*         AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            BufferSize,             // [in]
+        uint8_t const*      Tag,                    // [in]
+        uint32_t            TagSize                 // [in]
+    )
+{
+    AesContext      aes;
+
+    if( 0 != AesInitialise( &aes, Key, KeySize ) )
+    {
+        return -1;
+    }
+
+    return AesCcmDecrypt( &aes, Nonce, NonceSize, AData, ADataSize, InBuffer, OutBuffer, BufferSize, Tag, TagSize );
+}
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesCcm
+//
+//  Implementation of AES CCM authenticated encryption (RFC 3610 / NIST SP 800-38C).
+//
+//  Depends on: CryptoLib_Aes
+//
+//  AES CCM combines AES in counter mode for confidentiality with an AES CBC-MAC for authenticity. Both the MAC and
+//  the keystream are computed in a single pass over the data. The message length must be known in advance, so this
+//  module provides one-call encrypt and decrypt functions rather than a streaming interface.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_Aes.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Valid nonce sizes are 7 to 13 bytes. The nonce size N determines the size of the length field L = 15 - N, which in
+// turn limits the maximum message size to 2^(8*L) - 1 bytes.
+#define AES_CCM_NONCE_SIZE_MIN      7
+#define AES_CCM_NONCE_SIZE_MAX      13
+
+// Valid tag sizes are 4, 6, 8, 10, 12, 14, or 16 bytes.
+#define AES_CCM_TAG_SIZE_MIN        4
+#define AES_CCM_TAG_SIZE_MAX        16
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCcmEncrypt
+//
+//  Encrypts and authenticates a buffer using an already initialised AesContext. AData is additional data that is
+//  authenticated but not encrypted, it may be NULL if ADataSize is 0. The authentication tag of TagSize bytes is
+//  written to Tag.
+//  InBuffer and OutBuffer can point to the same location for in-place encrypting.
+//  Returns 0 if successful, or -1 if NonceSize or TagSize is invalid or Size is too large for the nonce size.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCcmEncrypt
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        void const*         AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size,                   // [in]
+        uint8_t*            Tag,                    // [out]
+        uint32_t            TagSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCcmDecrypt
+//
+//  Decrypts and verifies a buffer using an already initialised AesContext. The tag computed over the decrypted data
+//  is compared against Tag. If they do not match OutBuffer is cleared to zero and the function fails.
+//  InBuffer and OutBuffer can point to the same location for in-place decrypting.
+//  Returns 0 if successful, or -1 if the parameters are invalid or the data failed authentication.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCcmDecrypt
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        void const*         AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size,                   // [in]
+        uint8_t const*      Tag,                    // [in]
+        uint32_t            TagSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCcmEncryptWithKey
+//
+//  This function combines AesInitialise and AesCcmEncrypt. This is suitable when encrypting data in one go with a
+//  key that is not going to be reused.
+//  Returns 0 if successful, or -1 if invalid KeySize provided or the other parameters are invalid.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCcmEncryptWithKey
+    (
+        uint8_t const*      Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        void const*         AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            BufferSize,             // [in]
+        uint8_t*            Tag,                    // [out]
+        uint32_t            TagSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCcmDecryptWithKey
+//
+//  This function combines AesInitialise and AesCcmDecrypt. This is suitable when decrypting data in one go with a
+//  key that is not going to be reused.
+//  Returns 0 if successful, or -1 if invalid KeySize provided, the other parameters are invalid, or the data failed
+//  authentication.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCcmDecryptWithKey
+    (
+        uint8_t const*      Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        uint8_t const*      Nonce,                  // [in]
+        uint32_t            NonceSize,              // [in]
+        void const*         AData,                  // [in optional]
+        uint32_t            ADataSize,              // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            BufferSize,             // [in]
+        uint8_t const*      Tag,                    // [in]
+        uint32_t            TagSize                 // [in]
+    );
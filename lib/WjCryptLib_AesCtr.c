@@ -16,6 +16,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_Stats.h"
 #include "WjCryptLib_Aes.h"
 #include <stdint.h>
 #include <memory.h>
@@ -26,22 +27,51 @@
 
 #define MIN( x, y ) ( ((x)<(y))?(x):(y) )
 
-#define STORE64H( x, y )                                                       \
-   { (y)[0] = (uint8_t)(((x)>>56)&255); (y)[1] = (uint8_t)(((x)>>48)&255);     \
-     (y)[2] = (uint8_t)(((x)>>40)&255); (y)[3] = (uint8_t)(((x)>>32)&255);     \
-     (y)[4] = (uint8_t)(((x)>>24)&255); (y)[5] = (uint8_t)(((x)>>16)&255);     \
-     (y)[6] = (uint8_t)(((x)>>8)&255);  (y)[7] = (uint8_t)((x)&255); }
+// Fewest cipher blocks AesCtrXor runs on an OpenMP thread team (64 KiB). Below this starting the team costs more than
+// it saves, and it keeps the 8 KiB tiles of WjCryptLib_AesCtrSha256 on the calling thread where they stay in cache.
+#define OPENMP_MIN_BLOCKS   4096
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  INTERNAL FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  BuildCounterBlock
+//
+//  Produces the counter block for block number BlockIndex of the stream. This is the initial counter block with
+//  BlockIndex added to its counter field, wrapping modulo the size of the field. The addition is done a byte at a
+//  time from the least significant byte and stops once there is nothing left to carry.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    BuildCounterBlock
+    (
+        AesCtrContext const*    Context,                        // [in]
+        uint64_t                BlockIndex,                     // [in]
+        uint8_t                 CounterBlock [AES_BLOCK_SIZE]   // [out]
+    )
+{
+    uint64_t    carry = BlockIndex;
+    uint32_t    sum;
+    uint32_t    position;
+    uint32_t    i;
+
+    memcpy( CounterBlock, Context->InitialCounterBlock, AES_BLOCK_SIZE );
+
+    for( i=0; i<Context->CounterSize && 0 != carry; i++ )
+    {
+        position = ( AES_CTR_COUNTER_LITTLE_ENDIAN == Context->CounterEndian ) ? i : AES_BLOCK_SIZE - 1 - i;
+        sum = (uint32_t)CounterBlock[position] + (uint32_t)( carry & 0xff );
+        CounterBlock[position] = (uint8_t)sum;
+        carry = ( carry >> 8 ) + ( sum >> 8 );
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  CreateCurrentCipherBlock
 //
-//  Takes the IV and the counter in the AesCtrContext and produces the cipher block (CurrentCipherBlock). The cipher
-//  block is produced by first creating a 128 bit block with the IV as first 64 bits and the CurrentCipherBlockIndex
-//  stored as the remaining 64bits in Network byte order (Big Endian)
+//  Takes the initial counter block and the counter in the AesCtrContext and produces the cipher block
+//  (CurrentCipherBlock) by encrypting the counter block for CurrentCipherBlockIndex.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 static
 void
@@ -50,16 +80,95 @@ void
         AesCtrContext*      Context                 // [in out]
     )
 {
-    // Build block by first copying in the IV
-    memcpy( Context->CurrentCipherBlock, Context->IV, AES_CTR_IV_SIZE );
-
-    // Now place in the counter in Big Endian form
-    STORE64H( Context->CurrentCipherBlockIndex, Context->CurrentCipherBlock + AES_CTR_IV_SIZE );
+    // Build the counter block for the current block index
+    BuildCounterBlock( Context, Context->CurrentCipherBlockIndex, Context->CurrentCipherBlock );
 
     // Perform AES encryption on the block
     AesEncryptInPlace( &Context->Aes, Context->CurrentCipherBlock );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetBufferedKeyStreamBlock
+//
+//  Returns a pointer to the precomputed cipher block BlockIndex in the keystream buffer, or NULL if it is not held.
+//  Block n is always stored in slot (n % KeyStreamBufferNumBlocks).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint8_t*
+    GetBufferedKeyStreamBlock
+    (
+        AesCtrContext const*    Context,            // [in]
+        uint64_t                BlockIndex          // [in]
+    )
+{
+    if(     NULL == Context->KeyStreamBuffer
+        ||  BlockIndex < Context->KeyStreamFirstBlockIndex
+        ||  BlockIndex >= Context->KeyStreamFirstBlockIndex + Context->KeyStreamNumBlocks )
+    {
+        return NULL;
+    }
+
+    return Context->KeyStreamBuffer + ( (BlockIndex % Context->KeyStreamBufferNumBlocks) * AES_BLOCK_SIZE );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DiscardBufferedKeyStream
+//
+//  Drops the precomputed blocks that lie entirely before the current stream position, freeing their slots. If the
+//  current position is outside the buffered range the buffer is emptied and restarts at the current block.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    DiscardBufferedKeyStream
+    (
+        AesCtrContext*      Context                 // [in out]
+    )
+{
+    uint64_t    blockIndex = Context->StreamIndex / AES_BLOCK_SIZE;
+
+    if( NULL == GetBufferedKeyStreamBlock( Context, blockIndex ) )
+    {
+        Context->KeyStreamFirstBlockIndex = blockIndex;
+        Context->KeyStreamNumBlocks = 0;
+    }
+    else
+    {
+        Context->KeyStreamNumBlocks -= (uint32_t)( blockIndex - Context->KeyStreamFirstBlockIndex );
+        Context->KeyStreamFirstBlockIndex = blockIndex;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MoveToCurrentCipherBlock
+//
+//  Makes CurrentCipherBlock the cipher block containing the current stream position, taking it from the keystream
+//  buffer if it is held there, otherwise generating it.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    MoveToCurrentCipherBlock
+    (
+        AesCtrContext*      Context                 // [in out]
+    )
+{
+    uint64_t    blockIndex = Context->StreamIndex / AES_BLOCK_SIZE;
+    uint8_t*    bufferedBlock;
+
+    if( blockIndex != Context->CurrentCipherBlockIndex )
+    {
+        Context->CurrentCipherBlockIndex = blockIndex;
+        bufferedBlock = GetBufferedKeyStreamBlock( Context, blockIndex );
+        if( NULL != bufferedBlock )
+        {
+            memcpy( Context->CurrentCipherBlock, bufferedBlock, AES_BLOCK_SIZE );
+        }
+        else
+        {
+            CreateCurrentCipherBlock( Context );
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  XorBuffer
 //
@@ -83,6 +192,43 @@ void
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  XorFromKeyStreamBuffer
+//
+//  XORs as much of the request as is available in the keystream buffer, advancing the stream index. The ring may wrap
+//  so this is done in at most two contiguous pieces. Returns the number of bytes processed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    XorFromKeyStreamBuffer
+    (
+        AesCtrContext*      Context,                // [in out]
+        uint8_t const*      InBuffer,               // [in]
+        uint8_t*            OutBuffer,              // [out]
+        uint32_t            Size                    // [in]
+    )
+{
+    uint32_t    bufferSize = Context->KeyStreamBufferNumBlocks * AES_BLOCK_SIZE;
+    uint32_t    amount = MIN( AesCtrGetKeyStreamAvailable( Context ), Size );
+    uint32_t    offset = 0;
+    uint32_t    bufferOffset;
+    uint32_t    chunkSize;
+
+    while( offset < amount )
+    {
+        bufferOffset = (uint32_t)( (Context->StreamIndex + offset) % bufferSize );
+        chunkSize = MIN( amount - offset, bufferSize - bufferOffset );
+        XorBuffers( InBuffer + offset, Context->KeyStreamBuffer + bufferOffset, OutBuffer + offset, chunkSize );
+        offset += chunkSize;
+    }
+
+    // Advance and release the slots of blocks that have been completely used. The cipher block for the new position
+    // is only needed if AesCtrXor continues past the buffered keystream, so it is not updated here.
+    Context->StreamIndex += amount;
+    DiscardBufferedKeyStream( Context );
+    return amount;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -101,14 +247,12 @@ void
         uint8_t const       IV [AES_CTR_IV_SIZE]    // [in]
     )
 {
-    // Setup context values
-    Context->Aes = *InitialisedAesContext;
-    memcpy( Context->IV, IV, AES_CTR_IV_SIZE );
-    Context->StreamIndex = 0;
-    Context->CurrentCipherBlockIndex = 0;
+    uint8_t     counterBlock [AES_BLOCK_SIZE] = {0};
 
-    // Generate the first cipher block of the stream.
-    CreateCurrentCipherBlock( Context );
+    // The IV is the first half of the counter block, the second half is a 64 bit big endian counter starting at 0
+    memcpy( counterBlock, IV, AES_CTR_IV_SIZE );
+    AesCtrInitialiseWithCounterBlock( Context, InitialisedAesContext, counterBlock,
+        AES_BLOCK_SIZE - AES_CTR_IV_SIZE, AES_CTR_COUNTER_BIG_ENDIAN );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -140,6 +284,48 @@ int
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrInitialiseWithCounterBlock
+//
+//  Initialises an AesCtrContext with an already initialised AesContext and a full 16 byte initial counter block.
+//  Block n of the stream is the encryption of CounterBlock with n added to its counter field, which is CounterSize
+//  bytes (4, 8, or 16) stored in the byte order CounterEndian (AES_CTR_COUNTER_BIG_ENDIAN or
+//  AES_CTR_COUNTER_LITTLE_ENDIAN). The counter wraps modulo its size and never carries into the other bytes.
+//  Returns 0 if successful, or -1 if CounterSize or CounterEndian is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrInitialiseWithCounterBlock
+    (
+        AesCtrContext*      Context,                        // [out]
+        AesContext const*   InitialisedAesContext,          // [in]
+        uint8_t const       CounterBlock [AES_BLOCK_SIZE],  // [in]
+        uint32_t            CounterSize,                    // [in]
+        uint32_t            CounterEndian                   // [in]
+    )
+{
+    if(     ( 4 != CounterSize && 8 != CounterSize && 16 != CounterSize )
+        ||  ( AES_CTR_COUNTER_BIG_ENDIAN != CounterEndian && AES_CTR_COUNTER_LITTLE_ENDIAN != CounterEndian ) )
+    {
+        return -1;
+    }
+
+    // Setup context values
+    Context->Aes = *InitialisedAesContext;
+    memcpy( Context->InitialCounterBlock, CounterBlock, AES_BLOCK_SIZE );
+    Context->CounterSize = CounterSize;
+    Context->CounterEndian = CounterEndian;
+    Context->StreamIndex = 0;
+    Context->CurrentCipherBlockIndex = 0;
+    Context->KeyStreamBuffer = NULL;
+    Context->KeyStreamBufferNumBlocks = 0;
+    Context->KeyStreamFirstBlockIndex = 0;
+    Context->KeyStreamNumBlocks = 0;
+
+    // Generate the first cipher block of the stream.
+    CreateCurrentCipherBlock( Context );
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  AesCtrSetStreamIndex
 //
@@ -153,16 +339,129 @@ void
         uint64_t            StreamIndex             // [in]
     )
 {
-    uint64_t    blockIndex = StreamIndex / AES_BLOCK_SIZE;
-
     Context->StreamIndex = StreamIndex;
-    if( blockIndex != Context->CurrentCipherBlockIndex )
+
+    // Keep any precomputed keystream from the new position onwards, or empty the buffer if it is outside it.
+    if( NULL != Context->KeyStreamBuffer )
     {
-        // Update block index and generate new cipher block as the new StreamIndex is inside a different block to the
-        // one we currently had.
-        Context->CurrentCipherBlockIndex = blockIndex;
-        CreateCurrentCipherBlock( Context );
+        DiscardBufferedKeyStream( Context );
     }
+
+    // If the new StreamIndex is inside a different block to the one we currently had then get the new cipher block.
+    MoveToCurrentCipherBlock( Context );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSetKeyStreamBuffer
+//
+//  Attaches a caller provided buffer to the context for keystream precomputed by AesCtrFillKeyStream. BufferSize must
+//  be a non zero multiple of AES_BLOCK_SIZE, and is the only memory used; the buffer must remain valid until it is
+//  detached by passing NULL, or the context is reinitialised (which also detaches it). While attached, AesCtrXor and
+//  AesCtrOutput take keystream from the buffer first and only run AES for any part not already precomputed.
+//  The buffer is a ring keyed by stream position. AesCtrSetStreamIndex keeps precomputed keystream at or after the
+//  new position if it is within the buffered range, otherwise the buffer is emptied.
+//  Returns 0 if successful, or -1 if BufferSize is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrSetKeyStreamBuffer
+    (
+        AesCtrContext*      Context,                // [in out]
+        void*               Buffer,                 // [in optional]
+        uint32_t            BufferSize              // [in]
+    )
+{
+    if( NULL != Buffer && ( 0 == BufferSize || 0 != (BufferSize % AES_BLOCK_SIZE) ) )
+    {
+        return -1;
+    }
+
+    // AesCtrXor may have left the current cipher block behind the stream position while reading from the old buffer
+    MoveToCurrentCipherBlock( Context );
+
+    Context->KeyStreamBuffer = (uint8_t*)Buffer;
+    Context->KeyStreamBufferNumBlocks = ( NULL != Buffer ) ? BufferSize / AES_BLOCK_SIZE : 0;
+    Context->KeyStreamFirstBlockIndex = Context->StreamIndex / AES_BLOCK_SIZE;
+    Context->KeyStreamNumBlocks = 0;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrFillKeyStream
+//
+//  Precomputes keystream ahead of the current stream position into the buffer attached with
+//  AesCtrSetKeyStreamBuffer. At most MaxSize bytes (rounded down to whole blocks) are added, and never more than fits
+//  in the free part of the buffer, so this can be called in small steps during idle time. The context is not
+//  internally locked: if this is called from a background thread the caller must serialise it with other calls on
+//  the same context.
+//  Returns the number of bytes of keystream added
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    AesCtrFillKeyStream
+    (
+        AesCtrContext*      Context,                // [in out]
+        uint32_t            MaxSize                 // [in]
+    )
+{
+    int             numBlocks;
+    int             i;
+    uint64_t        loopStartingBlockIndex;
+    uint8_t         preCipherBlock [AES_BLOCK_SIZE];
+
+    if( NULL == Context->KeyStreamBuffer )
+    {
+        return 0;
+    }
+
+    DiscardBufferedKeyStream( Context );
+
+    numBlocks = (int)MIN( Context->KeyStreamBufferNumBlocks - Context->KeyStreamNumBlocks, MaxSize / AES_BLOCK_SIZE );
+    loopStartingBlockIndex = Context->KeyStreamFirstBlockIndex + Context->KeyStreamNumBlocks;
+
+    // Each block goes to its own slot so the blocks can be generated in parallel when built with OpenMP.
+    #ifdef _OPENMP
+        #pragma omp parallel for firstprivate( preCipherBlock ) if( numBlocks > 16 )
+    #endif
+    for( i=0; i<numBlocks; i++ )
+    {
+        uint64_t blockIndex = loopStartingBlockIndex + i;
+        uint8_t* slot = Context->KeyStreamBuffer
+            + ( (blockIndex % Context->KeyStreamBufferNumBlocks) * AES_BLOCK_SIZE );
+
+        if( blockIndex == Context->CurrentCipherBlockIndex )
+        {
+            // Already generated
+            memcpy( slot, Context->CurrentCipherBlock, AES_BLOCK_SIZE );
+        }
+        else
+        {
+            BuildCounterBlock( Context, blockIndex, preCipherBlock );
+            AesEncrypt( &Context->Aes, preCipherBlock, slot );
+        }
+    }
+
+    Context->KeyStreamNumBlocks += (uint32_t)numBlocks;
+    return (uint32_t)numBlocks * AES_BLOCK_SIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrGetKeyStreamAvailable
+//
+//  Returns the number of bytes from the current stream position that are already precomputed in the keystream
+//  buffer. An AesCtrXor of up to this many bytes will not perform any AES operations.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    AesCtrGetKeyStreamAvailable
+    (
+        AesCtrContext const*    Context             // [in]
+    )
+{
+    if( NULL == GetBufferedKeyStreamBlock( Context, Context->StreamIndex / AES_BLOCK_SIZE ) )
+    {
+        return 0;
+    }
+
+    return (uint32_t)( ( (Context->KeyStreamFirstBlockIndex + Context->KeyStreamNumBlocks) * AES_BLOCK_SIZE )
+        - Context->StreamIndex );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -192,6 +491,25 @@ void
     uint8_t         preCipherBlock [AES_BLOCK_SIZE];
     uint8_t         encCipherBlock [AES_BLOCK_SIZE];
     uint64_t        cipherBlockIndex = 0;
+    uint32_t        amountFromBuffer = 0;
+
+    STATS_BEGIN( startCycles );
+
+    // Take as much as possible from the precomputed keystream, then continue with AES for anything beyond it.
+    if( NULL != Context->KeyStreamBuffer )
+    {
+        amountFromBuffer = XorFromKeyStreamBuffer( Context, InBuffer, OutBuffer, Size );
+        if( amountFromBuffer == Size )
+        {
+            STATS_END( STATS_AES_CTR, startCycles, Size );
+            return;
+        }
+
+        InBuffer = (uint8_t const*)InBuffer + amountFromBuffer;
+        OutBuffer = (uint8_t*)OutBuffer + amountFromBuffer;
+        Size -= amountFromBuffer;
+        MoveToCurrentCipherBlock( Context );
+    }
 
     // First determine how much is available in the current block.
     amountAvailableInBlock = AES_BLOCK_SIZE - (Context->StreamIndex % AES_BLOCK_SIZE);
@@ -214,13 +532,10 @@ void
     loopStartingCipherBlockIndex = Context->CurrentCipherBlockIndex + 1;
     loopStartingOutputOffset = firstChunkSize;
 
-    // Copy the IV into the first half of the preCipherBlock. When built for OpenMP preCipherBlock will be copied into
-    // a local version within the loop.
-    memcpy( preCipherBlock, Context->IV, AES_CTR_IV_SIZE );
-
     // Now start generating new cipher blocks as required.
     #ifdef _OPENMP
-        #pragma omp parallel for firstprivate( preCipherBlock, cipherBlockIndex ) lastprivate( encCipherBlock, cipherBlockIndex )
+        #pragma omp parallel for firstprivate( preCipherBlock, cipherBlockIndex ) \
+            lastprivate( encCipherBlock, cipherBlockIndex ) if( numIterations >= OPENMP_MIN_BLOCKS )
     #endif
     for( i=0; i<numIterations; i++ )
     {
@@ -231,8 +546,9 @@ void
         // Increment block index and regenerate cipher block
         cipherBlockIndex = loopStartingCipherBlockIndex + i;
 
-        // Now place in the counter in Big Endian form in second half of preCipherBlock
-        STORE64H( cipherBlockIndex, preCipherBlock + AES_CTR_IV_SIZE );
+        // Build the counter block for this block index. Each block is built directly from its index so the
+        // iterations are independent of each other.
+        BuildCounterBlock( Context, cipherBlockIndex, preCipherBlock );
 
         // Perform AES encryption on the preCipherBlock and put result in encCipherBlock
         AesEncrypt( &Context->Aes, preCipherBlock, encCipherBlock );
@@ -248,6 +564,9 @@ void
         Context->CurrentCipherBlockIndex = cipherBlockIndex;
         memcpy( Context->CurrentCipherBlock, encCipherBlock, AES_BLOCK_SIZE );
     }
+
+    // Size excludes anything taken from the keystream buffer
+    STATS_END( STATS_AES_CTR, startCycles, Size + amountFromBuffer );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
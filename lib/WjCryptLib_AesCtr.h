@@ -26,6 +26,14 @@
 
 #define AES_CTR_IV_SIZE             8
 
+// Counter layouts for AesCtrInitialiseWithCounterBlock. The counter is the last CounterSize bytes of the counter
+// block when big endian, or the first CounterSize bytes when little endian. CounterSize may be 4, 8, or 16.
+// AesCtrInitialise uses an 8 byte big endian counter: IV || 64 bit counter.
+// A 12 byte nonce with a 4 byte big endian counter (as GCM) uses CounterSize 4, AES_CTR_COUNTER_BIG_ENDIAN.
+// A full 128 bit counter (as OpenSSL's CTR mode) uses CounterSize 16, AES_CTR_COUNTER_BIG_ENDIAN.
+#define AES_CTR_COUNTER_BIG_ENDIAN      0
+#define AES_CTR_COUNTER_LITTLE_ENDIAN   1
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  TYPES
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -35,10 +43,16 @@
 typedef struct
 {
     AesContext      Aes;
-    uint8_t         IV [AES_CTR_IV_SIZE];
+    uint8_t         InitialCounterBlock [AES_BLOCK_SIZE];
+    uint32_t        CounterSize;
+    uint32_t        CounterEndian;
     uint64_t        StreamIndex;
     uint64_t        CurrentCipherBlockIndex;
     uint8_t         CurrentCipherBlock [AES_BLOCK_SIZE];
+    uint8_t*        KeyStreamBuffer;
+    uint32_t        KeyStreamBufferNumBlocks;
+    uint64_t        KeyStreamFirstBlockIndex;
+    uint32_t        KeyStreamNumBlocks;
 } AesCtrContext;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -75,6 +89,25 @@ int
         uint8_t const       IV [AES_CTR_IV_SIZE]    // [in]
     );
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrInitialiseWithCounterBlock
+//
+//  Initialises an AesCtrContext with an already initialised AesContext and a full 16 byte initial counter block.
+//  Block n of the stream is the encryption of CounterBlock with n added to its counter field, which is CounterSize
+//  bytes (4, 8, or 16) stored in the byte order CounterEndian (AES_CTR_COUNTER_BIG_ENDIAN or
+//  AES_CTR_COUNTER_LITTLE_ENDIAN). The counter wraps modulo its size and never carries into the other bytes.
+//  Returns 0 if successful, or -1 if CounterSize or CounterEndian is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrInitialiseWithCounterBlock
+    (
+        AesCtrContext*      Context,                        // [out]
+        AesContext const*   InitialisedAesContext,          // [in]
+        uint8_t const       CounterBlock [AES_BLOCK_SIZE],  // [in]
+        uint32_t            CounterSize,                    // [in]
+        uint32_t            CounterEndian                   // [in]
+    );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  AesCtrSetStreamIndex
 //
@@ -88,6 +121,54 @@ void
         uint64_t            StreamIndex             // [in]
     );
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSetKeyStreamBuffer
+//
+//  Attaches a caller provided buffer to the context for keystream precomputed by AesCtrFillKeyStream. BufferSize must
+//  be a non zero multiple of AES_BLOCK_SIZE, and is the only memory used; the buffer must remain valid until it is
+//  detached by passing NULL, or the context is reinitialised (which also detaches it). While attached, AesCtrXor and
+//  AesCtrOutput take keystream from the buffer first and only run AES for any part not already precomputed.
+//  The buffer is a ring keyed by stream position. AesCtrSetStreamIndex keeps precomputed keystream at or after the
+//  new position if it is within the buffered range, otherwise the buffer is emptied.
+//  Returns 0 if successful, or -1 if BufferSize is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrSetKeyStreamBuffer
+    (
+        AesCtrContext*      Context,                // [in out]
+        void*               Buffer,                 // [in optional]
+        uint32_t            BufferSize              // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrFillKeyStream
+//
+//  Precomputes keystream ahead of the current stream position into the buffer attached with
+//  AesCtrSetKeyStreamBuffer. At most MaxSize bytes (rounded down to whole blocks) are added, and never more than fits
+//  in the free part of the buffer, so this can be called in small steps during idle time. The context is not
+//  internally locked: if this is called from a background thread the caller must serialise it with other calls on
+//  the same context.
+//  Returns the number of bytes of keystream added
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    AesCtrFillKeyStream
+    (
+        AesCtrContext*      Context,                // [in out]
+        uint32_t            MaxSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrGetKeyStreamAvailable
+//
+//  Returns the number of bytes from the current stream position that are already precomputed in the keystream
+//  buffer. An AesCtrXor of up to this many bytes will not perform any AES operations.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    AesCtrGetKeyStreamAvailable
+    (
+        AesCtrContext const*    Context             // [in]
+    );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  AesCtrXor
 //
@@ -0,0 +1,513 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesCtrDrbg
+//
+//  Implementation of CTR_DRBG (NIST SP 800-90A) using AES with the derivation function.
+//
+//  Depends on: CryptoLib_Aes, CryptoLib_AesCtr
+//
+//  The working state is the key (held as an initialised AesContext) and the 128 bit counter V. Output blocks and
+//  the blocks of the update function are the AES-CTR keystream with a 128 bit big endian counter starting at V+1.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_AesCtrDrbg.h"
+#include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_Aes.h"
+#include <stdint.h>
+#include <memory.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of the key and V together (seedlen), and the most the derivation function produces with AES-256
+#define SEED_SIZE( KeySize )    ( (KeySize) + AES_BLOCK_SIZE )
+#define MAX_SEED_SIZE           SEED_SIZE( AES_KEY_SIZE_256 )
+#define MAX_BCC_CHAINS          ( MAX_SEED_SIZE / AES_BLOCK_SIZE )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// State of the BCC (CBC-MAC) chains of the derivation function. All chains absorb the same data, so they are run
+// together in a single pass over it.
+typedef struct
+{
+    AesContext      Aes;
+    uint8_t         Chains [MAX_BCC_CHAINS][AES_BLOCK_SIZE];
+    uint32_t        NumChains;
+    uint8_t         Block [AES_BLOCK_SIZE];
+    uint32_t        BlockUsed;
+} BccState;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  BccAbsorb
+//
+//  Adds data to the BCC chains, encrypting every chain each time a block is complete.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    BccAbsorb
+    (
+        BccState*           State,                  // [in out]
+        uint8_t const*      Data,                   // [in]
+        uint32_t            Size                    // [in]
+    )
+{
+    uint32_t    n;
+    uint32_t    c;
+    uint32_t    i;
+
+    while( Size > 0 )
+    {
+        n = MIN( Size, AES_BLOCK_SIZE - State->BlockUsed );
+        memcpy( State->Block + State->BlockUsed, Data, n );
+        State->BlockUsed += n;
+        Data += n;
+        Size -= n;
+
+        if( AES_BLOCK_SIZE == State->BlockUsed )
+        {
+            for( c=0; c<State->NumChains; c++ )
+            {
+                for( i=0; i<AES_BLOCK_SIZE; i++ )
+                {
+                    State->Chains[c][i] ^= State->Block[i];
+                }
+                AesEncryptInPlace( &State->Aes, State->Chains[c] );
+            }
+            State->BlockUsed = 0;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DerivationFunction
+//
+//  Block_Cipher_df from SP 800-90A section 10.3.2. Produces SEED_SIZE(KeySize) bytes from the concatenation of up to
+//  three inputs, without building the padded input string in memory.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    DerivationFunction
+    (
+        uint32_t            KeySize,                // [in]
+        void const*         Input1,                 // [in optional]
+        uint32_t            Input1Size,             // [in]
+        void const*         Input2,                 // [in optional]
+        uint32_t            Input2Size,             // [in]
+        void const*         Input3,                 // [in optional]
+        uint32_t            Input3Size,             // [in]
+        uint8_t*            Output                  // [out]
+    )
+{
+    static uint8_t const zeros [AES_BLOCK_SIZE] = {0};
+    uint8_t const   endMarker = 0x80;
+    uint32_t const  seedSize = SEED_SIZE( KeySize );
+    uint32_t const  inputSize = Input1Size + Input2Size + Input3Size;
+    uint8_t         dfKey [AES_KEY_SIZE_256];
+    uint8_t         header [8];
+    uint8_t         temp [MAX_BCC_CHAINS * AES_BLOCK_SIZE];
+    uint8_t         x [AES_BLOCK_SIZE];
+    BccState        bcc;
+    AesContext      aes;
+    uint32_t        offset;
+    uint32_t        i;
+
+    // BCC with the fixed key 00 01 02 ..., one chain per block of temp. Chain i starts with the block i || 0*, so
+    // the first encryption of each is just of that block.
+    for( i=0; i<sizeof(dfKey); i++ )
+    {
+        dfKey[i] = (uint8_t)i;
+    }
+    AesInitialise( &bcc.Aes, dfKey, KeySize );
+    bcc.NumChains = ( seedSize + AES_BLOCK_SIZE - 1 ) / AES_BLOCK_SIZE;
+    bcc.BlockUsed = 0;
+    for( i=0; i<bcc.NumChains; i++ )
+    {
+        memset( bcc.Chains[i], 0, AES_BLOCK_SIZE );
+        bcc.Chains[i][3] = (uint8_t)i;
+        AesEncryptInPlace( &bcc.Aes, bcc.Chains[i] );
+    }
+
+    // S = L || N || input || 0x80 || 0*, with L and N as 32 bit big endian byte counts
+    header[0] = (uint8_t)( inputSize >> 24 );
+    header[1] = (uint8_t)( inputSize >> 16 );
+    header[2] = (uint8_t)( inputSize >> 8 );
+    header[3] = (uint8_t)( inputSize );
+    header[4] = (uint8_t)( seedSize >> 24 );
+    header[5] = (uint8_t)( seedSize >> 16 );
+    header[6] = (uint8_t)( seedSize >> 8 );
+    header[7] = (uint8_t)( seedSize );
+    BccAbsorb( &bcc, header, sizeof(header) );
+    BccAbsorb( &bcc, Input1, Input1Size );
+    BccAbsorb( &bcc, Input2, Input2Size );
+    BccAbsorb( &bcc, Input3, Input3Size );
+    BccAbsorb( &bcc, &endMarker, 1 );
+    if( bcc.BlockUsed > 0 )
+    {
+        BccAbsorb( &bcc, zeros, AES_BLOCK_SIZE - bcc.BlockUsed );
+    }
+
+    // The chains give a new key and a starting block X, which is encrypted repeatedly to produce the output
+    for( i=0; i<bcc.NumChains; i++ )
+    {
+        memcpy( temp + ( i * AES_BLOCK_SIZE ), bcc.Chains[i], AES_BLOCK_SIZE );
+    }
+    AesInitialise( &aes, temp, KeySize );
+    memcpy( x, temp + KeySize, AES_BLOCK_SIZE );
+    for( offset=0; offset<seedSize; offset+=AES_BLOCK_SIZE )
+    {
+        AesEncryptInPlace( &aes, x );
+        memcpy( Output + offset, x, MIN( AES_BLOCK_SIZE, seedSize - offset ) );
+    }
+
+    memset( &bcc, 0, sizeof(bcc) );
+    memset( &aes, 0, sizeof(aes) );
+    memset( temp, 0, sizeof(temp) );
+    memset( x, 0, sizeof(x) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DrbgUpdate
+//
+//  CTR_DRBG_Update from SP 800-90A section 10.2.1.2. The keystream blocks from V+1 are XORed with ProvidedData
+//  (SEED_SIZE bytes) and become the new key and V.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    DrbgUpdate
+    (
+        AesCtrDrbgContext*  Context,                // [in out]
+        uint8_t const*      ProvidedData            // [in]
+    )
+{
+    AesCtrContext   ctr;
+    uint8_t         temp [MAX_SEED_SIZE];
+
+    AesCtrInitialiseWithCounterBlock( &ctr, &Context->Aes, Context->V, AES_BLOCK_SIZE, AES_CTR_COUNTER_BIG_ENDIAN );
+    AesCtrSetStreamIndex( &ctr, AES_BLOCK_SIZE );
+    AesCtrXor( &ctr, ProvidedData, temp, SEED_SIZE( Context->KeySize ) );
+
+    AesInitialise( &Context->Aes, temp, Context->KeySize );
+    memcpy( Context->V, temp + Context->KeySize, AES_BLOCK_SIZE );
+
+    memset( &ctr, 0, sizeof(ctr) );
+    memset( temp, 0, sizeof(temp) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AddToCounter
+//
+//  Adds Amount to the 128 bit big endian counter V, modulo 2^128.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    AddToCounter
+    (
+        uint8_t             V [AES_BLOCK_SIZE],     // [in out]
+        uint64_t            Amount                  // [in]
+    )
+{
+    uint64_t    carry = Amount;
+    uint32_t    sum;
+    int         i;
+
+    for( i=AES_BLOCK_SIZE-1; i>=0 && 0 != carry; i-- )
+    {
+        sum = (uint32_t)V[i] + (uint32_t)( carry & 0xff );
+        V[i] = (uint8_t)sum;
+        carry = ( carry >> 8 ) + ( sum >> 8 );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DiscardOutputBuffer
+//
+//  Wipes any output in the output buffer that has not been handed out, and marks the buffer empty.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    DiscardOutputBuffer
+    (
+        AesCtrDrbgContext*  Context                 // [in out]
+    )
+{
+    if( NULL != Context->OutputBuffer )
+    {
+        memset( Context->OutputBuffer + Context->OutputBufferIndex, 0,
+            Context->OutputBufferSize - Context->OutputBufferIndex );
+        Context->OutputBufferIndex = Context->OutputBufferSize;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgInitialise
+//
+//  Instantiates a CTR_DRBG with an AES key size of KeySize (16, 24, or 32 bytes) from the entropy input, nonce, and
+//  personalisation string. Entropy must contain at least KeySize bytes of full entropy. The nonce and
+//  personalisation string are optional. The context has no output buffer attached and a reseed interval of
+//  AES_CTR_DRBG_MAX_RESEED_INTERVAL.
+//  Returns 0 if successful, or -1 if KeySize is invalid or EntropySize is too small
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgInitialise
+    (
+        AesCtrDrbgContext*  Context,                    // [out]
+        uint32_t            KeySize,                    // [in]
+        void const*         Entropy,                    // [in]
+        uint32_t            EntropySize,                // [in]
+        void const*         Nonce,                      // [in optional]
+        uint32_t            NonceSize,                  // [in]
+        void const*         Personalisation,            // [in optional]
+        uint32_t            PersonalisationSize         // [in]
+    )
+{
+    uint8_t const   zeroKey [AES_KEY_SIZE_256] = {0};
+    uint8_t         seed [MAX_SEED_SIZE];
+
+    if(     ( AES_KEY_SIZE_128 != KeySize && AES_KEY_SIZE_192 != KeySize && AES_KEY_SIZE_256 != KeySize )
+        ||  EntropySize < KeySize )
+    {
+        return -1;
+    }
+
+    memset( Context, 0, sizeof(*Context) );
+    Context->KeySize = KeySize;
+    Context->ReseedInterval = AES_CTR_DRBG_MAX_RESEED_INTERVAL;
+    AesInitialise( &Context->Aes, zeroKey, KeySize );
+
+    DerivationFunction( KeySize, Entropy, EntropySize, Nonce, NonceSize, Personalisation, PersonalisationSize, seed );
+    DrbgUpdate( Context, seed );
+    Context->ReseedCounter = 1;
+
+    memset( seed, 0, sizeof(seed) );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgReseed
+//
+//  Reseeds the DRBG with fresh entropy input (at least KeySize bytes) and optional additional input, and resets the
+//  reseed counter. Any output waiting in the output buffer is discarded.
+//  Returns 0 if successful, or -1 if EntropySize is too small
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgReseed
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        void const*         Entropy,                    // [in]
+        uint32_t            EntropySize,                // [in]
+        void const*         AdditionalInput,            // [in optional]
+        uint32_t            AdditionalInputSize         // [in]
+    )
+{
+    uint8_t     seed [MAX_SEED_SIZE];
+
+    if( EntropySize < Context->KeySize )
+    {
+        return -1;
+    }
+
+    DerivationFunction( Context->KeySize, Entropy, EntropySize, AdditionalInput, AdditionalInputSize, NULL, 0, seed );
+    DrbgUpdate( Context, seed );
+    Context->ReseedCounter = 1;
+    DiscardOutputBuffer( Context );
+
+    memset( seed, 0, sizeof(seed) );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgSetReseedInterval
+//
+//  Sets the number of requests allowed before AesCtrDrbgGenerate requires a reseed. Interval must be between 1 and
+//  AES_CTR_DRBG_MAX_RESEED_INTERVAL.
+//  Returns 0 if successful, or -1 if Interval is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgSetReseedInterval
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        uint64_t            Interval                    // [in]
+    )
+{
+    if( 0 == Interval || Interval > AES_CTR_DRBG_MAX_RESEED_INTERVAL )
+    {
+        return -1;
+    }
+
+    Context->ReseedInterval = Interval;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgGenerate
+//
+//  Generates Size bytes of random output into Buffer as one CTR_DRBG request, with optional additional input. The
+//  output buffer, if attached, is not used.
+//  Returns 0 if successful, or -1 if Size is larger than AES_CTR_DRBG_MAX_REQUEST_SIZE or the reseed interval has
+//  been reached, in which case AesCtrDrbgReseed must be called first.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgGenerate
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        void const*         AdditionalInput,            // [in optional]
+        uint32_t            AdditionalInputSize,        // [in]
+        void*               Buffer,                     // [out]
+        uint32_t            Size                        // [in]
+    )
+{
+    uint8_t         additional [MAX_SEED_SIZE] = {0};
+    AesCtrContext   ctr;
+
+    if( Size > AES_CTR_DRBG_MAX_REQUEST_SIZE || Context->ReseedCounter > Context->ReseedInterval )
+    {
+        return -1;
+    }
+
+    if( AdditionalInputSize > 0 )
+    {
+        DerivationFunction( Context->KeySize, AdditionalInput, AdditionalInputSize, NULL, 0, NULL, 0, additional );
+        DrbgUpdate( Context, additional );
+    }
+
+    // The output is the keystream from V+1 onwards, after which V has advanced by the number of blocks used
+    if( Size > 0 )
+    {
+        AesCtrInitialiseWithCounterBlock( &ctr, &Context->Aes, Context->V, AES_BLOCK_SIZE, AES_CTR_COUNTER_BIG_ENDIAN );
+        AesCtrSetStreamIndex( &ctr, AES_BLOCK_SIZE );
+        AesCtrOutput( &ctr, Buffer, Size );
+        AddToCounter( Context->V, ( Size + AES_BLOCK_SIZE - 1 ) / AES_BLOCK_SIZE );
+        memset( &ctr, 0, sizeof(ctr) );
+    }
+
+    DrbgUpdate( Context, additional );
+    Context->ReseedCounter += 1;
+
+    memset( additional, 0, sizeof(additional) );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgSetOutputBuffer
+//
+//  Attaches a caller provided buffer that AesCtrDrbgRandom fills with one large request and then serves small
+//  requests from. BufferSize must be between 1 and AES_CTR_DRBG_MAX_REQUEST_SIZE. The buffer must remain valid until
+//  it is detached by passing NULL, or the context is reinitialised. Bytes are wiped from the buffer as they are
+//  handed out, but output that has been generated and not yet handed out stays in memory, so it is not protected
+//  if the process memory is compromised before it is used.
+//  Returns 0 if successful, or -1 if BufferSize is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgSetOutputBuffer
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        void*               Buffer,                     // [in optional]
+        uint32_t            BufferSize                  // [in]
+    )
+{
+    if( NULL != Buffer && ( 0 == BufferSize || BufferSize > AES_CTR_DRBG_MAX_REQUEST_SIZE ) )
+    {
+        return -1;
+    }
+
+    DiscardOutputBuffer( Context );
+
+    Context->OutputBuffer = Buffer;
+    Context->OutputBufferSize = ( NULL != Buffer ) ? BufferSize : 0;
+    Context->OutputBufferIndex = Context->OutputBufferSize;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgRandom
+//
+//  Writes Size bytes of random output to Buffer. With an output buffer attached, bytes are taken from it and it is
+//  refilled with a single AesCtrDrbgGenerate request of the whole buffer size when empty; requests at least as large
+//  as the output buffer are generated directly into Buffer. Without one, this is AesCtrDrbgGenerate split into
+//  requests of at most AES_CTR_DRBG_MAX_REQUEST_SIZE bytes.
+//  Returns 0 if successful, or -1 if the reseed interval has been reached, in which case AesCtrDrbgReseed must be
+//  called and the output is incomplete.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgRandom
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        void*               Buffer,                     // [out]
+        uint32_t            Size                        // [in]
+    )
+{
+    uint8_t*    output = Buffer;
+    uint32_t    n;
+
+    while( Size > 0 )
+    {
+        if( Context->OutputBufferIndex == Context->OutputBufferSize )
+        {
+            if( Size >= Context->OutputBufferSize )
+            {
+                // Nothing buffered and at least a buffer's worth wanted, so skip the copy
+                n = MIN( Size, AES_CTR_DRBG_MAX_REQUEST_SIZE );
+                if( 0 != AesCtrDrbgGenerate( Context, NULL, 0, output, n ) )
+                {
+                    return -1;
+                }
+                output += n;
+                Size -= n;
+                continue;
+            }
+
+            if( 0 != AesCtrDrbgGenerate( Context, NULL, 0, Context->OutputBuffer, Context->OutputBufferSize ) )
+            {
+                return -1;
+            }
+            Context->OutputBufferIndex = 0;
+        }
+
+        n = MIN( Size, Context->OutputBufferSize - Context->OutputBufferIndex );
+        memcpy( output, Context->OutputBuffer + Context->OutputBufferIndex, n );
+        memset( Context->OutputBuffer + Context->OutputBufferIndex, 0, n );
+        Context->OutputBufferIndex += n;
+        output += n;
+        Size -= n;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgUninitialise
+//
+//  Wipes the DRBG state and any output waiting in the output buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    AesCtrDrbgUninitialise
+    (
+        AesCtrDrbgContext*  Context                     // [in out]
+    )
+{
+    DiscardOutputBuffer( Context );
+    memset( Context, 0, sizeof(*Context) );
+}
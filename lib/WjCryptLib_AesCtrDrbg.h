@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesCtrDrbg
+//
+//  Implementation of CTR_DRBG (NIST SP 800-90A) using AES with the derivation function.
+//
+//  Depends on: CryptoLib_Aes, CryptoLib_AesCtr
+//
+//  CTR_DRBG is a deterministic random bit generator: seeded with entropy supplied by the caller it produces a stream
+//  of random bytes, updating its key after every request so earlier output can not be recovered from the state.
+//  The output blocks are AES-CTR keystream and are produced with AesCtrOutput. This module has no entropy source of
+//  its own; the caller supplies entropy when initialising and reseeding.
+//  A context is not internally locked. For many threads use one context per thread, each with its own output buffer
+//  (see AesCtrDrbgSetOutputBuffer), so small requests are served from the buffer without any locking.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_Aes.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Largest single request to AesCtrDrbgGenerate (2^19 bits), and largest output buffer
+#define AES_CTR_DRBG_MAX_REQUEST_SIZE       65536
+
+// Largest number of requests allowed between reseeds (2^48), which is also the default
+#define AES_CTR_DRBG_MAX_RESEED_INTERVAL    ( (uint64_t)1 << 48 )
+
+// AesCtrDrbgContext
+// Do not modify the contents of this structure directly.
+typedef struct
+{
+    AesContext      Aes;                        // Current key
+    uint32_t        KeySize;
+    uint8_t         V [AES_BLOCK_SIZE];
+    uint64_t        ReseedCounter;              // Number of the next request since the last (re)seed, from 1
+    uint64_t        ReseedInterval;
+    uint8_t*        OutputBuffer;
+    uint32_t        OutputBufferSize;
+    uint32_t        OutputBufferIndex;          // First byte not yet handed out
+} AesCtrDrbgContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgInitialise
+//
+//  Instantiates a CTR_DRBG with an AES key size of KeySize (16, 24, or 32 bytes) from the entropy input, nonce, and
+//  personalisation string. Entropy must contain at least KeySize bytes of full entropy. The nonce and
+//  personalisation string are optional. The context has no output buffer attached and a reseed interval of
+//  AES_CTR_DRBG_MAX_RESEED_INTERVAL.
+//  Returns 0 if successful, or -1 if KeySize is invalid or EntropySize is too small
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgInitialise
+    (
+        AesCtrDrbgContext*  Context,                    // [out]
+        uint32_t            KeySize,                    // [in]
+        void const*         Entropy,                    // [in]
+        uint32_t            EntropySize,                // [in]
+        void const*         Nonce,                      // [in optional]
+        uint32_t            NonceSize,                  // [in]
+        void const*         Personalisation,            // [in optional]
+        uint32_t            PersonalisationSize         // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgReseed
+//
+//  Reseeds the DRBG with fresh entropy input (at least KeySize bytes) and optional additional input, and resets the
+//  reseed counter. Any output waiting in the output buffer is discarded.
+//  Returns 0 if successful, or -1 if EntropySize is too small
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgReseed
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        void const*         Entropy,                    // [in]
+        uint32_t            EntropySize,                // [in]
+        void const*         AdditionalInput,            // [in optional]
+        uint32_t            AdditionalInputSize         // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgSetReseedInterval
+//
+//  Sets the number of requests allowed before AesCtrDrbgGenerate requires a reseed. Interval must be between 1 and
+//  AES_CTR_DRBG_MAX_RESEED_INTERVAL.
+//  Returns 0 if successful, or -1 if Interval is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgSetReseedInterval
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        uint64_t            Interval                    // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgGenerate
+//
+//  Generates Size bytes of random output into Buffer as one CTR_DRBG request, with optional additional input. The
+//  output buffer, if attached, is not used.
+//  Returns 0 if successful, or -1 if Size is larger than AES_CTR_DRBG_MAX_REQUEST_SIZE or the reseed interval has
+//  been reached, in which case AesCtrDrbgReseed must be called first.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgGenerate
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        void const*         AdditionalInput,            // [in optional]
+        uint32_t            AdditionalInputSize,        // [in]
+        void*               Buffer,                     // [out]
+        uint32_t            Size                        // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgSetOutputBuffer
+//
+//  Attaches a caller provided buffer that AesCtrDrbgRandom fills with one large request and then serves small
+//  requests from. BufferSize must be between 1 and AES_CTR_DRBG_MAX_REQUEST_SIZE. The buffer must remain valid until
+//  it is detached by passing NULL, or the context is reinitialised. Bytes are wiped from the buffer as they are
+//  handed out, but output that has been generated and not yet handed out stays in memory, so it is not protected
+//  if the process memory is compromised before it is used.
+//  Returns 0 if successful, or -1 if BufferSize is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgSetOutputBuffer
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        void*               Buffer,                     // [in optional]
+        uint32_t            BufferSize                  // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgRandom
+//
+//  Writes Size bytes of random output to Buffer. With an output buffer attached, bytes are taken from it and it is
+//  refilled with a single AesCtrDrbgGenerate request of the whole buffer size when empty; requests at least as large
+//  as the output buffer are generated directly into Buffer. Without one, this is AesCtrDrbgGenerate split into
+//  requests of at most AES_CTR_DRBG_MAX_REQUEST_SIZE bytes.
+//  Returns 0 if successful, or -1 if the reseed interval has been reached, in which case AesCtrDrbgReseed must be
+//  called and the output is incomplete.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrDrbgRandom
+    (
+        AesCtrDrbgContext*  Context,                    // [in out]
+        void*               Buffer,                     // [out]
+        uint32_t            Size                        // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrDrbgUninitialise
+//
+//  Wipes the DRBG state and any output waiting in the output buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    AesCtrDrbgUninitialise
+    (
+        AesCtrDrbgContext*  Context                     // [in out]
+    );
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesCtrSha256
+//
+//  Encrypt-then-hash with AES CTR and SHA256 in a single pass over the data.
+//
+//  Depends on: CryptoLib_AesCtr, CryptoLib_Sha256
+//
+//  Each tile is encrypted and then hashed (or hashed and then decrypted) before moving on to the next, so the data is
+//  only brought in from memory once. The tiles are a whole number of SHA256 blocks, so apart from at the start of a
+//  call the hash never has to copy a partial block into its own buffer.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_AesCtrSha256.h"
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSha256Encrypt
+//
+//  XORs the stream of AesCtr over InBuffer into OutBuffer as AesCtrXor, and adds the output (the ciphertext) to Sha256
+//  as Sha256Update. Both contexts are left as if those two functions had been called.
+//  InBuffer and OutBuffer can point to the same location for in-place encrypting.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    AesCtrSha256Encrypt
+    (
+        AesCtrContext*      AesCtr,                 // [in out]
+        Sha256Context*      Sha256,                 // [in out]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size                    // [in]
+    )
+{
+    uint8_t const*  in = InBuffer;
+    uint8_t*        out = OutBuffer;
+    uint32_t        tileSize;
+
+    // If the hash already holds part of a block, make the first tile complete it so the rest start on block
+    // boundaries.
+    tileSize = AES_CTR_SHA256_TILE_SIZE - ( Sha256->curlen % 64 );
+    while( Size > 0 )
+    {
+        tileSize = MIN( tileSize, Size );
+        AesCtrXor( AesCtr, in, out, tileSize );
+        Sha256Update( Sha256, out, tileSize );
+
+        in += tileSize;
+        out += tileSize;
+        Size -= tileSize;
+        tileSize = AES_CTR_SHA256_TILE_SIZE;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSha256Decrypt
+//
+//  Adds InBuffer (the ciphertext) to Sha256 as Sha256Update, and XORs the stream of AesCtr over it into OutBuffer as
+//  AesCtrXor. This is the reverse of AesCtrSha256Encrypt and produces the same hash.
+//  InBuffer and OutBuffer can point to the same location for in-place decrypting.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    AesCtrSha256Decrypt
+    (
+        AesCtrContext*      AesCtr,                 // [in out]
+        Sha256Context*      Sha256,                 // [in out]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size                    // [in]
+    )
+{
+    uint8_t const*  in = InBuffer;
+    uint8_t*        out = OutBuffer;
+    uint32_t        tileSize;
+
+    // The tile must be hashed before it is decrypted, as in place decrypting overwrites the ciphertext.
+    tileSize = AES_CTR_SHA256_TILE_SIZE - ( Sha256->curlen % 64 );
+    while( Size > 0 )
+    {
+        tileSize = MIN( tileSize, Size );
+        Sha256Update( Sha256, in, tileSize );
+        AesCtrXor( AesCtr, in, out, tileSize );
+
+        in += tileSize;
+        out += tileSize;
+        Size -= tileSize;
+        tileSize = AES_CTR_SHA256_TILE_SIZE;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSha256EncryptWithKey
+//
+//  This function combines AesCtrInitialiseWithKey, Sha256Initialise, AesCtrSha256Encrypt, and Sha256Finalise. It
+//  encrypts InBuffer into OutBuffer with the Key and IV and returns the SHA256 hash of the ciphertext in Digest.
+//  Returns 0 if successful, or -1 if invalid KeySize provided
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrSha256EncryptWithKey
+    (
+        uint8_t const*      Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        uint8_t const       IV [AES_CTR_IV_SIZE],   // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            BufferSize,             // [in]
+        SHA256_HASH*        Digest                  // [out]
+    )
+{
+    int             error;
+    AesCtrContext   aesCtr;
+    Sha256Context   sha256;
+
+    error = AesCtrInitialiseWithKey( &aesCtr, Key, KeySize, IV );
+    if( 0 == error )
+    {
+        Sha256Initialise( &sha256 );
+        AesCtrSha256Encrypt( &aesCtr, &sha256, InBuffer, OutBuffer, BufferSize );
+        Sha256Finalise( &sha256, Digest );
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSha256DecryptWithKey
+//
+//  This function combines AesCtrInitialiseWithKey, Sha256Initialise, AesCtrSha256Decrypt, and Sha256Finalise. It
+//  decrypts InBuffer into OutBuffer with the Key and IV and returns the SHA256 hash of the ciphertext in Digest.
+//  Returns 0 if successful, or -1 if invalid KeySize provided
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrSha256DecryptWithKey
+    (
+        uint8_t const*      Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        uint8_t const       IV [AES_CTR_IV_SIZE],   // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            BufferSize,             // [in]
+        SHA256_HASH*        Digest                  // [out]
+    )
+{
+    int             error;
+    AesCtrContext   aesCtr;
+    Sha256Context   sha256;
+
+    error = AesCtrInitialiseWithKey( &aesCtr, Key, KeySize, IV );
+    if( 0 == error )
+    {
+        Sha256Initialise( &sha256 );
+        AesCtrSha256Decrypt( &aesCtr, &sha256, InBuffer, OutBuffer, BufferSize );
+        Sha256Finalise( &sha256, Digest );
+    }
+
+    return error;
+}
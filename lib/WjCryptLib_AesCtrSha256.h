@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesCtrSha256
+//
+//  Encrypt-then-hash with AES CTR and SHA256 in a single pass over the data.
+//
+//  Depends on: CryptoLib_AesCtr, CryptoLib_Sha256
+//
+//  Calling AesCtrXor over a buffer and then Sha256Update over the ciphertext reads the whole buffer from memory twice,
+//  and once a buffer is larger than the cache the second pass runs at memory speed. These functions work through the
+//  buffer in tiles of AES_CTR_SHA256_TILE_SIZE bytes, hashing each tile while it is still in the L1 cache. The
+//  results are identical to calling AesCtrXor and Sha256Update separately, so either side of a connection may use
+//  them.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_Sha256.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Amount encrypted before it is hashed. A whole number of SHA256 blocks, small enough that a tile of input and output
+// stay in L1 cache.
+#define AES_CTR_SHA256_TILE_SIZE        ( 8 * 1024 )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSha256Encrypt
+//
+//  XORs the stream of AesCtr over InBuffer into OutBuffer as AesCtrXor, and adds the output (the ciphertext) to Sha256
+//  as Sha256Update. Both contexts are left as if those two functions had been called.
+//  InBuffer and OutBuffer can point to the same location for in-place encrypting.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    AesCtrSha256Encrypt
+    (
+        AesCtrContext*      AesCtr,                 // [in out]
+        Sha256Context*      Sha256,                 // [in out]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size                    // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSha256Decrypt
+//
+//  Adds InBuffer (the ciphertext) to Sha256 as Sha256Update, and XORs the stream of AesCtr over it into OutBuffer as
+//  AesCtrXor. This is the reverse of AesCtrSha256Encrypt and produces the same hash.
+//  InBuffer and OutBuffer can point to the same location for in-place decrypting.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    AesCtrSha256Decrypt
+    (
+        AesCtrContext*      AesCtr,                 // [in out]
+        Sha256Context*      Sha256,                 // [in out]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size                    // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSha256EncryptWithKey
+//
+//  This function combines AesCtrInitialiseWithKey, Sha256Initialise, AesCtrSha256Encrypt, and Sha256Finalise. It
+//  encrypts InBuffer into OutBuffer with the Key and IV and returns the SHA256 hash of the ciphertext in Digest.
+//  Returns 0 if successful, or -1 if invalid KeySize provided
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrSha256EncryptWithKey
+    (
+        uint8_t const*      Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        uint8_t const       IV [AES_CTR_IV_SIZE],   // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            BufferSize,             // [in]
+        SHA256_HASH*        Digest                  // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrSha256DecryptWithKey
+//
+//  This function combines AesCtrInitialiseWithKey, Sha256Initialise, AesCtrSha256Decrypt, and Sha256Finalise. It
+//  decrypts InBuffer into OutBuffer with the Key and IV and returns the SHA256 hash of the ciphertext in Digest.
+//  Returns 0 if successful, or -1 if invalid KeySize provided
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesCtrSha256DecryptWithKey
+    (
+        uint8_t const*      Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        uint8_t const       IV [AES_CTR_IV_SIZE],   // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            BufferSize,             // [in]
+        SHA256_HASH*        Digest                  // [out]
+    );
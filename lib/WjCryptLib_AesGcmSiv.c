@@ -0,0 +1,875 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesGcmSiv
+//
+//  Implementation of AES GCM-SIV nonce misuse-resistant authenticated encryption (RFC 8452).
+//
+//  Depends on: CryptoLib_Aes, CryptoLib_AesCtr, CryptoLib_Cpu
+//
+//  AES GCM-SIV derives a fresh authentication key and encryption key for every nonce from a key-generating key. The
+//  tag is computed with POLYVAL over the additional data and the plaintext, and is then used as the initial counter
+//  block for AES in counter mode. Repeating a nonce only reveals whether the same message was encrypted twice.
+//  Encryption makes two passes over the plaintext (POLYVAL, then CTR) so the whole message is required in one call.
+//  The CTR pass uses the AesCtr module with a 32 bit little endian counter layout.
+//  On x86 processors supporting PCLMULQDQ a carry-less multiply POLYVAL is used, otherwise a table driven version.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_AesGcmSiv.h"
+#include "WjCryptLib_Stats.h"
+#include "WjCryptLib_Aes.h"
+#include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_Cpu.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <memory.h>
+
+// The carry-less multiply POLYVAL is only built for x86 with gcc or clang, which allow individual functions to be
+// compiled for PCLMULQDQ while the rest of the file targets the baseline instruction set.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+    #define USE_PCLMUL_POLYVAL
+    #include <emmintrin.h>
+    #include <wmmintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define LOAD64H( x, y )                                                      \
+   { x = (((uint64_t)((y)[0] & 255))<<56)|(((uint64_t)((y)[1] & 255))<<48) | \
+         (((uint64_t)((y)[2] & 255))<<40)|(((uint64_t)((y)[3] & 255))<<32) | \
+         (((uint64_t)((y)[4] & 255))<<24)|(((uint64_t)((y)[5] & 255))<<16) | \
+         (((uint64_t)((y)[6] & 255))<<8)|(((uint64_t)((y)[7] & 255))); }
+
+#define STORE64H( x, y )                                                       \
+   { (y)[0] = (uint8_t)(((x)>>56)&255); (y)[1] = (uint8_t)(((x)>>48)&255);     \
+     (y)[2] = (uint8_t)(((x)>>40)&255); (y)[3] = (uint8_t)(((x)>>32)&255);     \
+     (y)[4] = (uint8_t)(((x)>>24)&255); (y)[5] = (uint8_t)(((x)>>16)&255);     \
+     (y)[6] = (uint8_t)(((x)>>8)&255);  (y)[7] = (uint8_t)((x)&255); }
+
+#define STORE32L( x, y )                                                       \
+   { (y)[3] = (uint8_t)(((x)>>24)&255); (y)[2] = (uint8_t)(((x)>>16)&255);     \
+     (y)[1] = (uint8_t)(((x)>>8)&255);  (y)[0] = (uint8_t)((x)&255); }
+
+#define STORE64L( x, y )                                                       \
+   { (y)[7] = (uint8_t)(((x)>>56)&255); (y)[6] = (uint8_t)(((x)>>48)&255);     \
+     (y)[5] = (uint8_t)(((x)>>40)&255); (y)[4] = (uint8_t)(((x)>>32)&255);     \
+     (y)[3] = (uint8_t)(((x)>>24)&255); (y)[2] = (uint8_t)(((x)>>16)&255);     \
+     (y)[1] = (uint8_t)(((x)>>8)&255);  (y)[0] = (uint8_t)((x)&255); }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define POLYVAL_BLOCK_SIZE          16
+#define POLYVAL_AGGREGATE_BLOCKS    4
+
+// PolyvalContext - The accumulator is always kept in POLYVAL (little endian) byte order between calls. The table
+// version uses HL and HH, the carry-less multiply version uses Powers which holds H, H^2, H^3, H^4.
+typedef struct
+{
+    uint8_t     Accumulator [POLYVAL_BLOCK_SIZE];
+    uint64_t    HL [16];
+    uint64_t    HH [16];
+    uint8_t     Powers [POLYVAL_AGGREGATE_BLOCKS][POLYVAL_BLOCK_SIZE];
+} PolyvalContext;
+
+typedef void (*PolyvalInitialiseFunc)( PolyvalContext* Context, uint8_t const HashKey [POLYVAL_BLOCK_SIZE] );
+typedef void (*PolyvalUpdateFunc)( PolyvalContext* Context, uint8_t const* Blocks, uint32_t NumBlocks );
+
+typedef struct
+{
+    PolyvalInitialiseFunc   Initialise;
+    PolyvalUpdateFunc       Update;
+    char const*             Name;
+} PolyvalImplementation;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Reduction values for the 4 bits shifted out of the table driven multiply
+static const uint64_t gLast4 [16] =
+{
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - POLYVAL (table)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ByteReverseBlock
+//
+//  Reverses the order of the bytes in a 16 byte block. This maps between the POLYVAL and GHASH representations.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    ByteReverseBlock
+    (
+        uint8_t const       Input [POLYVAL_BLOCK_SIZE],     // [in]
+        uint8_t             Output [POLYVAL_BLOCK_SIZE]     // [out]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<POLYVAL_BLOCK_SIZE; i++ )
+    {
+        Output[i] = Input[POLYVAL_BLOCK_SIZE - 1 - i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GhashMultiply
+//
+//  Multiplies X by the hash key in the GHASH field using Shoup's 4 bit tables (as used by LibTomCrypt and others).
+//  X is in GHASH byte order.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    GhashMultiply
+    (
+        PolyvalContext const*   Context,                    // [in]
+        uint8_t                 X [POLYVAL_BLOCK_SIZE]      // [in out]
+    )
+{
+    int         i;
+    uint8_t     lo;
+    uint8_t     hi;
+    uint8_t     rem;
+    uint64_t    zh;
+    uint64_t    zl;
+
+    lo = X[15] & 0xf;
+    zh = Context->HH[lo];
+    zl = Context->HL[lo];
+
+    for( i=15; i>=0; i-- )
+    {
+        lo = X[i] & 0xf;
+        hi = (X[i] >> 4) & 0xf;
+
+        if( 15 != i )
+        {
+            rem = (uint8_t)( zl & 0xf );
+            zl = ( zh << 60 ) | ( zl >> 4 );
+            zh = ( zh >> 4 ) ^ ( gLast4[rem] << 48 );
+            zh ^= Context->HH[lo];
+            zl ^= Context->HL[lo];
+        }
+
+        rem = (uint8_t)( zl & 0xf );
+        zl = ( zh << 60 ) | ( zl >> 4 );
+        zh = ( zh >> 4 ) ^ ( gLast4[rem] << 48 );
+        zh ^= Context->HH[hi];
+        zl ^= Context->HL[hi];
+    }
+
+    STORE64H( zh, X );
+    STORE64H( zl, X + 8 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PolyvalInitialiseTable
+//
+//  Sets up the table driven POLYVAL. RFC 8452 Appendix A shows POLYVAL(H, X) is equal to
+//  ByteReverse( GHASH( mulX_GHASH( ByteReverse(H) ), ByteReverse(X) ) ) so the GHASH tables are built from
+//  mulX_GHASH( ByteReverse(H) ).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    PolyvalInitialiseTable
+    (
+        PolyvalContext*     Context,                        // [out]
+        uint8_t const       HashKey [POLYVAL_BLOCK_SIZE]    // [in]
+    )
+{
+    uint8_t     h [POLYVAL_BLOCK_SIZE];
+    uint64_t    vh;
+    uint64_t    vl;
+    uint64_t    t;
+    uint32_t    i;
+    uint32_t    j;
+
+    memset( Context->Accumulator, 0, sizeof(Context->Accumulator) );
+
+    // mulX_GHASH( ByteReverse(H) ): a right shift in GHASH bit order with reduction by 0xe1
+    ByteReverseBlock( HashKey, h );
+    LOAD64H( vh, h );
+    LOAD64H( vl, h + 8 );
+    t = ( vl & 1 ) ? 0xe100000000000000ULL : 0;
+    vl = ( vh << 63 ) | ( vl >> 1 );
+    vh = ( vh >> 1 ) ^ t;
+
+    // Build the table of multiples of H for each 4 bit value
+    Context->HL[0] = 0;
+    Context->HH[0] = 0;
+    Context->HL[8] = vl;
+    Context->HH[8] = vh;
+    for( i=4; i>0; i>>=1 )
+    {
+        t = ( vl & 1 ) ? 0xe100000000000000ULL : 0;
+        vl = ( vh << 63 ) | ( vl >> 1 );
+        vh = ( vh >> 1 ) ^ t;
+        Context->HL[i] = vl;
+        Context->HH[i] = vh;
+    }
+    for( i=2; i<=8; i*=2 )
+    {
+        for( j=1; j<i; j++ )
+        {
+            Context->HH[i+j] = Context->HH[i] ^ Context->HH[j];
+            Context->HL[i+j] = Context->HL[i] ^ Context->HL[j];
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PolyvalUpdateTable
+//
+//  Absorbs whole 16 byte blocks using the table driven multiply.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    PolyvalUpdateTable
+    (
+        PolyvalContext*     Context,                        // [in out]
+        uint8_t const*      Blocks,                         // [in]
+        uint32_t            NumBlocks                       // [in]
+    )
+{
+    uint8_t     accumulator [POLYVAL_BLOCK_SIZE];
+    uint32_t    i;
+    uint32_t    n;
+
+    // Work in GHASH byte order for the duration of the call
+    ByteReverseBlock( Context->Accumulator, accumulator );
+
+    for( n=0; n<NumBlocks; n++ )
+    {
+        for( i=0; i<POLYVAL_BLOCK_SIZE; i++ )
+        {
+            accumulator[i] ^= Blocks[POLYVAL_BLOCK_SIZE - 1 - i];
+        }
+        GhashMultiply( Context, accumulator );
+        Blocks += POLYVAL_BLOCK_SIZE;
+    }
+
+    ByteReverseBlock( accumulator, Context->Accumulator );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - POLYVAL (PCLMULQDQ)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef USE_PCLMUL_POLYVAL
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PolyvalReduce
+//
+//  Reduces the 256 bit carry-less product (High:Low) to 128 bits, giving Low*High*x^-128 mod the POLYVAL polynomial
+//  x^128 + x^127 + x^126 + x^121 + 1. This is the Montgomery style reduction described by Gueron.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "pclmul,sse2" ) ))
+static inline
+__m128i
+    PolyvalReduce
+    (
+        __m128i     Low,
+        __m128i     High
+    )
+{
+    __m128i const   poly = _mm_setr_epi32( 0x1, 0, 0, (int)0xc2000000 );
+    __m128i         t;
+
+    t = _mm_clmulepi64_si128( Low, poly, 0x10 );
+    Low = _mm_xor_si128( _mm_shuffle_epi32( Low, 78 ), t );
+    t = _mm_clmulepi64_si128( Low, poly, 0x10 );
+    Low = _mm_xor_si128( _mm_shuffle_epi32( Low, 78 ), t );
+
+    return _mm_xor_si128( High, Low );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ClMulAccumulate
+//
+//  Adds the unreduced 256 bit carry-less product of A and B to (*pLow, *pMiddle, *pHigh).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "pclmul,sse2" ) ))
+static inline
+void
+    ClMulAccumulate
+    (
+        __m128i     A,
+        __m128i     B,
+        __m128i*    pLow,
+        __m128i*    pMiddle,
+        __m128i*    pHigh
+    )
+{
+    *pLow    = _mm_xor_si128( *pLow,    _mm_clmulepi64_si128( A, B, 0x00 ) );
+    *pHigh   = _mm_xor_si128( *pHigh,   _mm_clmulepi64_si128( A, B, 0x11 ) );
+    *pMiddle = _mm_xor_si128( *pMiddle, _mm_clmulepi64_si128( A, B, 0x10 ) );
+    *pMiddle = _mm_xor_si128( *pMiddle, _mm_clmulepi64_si128( A, B, 0x01 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PolyvalDot
+//
+//  Returns A*B*x^-128, the POLYVAL "dot" operation.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "pclmul,sse2" ) ))
+static inline
+__m128i
+    PolyvalDot
+    (
+        __m128i     A,
+        __m128i     B
+    )
+{
+    __m128i     low = _mm_setzero_si128( );
+    __m128i     middle = _mm_setzero_si128( );
+    __m128i     high = _mm_setzero_si128( );
+
+    ClMulAccumulate( A, B, &low, &middle, &high );
+    low = _mm_xor_si128( low, _mm_slli_si128( middle, 8 ) );
+    high = _mm_xor_si128( high, _mm_srli_si128( middle, 8 ) );
+
+    return PolyvalReduce( low, high );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PolyvalInitialiseClMul
+//
+//  Sets up the carry-less multiply POLYVAL by precomputing H, H^2, H^3, and H^4 (powers under the dot operation).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "pclmul,sse2" ) ))
+static
+void
+    PolyvalInitialiseClMul
+    (
+        PolyvalContext*     Context,                        // [out]
+        uint8_t const       HashKey [POLYVAL_BLOCK_SIZE]    // [in]
+    )
+{
+    __m128i     h = _mm_loadu_si128( (__m128i const*)HashKey );
+    __m128i     power = h;
+    uint32_t    i;
+
+    memset( Context->Accumulator, 0, sizeof(Context->Accumulator) );
+
+    _mm_storeu_si128( (__m128i*)Context->Powers[0], h );
+    for( i=1; i<POLYVAL_AGGREGATE_BLOCKS; i++ )
+    {
+        power = PolyvalDot( power, h );
+        _mm_storeu_si128( (__m128i*)Context->Powers[i], power );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PolyvalUpdateClMul
+//
+//  Absorbs whole 16 byte blocks using carry-less multiplication. Four blocks at a time are multiplied by H^4, H^3,
+//  H^2, and H and the unreduced products summed, so only one reduction is needed per four blocks and the four
+//  multiplies are independent of each other.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "pclmul,sse2" ) ))
+static
+void
+    PolyvalUpdateClMul
+    (
+        PolyvalContext*     Context,                        // [in out]
+        uint8_t const*      Blocks,                         // [in]
+        uint32_t            NumBlocks                       // [in]
+    )
+{
+    __m128i     accumulator = _mm_loadu_si128( (__m128i const*)Context->Accumulator );
+    __m128i     h1 = _mm_loadu_si128( (__m128i const*)Context->Powers[0] );
+    __m128i     h2 = _mm_loadu_si128( (__m128i const*)Context->Powers[1] );
+    __m128i     h3 = _mm_loadu_si128( (__m128i const*)Context->Powers[2] );
+    __m128i     h4 = _mm_loadu_si128( (__m128i const*)Context->Powers[3] );
+    __m128i     low;
+    __m128i     middle;
+    __m128i     high;
+
+    while( NumBlocks >= POLYVAL_AGGREGATE_BLOCKS )
+    {
+        low = _mm_setzero_si128( );
+        middle = _mm_setzero_si128( );
+        high = _mm_setzero_si128( );
+
+        accumulator = _mm_xor_si128( accumulator, _mm_loadu_si128( (__m128i const*)Blocks ) );
+        ClMulAccumulate( accumulator, h4, &low, &middle, &high );
+        ClMulAccumulate( _mm_loadu_si128( (__m128i const*)(Blocks + 16) ), h3, &low, &middle, &high );
+        ClMulAccumulate( _mm_loadu_si128( (__m128i const*)(Blocks + 32) ), h2, &low, &middle, &high );
+        ClMulAccumulate( _mm_loadu_si128( (__m128i const*)(Blocks + 48) ), h1, &low, &middle, &high );
+
+        low = _mm_xor_si128( low, _mm_slli_si128( middle, 8 ) );
+        high = _mm_xor_si128( high, _mm_srli_si128( middle, 8 ) );
+        accumulator = PolyvalReduce( low, high );
+
+        Blocks += POLYVAL_AGGREGATE_BLOCKS * POLYVAL_BLOCK_SIZE;
+        NumBlocks -= POLYVAL_AGGREGATE_BLOCKS;
+    }
+
+    while( NumBlocks > 0 )
+    {
+        accumulator = _mm_xor_si128( accumulator, _mm_loadu_si128( (__m128i const*)Blocks ) );
+        accumulator = PolyvalDot( accumulator, h1 );
+
+        Blocks += POLYVAL_BLOCK_SIZE;
+        NumBlocks -= 1;
+    }
+
+    _mm_storeu_si128( (__m128i*)Context->Accumulator, accumulator );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuHasPclmul
+//
+//  Returns true if the processor supports PCLMULQDQ and SSE2.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    CpuHasPclmul
+    (
+        void
+    )
+{
+    uint32_t const  required = CPU_FEATURE_PCLMUL | CPU_FEATURE_SSE2;
+
+    return required == ( CpuGetFeatures( ) & required );
+}
+
+#endif // USE_PCLMUL_POLYVAL
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - POLYVAL dispatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static PolyvalImplementation const      gPolyvalTable = { PolyvalInitialiseTable, PolyvalUpdateTable, "portable" };
+#ifdef USE_PCLMUL_POLYVAL
+static PolyvalImplementation const      gPolyvalClMul = { PolyvalInitialiseClMul, PolyvalUpdateClMul, "pclmul" };
+#endif
+
+static PolyvalImplementation const*     gPolyval = NULL;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PolyvalSelectImplementation
+//
+//  Chooses the POLYVAL implementation on first use (see CpuGetFeatures on threads racing through here).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    PolyvalSelectImplementation
+    (
+        void
+    )
+{
+    PolyvalImplementation const*    implementation = &gPolyvalTable;
+
+    if( NULL != gPolyval )
+    {
+        return;
+    }
+
+#ifdef USE_PCLMUL_POLYVAL
+    if( CpuHasPclmul( ) )
+    {
+        implementation = &gPolyvalClMul;
+    }
+#endif
+
+    gPolyval = implementation;
+    STATS_SET_BACKEND( STATS_AES_GCM_SIV, implementation->Name );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PolyvalUpdatePadded
+//
+//  Absorbs a buffer of any size, zero padding the final partial block.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    PolyvalUpdatePadded
+    (
+        PolyvalContext*     Context,                        // [in out]
+        uint8_t const*      Buffer,                         // [in]
+        uint32_t            Size                            // [in]
+    )
+{
+    uint32_t    numBlocks = Size / POLYVAL_BLOCK_SIZE;
+    uint32_t    remainder = Size % POLYVAL_BLOCK_SIZE;
+    uint8_t     lastBlock [POLYVAL_BLOCK_SIZE] = {0};
+
+    if( numBlocks > 0 )
+    {
+        gPolyval->Update( Context, Buffer, numBlocks );
+    }
+    if( remainder > 0 )
+    {
+        memcpy( lastBlock, Buffer + (numBlocks * POLYVAL_BLOCK_SIZE), remainder );
+        gPolyval->Update( Context, lastBlock, 1 );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - GCM-SIV
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DeriveKeys
+//
+//  Derives the per-nonce message authentication key and message encryption key. Each derived half block is the first
+//  8 bytes of AES( KeyGeneratingKey, LE32(counter) || Nonce ). The 4 (or 6) blocks are independent of each other so
+//  they are built first and then encrypted back to back.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    DeriveKeys
+    (
+        AesGcmSivContext const* Context,                            // [in]
+        uint8_t const           Nonce [AES_GCM_SIV_NONCE_SIZE],     // [in]
+        uint8_t                 AuthenticationKey [POLYVAL_BLOCK_SIZE], // [out]
+        AesContext*             EncryptionAes                       // [out]
+    )
+{
+    uint8_t     blocks [6][AES_BLOCK_SIZE];
+    uint8_t     encryptionKey [AES_KEY_SIZE_256];
+    uint32_t    numBlocks = ( AES_KEY_SIZE_256 == Context->KeySize ) ? 6 : 4;
+    uint32_t    i;
+
+    for( i=0; i<numBlocks; i++ )
+    {
+        STORE32L( i, blocks[i] );
+        memcpy( blocks[i] + 4, Nonce, AES_GCM_SIV_NONCE_SIZE );
+    }
+    for( i=0; i<numBlocks; i++ )
+    {
+        AesEncryptInPlace( &Context->KeyGeneratingAes, blocks[i] );
+    }
+
+    memcpy( AuthenticationKey, blocks[0], 8 );
+    memcpy( AuthenticationKey + 8, blocks[1], 8 );
+    for( i=2; i<numBlocks; i++ )
+    {
+        memcpy( encryptionKey + ((i-2) * 8), blocks[i], 8 );
+    }
+
+    AesInitialise( EncryptionAes, encryptionKey, Context->KeySize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CalculateTag
+//
+//  Computes the tag: AES( EncryptionKey, POLYVAL( AuthenticationKey, AData || PlainText || Lengths ) ^ Nonce ) with
+//  the most significant bit of the last byte cleared before encryption.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    CalculateTag
+    (
+        AesContext const*   EncryptionAes,                      // [in]
+        uint8_t const       AuthenticationKey [POLYVAL_BLOCK_SIZE], // [in]
+        uint8_t const       Nonce [AES_GCM_SIV_NONCE_SIZE],     // [in]
+        uint8_t const*      AData,                              // [in optional]
+        uint32_t            ADataSize,                          // [in]
+        uint8_t const*      PlainText,                          // [in]
+        uint32_t            Size,                               // [in]
+        uint8_t             Tag [AES_GCM_SIV_TAG_SIZE]          // [out]
+    )
+{
+    PolyvalContext  polyval;
+    uint8_t         lengthBlock [POLYVAL_BLOCK_SIZE];
+    uint32_t        i;
+
+    gPolyval->Initialise( &polyval, AuthenticationKey );
+    PolyvalUpdatePadded( &polyval, AData, ADataSize );
+    PolyvalUpdatePadded( &polyval, PlainText, Size );
+
+    STORE64L( (uint64_t)ADataSize * 8, lengthBlock );
+    STORE64L( (uint64_t)Size * 8, lengthBlock + 8 );
+    gPolyval->Update( &polyval, lengthBlock, 1 );
+
+    for( i=0; i<AES_GCM_SIV_NONCE_SIZE; i++ )
+    {
+        polyval.Accumulator[i] ^= Nonce[i];
+    }
+    polyval.Accumulator[15] &= 0x7f;
+
+    AesEncrypt( EncryptionAes, polyval.Accumulator, Tag );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CtrXor
+//
+//  AES CTR as used by GCM-SIV. The initial counter block is the tag with the most significant bit of the last byte
+//  set, and the counter is the first 32 bits of the block as a little endian value, wrapping modulo 2^32.
+//  Returns 0 if successful, or -1 if the AES-CTR context could not be initialised.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    CtrXor
+    (
+        AesContext const*   EncryptionAes,                      // [in]
+        uint8_t const       Tag [AES_GCM_SIV_TAG_SIZE],         // [in]
+        uint8_t const*      InBuffer,                           // [in]
+        uint8_t*            OutBuffer,                          // [out]
+        uint32_t            Size                                // [in]
+    )
+{
+    uint8_t         counterBlock [AES_BLOCK_SIZE];
+    AesCtrContext   ctr;
+
+    memcpy( counterBlock, Tag, AES_BLOCK_SIZE );
+    counterBlock[15] |= 0x80;
+
+    if( 0 != AesCtrInitialiseWithCounterBlock( &ctr, EncryptionAes, counterBlock, 4, AES_CTR_COUNTER_LITTLE_ENDIAN ) )
+    {
+        return -1;
+    }
+
+    AesCtrXor( &ctr, InBuffer, OutBuffer, Size );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivInitialise
+//
+//  Initialises an AesGcmSivContext with a key-generating key. KeySize must be 16 or 32 (for 128 or 256 bit key size)
+//  Returns 0 if successful, or -1 if invalid KeySize provided
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivInitialise
+    (
+        AesGcmSivContext*   Context,                // [out]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize                 // [in]
+    )
+{
+    if( AES_KEY_SIZE_128 != KeySize && AES_KEY_SIZE_256 != KeySize )
+    {
+        return -1;
+    }
+
+    PolyvalSelectImplementation( );
+
+    Context->KeySize = KeySize;
+    return AesInitialise( &Context->KeyGeneratingAes, Key, KeySize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivEncrypt
+//
+//  Encrypts and authenticates a buffer. AData is additional data that is authenticated but not encrypted, it may be
+//  NULL if ADataSize is 0. The 16 byte authentication tag is written to Tag.
+//  InBuffer and OutBuffer can point to the same location for in-place encrypting. If encryption fails OutBuffer and
+//  Tag are cleared to zero.
+//  Returns 0 if successful, or -1 if the AES-CTR context could not be initialised.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivEncrypt
+    (
+        AesGcmSivContext const* Context,                        // [in]
+        uint8_t const           Nonce [AES_GCM_SIV_NONCE_SIZE], // [in]
+        void const*             AData,                          // [in optional]
+        uint32_t                ADataSize,                      // [in]
+        void const*             InBuffer,                       // [in]
+        void*                   OutBuffer,                      // [out]
+        uint32_t                Size,                           // [in]
+        uint8_t                 Tag [AES_GCM_SIV_TAG_SIZE]      // [out]
+    )
+{
+    uint8_t     authenticationKey [POLYVAL_BLOCK_SIZE];
+    AesContext  encryptionAes;
+    int         error;
+
+    STATS_BEGIN( startCycles );
+    DeriveKeys( Context, Nonce, authenticationKey, &encryptionAes );
+    CalculateTag( &encryptionAes, authenticationKey, Nonce, AData, ADataSize, InBuffer, Size, Tag );
+    error = CtrXor( &encryptionAes, Tag, InBuffer, OutBuffer, Size );
+    STATS_END( STATS_AES_GCM_SIV, startCycles, (uint64_t)ADataSize + Size );
+
+    if( 0 != error )
+    {
+        memset( OutBuffer, 0, Size );
+        memset( Tag, 0, AES_GCM_SIV_TAG_SIZE );
+        return -1;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivDecrypt
+//
+//  Decrypts and verifies a buffer. If the tag computed over the decrypted data does not match Tag then OutBuffer is
+//  cleared to zero and the function fails.
+//  InBuffer and OutBuffer can point to the same location for in-place decrypting.
+//  Returns 0 if successful, or -1 if the AES-CTR context could not be initialised or the data failed authentication.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivDecrypt
+    (
+        AesGcmSivContext const* Context,                        // [in]
+        uint8_t const           Nonce [AES_GCM_SIV_NONCE_SIZE], // [in]
+        void const*             AData,                          // [in optional]
+        uint32_t                ADataSize,                      // [in]
+        void const*             InBuffer,                       // [in]
+        void*                   OutBuffer,                      // [out]
+        uint32_t                Size,                           // [in]
+        uint8_t const           Tag [AES_GCM_SIV_TAG_SIZE]      // [in]
+    )
+{
+    uint8_t     authenticationKey [POLYVAL_BLOCK_SIZE];
+    uint8_t     expectedTag [AES_GCM_SIV_TAG_SIZE];
+    uint8_t     tag [AES_GCM_SIV_TAG_SIZE];
+    uint8_t     difference = 0;
+    AesContext  encryptionAes;
+    uint32_t    i;
+
+    STATS_BEGIN( startCycles );
+
+    // Take a copy of the tag in case it lives inside OutBuffer.
+    memcpy( tag, Tag, AES_GCM_SIV_TAG_SIZE );
+
+    DeriveKeys( Context, Nonce, authenticationKey, &encryptionAes );
+    if( 0 != CtrXor( &encryptionAes, tag, InBuffer, OutBuffer, Size ) )
+    {
+        memset( OutBuffer, 0, Size );
+        return -1;
+    }
+    CalculateTag( &encryptionAes, authenticationKey, Nonce, AData, ADataSize, OutBuffer, Size, expectedTag );
+    STATS_END( STATS_AES_GCM_SIV, startCycles, (uint64_t)ADataSize + Size );
+
+    // Compare the tags in constant time
+    for( i=0; i<AES_GCM_SIV_TAG_SIZE; i++ )
+    {
+        difference |= expectedTag[i] ^ tag[i];
+    }
+
+    if( 0 != difference )
+    {
+        // Do not release unauthenticated plaintext
+        memset( OutBuffer, 0, Size );
+        return -1;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivEncryptWithKey
+//
+//  This function combines AesGcmSivInitialise and AesGcmSivEncrypt. This is suitable when encrypting data in one go
+//  with a key that is not going to be reused.
+//  Returns 0 if successful, or -1 if invalid KeySize provided or AesGcmSivEncrypt failed
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivEncryptWithKey
+    (
+        uint8_t const*      Key,                            // [in]
+        uint32_t            KeySize,                        // [in]
+        uint8_t const       Nonce [AES_GCM_SIV_NONCE_SIZE], // [in]
+        void const*         AData,                          // [in optional]
+        uint32_t            ADataSize,                      // [in]
+        void const*         InBuffer,                       // [in]
+        void*               OutBuffer,                      // [out]
+        uint32_t            BufferSize,                     // [in]
+        uint8_t             Tag [AES_GCM_SIV_TAG_SIZE]      // [out]
+    )
+{
+    AesGcmSivContext    context;
+
+    if( 0 != AesGcmSivInitialise( &context, Key, KeySize ) )
+    {
+        return -1;
+    }
+
+    return AesGcmSivEncrypt( &context, Nonce, AData, ADataSize, InBuffer, OutBuffer, BufferSize, Tag );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivDecryptWithKey
+//
+//  This function combines AesGcmSivInitialise and AesGcmSivDecrypt. This is suitable when decrypting data in one go
+//  with a key that is not going to be reused.
+//  Returns 0 if successful, or -1 if invalid KeySize provided or the data failed authentication.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivDecryptWithKey
+    (
+        uint8_t const*      Key,                            // [in]
+        uint32_t            KeySize,                        // [in]
+        uint8_t const       Nonce [AES_GCM_SIV_NONCE_SIZE], // [in]
+        void const*         AData,                          // [in optional]
+        uint32_t            ADataSize,                      // [in]
+        void const*         InBuffer,                       // [in]
+        void*               OutBuffer,                      // [out]
+        uint32_t            BufferSize,                     // [in]
+        uint8_t const       Tag [AES_GCM_SIV_TAG_SIZE]      // [in]
+    )
+{
+    AesGcmSivContext    context;
+
+    if( 0 != AesGcmSivInitialise( &context, Key, KeySize ) )
+    {
+        return -1;
+    }
+
+    return AesGcmSivDecrypt( &context, Nonce, AData, ADataSize, InBuffer, OutBuffer, BufferSize, Tag );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivSetImplementation
+//
+//  Selects the POLYVAL implementation used by all contexts. AES_GCM_SIV_IMPLEMENTATION_AUTO (the default) uses the
+//  carry-less multiply when the processor supports it, otherwise the table driven version. The others force a
+//  particular one, which is intended for testing and benchmarking. This must not be called while another thread is
+//  encrypting or decrypting.
+//  Returns 0 if successful, or -1 if the implementation is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivSetImplementation
+    (
+        uint32_t                Implementation          // [in]
+    )
+{
+    switch( Implementation )
+    {
+    case AES_GCM_SIV_IMPLEMENTATION_AUTO:
+        gPolyval = NULL;
+        PolyvalSelectImplementation( );
+        return 0;
+
+    case AES_GCM_SIV_IMPLEMENTATION_PORTABLE:
+        gPolyval = &gPolyvalTable;
+        STATS_SET_BACKEND( STATS_AES_GCM_SIV, gPolyval->Name );
+        return 0;
+
+#ifdef USE_PCLMUL_POLYVAL
+    case AES_GCM_SIV_IMPLEMENTATION_PCLMUL:
+        if( CpuHasPclmul( ) )
+        {
+            gPolyval = &gPolyvalClMul;
+            STATS_SET_BACKEND( STATS_AES_GCM_SIV, gPolyval->Name );
+            return 0;
+        }
+        return -1;
+#endif
+
+    default:
+        return -1;
+    }
+}
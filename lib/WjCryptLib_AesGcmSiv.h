@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesGcmSiv
+//
+//  Implementation of AES GCM-SIV nonce misuse-resistant authenticated encryption (RFC 8452).
+//
+//  Depends on: CryptoLib_Aes, CryptoLib_AesCtr, CryptoLib_Cpu
+//
+//  AES GCM-SIV derives a fresh authentication key and encryption key for every nonce from a key-generating key. The
+//  tag is computed with POLYVAL over the additional data and the plaintext, and is then used as the initial counter
+//  block for AES in counter mode. Repeating a nonce only reveals whether the same message was encrypted twice.
+//  Encryption makes two passes over the plaintext (POLYVAL, then CTR) so the whole message is required in one call.
+//  The CTR pass uses the AesCtr module with a 32 bit little endian counter layout.
+//  On x86 processors supporting PCLMULQDQ a carry-less multiply POLYVAL is used, otherwise a table driven version.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_Aes.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define AES_GCM_SIV_NONCE_SIZE      12
+#define AES_GCM_SIV_TAG_SIZE        16
+
+// POLYVAL implementations for AesGcmSivSetImplementation
+#define AES_GCM_SIV_IMPLEMENTATION_AUTO         0       // PCLMULQDQ if the processor has it, otherwise portable
+#define AES_GCM_SIV_IMPLEMENTATION_PORTABLE     1       // Portable C, table driven
+#define AES_GCM_SIV_IMPLEMENTATION_PCLMUL       2       // x86 carry-less multiply
+
+// AesGcmSivContext - This must be initialised using AesGcmSivInitialise with a KeySize of AES_KEY_SIZE_128 or
+// AES_KEY_SIZE_256. Do not modify the contents of this structure directly.
+typedef struct
+{
+    AesContext      KeyGeneratingAes;
+    uint32_t        KeySize;
+} AesGcmSivContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivInitialise
+//
+//  Initialises an AesGcmSivContext with a key-generating key. KeySize must be 16 or 32 (for 128 or 256 bit key size)
+//  Returns 0 if successful, or -1 if invalid KeySize provided
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivInitialise
+    (
+        AesGcmSivContext*   Context,                // [out]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivEncrypt
+//
+//  Encrypts and authenticates a buffer. AData is additional data that is authenticated but not encrypted, it may be
+//  NULL if ADataSize is 0. The 16 byte authentication tag is written to Tag.
+//  InBuffer and OutBuffer can point to the same location for in-place encrypting. If encryption fails OutBuffer and
+//  Tag are cleared to zero.
+//  Returns 0 if successful, or -1 if the AES-CTR context could not be initialised.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivEncrypt
+    (
+        AesGcmSivContext const* Context,                        // [in]
+        uint8_t const           Nonce [AES_GCM_SIV_NONCE_SIZE], // [in]
+        void const*             AData,                          // [in optional]
+        uint32_t                ADataSize,                      // [in]
+        void const*             InBuffer,                       // [in]
+        void*                   OutBuffer,                      // [out]
+        uint32_t                Size,                           // [in]
+        uint8_t                 Tag [AES_GCM_SIV_TAG_SIZE]      // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivDecrypt
+//
+//  Decrypts and verifies a buffer. If the tag computed over the decrypted data does not match Tag then OutBuffer is
+//  cleared to zero and the function fails.
+//  InBuffer and OutBuffer can point to the same location for in-place decrypting.
+//  Returns 0 if successful, or -1 if the AES-CTR context could not be initialised or the data failed authentication.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivDecrypt
+    (
+        AesGcmSivContext const* Context,                        // [in]
+        uint8_t const           Nonce [AES_GCM_SIV_NONCE_SIZE], // [in]
+        void const*             AData,                          // [in optional]
+        uint32_t                ADataSize,                      // [in]
+        void const*             InBuffer,                       // [in]
+        void*                   OutBuffer,                      // [out]
+        uint32_t                Size,                           // [in]
+        uint8_t const           Tag [AES_GCM_SIV_TAG_SIZE]      // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivEncryptWithKey
+//
+//  This function combines AesGcmSivInitialise and AesGcmSivEncrypt. This is suitable when encrypting data in one go
+//  with a key that is not going to be reused.
+//  Returns 0 if successful, or -1 if invalid KeySize provided or AesGcmSivEncrypt failed
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivEncryptWithKey
+    (
+        uint8_t const*      Key,                            // [in]
+        uint32_t            KeySize,                        // [in]
+        uint8_t const       Nonce [AES_GCM_SIV_NONCE_SIZE], // [in]
+        void const*         AData,                          // [in optional]
+        uint32_t            ADataSize,                      // [in]
+        void const*         InBuffer,                       // [in]
+        void*               OutBuffer,                      // [out]
+        uint32_t            BufferSize,                     // [in]
+        uint8_t             Tag [AES_GCM_SIV_TAG_SIZE]      // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivDecryptWithKey
+//
+//  This function combines AesGcmSivInitialise and AesGcmSivDecrypt. This is suitable when decrypting data in one go
+//  with a key that is not going to be reused.
+//  Returns 0 if successful, or -1 if invalid KeySize provided or the data failed authentication.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivDecryptWithKey
+    (
+        uint8_t const*      Key,                            // [in]
+        uint32_t            KeySize,                        // [in]
+        uint8_t const       Nonce [AES_GCM_SIV_NONCE_SIZE], // [in]
+        void const*         AData,                          // [in optional]
+        uint32_t            ADataSize,                      // [in]
+        void const*         InBuffer,                       // [in]
+        void*               OutBuffer,                      // [out]
+        uint32_t            BufferSize,                     // [in]
+        uint8_t const       Tag [AES_GCM_SIV_TAG_SIZE]      // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesGcmSivSetImplementation
+//
+//  Selects the POLYVAL implementation used by all contexts. AES_GCM_SIV_IMPLEMENTATION_AUTO (the default) uses the
+//  carry-less multiply when the processor supports it, otherwise the table driven version. The others force a
+//  particular one, which is intended for testing and benchmarking. This must not be called while another thread is
+//  encrypting or decrypting.
+//  Returns 0 if successful, or -1 if the implementation is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesGcmSivSetImplementation
+    (
+        uint32_t                Implementation          // [in]
+    );
@@ -0,0 +1,497 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesKeyWrap
+//
+//  Implementation of AES Key Wrap (RFC 3394) and AES Key Wrap with Padding (RFC 5649).
+//
+//  Depends on: CryptoLib_Aes
+//
+//  AES Key Wrap encrypts key material under a key-encryption key (KEK) and adds a 64 bit integrity check value. The
+//  wrapped output is 8 bytes larger than the input (plus padding for RFC 5649). Each wrap is 6 x n AES operations in
+//  one dependent chain, so the batch functions wrap several keys together, stepping every chain in turn, which lets
+//  the independent AES operations overlap in the processor.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_AesKeyWrap.h"
+#include "WjCryptLib_Stats.h"
+#include "WjCryptLib_Aes.h"
+#include <stdint.h>
+#include <memory.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+#define STORE32H( x, y )                                                       \
+   { (y)[0] = (uint8_t)(((x)>>24)&255); (y)[1] = (uint8_t)(((x)>>16)&255);     \
+     (y)[2] = (uint8_t)(((x)>>8)&255);  (y)[3] = (uint8_t)((x)&255); }
+
+#define LOAD32H( x, y )                                                        \
+   { x = ((uint32_t)((y)[0] & 255)<<24) | ((uint32_t)((y)[1] & 255)<<16) |     \
+         ((uint32_t)((y)[2] & 255)<<8)  | ((uint32_t)((y)[3] & 255)); }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define SEMIBLOCK_SIZE      AES_KEY_WRAP_SEMIBLOCK_SIZE
+
+// Number of wrap chains that are stepped together by the batch functions
+#define BATCH_LANES         8
+
+// Default initial value from RFC 3394 section 2.2.3.1
+static const uint8_t gDefaultIV [SEMIBLOCK_SIZE] = { 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6 };
+
+// First half of the alternative initial value from RFC 5649 section 3. The second half is the key size.
+static const uint8_t gPaddedIVPrefix [4] = { 0xa6, 0x59, 0x59, 0xa6 };
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  XorStepCounter
+//
+//  XORs the 64 bit big endian step counter t into the integrity register A.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    XorStepCounter
+    (
+        uint8_t         A [SEMIBLOCK_SIZE],         // [in out]
+        uint64_t        t                           // [in]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<SEMIBLOCK_SIZE; i++ )
+    {
+        A[SEMIBLOCK_SIZE - 1 - i] ^= (uint8_t)( t >> (8 * i) );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WrapLanes
+//
+//  Runs the RFC 3394 wrapping process (section 2.2.1, index based) over NumLanes independent keys of n semiblocks.
+//  A[lane] holds the initial value on entry and the integrity register on exit. R[lane] points to the n semiblocks
+//  which are encrypted in place. For each step the AES operations of all lanes are performed back to back; they have
+//  no dependency on each other so their latencies overlap.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    WrapLanes
+    (
+        AesContext const*   Aes,                                // [in]
+        uint32_t            NumLanes,                           // [in]
+        uint8_t             A [BATCH_LANES][SEMIBLOCK_SIZE],    // [in out]
+        uint8_t*            R [BATCH_LANES],                    // [in out]
+        uint32_t            n                                   // [in]
+    )
+{
+    uint8_t     block [BATCH_LANES][AES_BLOCK_SIZE];
+    uint64_t    t;
+    uint32_t    i;
+    uint32_t    j;
+    uint32_t    lane;
+
+    for( j=0; j<6; j++ )
+    {
+        for( i=0; i<n; i++ )
+        {
+            t = ( (uint64_t)n * j ) + i + 1;
+
+            for( lane=0; lane<NumLanes; lane++ )
+            {
+                memcpy( block[lane], A[lane], SEMIBLOCK_SIZE );
+                memcpy( block[lane] + SEMIBLOCK_SIZE, R[lane] + (i * SEMIBLOCK_SIZE), SEMIBLOCK_SIZE );
+                AesEncryptInPlace( Aes, block[lane] );
+            }
+
+            for( lane=0; lane<NumLanes; lane++ )
+            {
+                memcpy( A[lane], block[lane], SEMIBLOCK_SIZE );
+                XorStepCounter( A[lane], t );
+                memcpy( R[lane] + (i * SEMIBLOCK_SIZE), block[lane] + SEMIBLOCK_SIZE, SEMIBLOCK_SIZE );
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UnwrapLanes
+//
+//  Runs the RFC 3394 unwrapping process (section 2.2.2, index based) over NumLanes independent wrapped keys. A[lane]
+//  holds the first semiblock of the wrapped key on entry and the recovered initial value on exit. R[lane] points to
+//  the remaining n semiblocks which are decrypted in place.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    UnwrapLanes
+    (
+        AesContext const*   Aes,                                // [in]
+        uint32_t            NumLanes,                           // [in]
+        uint8_t             A [BATCH_LANES][SEMIBLOCK_SIZE],    // [in out]
+        uint8_t*            R [BATCH_LANES],                    // [in out]
+        uint32_t            n                                   // [in]
+    )
+{
+    uint8_t     block [BATCH_LANES][AES_BLOCK_SIZE];
+    uint64_t    t;
+    uint32_t    i;
+    uint32_t    j;
+    uint32_t    lane;
+
+    for( j=6; j>0; j-- )
+    {
+        for( i=n; i>0; i-- )
+        {
+            t = ( (uint64_t)n * (j - 1) ) + i;
+
+            for( lane=0; lane<NumLanes; lane++ )
+            {
+                memcpy( block[lane], A[lane], SEMIBLOCK_SIZE );
+                XorStepCounter( block[lane], t );
+                memcpy( block[lane] + SEMIBLOCK_SIZE, R[lane] + ((i-1) * SEMIBLOCK_SIZE), SEMIBLOCK_SIZE );
+                AesDecryptInPlace( Aes, block[lane] );
+            }
+
+            for( lane=0; lane<NumLanes; lane++ )
+            {
+                memcpy( A[lane], block[lane], SEMIBLOCK_SIZE );
+                memcpy( R[lane] + ((i-1) * SEMIBLOCK_SIZE), block[lane] + SEMIBLOCK_SIZE, SEMIBLOCK_SIZE );
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SemiblocksDiffer
+//
+//  Compares two semiblocks in constant time. Returns 0 if they are equal.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint8_t
+    SemiblocksDiffer
+    (
+        uint8_t const   X [SEMIBLOCK_SIZE],         // [in]
+        uint8_t const   Y [SEMIBLOCK_SIZE]          // [in]
+    )
+{
+    uint8_t     difference = 0;
+    uint32_t    i;
+
+    for( i=0; i<SEMIBLOCK_SIZE; i++ )
+    {
+        difference |= X[i] ^ Y[i];
+    }
+
+    return difference;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyWrap
+//
+//  Wraps Key using RFC 3394 with an already initialised AesContext holding the KEK. KeySize must be a multiple of 8
+//  and at least 16. WrappedKey receives KeySize + 8 bytes. Key and WrappedKey must not overlap.
+//  Returns 0 if successful, or -1 if KeySize is invalid.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyWrap
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        void*               WrappedKey              // [out]
+    )
+{
+    return AesKeyWrapBatch( InitialisedAesContext, Key, KeySize, 1, WrappedKey );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyUnwrap
+//
+//  Unwraps a key wrapped with AesKeyWrap. WrappedKeySize must be a multiple of 8 and at least 24. Key receives
+//  WrappedKeySize - 8 bytes. If the integrity check fails Key is cleared to zero. WrappedKey and Key must not overlap.
+//  Returns 0 if successful, or -1 if WrappedKeySize is invalid or the integrity check failed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyUnwrap
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         WrappedKey,             // [in]
+        uint32_t            WrappedKeySize,         // [in]
+        void*               Key                     // [out]
+    )
+{
+    return AesKeyUnwrapBatch( InitialisedAesContext, WrappedKey, WrappedKeySize, 1, Key );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyWrapPadded
+//
+//  Wraps Key using RFC 5649, which allows any KeySize of 1 byte or more. WrappedKey receives
+//  AES_KEY_WRAP_PADDED_SIZE(KeySize) bytes. Key and WrappedKey must not overlap.
+//  Returns 0 if successful, or -1 if KeySize is 0.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyWrapPadded
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        void*               WrappedKey              // [out]
+    )
+{
+    uint8_t*    wrapped = (uint8_t*)WrappedKey;
+    uint32_t    paddedSize;
+    uint8_t     A [BATCH_LANES][SEMIBLOCK_SIZE];
+    uint8_t*    R [BATCH_LANES];
+
+    if( 0 == KeySize || KeySize > 0xffffffff - 2*SEMIBLOCK_SIZE )
+    {
+        return -1;
+    }
+
+    STATS_BEGIN( startCycles );
+    paddedSize = AES_KEY_WRAP_PADDED_SIZE( KeySize ) - AES_KEY_WRAP_OVERHEAD;
+
+    // Alternative initial value, followed by the key padded with zeros to a whole number of semiblocks
+    memcpy( A[0], gPaddedIVPrefix, sizeof(gPaddedIVPrefix) );
+    STORE32H( KeySize, A[0] + 4 );
+    memcpy( wrapped + SEMIBLOCK_SIZE, Key, KeySize );
+    memset( wrapped + SEMIBLOCK_SIZE + KeySize, 0, paddedSize - KeySize );
+
+    if( SEMIBLOCK_SIZE == paddedSize )
+    {
+        // A single semiblock is encrypted as one AES block (RFC 5649 section 4.1)
+        memcpy( wrapped, A[0], SEMIBLOCK_SIZE );
+        AesEncryptInPlace( InitialisedAesContext, wrapped );
+    }
+    else
+    {
+        R[0] = wrapped + SEMIBLOCK_SIZE;
+        WrapLanes( InitialisedAesContext, 1, A, R, paddedSize / SEMIBLOCK_SIZE );
+        memcpy( wrapped, A[0], SEMIBLOCK_SIZE );
+    }
+
+    STATS_END( STATS_AES_KEY_WRAP, startCycles, KeySize );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyUnwrapPadded
+//
+//  Unwraps a key wrapped with AesKeyWrapPadded. WrappedKeySize must be a multiple of 8 and at least 16. Key must have
+//  room for WrappedKeySize - 8 bytes, the actual size of the key is written to *pKeySize. If the integrity check
+//  fails Key is cleared to zero. WrappedKey and Key must not overlap.
+//  Returns 0 if successful, or -1 if WrappedKeySize is invalid or the integrity check failed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyUnwrapPadded
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         WrappedKey,             // [in]
+        uint32_t            WrappedKeySize,         // [in]
+        void*               Key,                    // [out]
+        uint32_t*           pKeySize                // [out]
+    )
+{
+    uint8_t const*  wrapped = (uint8_t const*)WrappedKey;
+    uint8_t*        key = (uint8_t*)Key;
+    uint32_t        paddedSize;
+    uint32_t        keySize;
+    uint8_t         block [AES_BLOCK_SIZE];
+    uint8_t         A [BATCH_LANES][SEMIBLOCK_SIZE];
+    uint8_t*        R [BATCH_LANES];
+    uint8_t         difference = 0;
+    uint32_t        i;
+
+    *pKeySize = 0;
+    if( WrappedKeySize < 2*SEMIBLOCK_SIZE || 0 != (WrappedKeySize % SEMIBLOCK_SIZE) )
+    {
+        return -1;
+    }
+
+    STATS_BEGIN( startCycles );
+    paddedSize = WrappedKeySize - SEMIBLOCK_SIZE;
+
+    if( SEMIBLOCK_SIZE == paddedSize )
+    {
+        memcpy( block, wrapped, AES_BLOCK_SIZE );
+        AesDecryptInPlace( InitialisedAesContext, block );
+        memcpy( A[0], block, SEMIBLOCK_SIZE );
+        memcpy( key, block + SEMIBLOCK_SIZE, SEMIBLOCK_SIZE );
+    }
+    else
+    {
+        memcpy( A[0], wrapped, SEMIBLOCK_SIZE );
+        memcpy( key, wrapped + SEMIBLOCK_SIZE, paddedSize );
+        R[0] = key;
+        UnwrapLanes( InitialisedAesContext, 1, A, R, paddedSize / SEMIBLOCK_SIZE );
+    }
+
+    // Check the initial value prefix, that the stated size fits the last semiblock, and that the padding is zero
+    for( i=0; i<sizeof(gPaddedIVPrefix); i++ )
+    {
+        difference |= A[0][i] ^ gPaddedIVPrefix[i];
+    }
+    LOAD32H( keySize, A[0] + 4 );
+    if( keySize <= paddedSize - SEMIBLOCK_SIZE || keySize > paddedSize )
+    {
+        difference |= 1;
+        keySize = paddedSize;
+    }
+    for( i=keySize; i<paddedSize; i++ )
+    {
+        difference |= key[i];
+    }
+    STATS_END( STATS_AES_KEY_WRAP, startCycles, paddedSize );
+
+    if( 0 != difference )
+    {
+        memset( key, 0, paddedSize );
+        return -1;
+    }
+
+    *pKeySize = keySize;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyWrapBatch
+//
+//  Wraps NumKeys keys of KeySize bytes each with the same KEK using RFC 3394. Keys holds the keys back to back
+//  (NumKeys x KeySize bytes) and WrappedKeys receives the wrapped keys back to back (NumKeys x (KeySize + 8) bytes).
+//  The output is identical to calling AesKeyWrap on each key, but the wrap chains of several keys are interleaved.
+//  Keys and WrappedKeys must not overlap.
+//  Returns 0 if successful, or -1 if KeySize is invalid.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyWrapBatch
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         Keys,                   // [in]
+        uint32_t            KeySize,                // [in]
+        uint32_t            NumKeys,                // [in]
+        void*               WrappedKeys             // [out]
+    )
+{
+    uint8_t const*  keys = (uint8_t const*)Keys;
+    uint8_t*        wrappedKeys = (uint8_t*)WrappedKeys;
+    uint32_t        wrappedKeySize = KeySize + SEMIBLOCK_SIZE;
+    uint8_t         A [BATCH_LANES][SEMIBLOCK_SIZE];
+    uint8_t*        R [BATCH_LANES];
+    uint32_t        numLanes;
+    uint32_t        lane;
+
+    if(     KeySize < AES_KEY_WRAP_MIN_KEY_SIZE
+        ||  0 != (KeySize % SEMIBLOCK_SIZE)
+        ||  KeySize > 0xffffffff - SEMIBLOCK_SIZE )
+    {
+        return -1;
+    }
+
+    STATS_BEGIN( startCycles );
+    while( NumKeys > 0 )
+    {
+        numLanes = MIN( NumKeys, BATCH_LANES );
+
+        for( lane=0; lane<numLanes; lane++ )
+        {
+            memcpy( A[lane], gDefaultIV, SEMIBLOCK_SIZE );
+            R[lane] = wrappedKeys + (lane * wrappedKeySize) + SEMIBLOCK_SIZE;
+            memcpy( R[lane], keys + (lane * KeySize), KeySize );
+        }
+
+        WrapLanes( InitialisedAesContext, numLanes, A, R, KeySize / SEMIBLOCK_SIZE );
+
+        for( lane=0; lane<numLanes; lane++ )
+        {
+            memcpy( wrappedKeys + (lane * wrappedKeySize), A[lane], SEMIBLOCK_SIZE );
+        }
+
+        keys += numLanes * KeySize;
+        wrappedKeys += numLanes * wrappedKeySize;
+        NumKeys -= numLanes;
+    }
+
+    STATS_END( STATS_AES_KEY_WRAP, startCycles, keys - (uint8_t const*)Keys );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyUnwrapBatch
+//
+//  Unwraps NumKeys keys wrapped with AesKeyWrap (or AesKeyWrapBatch), each WrappedKeySize bytes, stored back to back.
+//  Keys receives the keys back to back (NumKeys x (WrappedKeySize - 8) bytes). Any key that fails its integrity
+//  check is cleared to zero, the other keys are still unwrapped. WrappedKeys and Keys must not overlap.
+//  Returns 0 if all keys were unwrapped, or -1 if WrappedKeySize is invalid or any key failed its integrity check.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyUnwrapBatch
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         WrappedKeys,            // [in]
+        uint32_t            WrappedKeySize,         // [in]
+        uint32_t            NumKeys,                // [in]
+        void*               Keys                    // [out]
+    )
+{
+    uint8_t const*  wrappedKeys = (uint8_t const*)WrappedKeys;
+    uint8_t*        keys = (uint8_t*)Keys;
+    uint32_t        keySize = WrappedKeySize - SEMIBLOCK_SIZE;
+    uint8_t         A [BATCH_LANES][SEMIBLOCK_SIZE];
+    uint8_t*        R [BATCH_LANES];
+    uint32_t        numLanes;
+    uint32_t        lane;
+    int             result = 0;
+
+    if( WrappedKeySize < AES_KEY_WRAP_MIN_KEY_SIZE + SEMIBLOCK_SIZE || 0 != (WrappedKeySize % SEMIBLOCK_SIZE) )
+    {
+        return -1;
+    }
+
+    STATS_BEGIN( startCycles );
+    while( NumKeys > 0 )
+    {
+        numLanes = MIN( NumKeys, BATCH_LANES );
+
+        for( lane=0; lane<numLanes; lane++ )
+        {
+            memcpy( A[lane], wrappedKeys + (lane * WrappedKeySize), SEMIBLOCK_SIZE );
+            R[lane] = keys + (lane * keySize);
+            memcpy( R[lane], wrappedKeys + (lane * WrappedKeySize) + SEMIBLOCK_SIZE, keySize );
+        }
+
+        UnwrapLanes( InitialisedAesContext, numLanes, A, R, keySize / SEMIBLOCK_SIZE );
+
+        for( lane=0; lane<numLanes; lane++ )
+        {
+            if( 0 != SemiblocksDiffer( A[lane], gDefaultIV ) )
+            {
+                memset( R[lane], 0, keySize );
+                result = -1;
+            }
+        }
+
+        wrappedKeys += numLanes * WrappedKeySize;
+        keys += numLanes * keySize;
+        NumKeys -= numLanes;
+    }
+
+    STATS_END( STATS_AES_KEY_WRAP, startCycles, keys - (uint8_t*)Keys );
+    return result;
+}
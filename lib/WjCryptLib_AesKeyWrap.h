@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_AesKeyWrap
+//
+//  Implementation of AES Key Wrap (RFC 3394) and AES Key Wrap with Padding (RFC 5649).
+//
+//  Depends on: CryptoLib_Aes
+//
+//  AES Key Wrap encrypts key material under a key-encryption key (KEK) and adds a 64 bit integrity check value. The
+//  wrapped output is 8 bytes larger than the input (plus padding for RFC 5649). Each wrap is 6 x n AES operations in
+//  one dependent chain, so the batch functions wrap several keys together, stepping every chain in turn, which lets
+//  the independent AES operations overlap in the processor.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_Aes.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Key material is processed in 8 byte semiblocks. The wrapped output is one semiblock larger than the (padded) input.
+#define AES_KEY_WRAP_SEMIBLOCK_SIZE     8
+#define AES_KEY_WRAP_OVERHEAD           AES_KEY_WRAP_SEMIBLOCK_SIZE
+
+// Smallest key that can be wrapped with AesKeyWrap (RFC 3394 requires at least two semiblocks)
+#define AES_KEY_WRAP_MIN_KEY_SIZE       16
+
+// Size of the output of AesKeyWrapPadded for a key of x bytes
+#define AES_KEY_WRAP_PADDED_SIZE( x )   ( ( ((x) + 7) / 8 ) * 8 + AES_KEY_WRAP_OVERHEAD )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyWrap
+//
+//  Wraps Key using RFC 3394 with an already initialised AesContext holding the KEK. KeySize must be a multiple of 8
+//  and at least 16. WrappedKey receives KeySize + 8 bytes. Key and WrappedKey must not overlap.
+//  Returns 0 if successful, or -1 if KeySize is invalid.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyWrap
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        void*               WrappedKey              // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyUnwrap
+//
+//  Unwraps a key wrapped with AesKeyWrap. WrappedKeySize must be a multiple of 8 and at least 24. Key receives
+//  WrappedKeySize - 8 bytes. If the integrity check fails Key is cleared to zero. WrappedKey and Key must not overlap.
+//  Returns 0 if successful, or -1 if WrappedKeySize is invalid or the integrity check failed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyUnwrap
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         WrappedKey,             // [in]
+        uint32_t            WrappedKeySize,         // [in]
+        void*               Key                     // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyWrapPadded
+//
+//  Wraps Key using RFC 5649, which allows any KeySize of 1 byte or more. WrappedKey receives
+//  AES_KEY_WRAP_PADDED_SIZE(KeySize) bytes. Key and WrappedKey must not overlap.
+//  Returns 0 if successful, or -1 if KeySize is 0.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyWrapPadded
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        void*               WrappedKey              // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyUnwrapPadded
+//
+//  Unwraps a key wrapped with AesKeyWrapPadded. WrappedKeySize must be a multiple of 8 and at least 16. Key must have
+//  room for WrappedKeySize - 8 bytes, the actual size of the key is written to *pKeySize. If the integrity check
+//  fails Key is cleared to zero. WrappedKey and Key must not overlap.
+//  Returns 0 if successful, or -1 if WrappedKeySize is invalid or the integrity check failed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyUnwrapPadded
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         WrappedKey,             // [in]
+        uint32_t            WrappedKeySize,         // [in]
+        void*               Key,                    // [out]
+        uint32_t*           pKeySize                // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyWrapBatch
+//
+//  Wraps NumKeys keys of KeySize bytes each with the same KEK using RFC 3394. Keys holds the keys back to back
+//  (NumKeys x KeySize bytes) and WrappedKeys receives the wrapped keys back to back (NumKeys x (KeySize + 8) bytes).
+//  The output is identical to calling AesKeyWrap on each key, but the wrap chains of several keys are interleaved.
+//  Keys and WrappedKeys must not overlap.
+//  Returns 0 if successful, or -1 if KeySize is invalid.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyWrapBatch
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         Keys,                   // [in]
+        uint32_t            KeySize,                // [in]
+        uint32_t            NumKeys,                // [in]
+        void*               WrappedKeys             // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesKeyUnwrapBatch
+//
+//  Unwraps NumKeys keys wrapped with AesKeyWrap (or AesKeyWrapBatch), each WrappedKeySize bytes, stored back to back.
+//  Keys receives the keys back to back (NumKeys x (WrappedKeySize - 8) bytes). Any key that fails its integrity
+//  check is cleared to zero, the other keys are still unwrapped. WrappedKeys and Keys must not overlap.
+//  Returns 0 if all keys were unwrapped, or -1 if WrappedKeySize is invalid or any key failed its integrity check.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesKeyUnwrapBatch
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         WrappedKeys,            // [in]
+        uint32_t            WrappedKeySize,         // [in]
+        uint32_t            NumKeys,                // [in]
+        void*               Keys                    // [out]
+    );
@@ -6,6 +6,9 @@
 //  Depends on: CryptoLib_Aes
 //
 //  AES OFB is a stream cipher using the AES block cipher in output feedback mode.
+//  Each keystream block is the encryption of the previous one, so OFB can not normally seek or run in parallel. A
+//  checkpoint table (the keystream block at every Nth block) recorded while encrypting allows a later reader to start
+//  from the nearest checkpoint, and to split a large range across threads.
 //  This implementation works on both little and big endian architectures.
 //
 //  This is free and unencumbered software released into the public domain - January 2018 waterjuice.org
@@ -16,8 +19,10 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_AesOfb.h"
+#include "WjCryptLib_Stats.h"
 #include "WjCryptLib_Aes.h"
 #include <stdint.h>
+#include <stdbool.h>
 #include <memory.h>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +31,9 @@
 
 #define MIN( x, y ) ( ((x)<(y))?(x):(y) )
 
+// Number of streams AesOfbXorMultiple advances in lock-step on one thread
+#define MULTI_STREAM_LANES      8
+
 #define STORE64H( x, y )                                                       \
    { (y)[0] = (uint8_t)(((x)>>56)&255); (y)[1] = (uint8_t)(((x)>>48)&255);     \
      (y)[2] = (uint8_t)(((x)>>40)&255); (y)[3] = (uint8_t)(((x)>>32)&255);     \
@@ -59,6 +67,159 @@ void
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetCurrentBlockIndex
+//
+//  Returns the index within the keystream of CurrentCipherBlock. IndexWithinCipherBlock can be AES_BLOCK_SIZE when a
+//  call ended exactly at the end of a block, so this is calculated back from the start of the block.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint64_t
+    GetCurrentBlockIndex
+    (
+        AesOfbContext const*    Context             // [in]
+    )
+{
+    return ( Context->StreamIndex - Context->IndexWithinCipherBlock ) / AES_BLOCK_SIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  RecordCheckpoint
+//
+//  Stores CurrentCipherBlock in the checkpoint table if recording is enabled, BlockIndex falls on a checkpoint, and
+//  there is room in the table.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    RecordCheckpoint
+    (
+        AesOfbContext*      Context,                // [in out]
+        uint64_t            BlockIndex              // [in]
+    )
+{
+    uint64_t    checkpointIndex;
+
+    if( NULL == Context->Checkpoints || 0 != (BlockIndex % Context->BlocksPerCheckpoint) )
+    {
+        return;
+    }
+
+    checkpointIndex = BlockIndex / Context->BlocksPerCheckpoint;
+    if( checkpointIndex < Context->MaxCheckpoints )
+    {
+        memcpy( Context->Checkpoints + (checkpointIndex * AES_OFB_CHECKPOINT_SIZE),
+            Context->CurrentCipherBlock, AES_OFB_CHECKPOINT_SIZE );
+        if( checkpointIndex >= Context->NumCheckpoints )
+        {
+            Context->NumCheckpoints = (uint32_t)checkpointIndex + 1;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GenerateNextCipherBlock
+//
+//  Advances CurrentCipherBlock to the next keystream block. *pBlockIndex is the index of CurrentCipherBlock and is
+//  incremented.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    GenerateNextCipherBlock
+    (
+        AesOfbContext*      Context,                // [in out]
+        uint64_t*           pBlockIndex             // [in out]
+    )
+{
+    AesEncryptInPlace( &Context->Aes, Context->CurrentCipherBlock );
+    *pBlockIndex += 1;
+    RecordCheckpoint( Context, *pBlockIndex );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  XorLanes
+//
+//  Performs AesOfbXor of Size bytes on NumLanes (up to MULTI_STREAM_LANES) streams. Each pass generates the next
+//  block of every stream that still needs one before XORing any of them, so the AES operations of different streams
+//  are back to back with no dependency on each other.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    XorLanes
+    (
+        AesOfbContext* const    Contexts [],        // [in out]
+        void const* const       InBuffers [],       // [in]
+        void* const             OutBuffers [],      // [out]
+        uint32_t                NumLanes,           // [in]
+        uint32_t                Size                // [in]
+    )
+{
+    uint32_t        amountLeft [MULTI_STREAM_LANES];
+    uint32_t        outputOffset [MULTI_STREAM_LANES];
+    uint32_t        chunkSize [MULTI_STREAM_LANES];
+    uint64_t        blockIndex [MULTI_STREAM_LANES];
+    uint32_t        amountAvailableInBlock;
+    uint32_t        lane;
+    bool            moreBlocks = false;
+    AesOfbContext*  context;
+
+    // Take what is left of each stream's current block.
+    for( lane=0; lane<NumLanes; lane++ )
+    {
+        context = Contexts[lane];
+        blockIndex[lane] = GetCurrentBlockIndex( context );
+        amountAvailableInBlock = AES_BLOCK_SIZE - context->IndexWithinCipherBlock;
+        chunkSize[lane] = MIN( amountAvailableInBlock, Size );
+        XorBuffers( InBuffers[lane], context->CurrentCipherBlock + (AES_BLOCK_SIZE - amountAvailableInBlock),
+            OutBuffers[lane], chunkSize[lane] );
+
+        amountLeft[lane] = Size - chunkSize[lane];
+        outputOffset[lane] = chunkSize[lane];
+        context->IndexWithinCipherBlock += chunkSize[lane];
+        if( amountLeft[lane] > 0 ) { moreBlocks = true; }
+    }
+
+    // Generate new cipher blocks for all the streams that need them, then XOR them out.
+    while( moreBlocks )
+    {
+        for( lane=0; lane<NumLanes; lane++ )
+        {
+            if( amountLeft[lane] > 0 )
+            {
+                GenerateNextCipherBlock( Contexts[lane], &blockIndex[lane] );
+            }
+        }
+
+        moreBlocks = false;
+        for( lane=0; lane<NumLanes; lane++ )
+        {
+            if( amountLeft[lane] > 0 )
+            {
+                context = Contexts[lane];
+                chunkSize[lane] = MIN( amountLeft[lane], AES_BLOCK_SIZE );
+                XorBuffers( (uint8_t const*)InBuffers[lane] + outputOffset[lane], context->CurrentCipherBlock,
+                    (uint8_t*)OutBuffers[lane] + outputOffset[lane], chunkSize[lane] );
+
+                amountLeft[lane] -= chunkSize[lane];
+                outputOffset[lane] += chunkSize[lane];
+                context->IndexWithinCipherBlock = chunkSize[lane];    // Note: Not incremented
+                if( amountLeft[lane] > 0 ) { moreBlocks = true; }
+            }
+        }
+    }
+
+    // As AesOfbXor, streams that completely used their last block get a new one for next time.
+    for( lane=0; lane<NumLanes; lane++ )
+    {
+        context = Contexts[lane];
+        if( AES_BLOCK_SIZE == chunkSize[lane] )
+        {
+            GenerateNextCipherBlock( context, &blockIndex[lane] );
+            context->IndexWithinCipherBlock = 0;
+        }
+        context->StreamIndex += Size;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -81,6 +242,11 @@ void
     Context->Aes = *InitialisedAesContext;
     memcpy( Context->CurrentCipherBlock, IV, sizeof(Context->CurrentCipherBlock) );
     Context->IndexWithinCipherBlock = 0;
+    Context->StreamIndex = 0;
+    Context->Checkpoints = NULL;
+    Context->MaxCheckpoints = 0;
+    Context->NumCheckpoints = 0;
+    Context->BlocksPerCheckpoint = 0;
 
     // Generate the first cipher block of the stream.
     AesEncryptInPlace( &Context->Aes, Context->CurrentCipherBlock );
@@ -137,6 +303,9 @@ void
     uint32_t    outputOffset = 0;
     uint32_t    chunkSize;
     uint32_t    amountAvailableInBlock;
+    uint64_t    blockIndex = GetCurrentBlockIndex( Context );
+
+    STATS_BEGIN( startCycles );
 
     // First determine how much is available in the current block.
     amountAvailableInBlock = AES_BLOCK_SIZE - Context->IndexWithinCipherBlock;
@@ -156,7 +325,7 @@ void
     while( amountLeft > 0 )
     {
         // Generate new cipher block
-        AesEncryptInPlace( &Context->Aes, Context->CurrentCipherBlock );
+        GenerateNextCipherBlock( Context, &blockIndex );
 
         // Determine how much of the current block we need and XOR it out onto the buffer
         chunkSize = MIN( amountLeft, AES_BLOCK_SIZE );
@@ -170,9 +339,12 @@ void
     // If we ended up completely reading the last cipher block we need to generate a new one for next time.
     if( AES_BLOCK_SIZE == chunkSize )
     {
-        AesEncryptInPlace( &Context->Aes, Context->CurrentCipherBlock );
+        GenerateNextCipherBlock( Context, &blockIndex );
         Context->IndexWithinCipherBlock = 0;
     }
+
+    Context->StreamIndex += Size;
+    STATS_END( STATS_AES_OFB, startCycles, Size );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -193,6 +365,45 @@ void
     AesOfbXor( Context, Buffer, Buffer, Size );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbXorMultiple
+//
+//  XORs Size bytes of each of NumStreams independent OFB streams onto its own buffer: stream i is Contexts[i] and is
+//  XORed from InBuffers[i] into OutBuffers[i]. Each stream advances by Size bytes and produces exactly what AesOfbXor
+//  would. Within one OFB stream every block depends on the previous one, so this advances up to eight streams in
+//  lock-step, generating one block of each in turn so that the independent AES operations overlap. When built with
+//  OpenMP separate groups of eight streams run on separate threads.
+//  The contexts may use different keys, but each must appear only once in Contexts.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    AesOfbXorMultiple
+    (
+        AesOfbContext* const    Contexts [],        // [in out]
+        void const* const       InBuffers [],       // [in]
+        void* const             OutBuffers [],      // [out]
+        uint32_t                NumStreams,         // [in]
+        uint32_t                Size                // [in]
+    )
+{
+    int     numGroups = (int)( (NumStreams + MULTI_STREAM_LANES - 1) / MULTI_STREAM_LANES );
+    int     group;
+
+    STATS_BEGIN( startCycles );
+
+    #ifdef _OPENMP
+        #pragma omp parallel for if( numGroups > 1 )
+    #endif
+    for( group=0; group<numGroups; group++ )
+    {
+        uint32_t first = (uint32_t)group * MULTI_STREAM_LANES;
+
+        XorLanes( Contexts + first, InBuffers + first, OutBuffers + first,
+            MIN( NumStreams - first, MULTI_STREAM_LANES ), Size );
+    }
+
+    STATS_END( STATS_AES_OFB, startCycles, (uint64_t)NumStreams * Size );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  AesOfbXorWithKey
 //
@@ -224,3 +435,171 @@ int
 
     return error;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbSetCheckpointRecording
+//
+//  Starts recording checkpoints into the caller provided table Checkpoints, which has room for MaxCheckpoints entries
+//  of AES_OFB_CHECKPOINT_SIZE bytes. Every keystream block whose index is a multiple of BlocksPerCheckpoint is stored
+//  as it is generated by AesOfbXor or AesOfbOutput, until the table is full. This should be called straight after
+//  AesOfbInitialise so that the table starts with checkpoint 0. Passing NULL for Checkpoints stops recording.
+//  Returns 0 if successful, or -1 if BlocksPerCheckpoint is 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesOfbSetCheckpointRecording
+    (
+        AesOfbContext*      Context,                // [in out]
+        uint32_t            BlocksPerCheckpoint,    // [in]
+        void*               Checkpoints,            // [out optional]
+        uint32_t            MaxCheckpoints          // [in]
+    )
+{
+    if( NULL != Checkpoints && 0 == BlocksPerCheckpoint )
+    {
+        return -1;
+    }
+
+    Context->Checkpoints = (uint8_t*)Checkpoints;
+    Context->MaxCheckpoints = ( NULL != Checkpoints ) ? MaxCheckpoints : 0;
+    Context->NumCheckpoints = 0;
+    Context->BlocksPerCheckpoint = BlocksPerCheckpoint;
+
+    // The current block has already been generated, so record it now if it is a checkpoint.
+    RecordCheckpoint( Context, GetCurrentBlockIndex( Context ) );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbGetNumCheckpoints
+//
+//  Returns the number of checkpoints that have been recorded into the table set with AesOfbSetCheckpointRecording.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    AesOfbGetNumCheckpoints
+    (
+        AesOfbContext const*    Context             // [in]
+    )
+{
+    return Context->NumCheckpoints;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbSetStreamIndexFromCheckpoints
+//
+//  Moves the stream to any position using a checkpoint table. The keystream is regenerated from the nearest
+//  checkpoint at or before the position (or from the current position if that is closer), so at most
+//  BlocksPerCheckpoint - 1 blocks are generated for positions covered by the table. Positions after the last
+//  checkpoint are reached by generating forward from it.
+//  Returns 0 if successful, or -1 if NumCheckpoints or BlocksPerCheckpoint is 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesOfbSetStreamIndexFromCheckpoints
+    (
+        AesOfbContext*      Context,                // [in out]
+        uint64_t            StreamIndex,            // [in]
+        void const*         Checkpoints,            // [in]
+        uint32_t            NumCheckpoints,         // [in]
+        uint32_t            BlocksPerCheckpoint     // [in]
+    )
+{
+    uint64_t    targetBlockIndex = StreamIndex / AES_BLOCK_SIZE;
+    uint64_t    checkpointIndex;
+    uint64_t    checkpointBlockIndex;
+    uint64_t    blockIndex = GetCurrentBlockIndex( Context );
+
+    if( 0 == NumCheckpoints || 0 == BlocksPerCheckpoint )
+    {
+        return -1;
+    }
+
+    checkpointIndex = MIN( targetBlockIndex / BlocksPerCheckpoint, (uint64_t)NumCheckpoints - 1 );
+    checkpointBlockIndex = checkpointIndex * BlocksPerCheckpoint;
+
+    // Start from the checkpoint unless the current block is between it and the target.
+    if( blockIndex < checkpointBlockIndex || blockIndex > targetBlockIndex )
+    {
+        memcpy( Context->CurrentCipherBlock,
+            (uint8_t const*)Checkpoints + (checkpointIndex * AES_OFB_CHECKPOINT_SIZE), AES_BLOCK_SIZE );
+        blockIndex = checkpointBlockIndex;
+    }
+
+    while( blockIndex < targetBlockIndex )
+    {
+        GenerateNextCipherBlock( Context, &blockIndex );
+    }
+
+    Context->StreamIndex = StreamIndex;
+    Context->IndexWithinCipherBlock = (uint32_t)( StreamIndex % AES_BLOCK_SIZE );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbXorFromCheckpoints
+//
+//  XORs Size bytes of the keystream starting at StreamIndex onto the buffer using a checkpoint table, without a
+//  context. The range is split at checkpoint boundaries and each piece is generated from its own checkpoint, so when
+//  built with OpenMP the pieces are processed in parallel.
+//  InBuffer and OutBuffer can point to the same location for in-place encrypting/decrypting
+//  Returns 0 if successful, or -1 if NumCheckpoints or BlocksPerCheckpoint is 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesOfbXorFromCheckpoints
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         Checkpoints,            // [in]
+        uint32_t            NumCheckpoints,         // [in]
+        uint32_t            BlocksPerCheckpoint,    // [in]
+        uint64_t            StreamIndex,            // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size                    // [in]
+    )
+{
+    uint64_t    segmentSize = (uint64_t)BlocksPerCheckpoint * AES_BLOCK_SIZE;
+    uint64_t    firstSegment;
+    uint64_t    lastSegment;
+    int         numSegments;
+    int         i;
+
+    if( 0 == NumCheckpoints || 0 == BlocksPerCheckpoint )
+    {
+        return -1;
+    }
+    if( 0 == Size )
+    {
+        return 0;
+    }
+
+    // Each segment starts at a checkpoint. Anything past the last checkpoint belongs to the final segment.
+    firstSegment = MIN( StreamIndex / segmentSize, (uint64_t)NumCheckpoints - 1 );
+    lastSegment = MIN( (StreamIndex + Size - 1) / segmentSize, (uint64_t)NumCheckpoints - 1 );
+    numSegments = (int)( lastSegment - firstSegment + 1 );
+
+    #ifdef _OPENMP
+        #pragma omp parallel for if( numSegments > 1 )
+    #endif
+    for( i=0; i<numSegments; i++ )
+    {
+        uint64_t        segment = firstSegment + i;
+        uint64_t        segmentStart = ( 0 == i ) ? StreamIndex : segment * segmentSize;
+        uint64_t        segmentEnd = ( numSegments - 1 == i ) ? StreamIndex + Size : (segment + 1) * segmentSize;
+        uint32_t        offset = (uint32_t)( segmentStart - StreamIndex );
+        AesOfbContext   context;
+
+        // A context positioned at the start of the stream using checkpoint 0, then moved to the segment start.
+        context.Aes = *InitialisedAesContext;
+        memcpy( context.CurrentCipherBlock, Checkpoints, AES_BLOCK_SIZE );
+        context.IndexWithinCipherBlock = 0;
+        context.StreamIndex = 0;
+        context.Checkpoints = NULL;
+        context.MaxCheckpoints = 0;
+        context.NumCheckpoints = 0;
+        context.BlocksPerCheckpoint = 0;
+
+        AesOfbSetStreamIndexFromCheckpoints( &context, segmentStart, Checkpoints, NumCheckpoints, BlocksPerCheckpoint );
+        AesOfbXor( &context, (uint8_t const*)InBuffer + offset, (uint8_t*)OutBuffer + offset,
+            (uint32_t)( segmentEnd - segmentStart ) );
+    }
+
+    return 0;
+}
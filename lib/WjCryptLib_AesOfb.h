@@ -6,6 +6,9 @@
 //  Depends on: CryptoLib_Aes
 //
 //  AES OFB is a stream cipher using the AES block cipher in output feedback mode.
+//  Each keystream block is the encryption of the previous one, so OFB can not normally seek or run in parallel. A
+//  checkpoint table (the keystream block at every Nth block) recorded while encrypting allows a later reader to start
+//  from the nearest checkpoint, and to split a large range across threads.
 //  This implementation works on both little and big endian architectures.
 //
 //  This is free and unencumbered software released into the public domain - January 2018 waterjuice.org
@@ -26,6 +29,13 @@
 
 #define AES_OFB_IV_SIZE             AES_BLOCK_SIZE
 
+// Each checkpoint is one keystream block. Checkpoint i is keystream block (i x BlocksPerCheckpoint), so a table of
+// NumCheckpoints takes NumCheckpoints x AES_OFB_CHECKPOINT_SIZE bytes.
+// Checkpoints ARE keystream: anyone holding a checkpoint and the ciphertext can recover that block of plaintext and,
+// with the key, all that follow. Store the table with the same protection as the key (for example wrapped with
+// AesKeyWrapPadded), not in the clear beside the ciphertext.
+#define AES_OFB_CHECKPOINT_SIZE     AES_BLOCK_SIZE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  TYPES
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -37,6 +47,11 @@ typedef struct
     AesContext      Aes;
     uint8_t         CurrentCipherBlock [AES_BLOCK_SIZE];
     uint32_t        IndexWithinCipherBlock;
+    uint64_t        StreamIndex;
+    uint8_t*        Checkpoints;
+    uint32_t        MaxCheckpoints;
+    uint32_t        NumCheckpoints;
+    uint32_t        BlocksPerCheckpoint;
 } AesOfbContext;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -105,6 +120,26 @@ void
         uint32_t            Size                    // [in]
     );
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbXorMultiple
+//
+//  XORs Size bytes of each of NumStreams independent OFB streams onto its own buffer: stream i is Contexts[i] and is
+//  XORed from InBuffers[i] into OutBuffers[i]. Each stream advances by Size bytes and produces exactly what AesOfbXor
+//  would. Within one OFB stream every block depends on the previous one, so this advances up to eight streams in
+//  lock-step, generating one block of each in turn so that the independent AES operations overlap. When built with
+//  OpenMP separate groups of eight streams run on separate threads.
+//  The contexts may use different keys, but each must appear only once in Contexts.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    AesOfbXorMultiple
+    (
+        AesOfbContext* const    Contexts [],        // [in out]
+        void const* const       InBuffers [],       // [in]
+        void* const             OutBuffers [],      // [out]
+        uint32_t                NumStreams,         // [in]
+        uint32_t                Size                // [in]
+    );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  AesOfbXorWithKey
 //
@@ -124,3 +159,73 @@ int
         void*               OutBuffer,              // [out]
         uint32_t            BufferSize              // [in]
     );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbSetCheckpointRecording
+//
+//  Starts recording checkpoints into the caller provided table Checkpoints, which has room for MaxCheckpoints entries
+//  of AES_OFB_CHECKPOINT_SIZE bytes. Every keystream block whose index is a multiple of BlocksPerCheckpoint is stored
+//  as it is generated by AesOfbXor or AesOfbOutput, until the table is full. This should be called straight after
+//  AesOfbInitialise so that the table starts with checkpoint 0. Passing NULL for Checkpoints stops recording.
+//  Returns 0 if successful, or -1 if BlocksPerCheckpoint is 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesOfbSetCheckpointRecording
+    (
+        AesOfbContext*      Context,                // [in out]
+        uint32_t            BlocksPerCheckpoint,    // [in]
+        void*               Checkpoints,            // [out optional]
+        uint32_t            MaxCheckpoints          // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbGetNumCheckpoints
+//
+//  Returns the number of checkpoints that have been recorded into the table set with AesOfbSetCheckpointRecording.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    AesOfbGetNumCheckpoints
+    (
+        AesOfbContext const*    Context             // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbSetStreamIndexFromCheckpoints
+//
+//  Moves the stream to any position using a checkpoint table. The keystream is regenerated from the nearest
+//  checkpoint at or before the position (or from the current position if that is closer), so at most
+//  BlocksPerCheckpoint - 1 blocks are generated for positions covered by the table. Positions after the last
+//  checkpoint are reached by generating forward from it.
+//  Returns 0 if successful, or -1 if NumCheckpoints or BlocksPerCheckpoint is 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesOfbSetStreamIndexFromCheckpoints
+    (
+        AesOfbContext*      Context,                // [in out]
+        uint64_t            StreamIndex,            // [in]
+        void const*         Checkpoints,            // [in]
+        uint32_t            NumCheckpoints,         // [in]
+        uint32_t            BlocksPerCheckpoint     // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesOfbXorFromCheckpoints
+//
+//  XORs Size bytes of the keystream starting at StreamIndex onto the buffer using a checkpoint table, without a
+//  context. The range is split at checkpoint boundaries and each piece is generated from its own checkpoint, so when
+//  built with OpenMP the pieces are processed in parallel.
+//  InBuffer and OutBuffer can point to the same location for in-place encrypting/decrypting
+//  Returns 0 if successful, or -1 if NumCheckpoints or BlocksPerCheckpoint is 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    AesOfbXorFromCheckpoints
+    (
+        AesContext const*   InitialisedAesContext,  // [in]
+        void const*         Checkpoints,            // [in]
+        uint32_t            NumCheckpoints,         // [in]
+        uint32_t            BlocksPerCheckpoint,    // [in]
+        uint64_t            StreamIndex,            // [in]
+        void const*         InBuffer,               // [in]
+        void*               OutBuffer,              // [out]
+        uint32_t            Size                    // [in]
+    );
@@ -0,0 +1,373 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_Cpu
+//
+//  Detection of the processor features used by the accelerated implementations of the other modules.
+//
+//  The detected and disabled features are each cached in a single word with a flag bit marking it as set, so threads
+//  that race through the first use all store the same value and never see one half set.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_Cpu.h"
+#include <stdlib.h>
+#include <string.h>
+
+// CPUID is only used on x86 with gcc or clang, which are also the only builds with accelerated implementations.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+    #define USE_CPUID
+    #include <cpuid.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Set in the cached words once they hold a value
+#define CACHED_FLAG                 0x80000000
+
+// Older cpuid.h do not define these (CPUID leaf 7, ECX)
+#ifndef bit_VAES
+    #define bit_VAES                ( 1 << 9 )
+#endif
+#ifndef bit_VPCLMULQDQ
+    #define bit_VPCLMULQDQ          ( 1 << 10 )
+#endif
+
+// XCR0 bits that must be set for the operating system to save the YMM registers, and the ZMM and mask registers
+#define XCR0_AVX                    0x06
+#define XCR0_AVX512                 0xe6
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+    uint32_t        Feature;
+    char const*     Name;
+} FeatureName;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static FeatureName const gFeatureNames [] =
+{
+    { CPU_FEATURE_SSE2,         "sse2" },
+    { CPU_FEATURE_SSSE3,        "ssse3" },
+    { CPU_FEATURE_SSE41,        "sse4.1" },
+    { CPU_FEATURE_AESNI,        "aesni" },
+    { CPU_FEATURE_PCLMUL,       "pclmul" },
+    { CPU_FEATURE_AVX,          "avx" },
+    { CPU_FEATURE_AVX2,         "avx2" },
+    { CPU_FEATURE_AVX512F,      "avx512f" },
+    { CPU_FEATURE_VAES,         "vaes" },
+    { CPU_FEATURE_VPCLMULQDQ,   "vpclmulqdq" },
+    { CPU_FEATURE_SHA,          "sha" },
+    { CPU_FEATURE_BMI2,         "bmi2" },
+};
+
+#define NUM_FEATURE_NAMES ( sizeof(gFeatureNames) / sizeof(gFeatureNames[0]) )
+
+static uint32_t     gDetectedFeatures = 0;
+static uint32_t     gDisabledFeatures = 0;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DetectFeatures
+//
+//  Returns the CPU_FEATURE_ flags the processor and operating system support.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    DetectFeatures
+    (
+        void
+    )
+{
+    uint32_t        features = 0;
+#ifdef USE_CPUID
+    unsigned int    eax;
+    unsigned int    ebx;
+    unsigned int    ecx;
+    unsigned int    edx;
+    unsigned int    leaf1Ecx;
+    unsigned int    xcr0 = 0;
+
+    if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+    {
+        return 0;
+    }
+    leaf1Ecx = ecx;
+
+    if( 0 != (edx & bit_SSE2) )      { features |= CPU_FEATURE_SSE2; }
+    if( 0 != (ecx & bit_SSSE3) )     { features |= CPU_FEATURE_SSSE3; }
+    if( 0 != (ecx & bit_SSE4_1) )    { features |= CPU_FEATURE_SSE41; }
+    if( 0 != (ecx & bit_AES) )       { features |= CPU_FEATURE_AESNI; }
+    if( 0 != (ecx & bit_PCLMUL) )    { features |= CPU_FEATURE_PCLMUL; }
+
+    // Anything using the YMM or ZMM registers also needs the operating system to save them
+    if( 0 != (leaf1Ecx & bit_OSXSAVE) )
+    {
+        __asm__( "xgetbv" : "=a"( xcr0 ), "=d"( edx ) : "c"( 0 ) );
+    }
+    if( 0 != (leaf1Ecx & bit_AVX) && XCR0_AVX == (xcr0 & XCR0_AVX) )
+    {
+        features |= CPU_FEATURE_AVX;
+    }
+
+    if( __get_cpuid_max( 0, NULL ) >= 7 )
+    {
+        __cpuid_count( 7, 0, eax, ebx, ecx, edx );
+        if( 0 != (ebx & bit_SHA) )   { features |= CPU_FEATURE_SHA; }
+        if( 0 != (ebx & bit_BMI2) )  { features |= CPU_FEATURE_BMI2; }
+        if( 0 != (features & CPU_FEATURE_AVX) )
+        {
+            if( 0 != (ebx & bit_AVX2) )          { features |= CPU_FEATURE_AVX2; }
+            if( 0 != (ecx & bit_VAES) )          { features |= CPU_FEATURE_VAES; }
+            if( 0 != (ecx & bit_VPCLMULQDQ) )    { features |= CPU_FEATURE_VPCLMULQDQ; }
+        }
+        if( 0 != (ebx & bit_AVX512F) && XCR0_AVX512 == (xcr0 & XCR0_AVX512) )
+        {
+            features |= CPU_FEATURE_AVX512F;
+        }
+    }
+#endif
+
+    return features;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ParseFeatureList
+//
+//  Returns the CPU_FEATURE_ flags named in a list separated by commas or spaces. "all" names every feature. Unknown
+//  names are ignored.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    ParseFeatureList
+    (
+        char const*         List            // [in]
+    )
+{
+    uint32_t        features = 0;
+    size_t          length;
+    uint32_t        i;
+
+    while( '\0' != *List )
+    {
+        length = strcspn( List, ", " );
+        if( 3 == length && 0 == strncmp( List, "all", 3 ) )
+        {
+            features |= CPU_FEATURE_ALL;
+        }
+        for( i=0; i<NUM_FEATURE_NAMES; i++ )
+        {
+            if( length == strlen( gFeatureNames[i].Name ) && 0 == strncmp( List, gFeatureNames[i].Name, length ) )
+            {
+                features |= gFeatureNames[i].Feature;
+            }
+        }
+
+        List += length;
+        if( '\0' != *List )
+        {
+            List += 1;
+        }
+    }
+
+    return features;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetFeatures
+//
+//  Returns the CPU_FEATURE_ flags that may be used: those the processor and operating system support, less any that
+//  have been disabled. AVX-512F is not reported without AVX2, as the AVX-512 code paths also use AVX2 instructions.
+//
+//  The other modules choose an implementation from these on first use and cache it in a single pointer, with no lock.
+//  Threads that race through the first use all compute the same pointer from the same features, and an aligned
+//  pointer is written in one store on every supported target, so a racing thread sees either NULL (and makes the
+//  choice itself) or the final value, never a torn one. Anything chosen along with it (eg the number of lanes) is
+//  reached through that pointer, in a constant table, rather than stored beside it where a racing thread could see
+//  one set and not the other.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    CpuGetFeatures
+    (
+        void
+    )
+{
+    uint32_t    features = CpuGetDetectedFeatures( ) & ~CpuGetDisabledFeatures( );
+
+    if( 0 == (features & CPU_FEATURE_AVX2) )
+    {
+        features &= ~CPU_FEATURE_AVX512F;
+    }
+
+    return features;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetDetectedFeatures
+//
+//  Returns the CPU_FEATURE_ flags the processor and operating system support, whether or not they are disabled.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    CpuGetDetectedFeatures
+    (
+        void
+    )
+{
+    uint32_t    detected = gDetectedFeatures;
+
+    if( 0 == detected )
+    {
+        detected = DetectFeatures( ) | CACHED_FLAG;
+        gDetectedFeatures = detected;
+    }
+
+    return detected & CPU_FEATURE_ALL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetDisabledFeatures
+//
+//  Returns the CPU_FEATURE_ flags that are disabled, by CpuSetDisabledFeatures or the environment.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    CpuGetDisabledFeatures
+    (
+        void
+    )
+{
+    uint32_t        disabled = gDisabledFeatures;
+    char const*     list;
+
+    if( 0 == disabled )
+    {
+        list = getenv( CPU_DISABLE_ENVIRONMENT_VARIABLE );
+        disabled = ( NULL != list ? ParseFeatureList( list ) : 0 ) | CACHED_FLAG;
+        gDisabledFeatures = disabled;
+    }
+
+    return disabled & CPU_FEATURE_ALL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuSetDisabledFeatures
+//
+//  Disables the CPU_FEATURE_ flags in Features, replacing the setting from the environment. CPU_FEATURE_ALL forces
+//  the portable implementations and 0 enables everything that was detected.
+//  Modules choose their implementation when first used, so call this before hashing or encrypting, or afterwards call
+//  the module's SetImplementation function with its AUTO value to choose again. This must not be called while another
+//  thread is using the library.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    CpuSetDisabledFeatures
+    (
+        uint32_t            Features        // [in]
+    )
+{
+    gDisabledFeatures = ( Features & CPU_FEATURE_ALL ) | CACHED_FLAG;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetFeatureName
+//
+//  Returns the name of a single CPU_FEATURE_ flag, or NULL if Feature is not one.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+char const*
+    CpuGetFeatureName
+    (
+        uint32_t            Feature         // [in]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<NUM_FEATURE_NAMES; i++ )
+    {
+        if( Feature == gFeatureNames[i].Feature )
+        {
+            return gFeatureNames[i].Name;
+        }
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetBrand
+//
+//  Gets the processor's brand string (eg "Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz") without leading spaces, or
+//  "unknown" where CPUID is not available. Used to tell machines apart, eg for performance baselines.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    CpuGetBrand
+    (
+        char                Brand [CPU_BRAND_SIZE]  // [out]
+    )
+{
+#ifdef USE_CPUID
+    unsigned int    registers [12];
+    char            text [CPU_BRAND_SIZE];
+    char const*     start = text;
+    uint32_t        i;
+
+    // Leaves 0x80000002 to 0x80000004 each return 16 characters of the brand string
+    if( __get_cpuid_max( 0x80000000, NULL ) >= 0x80000004 )
+    {
+        for( i=0; i<3; i++ )
+        {
+            __get_cpuid( 0x80000002 + i, &registers[i*4], &registers[i*4+1], &registers[i*4+2], &registers[i*4+3] );
+        }
+        memcpy( text, registers, sizeof(registers) );
+        text[CPU_BRAND_SIZE-1] = 0;
+        while( ' ' == *start )
+        {
+            start += 1;
+        }
+        if( '\0' != *start )
+        {
+            memcpy( Brand, start, strlen( start ) + 1 );
+            return;
+        }
+    }
+#endif
+
+    memcpy( Brand, "unknown", sizeof("unknown") );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetIsaLevel
+//
+//  Returns the highest CPU_ISA_ level whose features may all be used (see CpuGetFeatures). Selects which compiled copy
+//  of the portable code to run when the library is built with WJCRYPTLIB_ISA_VARIANTS.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    CpuGetIsaLevel
+    (
+        void
+    )
+{
+    uint32_t    features = CpuGetFeatures( );
+
+    if( (CPU_FEATURE_AVX2 | CPU_FEATURE_BMI2) != (features & (CPU_FEATURE_AVX2 | CPU_FEATURE_BMI2)) )
+    {
+        return CPU_ISA_BASELINE;
+    }
+
+    return ( 0 != (features & CPU_FEATURE_AVX512F) ) ? CPU_ISA_AVX512 : CPU_ISA_AVX2;
+}
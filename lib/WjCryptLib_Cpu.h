@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_Cpu
+//
+//  Detection of the processor features used by the accelerated implementations of the other modules.
+//
+//  The features are detected once, on first use, with CPUID and XGETBV (a feature that needs the wider registers is
+//  only reported if the operating system saves them). Each module then chooses its implementation from
+//  CpuGetFeatures the first time it needs one.
+//
+//  Features can be disabled to force the portable implementations, either with CpuSetDisabledFeatures or by setting
+//  the environment variable WJCRYPTLIB_CPU_DISABLE to a list of feature names (eg "avx512f,sha") or to "all". This
+//  allows accelerated and portable code to be compared, or a fault narrowed down to one feature, without a rebuild.
+//
+//  On processors other than x86, or compilers other than gcc and clang, no features are reported.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Processor features. Names (as used in WJCRYPTLIB_CPU_DISABLE) are given by CpuGetFeatureName.
+#define CPU_FEATURE_SSE2            0x00000001      // "sse2"
+#define CPU_FEATURE_SSSE3           0x00000002      // "ssse3"
+#define CPU_FEATURE_SSE41           0x00000004      // "sse4.1"
+#define CPU_FEATURE_AESNI           0x00000008      // "aesni"
+#define CPU_FEATURE_PCLMUL          0x00000010      // "pclmul"
+#define CPU_FEATURE_AVX             0x00000020      // "avx"
+#define CPU_FEATURE_AVX2            0x00000040      // "avx2"
+#define CPU_FEATURE_AVX512F         0x00000080      // "avx512f"
+#define CPU_FEATURE_VAES            0x00000100      // "vaes"
+#define CPU_FEATURE_VPCLMULQDQ      0x00000200      // "vpclmulqdq"
+#define CPU_FEATURE_SHA             0x00000400      // "sha"
+#define CPU_FEATURE_BMI2            0x00000800      // "bmi2"
+
+#define CPU_FEATURE_ALL             0x00000fff
+
+// Name of the environment variable read on first use
+#define CPU_DISABLE_ENVIRONMENT_VARIABLE    "WJCRYPTLIB_CPU_DISABLE"
+
+// Instruction set levels returned by CpuGetIsaLevel. Portable code built with WJCRYPTLIB_ISA_VARIANTS has a copy
+// compiled for each level.
+#define CPU_ISA_BASELINE            0
+#define CPU_ISA_AVX2                1       // AVX2 and BMI2
+#define CPU_ISA_AVX512              2       // AVX2, BMI2, and AVX-512F
+
+// Size of the buffer given to CpuGetBrand, including the terminating zero
+#define CPU_BRAND_SIZE              49
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetFeatures
+//
+//  Returns the CPU_FEATURE_ flags that may be used: those the processor and operating system support, less any that
+//  have been disabled. AVX-512F is not reported without AVX2, as the AVX-512 code paths also use AVX2 instructions.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    CpuGetFeatures
+    (
+        void
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetDetectedFeatures
+//
+//  Returns the CPU_FEATURE_ flags the processor and operating system support, whether or not they are disabled.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    CpuGetDetectedFeatures
+    (
+        void
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetDisabledFeatures
+//
+//  Returns the CPU_FEATURE_ flags that are disabled, by CpuSetDisabledFeatures or the environment.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    CpuGetDisabledFeatures
+    (
+        void
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuSetDisabledFeatures
+//
+//  Disables the CPU_FEATURE_ flags in Features, replacing the setting from the environment. CPU_FEATURE_ALL forces
+//  the portable implementations and 0 enables everything that was detected.
+//  Modules choose their implementation when first used, so call this before hashing or encrypting, or afterwards call
+//  the module's SetImplementation function with its AUTO value to choose again. This must not be called while another
+//  thread is using the library.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    CpuSetDisabledFeatures
+    (
+        uint32_t            Features        // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetFeatureName
+//
+//  Returns the name of a single CPU_FEATURE_ flag, or NULL if Feature is not one.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+char const*
+    CpuGetFeatureName
+    (
+        uint32_t            Feature         // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetBrand
+//
+//  Gets the processor's brand string (eg "Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz") without leading spaces, or
+//  "unknown" where CPUID is not available. Used to tell machines apart, eg for performance baselines.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    CpuGetBrand
+    (
+        char                Brand [CPU_BRAND_SIZE]  // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuGetIsaLevel
+//
+//  Returns the highest CPU_ISA_ level whose features may all be used (see CpuGetFeatures). Selects which compiled copy
+//  of the portable code to run when the library is built with WJCRYPTLIB_ISA_VARIANTS.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t
+    CpuGetIsaLevel
+    (
+        void
+    );
@@ -0,0 +1,465 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_Hkdf
+//
+//  Implementation of HKDF (RFC 5869), the HMAC based extract-and-expand key derivation function, using HMAC-SHA256
+//  or HMAC-SHA512.
+//
+//  Depends on: CryptoLib_Hmac, CryptoLib_Sha256, CryptoLib_Sha512
+//
+//  The context holds the PRK as an HMAC context, i.e. the hash states after the PRK XORed with ipad and with opad have
+//  been absorbed. Every expand and every output block starts from those states.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_Hkdf.h"
+#include "WjCryptLib_Hmac.h"
+#include <stdint.h>
+#include <memory.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256Extract
+//
+//  Performs the HKDF extract step: PRK = HMAC-SHA256( Salt, Ikm ), and initialises Context with it ready for
+//  HkdfSha256Expand. Salt is optional (NULL and 0 is the same as no salt).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha256Extract
+    (
+        HkdfSha256Context*  Context,                // [out]
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const*         Ikm,                    // [in]
+        uint32_t            IkmSize                 // [in]
+    )
+{
+    SHA256_HASH     prk;
+
+    // An absent salt is a block of zeros, which HMAC treats the same as an empty key
+    HmacSha256Calculate( Salt, SaltSize, Ikm, IkmSize, &prk );
+    HmacSha256Initialise( &Context->Prk, prk.bytes, sizeof(prk.bytes) );
+
+    memset( &prk, 0, sizeof(prk) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256InitialiseWithPrk
+//
+//  Initialises Context with an already extracted PRK, for when only the expand step of HKDF is used.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha256InitialiseWithPrk
+    (
+        HkdfSha256Context*  Context,                // [out]
+        void const*         Prk,                    // [in]
+        uint32_t            PrkSize                 // [in]
+    )
+{
+    HmacSha256Initialise( &Context->Prk, Prk, PrkSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256Expand
+//
+//  Performs the HKDF expand step, writing OkmSize bytes of output keying material derived from the PRK in Context
+//  and Info to Okm. The context is not modified, so it can be used for any number of expands.
+//  Returns 0 if successful, or -1 if OkmSize is larger than HKDF_SHA256_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha256Expand
+    (
+        HkdfSha256Context const*    Context,        // [in]
+        void const*                 Info,           // [in optional]
+        uint32_t                    InfoSize,       // [in]
+        void*                       Okm,            // [out]
+        uint32_t                    OkmSize         // [in]
+    )
+{
+    HmacSha256Context   hmac;
+    SHA256_HASH         block;
+    uint8_t             counter;
+    uint32_t            offset;
+    uint32_t            n;
+
+    if( OkmSize > HKDF_SHA256_MAX_OUTPUT_SIZE )
+    {
+        return -1;
+    }
+
+    // T(i) = HMAC( PRK, T(i-1) | Info | i ). Each block starts from the precomputed inner state in the context and
+    // Finalise resets to it, so the PRK key blocks are never hashed again.
+    hmac = Context->Prk;
+    counter = 1;
+    for( offset=0; offset<OkmSize; offset+=n )
+    {
+        if( offset > 0 )
+        {
+            HmacSha256Update( &hmac, block.bytes, sizeof(block.bytes) );
+        }
+        if( InfoSize > 0 )
+        {
+            HmacSha256Update( &hmac, Info, InfoSize );
+        }
+        HmacSha256Update( &hmac, &counter, 1 );
+        HmacSha256Finalise( &hmac, &block );
+
+        n = MIN( OkmSize - offset, SHA256_HASH_SIZE );
+        memcpy( (uint8_t*)Okm + offset, block.bytes, n );
+        counter += 1;
+    }
+
+    memset( &hmac, 0, sizeof(hmac) );
+    memset( &block, 0, sizeof(block) );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256
+//
+//  Combines HkdfSha256Extract and HkdfSha256Expand into one function.
+//  Returns 0 if successful, or -1 if OkmSize is larger than HKDF_SHA256_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha256
+    (
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const*         Ikm,                    // [in]
+        uint32_t            IkmSize,                // [in]
+        void const*         Info,                   // [in optional]
+        uint32_t            InfoSize,               // [in]
+        void*               Okm,                    // [out]
+        uint32_t            OkmSize                 // [in]
+    )
+{
+    HkdfSha256Context   context;
+    int                 result;
+
+    if( OkmSize > HKDF_SHA256_MAX_OUTPUT_SIZE )
+    {
+        return -1;
+    }
+
+    HkdfSha256Extract( &context, Salt, SaltSize, Ikm, IkmSize );
+    result = HkdfSha256Expand( &context, Info, InfoSize, Okm, OkmSize );
+
+    memset( &context, 0, sizeof(context) );
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256ExtractBatch
+//
+//  Performs HkdfSha256Extract for NumSessions sessions that share the same salt: Contexts[i] is initialised from
+//  IkmSizes[i] bytes of Ikms[i].
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha256ExtractBatch
+    (
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const* const   Ikms [],                // [in]
+        uint32_t const      IkmSizes [],            // [in]
+        uint32_t            NumSessions,            // [in]
+        HkdfSha256Context   Contexts []             // [out]
+    )
+{
+    HmacSha256Context   salt;
+    int                 i;
+
+    // The salt key is the same for every session, so its inner and outer states are only computed once
+    HmacSha256Initialise( &salt, Salt, SaltSize );
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( NumSessions > 1 )
+#endif
+    for( i=0; i<(int)NumSessions; i++ )
+    {
+        HmacSha256Context   hmac = salt;
+        SHA256_HASH         prk;
+
+        HmacSha256Update( &hmac, Ikms[i], IkmSizes[i] );
+        HmacSha256Finalise( &hmac, &prk );
+        HmacSha256Initialise( &Contexts[i].Prk, prk.bytes, sizeof(prk.bytes) );
+
+        memset( &hmac, 0, sizeof(hmac) );
+        memset( &prk, 0, sizeof(prk) );
+    }
+
+    memset( &salt, 0, sizeof(salt) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256ExpandBatch
+//
+//  Derives NumInfos keys of KeySize bytes for each of NumSessions sessions. Key j of session i is the same as
+//  HkdfSha256Expand( &Contexts[i], Infos[j], InfoSizes[j], ..., KeySize ). Keys receives the keys back to back,
+//  session by session: key j of session i is at offset ( i * NumInfos + j ) * KeySize.
+//  Returns 0 if successful, or -1 if KeySize is larger than HKDF_SHA256_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha256ExpandBatch
+    (
+        HkdfSha256Context const     Contexts [],    // [in]
+        uint32_t                    NumSessions,    // [in]
+        void const* const           Infos [],       // [in]
+        uint32_t const              InfoSizes [],   // [in]
+        uint32_t                    NumInfos,       // [in]
+        void*                       Keys,           // [out]
+        uint32_t                    KeySize         // [in]
+    )
+{
+    int     i;
+
+    if( KeySize > HKDF_SHA256_MAX_OUTPUT_SIZE )
+    {
+        return -1;
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( NumSessions > 1 )
+#endif
+    for( i=0; i<(int)NumSessions; i++ )
+    {
+        uint8_t*    sessionKeys = (uint8_t*)Keys + (size_t)i * NumInfos * KeySize;
+        uint32_t    j;
+
+        for( j=0; j<NumInfos; j++ )
+        {
+            HkdfSha256Expand( &Contexts[i], Infos[j], InfoSizes[j], sessionKeys + (size_t)j * KeySize, KeySize );
+        }
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512Extract
+//
+//  Performs the HKDF extract step: PRK = HMAC-SHA512( Salt, Ikm ), and initialises Context with it ready for
+//  HkdfSha512Expand. Salt is optional (NULL and 0 is the same as no salt).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha512Extract
+    (
+        HkdfSha512Context*  Context,                // [out]
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const*         Ikm,                    // [in]
+        uint32_t            IkmSize                 // [in]
+    )
+{
+    SHA512_HASH     prk;
+
+    // An absent salt is a block of zeros, which HMAC treats the same as an empty key
+    HmacSha512Calculate( Salt, SaltSize, Ikm, IkmSize, &prk );
+    HmacSha512Initialise( &Context->Prk, prk.bytes, sizeof(prk.bytes) );
+
+    memset( &prk, 0, sizeof(prk) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512InitialiseWithPrk
+//
+//  Initialises Context with an already extracted PRK, for when only the expand step of HKDF is used.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha512InitialiseWithPrk
+    (
+        HkdfSha512Context*  Context,                // [out]
+        void const*         Prk,                    // [in]
+        uint32_t            PrkSize                 // [in]
+    )
+{
+    HmacSha512Initialise( &Context->Prk, Prk, PrkSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512Expand
+//
+//  Performs the HKDF expand step, writing OkmSize bytes of output keying material derived from the PRK in Context
+//  and Info to Okm. The context is not modified, so it can be used for any number of expands.
+//  Returns 0 if successful, or -1 if OkmSize is larger than HKDF_SHA512_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha512Expand
+    (
+        HkdfSha512Context const*    Context,        // [in]
+        void const*                 Info,           // [in optional]
+        uint32_t                    InfoSize,       // [in]
+        void*                       Okm,            // [out]
+        uint32_t                    OkmSize         // [in]
+    )
+{
+    HmacSha512Context   hmac;
+    SHA512_HASH         block;
+    uint8_t             counter;
+    uint32_t            offset;
+    uint32_t            n;
+
+    if( OkmSize > HKDF_SHA512_MAX_OUTPUT_SIZE )
+    {
+        return -1;
+    }
+
+    // T(i) = HMAC( PRK, T(i-1) | Info | i ). Each block starts from the precomputed inner state in the context and
+    // Finalise resets to it, so the PRK key blocks are never hashed again.
+    hmac = Context->Prk;
+    counter = 1;
+    for( offset=0; offset<OkmSize; offset+=n )
+    {
+        if( offset > 0 )
+        {
+            HmacSha512Update( &hmac, block.bytes, sizeof(block.bytes) );
+        }
+        if( InfoSize > 0 )
+        {
+            HmacSha512Update( &hmac, Info, InfoSize );
+        }
+        HmacSha512Update( &hmac, &counter, 1 );
+        HmacSha512Finalise( &hmac, &block );
+
+        n = MIN( OkmSize - offset, SHA512_HASH_SIZE );
+        memcpy( (uint8_t*)Okm + offset, block.bytes, n );
+        counter += 1;
+    }
+
+    memset( &hmac, 0, sizeof(hmac) );
+    memset( &block, 0, sizeof(block) );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512
+//
+//  Combines HkdfSha512Extract and HkdfSha512Expand into one function.
+//  Returns 0 if successful, or -1 if OkmSize is larger than HKDF_SHA512_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha512
+    (
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const*         Ikm,                    // [in]
+        uint32_t            IkmSize,                // [in]
+        void const*         Info,                   // [in optional]
+        uint32_t            InfoSize,               // [in]
+        void*               Okm,                    // [out]
+        uint32_t            OkmSize                 // [in]
+    )
+{
+    HkdfSha512Context   context;
+    int                 result;
+
+    if( OkmSize > HKDF_SHA512_MAX_OUTPUT_SIZE )
+    {
+        return -1;
+    }
+
+    HkdfSha512Extract( &context, Salt, SaltSize, Ikm, IkmSize );
+    result = HkdfSha512Expand( &context, Info, InfoSize, Okm, OkmSize );
+
+    memset( &context, 0, sizeof(context) );
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512ExtractBatch
+//
+//  Performs HkdfSha512Extract for NumSessions sessions that share the same salt: Contexts[i] is initialised from
+//  IkmSizes[i] bytes of Ikms[i].
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha512ExtractBatch
+    (
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const* const   Ikms [],                // [in]
+        uint32_t const      IkmSizes [],            // [in]
+        uint32_t            NumSessions,            // [in]
+        HkdfSha512Context   Contexts []             // [out]
+    )
+{
+    HmacSha512Context   salt;
+    int                 i;
+
+    // The salt key is the same for every session, so its inner and outer states are only computed once
+    HmacSha512Initialise( &salt, Salt, SaltSize );
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( NumSessions > 1 )
+#endif
+    for( i=0; i<(int)NumSessions; i++ )
+    {
+        HmacSha512Context   hmac = salt;
+        SHA512_HASH         prk;
+
+        HmacSha512Update( &hmac, Ikms[i], IkmSizes[i] );
+        HmacSha512Finalise( &hmac, &prk );
+        HmacSha512Initialise( &Contexts[i].Prk, prk.bytes, sizeof(prk.bytes) );
+
+        memset( &hmac, 0, sizeof(hmac) );
+        memset( &prk, 0, sizeof(prk) );
+    }
+
+    memset( &salt, 0, sizeof(salt) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512ExpandBatch
+//
+//  Derives NumInfos keys of KeySize bytes for each of NumSessions sessions. Key j of session i is the same as
+//  HkdfSha512Expand( &Contexts[i], Infos[j], InfoSizes[j], ..., KeySize ). Keys receives the keys back to back,
+//  session by session: key j of session i is at offset ( i * NumInfos + j ) * KeySize.
+//  Returns 0 if successful, or -1 if KeySize is larger than HKDF_SHA512_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha512ExpandBatch
+    (
+        HkdfSha512Context const     Contexts [],    // [in]
+        uint32_t                    NumSessions,    // [in]
+        void const* const           Infos [],       // [in]
+        uint32_t const              InfoSizes [],   // [in]
+        uint32_t                    NumInfos,       // [in]
+        void*                       Keys,           // [out]
+        uint32_t                    KeySize         // [in]
+    )
+{
+    int     i;
+
+    if( KeySize > HKDF_SHA512_MAX_OUTPUT_SIZE )
+    {
+        return -1;
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( NumSessions > 1 )
+#endif
+    for( i=0; i<(int)NumSessions; i++ )
+    {
+        uint8_t*    sessionKeys = (uint8_t*)Keys + (size_t)i * NumInfos * KeySize;
+        uint32_t    j;
+
+        for( j=0; j<NumInfos; j++ )
+        {
+            HkdfSha512Expand( &Contexts[i], Infos[j], InfoSizes[j], sessionKeys + (size_t)j * KeySize, KeySize );
+        }
+    }
+
+    return 0;
+}
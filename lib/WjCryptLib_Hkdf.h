@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_Hkdf
+//
+//  Implementation of HKDF (RFC 5869), the HMAC based extract-and-expand key derivation function, using HMAC-SHA256
+//  or HMAC-SHA512.
+//
+//  Depends on: CryptoLib_Hmac, CryptoLib_Sha256, CryptoLib_Sha512
+//
+//  Extract turns input keying material into a pseudorandom key (PRK), which the context holds as the precomputed HMAC
+//  inner and outer states. Expand then derives any number of output keys from the context with different Info
+//  strings. Neither the PRK nor the padded key blocks are processed again, so each output block costs only the HMAC
+//  of its own input. The batch functions derive keys for many sessions at once, in parallel when built with OpenMP.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_Hmac.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Largest output a single expand can produce (RFC 5869 allows 255 hash blocks)
+#define HKDF_SHA256_MAX_OUTPUT_SIZE     ( 255 * SHA256_HASH_SIZE )
+#define HKDF_SHA512_MAX_OUTPUT_SIZE     ( 255 * SHA512_HASH_SIZE )
+
+// HkdfSha256Context - The PRK of one session. Initialise with HkdfSha256Extract or HkdfSha256InitialiseWithPrk.
+// Do not modify the contents of this structure directly.
+typedef struct
+{
+    HmacSha256Context   Prk;
+} HkdfSha256Context;
+
+// HkdfSha512Context - The PRK of one session. Initialise with HkdfSha512Extract or HkdfSha512InitialiseWithPrk.
+// Do not modify the contents of this structure directly.
+typedef struct
+{
+    HmacSha512Context   Prk;
+} HkdfSha512Context;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256Extract
+//
+//  Performs the HKDF extract step: PRK = HMAC-SHA256( Salt, Ikm ), and initialises Context with it ready for
+//  HkdfSha256Expand. Salt is optional (NULL and 0 is the same as no salt).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha256Extract
+    (
+        HkdfSha256Context*  Context,                // [out]
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const*         Ikm,                    // [in]
+        uint32_t            IkmSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256InitialiseWithPrk
+//
+//  Initialises Context with an already extracted PRK, for when only the expand step of HKDF is used.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha256InitialiseWithPrk
+    (
+        HkdfSha256Context*  Context,                // [out]
+        void const*         Prk,                    // [in]
+        uint32_t            PrkSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256Expand
+//
+//  Performs the HKDF expand step, writing OkmSize bytes of output keying material derived from the PRK in Context
+//  and Info to Okm. The context is not modified, so it can be used for any number of expands.
+//  Returns 0 if successful, or -1 if OkmSize is larger than HKDF_SHA256_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha256Expand
+    (
+        HkdfSha256Context const*    Context,        // [in]
+        void const*                 Info,           // [in optional]
+        uint32_t                    InfoSize,       // [in]
+        void*                       Okm,            // [out]
+        uint32_t                    OkmSize         // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256
+//
+//  Combines HkdfSha256Extract and HkdfSha256Expand into one function.
+//  Returns 0 if successful, or -1 if OkmSize is larger than HKDF_SHA256_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha256
+    (
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const*         Ikm,                    // [in]
+        uint32_t            IkmSize,                // [in]
+        void const*         Info,                   // [in optional]
+        uint32_t            InfoSize,               // [in]
+        void*               Okm,                    // [out]
+        uint32_t            OkmSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256ExtractBatch
+//
+//  Performs HkdfSha256Extract for NumSessions sessions that share the same salt: Contexts[i] is initialised from
+//  IkmSizes[i] bytes of Ikms[i].
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha256ExtractBatch
+    (
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const* const   Ikms [],                // [in]
+        uint32_t const      IkmSizes [],            // [in]
+        uint32_t            NumSessions,            // [in]
+        HkdfSha256Context   Contexts []             // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha256ExpandBatch
+//
+//  Derives NumInfos keys of KeySize bytes for each of NumSessions sessions. Key j of session i is the same as
+//  HkdfSha256Expand( &Contexts[i], Infos[j], InfoSizes[j], ..., KeySize ). Keys receives the keys back to back,
+//  session by session: key j of session i is at offset ( i * NumInfos + j ) * KeySize.
+//  Returns 0 if successful, or -1 if KeySize is larger than HKDF_SHA256_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha256ExpandBatch
+    (
+        HkdfSha256Context const     Contexts [],    // [in]
+        uint32_t                    NumSessions,    // [in]
+        void const* const           Infos [],       // [in]
+        uint32_t const              InfoSizes [],   // [in]
+        uint32_t                    NumInfos,       // [in]
+        void*                       Keys,           // [out]
+        uint32_t                    KeySize         // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512Extract
+//
+//  Performs the HKDF extract step: PRK = HMAC-SHA512( Salt, Ikm ), and initialises Context with it ready for
+//  HkdfSha512Expand. Salt is optional (NULL and 0 is the same as no salt).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha512Extract
+    (
+        HkdfSha512Context*  Context,                // [out]
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const*         Ikm,                    // [in]
+        uint32_t            IkmSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512InitialiseWithPrk
+//
+//  Initialises Context with an already extracted PRK, for when only the expand step of HKDF is used.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha512InitialiseWithPrk
+    (
+        HkdfSha512Context*  Context,                // [out]
+        void const*         Prk,                    // [in]
+        uint32_t            PrkSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512Expand
+//
+//  Performs the HKDF expand step, writing OkmSize bytes of output keying material derived from the PRK in Context
+//  and Info to Okm. The context is not modified, so it can be used for any number of expands.
+//  Returns 0 if successful, or -1 if OkmSize is larger than HKDF_SHA512_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha512Expand
+    (
+        HkdfSha512Context const*    Context,        // [in]
+        void const*                 Info,           // [in optional]
+        uint32_t                    InfoSize,       // [in]
+        void*                       Okm,            // [out]
+        uint32_t                    OkmSize         // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512
+//
+//  Combines HkdfSha512Extract and HkdfSha512Expand into one function.
+//  Returns 0 if successful, or -1 if OkmSize is larger than HKDF_SHA512_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha512
+    (
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const*         Ikm,                    // [in]
+        uint32_t            IkmSize,                // [in]
+        void const*         Info,                   // [in optional]
+        uint32_t            InfoSize,               // [in]
+        void*               Okm,                    // [out]
+        uint32_t            OkmSize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512ExtractBatch
+//
+//  Performs HkdfSha512Extract for NumSessions sessions that share the same salt: Contexts[i] is initialised from
+//  IkmSizes[i] bytes of Ikms[i].
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HkdfSha512ExtractBatch
+    (
+        void const*         Salt,                   // [in optional]
+        uint32_t            SaltSize,               // [in]
+        void const* const   Ikms [],                // [in]
+        uint32_t const      IkmSizes [],            // [in]
+        uint32_t            NumSessions,            // [in]
+        HkdfSha512Context   Contexts []             // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HkdfSha512ExpandBatch
+//
+//  Derives NumInfos keys of KeySize bytes for each of NumSessions sessions. Key j of session i is the same as
+//  HkdfSha512Expand( &Contexts[i], Infos[j], InfoSizes[j], ..., KeySize ). Keys receives the keys back to back,
+//  session by session: key j of session i is at offset ( i * NumInfos + j ) * KeySize.
+//  Returns 0 if successful, or -1 if KeySize is larger than HKDF_SHA512_MAX_OUTPUT_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HkdfSha512ExpandBatch
+    (
+        HkdfSha512Context const     Contexts [],    // [in]
+        uint32_t                    NumSessions,    // [in]
+        void const* const           Infos [],       // [in]
+        uint32_t const              InfoSizes [],   // [in]
+        uint32_t                    NumInfos,       // [in]
+        void*                       Keys,           // [out]
+        uint32_t                    KeySize         // [in]
+    );
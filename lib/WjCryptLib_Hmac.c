@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_Hmac
+//
+//  Implementation of HMAC (RFC 2104) using SHA256 or SHA512.
+//
+//  Depends on: CryptoLib_Sha256, CryptoLib_Sha512
+//
+//  The key is only processed when the context is initialised. The context keeps the hash states after the key XORed
+//  with ipad and with opad have been absorbed, and every Finalise restarts from them.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_Hmac.h"
+#include "WjCryptLib_Sha256.h"
+#include "WjCryptLib_Sha512.h"
+#include <stdint.h>
+#include <memory.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define SHA256_BLOCK_SIZE       64
+#define SHA512_BLOCK_SIZE       128
+
+#define IPAD                    0x36
+#define OPAD                    0x5c
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha256Initialise
+//
+//  Initialises an HmacSha256Context with a key of any size (keys longer than 64 bytes are hashed first, as RFC 2104
+//  requires). The context is then ready for HmacSha256Update.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha256Initialise
+    (
+        HmacSha256Context*  Context,                // [out]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize                 // [in]
+    )
+{
+    uint8_t         block [SHA256_BLOCK_SIZE];
+    SHA256_HASH     keyHash;
+    uint32_t        i;
+
+    memset( block, 0, sizeof(block) );
+    if( KeySize > SHA256_BLOCK_SIZE )
+    {
+        Sha256Calculate( Key, KeySize, &keyHash );
+        memcpy( block, keyHash.bytes, sizeof(keyHash.bytes) );
+    }
+    else if( KeySize > 0 )
+    {
+        memcpy( block, Key, KeySize );
+    }
+
+    for( i=0; i<SHA256_BLOCK_SIZE; i++ )
+    {
+        block[i] ^= IPAD;
+    }
+    Sha256Initialise( &Context->InnerStart );
+    Sha256Update( &Context->InnerStart, block, SHA256_BLOCK_SIZE );
+
+    for( i=0; i<SHA256_BLOCK_SIZE; i++ )
+    {
+        block[i] ^= IPAD ^ OPAD;
+    }
+    Sha256Initialise( &Context->OuterStart );
+    Sha256Update( &Context->OuterStart, block, SHA256_BLOCK_SIZE );
+
+    Context->Inner = Context->InnerStart;
+
+    memset( block, 0, sizeof(block) );
+    memset( &keyHash, 0, sizeof(keyHash) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha256Update
+//
+//  Adds data to the message being authenticated. Keep on calling this function until all the data has been added.
+//  Then call HmacSha256Finalise to calculate the MAC.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha256Update
+    (
+        HmacSha256Context*  Context,                // [in out]
+        void const*         Buffer,                 // [in]
+        uint32_t            BufferSize              // [in]
+    )
+{
+    Sha256Update( &Context->Inner, Buffer, BufferSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha256Finalise
+//
+//  Calculates the MAC of the message added with HmacSha256Update. The context is then reset to the start of a new
+//  message with the same key, so it can be reused without calling HmacSha256Initialise again.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha256Finalise
+    (
+        HmacSha256Context*  Context,                // [in out]
+        SHA256_HASH*        Mac                     // [out]
+    )
+{
+    SHA256_HASH     innerHash;
+    Sha256Context   outer;
+
+    Sha256Finalise( &Context->Inner, &innerHash );
+
+    outer = Context->OuterStart;
+    Sha256Update( &outer, innerHash.bytes, sizeof(innerHash.bytes) );
+    Sha256Finalise( &outer, Mac );
+
+    Context->Inner = Context->InnerStart;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha256Calculate
+//
+//  Combines HmacSha256Initialise, HmacSha256Update, and HmacSha256Finalise into one function.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha256Calculate
+    (
+        void const*         Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        void const*         Buffer,                 // [in]
+        uint32_t            BufferSize,             // [in]
+        SHA256_HASH*        Mac                     // [out]
+    )
+{
+    HmacSha256Context   context;
+
+    HmacSha256Initialise( &context, Key, KeySize );
+    HmacSha256Update( &context, Buffer, BufferSize );
+    HmacSha256Finalise( &context, Mac );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha512Initialise
+//
+//  Initialises an HmacSha512Context with a key of any size (keys longer than 128 bytes are hashed first, as RFC 2104
+//  requires). The context is then ready for HmacSha512Update.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha512Initialise
+    (
+        HmacSha512Context*  Context,                // [out]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize                 // [in]
+    )
+{
+    uint8_t         block [SHA512_BLOCK_SIZE];
+    SHA512_HASH     keyHash;
+    uint32_t        i;
+
+    memset( block, 0, sizeof(block) );
+    if( KeySize > SHA512_BLOCK_SIZE )
+    {
+        Sha512Calculate( Key, KeySize, &keyHash );
+        memcpy( block, keyHash.bytes, sizeof(keyHash.bytes) );
+    }
+    else if( KeySize > 0 )
+    {
+        memcpy( block, Key, KeySize );
+    }
+
+    for( i=0; i<SHA512_BLOCK_SIZE; i++ )
+    {
+        block[i] ^= IPAD;
+    }
+    Sha512Initialise( &Context->InnerStart );
+    Sha512Update( &Context->InnerStart, block, SHA512_BLOCK_SIZE );
+
+    for( i=0; i<SHA512_BLOCK_SIZE; i++ )
+    {
+        block[i] ^= IPAD ^ OPAD;
+    }
+    Sha512Initialise( &Context->OuterStart );
+    Sha512Update( &Context->OuterStart, block, SHA512_BLOCK_SIZE );
+
+    Context->Inner = Context->InnerStart;
+
+    memset( block, 0, sizeof(block) );
+    memset( &keyHash, 0, sizeof(keyHash) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha512Update
+//
+//  Adds data to the message being authenticated. Keep on calling this function until all the data has been added.
+//  Then call HmacSha512Finalise to calculate the MAC.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha512Update
+    (
+        HmacSha512Context*  Context,                // [in out]
+        void const*         Buffer,                 // [in]
+        uint32_t            BufferSize              // [in]
+    )
+{
+    Sha512Update( &Context->Inner, Buffer, BufferSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha512Finalise
+//
+//  Calculates the MAC of the message added with HmacSha512Update. The context is then reset to the start of a new
+//  message with the same key, so it can be reused without calling HmacSha512Initialise again.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha512Finalise
+    (
+        HmacSha512Context*  Context,                // [in out]
+        SHA512_HASH*        Mac                     // [out]
+    )
+{
+    SHA512_HASH     innerHash;
+    Sha512Context   outer;
+
+    Sha512Finalise( &Context->Inner, &innerHash );
+
+    outer = Context->OuterStart;
+    Sha512Update( &outer, innerHash.bytes, sizeof(innerHash.bytes) );
+    Sha512Finalise( &outer, Mac );
+
+    Context->Inner = Context->InnerStart;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha512Calculate
+//
+//  Combines HmacSha512Initialise, HmacSha512Update, and HmacSha512Finalise into one function.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha512Calculate
+    (
+        void const*         Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        void const*         Buffer,                 // [in]
+        uint32_t            BufferSize,             // [in]
+        SHA512_HASH*        Mac                     // [out]
+    )
+{
+    HmacSha512Context   context;
+
+    HmacSha512Initialise( &context, Key, KeySize );
+    HmacSha512Update( &context, Buffer, BufferSize );
+    HmacSha512Finalise( &context, Mac );
+}
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_Hmac
+//
+//  Implementation of HMAC (RFC 2104) using SHA256 or SHA512.
+//
+//  Depends on: CryptoLib_Sha256, CryptoLib_Sha512
+//
+//  The key is only processed when the context is initialised. The context keeps the hash states after the key XORed
+//  with ipad and with opad have been absorbed, and every Finalise restarts from them. Any number of messages can then
+//  be authenticated with the same key without processing the key again, which saves two compressions per message.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_Sha256.h"
+#include "WjCryptLib_Sha512.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// HmacSha256Context
+// Do not modify the contents of this structure directly.
+typedef struct
+{
+    Sha256Context       InnerStart;         // State after absorbing Key ^ ipad
+    Sha256Context       OuterStart;         // State after absorbing Key ^ opad
+    Sha256Context       Inner;              // Current message
+} HmacSha256Context;
+
+// HmacSha512Context
+// Do not modify the contents of this structure directly.
+typedef struct
+{
+    Sha512Context       InnerStart;         // State after absorbing Key ^ ipad
+    Sha512Context       OuterStart;         // State after absorbing Key ^ opad
+    Sha512Context       Inner;              // Current message
+} HmacSha512Context;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha256Initialise
+//
+//  Initialises an HmacSha256Context with a key of any size (keys longer than 64 bytes are hashed first, as RFC 2104
+//  requires). The context is then ready for HmacSha256Update.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha256Initialise
+    (
+        HmacSha256Context*  Context,                // [out]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha256Update
+//
+//  Adds data to the message being authenticated. Keep on calling this function until all the data has been added.
+//  Then call HmacSha256Finalise to calculate the MAC.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha256Update
+    (
+        HmacSha256Context*  Context,                // [in out]
+        void const*         Buffer,                 // [in]
+        uint32_t            BufferSize              // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha256Finalise
+//
+//  Calculates the MAC of the message added with HmacSha256Update. The context is then reset to the start of a new
+//  message with the same key, so it can be reused without calling HmacSha256Initialise again.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha256Finalise
+    (
+        HmacSha256Context*  Context,                // [in out]
+        SHA256_HASH*        Mac                     // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha256Calculate
+//
+//  Combines HmacSha256Initialise, HmacSha256Update, and HmacSha256Finalise into one function.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha256Calculate
+    (
+        void const*         Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        void const*         Buffer,                 // [in]
+        uint32_t            BufferSize,             // [in]
+        SHA256_HASH*        Mac                     // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha512Initialise
+//
+//  Initialises an HmacSha512Context with a key of any size (keys longer than 128 bytes are hashed first, as RFC 2104
+//  requires). The context is then ready for HmacSha512Update.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha512Initialise
+    (
+        HmacSha512Context*  Context,                // [out]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha512Update
+//
+//  Adds data to the message being authenticated. Keep on calling this function until all the data has been added.
+//  Then call HmacSha512Finalise to calculate the MAC.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha512Update
+    (
+        HmacSha512Context*  Context,                // [in out]
+        void const*         Buffer,                 // [in]
+        uint32_t            BufferSize              // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha512Finalise
+//
+//  Calculates the MAC of the message added with HmacSha512Update. The context is then reset to the start of a new
+//  message with the same key, so it can be reused without calling HmacSha512Initialise again.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha512Finalise
+    (
+        HmacSha512Context*  Context,                // [in out]
+        SHA512_HASH*        Mac                     // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacSha512Calculate
+//
+//  Combines HmacSha512Initialise, HmacSha512Update, and HmacSha512Finalise into one function.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacSha512Calculate
+    (
+        void const*         Key,                    // [in]
+        uint32_t            KeySize,                // [in]
+        void const*         Buffer,                 // [in]
+        uint32_t            BufferSize,             // [in]
+        SHA512_HASH*        Mac                     // [out]
+    );
@@ -0,0 +1,337 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_HmacDrbg
+//
+//  Implementation of HMAC_DRBG (NIST SP 800-90A) using HMAC-SHA256.
+//
+//  Depends on: CryptoLib_Hmac, CryptoLib_Sha256, CryptoLib_Sha512
+//
+//  The working state is the key K and the value V. K only changes in the update function, so it is held as an HMAC
+//  context that has already absorbed the padded key blocks, and the V = HMAC( K, V ) steps of a request all start
+//  from those states.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_HmacDrbg.h"
+#include "WjCryptLib_Hmac.h"
+#include <stdint.h>
+#include <memory.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DrbgUpdate
+//
+//  HMAC_DRBG_Update from SP 800-90A section 10.1.2.2, with the provided data being the concatenation of up to three
+//  inputs. K = HMAC( K, V || 0x00 || data ) and V = HMAC( K, V ), then if there is any data the same again with 0x01.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    DrbgUpdate
+    (
+        HmacDrbgContext*    Context,                // [in out]
+        void const*         Input1,                 // [in optional]
+        uint32_t            Input1Size,             // [in]
+        void const*         Input2,                 // [in optional]
+        uint32_t            Input2Size,             // [in]
+        void const*         Input3,                 // [in optional]
+        uint32_t            Input3Size              // [in]
+    )
+{
+    uint8_t         separator;
+    SHA256_HASH     key;
+
+    for( separator=0x00; separator<=0x01; separator++ )
+    {
+        if( 0x01 == separator && 0 == Input1Size + Input2Size + Input3Size )
+        {
+            break;
+        }
+
+        HmacSha256Update( &Context->Hmac, Context->V.bytes, sizeof(Context->V.bytes) );
+        HmacSha256Update( &Context->Hmac, &separator, 1 );
+        if( Input1Size > 0 ) { HmacSha256Update( &Context->Hmac, Input1, Input1Size ); }
+        if( Input2Size > 0 ) { HmacSha256Update( &Context->Hmac, Input2, Input2Size ); }
+        if( Input3Size > 0 ) { HmacSha256Update( &Context->Hmac, Input3, Input3Size ); }
+        HmacSha256Finalise( &Context->Hmac, &key );
+        HmacSha256Initialise( &Context->Hmac, key.bytes, sizeof(key.bytes) );
+
+        HmacSha256Update( &Context->Hmac, Context->V.bytes, sizeof(Context->V.bytes) );
+        HmacSha256Finalise( &Context->Hmac, &Context->V );
+    }
+
+    memset( &key, 0, sizeof(key) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DiscardOutputBuffer
+//
+//  Wipes any output in the output buffer that has not been handed out, and marks the buffer empty.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    DiscardOutputBuffer
+    (
+        HmacDrbgContext*    Context                 // [in out]
+    )
+{
+    if( NULL != Context->OutputBuffer )
+    {
+        memset( Context->OutputBuffer + Context->OutputBufferIndex, 0,
+            Context->OutputBufferSize - Context->OutputBufferIndex );
+        Context->OutputBufferIndex = Context->OutputBufferSize;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgInitialise
+//
+//  Instantiates an HMAC_DRBG from the entropy input, nonce, and personalisation string. Entropy must contain at least
+//  HMAC_DRBG_MIN_ENTROPY_SIZE bytes of full entropy. The nonce and personalisation string are optional. The context
+//  has no output buffer attached and a reseed interval of HMAC_DRBG_MAX_RESEED_INTERVAL.
+//  Returns 0 if successful, or -1 if EntropySize is too small
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgInitialise
+    (
+        HmacDrbgContext*    Context,                    // [out]
+        void const*         Entropy,                    // [in]
+        uint32_t            EntropySize,                // [in]
+        void const*         Nonce,                      // [in optional]
+        uint32_t            NonceSize,                  // [in]
+        void const*         Personalisation,            // [in optional]
+        uint32_t            PersonalisationSize         // [in]
+    )
+{
+    uint8_t const   zeroKey [SHA256_HASH_SIZE] = {0};
+
+    if( EntropySize < HMAC_DRBG_MIN_ENTROPY_SIZE )
+    {
+        return -1;
+    }
+
+    // K = 0x00 00 ... 00, V = 0x01 01 ... 01
+    memset( Context, 0, sizeof(*Context) );
+    Context->ReseedInterval = HMAC_DRBG_MAX_RESEED_INTERVAL;
+    HmacSha256Initialise( &Context->Hmac, zeroKey, sizeof(zeroKey) );
+    memset( Context->V.bytes, 0x01, sizeof(Context->V.bytes) );
+
+    DrbgUpdate( Context, Entropy, EntropySize, Nonce, NonceSize, Personalisation, PersonalisationSize );
+    Context->ReseedCounter = 1;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgReseed
+//
+//  Reseeds the DRBG with fresh entropy input (at least HMAC_DRBG_MIN_ENTROPY_SIZE bytes) and optional additional
+//  input, and resets the reseed counter. Any output waiting in the output buffer is discarded.
+//  Returns 0 if successful, or -1 if EntropySize is too small
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgReseed
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        void const*         Entropy,                    // [in]
+        uint32_t            EntropySize,                // [in]
+        void const*         AdditionalInput,            // [in optional]
+        uint32_t            AdditionalInputSize         // [in]
+    )
+{
+    if( EntropySize < HMAC_DRBG_MIN_ENTROPY_SIZE )
+    {
+        return -1;
+    }
+
+    DrbgUpdate( Context, Entropy, EntropySize, AdditionalInput, AdditionalInputSize, NULL, 0 );
+    Context->ReseedCounter = 1;
+    DiscardOutputBuffer( Context );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgSetReseedInterval
+//
+//  Sets the number of requests allowed before HmacDrbgGenerate requires a reseed. Interval must be between 1 and
+//  HMAC_DRBG_MAX_RESEED_INTERVAL.
+//  Returns 0 if successful, or -1 if Interval is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgSetReseedInterval
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        uint64_t            Interval                    // [in]
+    )
+{
+    if( 0 == Interval || Interval > HMAC_DRBG_MAX_RESEED_INTERVAL )
+    {
+        return -1;
+    }
+
+    Context->ReseedInterval = Interval;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgGenerate
+//
+//  Generates Size bytes of random output into Buffer as one HMAC_DRBG request, with optional additional input. The
+//  output buffer, if attached, is not used.
+//  Returns 0 if successful, or -1 if Size is larger than HMAC_DRBG_MAX_REQUEST_SIZE or the reseed interval has
+//  been reached, in which case HmacDrbgReseed must be called first.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgGenerate
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        void const*         AdditionalInput,            // [in optional]
+        uint32_t            AdditionalInputSize,        // [in]
+        void*               Buffer,                     // [out]
+        uint32_t            Size                        // [in]
+    )
+{
+    uint32_t    offset;
+    uint32_t    n;
+
+    if( Size > HMAC_DRBG_MAX_REQUEST_SIZE || Context->ReseedCounter > Context->ReseedInterval )
+    {
+        return -1;
+    }
+
+    if( AdditionalInputSize > 0 )
+    {
+        DrbgUpdate( Context, AdditionalInput, AdditionalInputSize, NULL, 0, NULL, 0 );
+    }
+
+    // Each block is V = HMAC( K, V ), starting from the keyed states held in the context
+    for( offset=0; offset<Size; offset+=n )
+    {
+        HmacSha256Update( &Context->Hmac, Context->V.bytes, sizeof(Context->V.bytes) );
+        HmacSha256Finalise( &Context->Hmac, &Context->V );
+        n = MIN( Size - offset, SHA256_HASH_SIZE );
+        memcpy( (uint8_t*)Buffer + offset, Context->V.bytes, n );
+    }
+
+    DrbgUpdate( Context, AdditionalInput, AdditionalInputSize, NULL, 0, NULL, 0 );
+    Context->ReseedCounter += 1;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgSetOutputBuffer
+//
+//  Attaches a caller provided buffer that HmacDrbgRandom fills with one large request and then serves small
+//  requests from. BufferSize must be between 1 and HMAC_DRBG_MAX_REQUEST_SIZE. The buffer must remain valid until
+//  it is detached by passing NULL, or the context is reinitialised. Bytes are wiped from the buffer as they are
+//  handed out, but output that has been generated and not yet handed out stays in memory, so it is not protected
+//  if the process memory is compromised before it is used.
+//  Returns 0 if successful, or -1 if BufferSize is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgSetOutputBuffer
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        void*               Buffer,                     // [in optional]
+        uint32_t            BufferSize                  // [in]
+    )
+{
+    if( NULL != Buffer && ( 0 == BufferSize || BufferSize > HMAC_DRBG_MAX_REQUEST_SIZE ) )
+    {
+        return -1;
+    }
+
+    DiscardOutputBuffer( Context );
+
+    Context->OutputBuffer = Buffer;
+    Context->OutputBufferSize = ( NULL != Buffer ) ? BufferSize : 0;
+    Context->OutputBufferIndex = Context->OutputBufferSize;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgRandom
+//
+//  Writes Size bytes of random output to Buffer. With an output buffer attached, bytes are taken from it and it is
+//  refilled with a single HmacDrbgGenerate request of the whole buffer size when empty; requests at least as large
+//  as the output buffer are generated directly into Buffer. Without one, this is HmacDrbgGenerate split into
+//  requests of at most HMAC_DRBG_MAX_REQUEST_SIZE bytes.
+//  Returns 0 if successful, or -1 if the reseed interval has been reached, in which case HmacDrbgReseed must be
+//  called and the output is incomplete.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgRandom
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        void*               Buffer,                     // [out]
+        uint32_t            Size                        // [in]
+    )
+{
+    uint8_t*    output = Buffer;
+    uint32_t    n;
+
+    while( Size > 0 )
+    {
+        if( Context->OutputBufferIndex == Context->OutputBufferSize )
+        {
+            if( Size >= Context->OutputBufferSize )
+            {
+                // Nothing buffered and at least a buffer's worth wanted, so skip the copy
+                n = MIN( Size, HMAC_DRBG_MAX_REQUEST_SIZE );
+                if( 0 != HmacDrbgGenerate( Context, NULL, 0, output, n ) )
+                {
+                    return -1;
+                }
+                output += n;
+                Size -= n;
+                continue;
+            }
+
+            if( 0 != HmacDrbgGenerate( Context, NULL, 0, Context->OutputBuffer, Context->OutputBufferSize ) )
+            {
+                return -1;
+            }
+            Context->OutputBufferIndex = 0;
+        }
+
+        n = MIN( Size, Context->OutputBufferSize - Context->OutputBufferIndex );
+        memcpy( output, Context->OutputBuffer + Context->OutputBufferIndex, n );
+        memset( Context->OutputBuffer + Context->OutputBufferIndex, 0, n );
+        Context->OutputBufferIndex += n;
+        output += n;
+        Size -= n;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgUninitialise
+//
+//  Wipes the DRBG state and any output waiting in the output buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacDrbgUninitialise
+    (
+        HmacDrbgContext*    Context                     // [in out]
+    )
+{
+    DiscardOutputBuffer( Context );
+    memset( Context, 0, sizeof(*Context) );
+}
@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_HmacDrbg
+//
+//  Implementation of HMAC_DRBG (NIST SP 800-90A) using HMAC-SHA256.
+//
+//  Depends on: CryptoLib_Hmac, CryptoLib_Sha256, CryptoLib_Sha512
+//
+//  HMAC_DRBG is a deterministic random bit generator: seeded with entropy supplied by the caller it produces a
+//  stream of random bytes, updating its key after every request so earlier output can not be recovered from the
+//  state. The key is held as an HMAC context, so each output block costs two SHA256 compressions. This module has
+//  no entropy source of its own; the caller supplies entropy when initialising and reseeding.
+//  A context is not internally locked. For many threads use one context per thread, each with its own output buffer
+//  (see HmacDrbgSetOutputBuffer), so small requests are served from the buffer without any locking.
+//  This implementation works on both little and big endian architectures.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_Hmac.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Largest single request to HmacDrbgGenerate (2^19 bits), and largest output buffer
+#define HMAC_DRBG_MAX_REQUEST_SIZE          65536
+
+// Largest number of requests allowed between reseeds (2^48), which is also the default
+#define HMAC_DRBG_MAX_RESEED_INTERVAL       ( (uint64_t)1 << 48 )
+
+// Smallest entropy input accepted, for the 256 bit security strength of HMAC-SHA256
+#define HMAC_DRBG_MIN_ENTROPY_SIZE          32
+
+// HmacDrbgContext
+// Do not modify the contents of this structure directly.
+typedef struct
+{
+    HmacSha256Context   Hmac;                   // Keyed with the current key
+    SHA256_HASH         V;
+    uint64_t            ReseedCounter;          // Number of the next request since the last (re)seed, from 1
+    uint64_t            ReseedInterval;
+    uint8_t*            OutputBuffer;
+    uint32_t            OutputBufferSize;
+    uint32_t            OutputBufferIndex;      // First byte not yet handed out
+} HmacDrbgContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgInitialise
+//
+//  Instantiates an HMAC_DRBG from the entropy input, nonce, and personalisation string. Entropy must contain at least
+//  HMAC_DRBG_MIN_ENTROPY_SIZE bytes of full entropy. The nonce and personalisation string are optional. The context
+//  has no output buffer attached and a reseed interval of HMAC_DRBG_MAX_RESEED_INTERVAL.
+//  Returns 0 if successful, or -1 if EntropySize is too small
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgInitialise
+    (
+        HmacDrbgContext*    Context,                    // [out]
+        void const*         Entropy,                    // [in]
+        uint32_t            EntropySize,                // [in]
+        void const*         Nonce,                      // [in optional]
+        uint32_t            NonceSize,                  // [in]
+        void const*         Personalisation,            // [in optional]
+        uint32_t            PersonalisationSize         // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgReseed
+//
+//  Reseeds the DRBG with fresh entropy input (at least HMAC_DRBG_MIN_ENTROPY_SIZE bytes) and optional additional
+//  input, and resets the reseed counter. Any output waiting in the output buffer is discarded.
+//  Returns 0 if successful, or -1 if EntropySize is too small
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgReseed
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        void const*         Entropy,                    // [in]
+        uint32_t            EntropySize,                // [in]
+        void const*         AdditionalInput,            // [in optional]
+        uint32_t            AdditionalInputSize         // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgSetReseedInterval
+//
+//  Sets the number of requests allowed before HmacDrbgGenerate requires a reseed. Interval must be between 1 and
+//  HMAC_DRBG_MAX_RESEED_INTERVAL.
+//  Returns 0 if successful, or -1 if Interval is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgSetReseedInterval
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        uint64_t            Interval                    // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgGenerate
+//
+//  Generates Size bytes of random output into Buffer as one HMAC_DRBG request, with optional additional input. The
+//  output buffer, if attached, is not used.
+//  Returns 0 if successful, or -1 if Size is larger than HMAC_DRBG_MAX_REQUEST_SIZE or the reseed interval has
+//  been reached, in which case HmacDrbgReseed must be called first.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgGenerate
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        void const*         AdditionalInput,            // [in optional]
+        uint32_t            AdditionalInputSize,        // [in]
+        void*               Buffer,                     // [out]
+        uint32_t            Size                        // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgSetOutputBuffer
+//
+//  Attaches a caller provided buffer that HmacDrbgRandom fills with one large request and then serves small
+//  requests from. BufferSize must be between 1 and HMAC_DRBG_MAX_REQUEST_SIZE. The buffer must remain valid until
+//  it is detached by passing NULL, or the context is reinitialised. Bytes are wiped from the buffer as they are
+//  handed out, but output that has been generated and not yet handed out stays in memory, so it is not protected
+//  if the process memory is compromised before it is used.
+//  Returns 0 if successful, or -1 if BufferSize is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgSetOutputBuffer
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        void*               Buffer,                     // [in optional]
+        uint32_t            BufferSize                  // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgRandom
+//
+//  Writes Size bytes of random output to Buffer. With an output buffer attached, bytes are taken from it and it is
+//  refilled with a single HmacDrbgGenerate request of the whole buffer size when empty; requests at least as large
+//  as the output buffer are generated directly into Buffer. Without one, this is HmacDrbgGenerate split into
+//  requests of at most HMAC_DRBG_MAX_REQUEST_SIZE bytes.
+//  Returns 0 if successful, or -1 if the reseed interval has been reached, in which case HmacDrbgReseed must be
+//  called and the output is incomplete.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    HmacDrbgRandom
+    (
+        HmacDrbgContext*    Context,                    // [in out]
+        void*               Buffer,                     // [out]
+        uint32_t            Size                        // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HmacDrbgUninitialise
+//
+//  Wipes the DRBG state and any output waiting in the output buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    HmacDrbgUninitialise
+    (
+        HmacDrbgContext*    Context                     // [in out]
+    );
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_IsaVariants
+//
+//  Internal to the library. When built with the CMake option WJCRYPTLIB_ISA_VARIANTS the portable block transforms of
+//  SHA1 and SHA256 are compiled again for each of the higher CPU_ISA_ levels, where the compiler can use the BMI2
+//  rotates and shifts, and the modules run the copy for the level CpuGetIsaLevel returns. This names those copies.
+//
+//  The copies are built by compiling the module's own source file with WJCRYPTLIB_ISA_VARIANT set to the level's
+//  suffix (Avx2 or Avx512), which builds only the transform, under a name ending in that suffix.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "WjCryptLib_Sha256.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define ISA_VARIANT_CONCAT2( Name, Suffix )     Name##Suffix
+#define ISA_VARIANT_CONCAT( Name, Suffix )      ISA_VARIANT_CONCAT2( Name, Suffix )
+
+// Name of a function in the variant being compiled, eg ISA_VARIANT_NAME( Sha256Transform ) is Sha256TransformAvx2
+#ifdef WJCRYPTLIB_ISA_VARIANT
+    #define ISA_VARIANT_NAME( Name )            ISA_VARIANT_CONCAT( Name, WJCRYPTLIB_ISA_VARIANT )
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// WjCryptLib_Sha1.c: TransformBlocksPortable
+void Sha1TransformBlocksAvx2( uint32_t State [5], uint8_t const* Buffer, uint32_t NumBlocks );
+void Sha1TransformBlocksAvx512( uint32_t State [5], uint8_t const* Buffer, uint32_t NumBlocks );
+
+// WjCryptLib_Sha256.c: TransformFunction
+void Sha256TransformAvx2( Sha256Context* Context, uint8_t const* Buffer, uint32_t NumBlocks );
+void Sha256TransformAvx512( Sha256Context* Context, uint8_t const* Buffer, uint32_t NumBlocks );
@@ -4,6 +4,8 @@
 //  Implementation of MD5 hash function. Originally written by Alexander Peslyak. Modified by WaterJuice retaining
 //  Public Domain license.
 //
+//  Depends on: CryptoLib_Cpu
+//
 //  This is free and unencumbered software released into the public domain - June 2013 waterjuice.org
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -12,8 +14,49 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_Md5.h"
+#include "WjCryptLib_Stats.h"
+#include "WjCryptLib_Cpu.h"
+#include <stdbool.h>
 #include <memory.h>
 
+// The SIMD multi-buffer transforms are only built for x86 with gcc or clang, which allow individual functions to be
+// compiled for SSE2, AVX2, and AVX-512 while the rest of the file targets the baseline instruction set.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+    #define USE_SIMD_MD5_MULTIPLE
+    #include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The most lanes (independent messages) any multi-buffer transform processes at once
+#define MULTIPLE_MAX_LANES      16
+
+// Performs one MD5 block on each of the lanes. State holds a, b, c, d for each lane and Words holds the 16 message
+// words of each lane's block, transposed so that each row is one word across all the lanes.
+typedef void (*TransformLanesFunc)(
+    uint32_t State [4][MULTIPLE_MAX_LANES], uint32_t const Words [16][MULTIPLE_MAX_LANES] );
+
+typedef struct
+{
+    uint32_t                NumLanes;
+    TransformLanesFunc      TransformLanes;         // NULL to use Md5Calculate on each buffer
+    char const*             Name;
+} MultipleImplementation;
+
+// Progress of one message within a multi-buffer calculation
+typedef struct
+{
+    bool                Active;
+    uint32_t            BufferIndex;
+    uint8_t const*      Data;                   // Next whole block of the caller's buffer
+    uint32_t            WholeBlocksLeft;
+    uint32_t            TailBlocksLeft;
+    uint32_t            TailIndex;
+    uint8_t             Tail [128];             // Last partial block with padding and length (1 or 2 blocks)
+} MultipleLane;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  INTERNAL FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -63,9 +106,12 @@ void*
     uint32_t     saved_b;
     uint32_t     saved_c;
     uint32_t     saved_d;
+    uint32_t     block[16];
 
-    #define GET(n) (ctx->block[(n)])
-    #define SET(n) (ctx->block[(n)] =             \
+    // The message words are decoded into a local array rather than the context so that the compiler can keep them in
+    // registers or on the stack without having to assume they alias the context.
+    #define GET(n) (block[(n)])
+    #define SET(n) (block[(n)] =                  \
             ((uint32_t)ptr[(n)*4 + 0] << 0 )      \
         |   ((uint32_t)ptr[(n)*4 + 1] << 8 )      \
         |   ((uint32_t)ptr[(n)*4 + 2] << 16)      \
@@ -176,6 +222,363 @@ void*
     return ptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MULTIPLE_STEPS
+//
+//  All 64 steps of MD5 for the multi-buffer transforms. S is invoked as S( f, a, b, c, d, k, t, s ) where k is the
+//  index of the message word.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#define MULTIPLE_STEPS( S )                                                                                     \
+    S( F, a, b, c, d,  0, 0xd76aa478,  7 ) S( F, d, a, b, c,  1, 0xe8c7b756, 12 )                               \
+    S( F, c, d, a, b,  2, 0x242070db, 17 ) S( F, b, c, d, a,  3, 0xc1bdceee, 22 )                               \
+    S( F, a, b, c, d,  4, 0xf57c0faf,  7 ) S( F, d, a, b, c,  5, 0x4787c62a, 12 )                               \
+    S( F, c, d, a, b,  6, 0xa8304613, 17 ) S( F, b, c, d, a,  7, 0xfd469501, 22 )                               \
+    S( F, a, b, c, d,  8, 0x698098d8,  7 ) S( F, d, a, b, c,  9, 0x8b44f7af, 12 )                               \
+    S( F, c, d, a, b, 10, 0xffff5bb1, 17 ) S( F, b, c, d, a, 11, 0x895cd7be, 22 )                               \
+    S( F, a, b, c, d, 12, 0x6b901122,  7 ) S( F, d, a, b, c, 13, 0xfd987193, 12 )                               \
+    S( F, c, d, a, b, 14, 0xa679438e, 17 ) S( F, b, c, d, a, 15, 0x49b40821, 22 )                               \
+    S( G, a, b, c, d,  1, 0xf61e2562,  5 ) S( G, d, a, b, c,  6, 0xc040b340,  9 )                               \
+    S( G, c, d, a, b, 11, 0x265e5a51, 14 ) S( G, b, c, d, a,  0, 0xe9b6c7aa, 20 )                               \
+    S( G, a, b, c, d,  5, 0xd62f105d,  5 ) S( G, d, a, b, c, 10, 0x02441453,  9 )                               \
+    S( G, c, d, a, b, 15, 0xd8a1e681, 14 ) S( G, b, c, d, a,  4, 0xe7d3fbc8, 20 )                               \
+    S( G, a, b, c, d,  9, 0x21e1cde6,  5 ) S( G, d, a, b, c, 14, 0xc33707d6,  9 )                               \
+    S( G, c, d, a, b,  3, 0xf4d50d87, 14 ) S( G, b, c, d, a,  8, 0x455a14ed, 20 )                               \
+    S( G, a, b, c, d, 13, 0xa9e3e905,  5 ) S( G, d, a, b, c,  2, 0xfcefa3f8,  9 )                               \
+    S( G, c, d, a, b,  7, 0x676f02d9, 14 ) S( G, b, c, d, a, 12, 0x8d2a4c8a, 20 )                               \
+    S( H, a, b, c, d,  5, 0xfffa3942,  4 ) S( H, d, a, b, c,  8, 0x8771f681, 11 )                               \
+    S( H, c, d, a, b, 11, 0x6d9d6122, 16 ) S( H, b, c, d, a, 14, 0xfde5380c, 23 )                               \
+    S( H, a, b, c, d,  1, 0xa4beea44,  4 ) S( H, d, a, b, c,  4, 0x4bdecfa9, 11 )                               \
+    S( H, c, d, a, b,  7, 0xf6bb4b60, 16 ) S( H, b, c, d, a, 10, 0xbebfbc70, 23 )                               \
+    S( H, a, b, c, d, 13, 0x289b7ec6,  4 ) S( H, d, a, b, c,  0, 0xeaa127fa, 11 )                               \
+    S( H, c, d, a, b,  3, 0xd4ef3085, 16 ) S( H, b, c, d, a,  6, 0x04881d05, 23 )                               \
+    S( H, a, b, c, d,  9, 0xd9d4d039,  4 ) S( H, d, a, b, c, 12, 0xe6db99e5, 11 )                               \
+    S( H, c, d, a, b, 15, 0x1fa27cf8, 16 ) S( H, b, c, d, a,  2, 0xc4ac5665, 23 )                               \
+    S( I, a, b, c, d,  0, 0xf4292244,  6 ) S( I, d, a, b, c,  7, 0x432aff97, 10 )                               \
+    S( I, c, d, a, b, 14, 0xab9423a7, 15 ) S( I, b, c, d, a,  5, 0xfc93a039, 21 )                               \
+    S( I, a, b, c, d, 12, 0x655b59c3,  6 ) S( I, d, a, b, c,  3, 0x8f0ccc92, 10 )                               \
+    S( I, c, d, a, b, 10, 0xffeff47d, 15 ) S( I, b, c, d, a,  1, 0x85845dd1, 21 )                               \
+    S( I, a, b, c, d,  8, 0x6fa87e4f,  6 ) S( I, d, a, b, c, 15, 0xfe2ce6e0, 10 )                               \
+    S( I, c, d, a, b,  6, 0xa3014314, 15 ) S( I, b, c, d, a, 13, 0x4e0811a1, 21 )                               \
+    S( I, a, b, c, d,  4, 0xf7537e82,  6 ) S( I, d, a, b, c, 11, 0xbd3af235, 10 )                               \
+    S( I, c, d, a, b,  2, 0x2ad7d2bb, 15 ) S( I, b, c, d, a,  9, 0xeb86d391, 21 )
+
+#ifdef USE_SIMD_MD5_MULTIPLE
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - SIMD multi-buffer transforms
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// SSE2, 4 lanes
+#define SSE2_F( x, y, z )   _mm_xor_si128( z, _mm_and_si128( x, _mm_xor_si128( y, z ) ) )
+#define SSE2_G( x, y, z )   _mm_xor_si128( y, _mm_and_si128( z, _mm_xor_si128( x, y ) ) )
+#define SSE2_H( x, y, z )   _mm_xor_si128( _mm_xor_si128( x, y ), z )
+#define SSE2_I( x, y, z )   _mm_xor_si128( y, _mm_or_si128( x, _mm_xor_si128( z, allOnes ) ) )
+#define SSE2_STEP( f, a, b, c, d, k, t, s )                                                             \
+    a = _mm_add_epi32( a, _mm_add_epi32( SSE2_##f( b, c, d ),                                           \
+            _mm_add_epi32( _mm_loadu_si128( (__m128i const*)Words[k] ), _mm_set1_epi32( (int)t ) ) ) ); \
+    a = _mm_or_si128( _mm_slli_epi32( a, s ), _mm_srli_epi32( a, 32 - s ) );                            \
+    a = _mm_add_epi32( a, b );
+
+__attribute__(( target( "sse2" ) ))
+static
+void
+    TransformLanesSse2
+    (
+        uint32_t            State [4][MULTIPLE_MAX_LANES],          // [in out]
+        uint32_t const      Words [16][MULTIPLE_MAX_LANES]          // [in]
+    )
+{
+    __m128i const   allOnes = _mm_set1_epi32( -1 );
+    __m128i         a = _mm_loadu_si128( (__m128i const*)State[0] );
+    __m128i         b = _mm_loadu_si128( (__m128i const*)State[1] );
+    __m128i         c = _mm_loadu_si128( (__m128i const*)State[2] );
+    __m128i         d = _mm_loadu_si128( (__m128i const*)State[3] );
+
+    MULTIPLE_STEPS( SSE2_STEP )
+
+    _mm_storeu_si128( (__m128i*)State[0], _mm_add_epi32( a, _mm_loadu_si128( (__m128i const*)State[0] ) ) );
+    _mm_storeu_si128( (__m128i*)State[1], _mm_add_epi32( b, _mm_loadu_si128( (__m128i const*)State[1] ) ) );
+    _mm_storeu_si128( (__m128i*)State[2], _mm_add_epi32( c, _mm_loadu_si128( (__m128i const*)State[2] ) ) );
+    _mm_storeu_si128( (__m128i*)State[3], _mm_add_epi32( d, _mm_loadu_si128( (__m128i const*)State[3] ) ) );
+}
+
+// AVX2, 8 lanes
+#define AVX2_F( x, y, z )   _mm256_xor_si256( z, _mm256_and_si256( x, _mm256_xor_si256( y, z ) ) )
+#define AVX2_G( x, y, z )   _mm256_xor_si256( y, _mm256_and_si256( z, _mm256_xor_si256( x, y ) ) )
+#define AVX2_H( x, y, z )   _mm256_xor_si256( _mm256_xor_si256( x, y ), z )
+#define AVX2_I( x, y, z )   _mm256_xor_si256( y, _mm256_or_si256( x, _mm256_xor_si256( z, allOnes ) ) )
+#define AVX2_STEP( f, a, b, c, d, k, t, s )                                                                         \
+    a = _mm256_add_epi32( a, _mm256_add_epi32( AVX2_##f( b, c, d ),                                                 \
+            _mm256_add_epi32( _mm256_loadu_si256( (__m256i const*)Words[k] ), _mm256_set1_epi32( (int)t ) ) ) );    \
+    a = _mm256_or_si256( _mm256_slli_epi32( a, s ), _mm256_srli_epi32( a, 32 - s ) );                               \
+    a = _mm256_add_epi32( a, b );
+
+__attribute__(( target( "avx2" ) ))
+static
+void
+    TransformLanesAvx2
+    (
+        uint32_t            State [4][MULTIPLE_MAX_LANES],          // [in out]
+        uint32_t const      Words [16][MULTIPLE_MAX_LANES]          // [in]
+    )
+{
+    __m256i const   allOnes = _mm256_set1_epi32( -1 );
+    __m256i         a = _mm256_loadu_si256( (__m256i const*)State[0] );
+    __m256i         b = _mm256_loadu_si256( (__m256i const*)State[1] );
+    __m256i         c = _mm256_loadu_si256( (__m256i const*)State[2] );
+    __m256i         d = _mm256_loadu_si256( (__m256i const*)State[3] );
+
+    MULTIPLE_STEPS( AVX2_STEP )
+
+    _mm256_storeu_si256( (__m256i*)State[0], _mm256_add_epi32( a, _mm256_loadu_si256( (__m256i const*)State[0] ) ) );
+    _mm256_storeu_si256( (__m256i*)State[1], _mm256_add_epi32( b, _mm256_loadu_si256( (__m256i const*)State[1] ) ) );
+    _mm256_storeu_si256( (__m256i*)State[2], _mm256_add_epi32( c, _mm256_loadu_si256( (__m256i const*)State[2] ) ) );
+    _mm256_storeu_si256( (__m256i*)State[3], _mm256_add_epi32( d, _mm256_loadu_si256( (__m256i const*)State[3] ) ) );
+}
+
+// AVX-512, 16 lanes. Each of F, G, H, and I is a single ternary logic instruction and rotates are native.
+#define AVX512_F( x, y, z )     _mm512_ternarylogic_epi32( x, y, z, 0xca )
+#define AVX512_G( x, y, z )     _mm512_ternarylogic_epi32( x, y, z, 0xe4 )
+#define AVX512_H( x, y, z )     _mm512_ternarylogic_epi32( x, y, z, 0x96 )
+#define AVX512_I( x, y, z )     _mm512_ternarylogic_epi32( x, y, z, 0x39 )
+#define AVX512_STEP( f, a, b, c, d, k, t, s )                                                                       \
+    a = _mm512_add_epi32( a, _mm512_add_epi32( AVX512_##f( b, c, d ),                                               \
+            _mm512_add_epi32( _mm512_loadu_si512( (void const*)Words[k] ), _mm512_set1_epi32( (int)t ) ) ) );       \
+    a = _mm512_add_epi32( _mm512_rol_epi32( a, s ), b );
+
+__attribute__(( target( "avx512f" ) ))
+static
+void
+    TransformLanesAvx512
+    (
+        uint32_t            State [4][MULTIPLE_MAX_LANES],          // [in out]
+        uint32_t const      Words [16][MULTIPLE_MAX_LANES]          // [in]
+    )
+{
+    __m512i     a = _mm512_loadu_si512( (void const*)State[0] );
+    __m512i     b = _mm512_loadu_si512( (void const*)State[1] );
+    __m512i     c = _mm512_loadu_si512( (void const*)State[2] );
+    __m512i     d = _mm512_loadu_si512( (void const*)State[3] );
+
+    MULTIPLE_STEPS( AVX512_STEP )
+
+    _mm512_storeu_si512( (void*)State[0], _mm512_add_epi32( a, _mm512_loadu_si512( (void const*)State[0] ) ) );
+    _mm512_storeu_si512( (void*)State[1], _mm512_add_epi32( b, _mm512_loadu_si512( (void const*)State[1] ) ) );
+    _mm512_storeu_si512( (void*)State[2], _mm512_add_epi32( c, _mm512_loadu_si512( (void const*)State[2] ) ) );
+    _mm512_storeu_si512( (void*)State[3], _mm512_add_epi32( d, _mm512_loadu_si512( (void const*)State[3] ) ) );
+}
+
+#endif // USE_SIMD_MD5_MULTIPLE
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Multi-buffer scheduling
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static MultipleImplementation const     gMultiplePortable = { 1, NULL, "portable" };
+#ifdef USE_SIMD_MD5_MULTIPLE
+static MultipleImplementation const     gMultipleSse2 = { 4, TransformLanesSse2, "sse2" };
+static MultipleImplementation const     gMultipleAvx2 = { 8, TransformLanesAvx2, "avx2" };
+static MultipleImplementation const     gMultipleAvx512 = { 16, TransformLanesAvx512, "avx512" };
+#endif
+
+// Chosen on first use (see CpuGetFeatures on threads racing to set it)
+static MultipleImplementation const*    gMultipleImplementation = NULL;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetMultipleImplementation
+//
+//  Returns one of the multi-buffer implementations, or NULL if it is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+MultipleImplementation const*
+    GetMultipleImplementation
+    (
+        uint32_t                    Implementation      // [in]
+    )
+{
+#ifdef USE_SIMD_MD5_MULTIPLE
+    uint32_t    features = CpuGetFeatures( );
+    bool        hasSse2 = ( 0 != (features & CPU_FEATURE_SSE2) );
+    bool        hasAvx2 = ( 0 != (features & CPU_FEATURE_AVX2) );
+    bool        hasAvx512 = ( 0 != (features & CPU_FEATURE_AVX512F) );
+
+    if( MD5_IMPLEMENTATION_AUTO == Implementation )
+    {
+        Implementation = hasAvx512 ? MD5_IMPLEMENTATION_AVX512
+                       : hasAvx2   ? MD5_IMPLEMENTATION_AVX2
+                       : hasSse2   ? MD5_IMPLEMENTATION_SSE2
+                       :             MD5_IMPLEMENTATION_PORTABLE;
+    }
+
+    switch( Implementation )
+    {
+    case MD5_IMPLEMENTATION_SSE2:       return hasSse2 ? &gMultipleSse2 : NULL;
+    case MD5_IMPLEMENTATION_AVX2:       return hasAvx2 ? &gMultipleAvx2 : NULL;
+    case MD5_IMPLEMENTATION_AVX512:     return hasAvx512 ? &gMultipleAvx512 : NULL;
+    default:                            break;
+    }
+#endif
+
+    if( MD5_IMPLEMENTATION_AUTO == Implementation || MD5_IMPLEMENTATION_PORTABLE == Implementation )
+    {
+        return &gMultiplePortable;
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StartLane
+//
+//  Sets up a lane to hash a buffer. The whole blocks are read directly from the buffer, the remaining bytes are
+//  copied into the lane's tail along with the padding and the length.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    StartLane
+    (
+        MultipleLane*       Lane,                               // [out]
+        uint32_t            State [4][MULTIPLE_MAX_LANES],      // [out]
+        uint32_t            LaneIndex,                          // [in]
+        uint32_t            BufferIndex,                        // [in]
+        void const*         Buffer,                             // [in]
+        uint32_t            BufferSize                          // [in]
+    )
+{
+    uint32_t    remainder = BufferSize % 64;
+    uint64_t    bitLength = (uint64_t)BufferSize * 8;
+    uint32_t    tailSize;
+    uint32_t    i;
+
+    Lane->Active = true;
+    Lane->BufferIndex = BufferIndex;
+    Lane->Data = (uint8_t const*)Buffer;
+    Lane->WholeBlocksLeft = BufferSize / 64;
+    Lane->TailBlocksLeft = ( remainder + 1 + 8 > 64 ) ? 2 : 1;
+    Lane->TailIndex = 0;
+
+    tailSize = Lane->TailBlocksLeft * 64;
+    memset( Lane->Tail, 0, tailSize );
+    memcpy( Lane->Tail, (uint8_t const*)Buffer + (BufferSize - remainder), remainder );
+    Lane->Tail[remainder] = 0x80;
+    for( i=0; i<8; i++ )
+    {
+        Lane->Tail[tailSize - 8 + i] = (uint8_t)( bitLength >> (i * 8) );
+    }
+
+    State[0][LaneIndex] = 0x67452301;
+    State[1][LaneIndex] = 0xefcdab89;
+    State[2][LaneIndex] = 0x98badcfe;
+    State[3][LaneIndex] = 0x10325476;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CalculateMultipleLanes
+//
+//  Hashes the buffers with a multi-buffer transform. Each lane works through one buffer; as soon as a lane finishes
+//  its digest is written and it starts on the next buffer not yet hashed, so buffers of different lengths keep all
+//  the lanes busy until the last few.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    CalculateMultipleLanes
+    (
+        MultipleImplementation const*   Implementation,     // [in]
+        void const* const               Buffers [],         // [in]
+        uint32_t const                  BufferSizes [],     // [in]
+        uint32_t                        NumBuffers,         // [in]
+        MD5_HASH                        Digests []          // [out]
+    )
+{
+    static uint8_t const    idleBlock [64] = { 0 };
+    MultipleLane            lanes [MULTIPLE_MAX_LANES];
+    uint32_t                state [4][MULTIPLE_MAX_LANES];
+    uint32_t                words [16][MULTIPLE_MAX_LANES];
+    uint8_t const*          block;
+    uint32_t                nextBuffer = 0;
+    uint32_t                numActive;
+    uint32_t                lane;
+    uint32_t                i;
+
+    memset( state, 0, sizeof(state) );
+    for( lane=0; lane<MULTIPLE_MAX_LANES; lane++ )
+    {
+        lanes[lane].Active = false;
+    }
+
+    for( ;; )
+    {
+        // Give any idle lanes the next buffers, and gather each lane's next block into the word rows.
+        numActive = 0;
+        for( lane=0; lane<Implementation->NumLanes; lane++ )
+        {
+            if( !lanes[lane].Active && nextBuffer < NumBuffers )
+            {
+                StartLane( &lanes[lane], state, lane, nextBuffer, Buffers[nextBuffer], BufferSizes[nextBuffer] );
+                nextBuffer += 1;
+            }
+
+            if( !lanes[lane].Active )
+            {
+                block = idleBlock;
+            }
+            else if( lanes[lane].WholeBlocksLeft > 0 )
+            {
+                block = lanes[lane].Data;
+                numActive += 1;
+            }
+            else
+            {
+                block = lanes[lane].Tail + (lanes[lane].TailIndex * 64);
+                numActive += 1;
+            }
+
+            for( i=0; i<16; i++ )
+            {
+                words[i][lane] = (uint32_t)block[i*4]
+                    | ((uint32_t)block[i*4+1] << 8) | ((uint32_t)block[i*4+2] << 16) | ((uint32_t)block[i*4+3] << 24);
+            }
+        }
+
+        if( 0 == numActive )
+        {
+            break;
+        }
+
+        Implementation->TransformLanes( state, (uint32_t const (*)[MULTIPLE_MAX_LANES])words );
+
+        // Advance each lane, and output the digests of those that have finished.
+        for( lane=0; lane<Implementation->NumLanes; lane++ )
+        {
+            MultipleLane* current = &lanes[lane];
+
+            if( !current->Active )
+            {
+                continue;
+            }
+
+            if( current->WholeBlocksLeft > 0 )
+            {
+                current->Data += 64;
+                current->WholeBlocksLeft -= 1;
+            }
+            else
+            {
+                current->TailIndex += 1;
+                current->TailBlocksLeft -= 1;
+                if( 0 == current->TailBlocksLeft )
+                {
+                    for( i=0; i<MD5_HASH_SIZE; i++ )
+                    {
+                        Digests[current->BufferIndex].bytes[i] = (uint8_t)( state[i/4][lane] >> ((i % 4) * 8) );
+                    }
+                    current->Active = false;
+                }
+            }
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  EXPORTED FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -216,7 +619,9 @@ void
 {
     uint32_t    saved_lo;
     uint32_t    used;
-    uint32_t    free;
+    uint32_t    free = 0;
+    uint32_t    wholeSize = 0;
+    STATS_BEGIN( startCycles );
 
     saved_lo = Context->lo;
     if( (Context->lo = (saved_lo + BufferSize) & 0x1fffffff) < saved_lo )
@@ -234,6 +639,7 @@ void
         if( BufferSize < free )
         {
             memcpy( &Context->buffer[used], Buffer, BufferSize );
+            STATS_END( STATS_MD5, startCycles, BufferSize );
             return;
         }
 
@@ -245,11 +651,13 @@ void
 
     if( BufferSize >= 64 )
     {
-        Buffer = TransformFunction( Context, Buffer, BufferSize & ~(unsigned long)0x3f );
-        BufferSize &= 0x3f;
+        wholeSize = BufferSize & ~(uint32_t)0x3f;
+        Buffer = TransformFunction( Context, Buffer, wholeSize );
+        BufferSize -= wholeSize;
     }
 
     memcpy( Context->buffer, Buffer, BufferSize );
+    STATS_END( STATS_MD5, startCycles, (uint64_t)free + wholeSize + BufferSize );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -333,3 +741,71 @@ void
     Md5Update( &context, Buffer, BufferSize );
     Md5Finalise( &context, Digest );
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Md5CalculateMultiple
+//
+//  Calculates the MD5 hashes of NumBuffers independent buffers: Digests[i] is the MD5 of BufferSizes[i] bytes of
+//  Buffers[i], identical to Md5Calculate. The buffers may all be different lengths. Where the processor supports it
+//  several buffers are hashed at once in SIMD lanes (4 with SSE2, 8 with AVX2, 16 with AVX-512), which is much faster
+//  than hashing them one at a time as a single MD5 is one long dependency chain.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Md5CalculateMultiple
+    (
+        void const* const   Buffers [],     // [in]
+        uint32_t const      BufferSizes [], // [in]
+        uint32_t            NumBuffers,     // [in]
+        MD5_HASH            Digests []      // [out]
+    )
+{
+    MultipleImplementation const*   implementation = gMultipleImplementation;
+    uint32_t                        i;
+
+    if( NULL == implementation )
+    {
+        implementation = GetMultipleImplementation( MD5_IMPLEMENTATION_AUTO );
+        gMultipleImplementation = implementation;
+        STATS_SET_BACKEND( STATS_MD5, implementation->Name );
+    }
+
+    if( NULL == implementation->TransformLanes || NumBuffers < 2 )
+    {
+        for( i=0; i<NumBuffers; i++ )
+        {
+            Md5Calculate( Buffers[i], BufferSizes[i], &Digests[i] );
+        }
+    }
+    else
+    {
+        STATS_BEGIN( startCycles );
+        CalculateMultipleLanes( implementation, Buffers, BufferSizes, NumBuffers, Digests );
+        STATS_END( STATS_MD5, startCycles, StatsTotalSize( BufferSizes, NumBuffers ) );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Md5SetImplementation
+//
+//  Selects the implementation used by Md5CalculateMultiple. MD5_IMPLEMENTATION_AUTO (the default) uses the widest
+//  SIMD the processor supports. The others force a particular one, which is intended for testing and benchmarking.
+//  This must not be called while another thread is hashing.
+//  Returns 0 if successful, or -1 if the implementation is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Md5SetImplementation
+    (
+        uint32_t            Implementation  // [in]
+    )
+{
+    MultipleImplementation const*   implementation = GetMultipleImplementation( Implementation );
+
+    if( NULL == implementation )
+    {
+        return -1;
+    }
+
+    gMultipleImplementation = implementation;
+    STATS_SET_BACKEND( STATS_MD5, implementation->Name );
+    return 0;
+}
@@ -4,6 +4,8 @@
 //  Implementation of MD5 hash function. Originally written by Alexander Peslyak. Modified by WaterJuice retaining
 //  Public Domain license.
 //
+//  Depends on: CryptoLib_Cpu
+//
 //  This is free and unencumbered software released into the public domain - June 2013 waterjuice.org
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -30,7 +32,6 @@ typedef struct
     uint32_t     c;
     uint32_t     d;
     uint8_t      buffer[64];
-    uint32_t     block[16];
 } Md5Context;
 
 #define MD5_HASH_SIZE           ( 128 / 8 )
@@ -40,6 +41,13 @@ typedef struct
     uint8_t      bytes [MD5_HASH_SIZE];
 } MD5_HASH;
 
+// Implementations of Md5CalculateMultiple for Md5SetImplementation
+#define MD5_IMPLEMENTATION_AUTO         0       // Widest SIMD the processor supports
+#define MD5_IMPLEMENTATION_PORTABLE     1       // Portable C, one buffer at a time
+#define MD5_IMPLEMENTATION_SSE2         2       // x86 SSE2, 4 buffers at once
+#define MD5_IMPLEMENTATION_AVX2         3       // x86 AVX2, 8 buffers at once
+#define MD5_IMPLEMENTATION_AVX512       4       // x86 AVX-512F, 16 buffers at once
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -94,3 +102,34 @@ void
         uint32_t            BufferSize,     // [in]
         MD5_HASH*           Digest          // [out]
     );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Md5CalculateMultiple
+//
+//  Calculates the MD5 hashes of NumBuffers independent buffers: Digests[i] is the MD5 of BufferSizes[i] bytes of
+//  Buffers[i], identical to Md5Calculate. The buffers may all be different lengths. Where the processor supports it
+//  several buffers are hashed at once in SIMD lanes (4 with SSE2, 8 with AVX2, 16 with AVX-512), which is much faster
+//  than hashing them one at a time as a single MD5 is one long dependency chain.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Md5CalculateMultiple
+    (
+        void const* const   Buffers [],     // [in]
+        uint32_t const      BufferSizes [], // [in]
+        uint32_t            NumBuffers,     // [in]
+        MD5_HASH            Digests []      // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Md5SetImplementation
+//
+//  Selects the implementation used by Md5CalculateMultiple. MD5_IMPLEMENTATION_AUTO (the default) uses the widest
+//  SIMD the processor supports. The others force a particular one, which is intended for testing and benchmarking.
+//  This must not be called while another thread is hashing.
+//  Returns 0 if successful, or -1 if the implementation is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Md5SetImplementation
+    (
+        uint32_t            Implementation  // [in]
+    );
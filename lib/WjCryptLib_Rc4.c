@@ -11,7 +11,22 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_Rc4.h"
+#include "WjCryptLib_Stats.h"
 #include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Number of independent streams advanced together by Rc4XorMultiple
+#define MULTI_STREAM_LANES      8
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  INTERNAL FUNCTIONS
@@ -24,6 +39,385 @@
     Value2 = temp;                                  \
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  XorEightLanes
+//
+//  Inner loop of XorLanes when all eight lanes are active and have at least Size bytes left. Every lane's state is
+//  held in its own local so that each step is only loads from its S-box and no lane waits on the memory of another.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#define LaneStep( Lane )                                                \
+{                                                                       \
+    uint8_t si;                                                         \
+    uint8_t sj;                                                         \
+                                                                        \
+    i##Lane += 1;                                                       \
+    si = S##Lane[i##Lane];                                              \
+    j##Lane += si;                                                      \
+    sj = S##Lane[j##Lane];                                              \
+    S##Lane[i##Lane] = sj;                                              \
+    S##Lane[j##Lane] = si;                                              \
+                                                                        \
+    Out[Lane][n] = In[Lane][n] ^ S##Lane[(uint8_t)( si + sj )];         \
+}
+
+static
+void
+    XorEightLanes
+    (
+        uint8_t* const          S [],           // [in out]
+        uint8_t const* const    In [],          // [in]
+        uint8_t* const          Out [],         // [out]
+        uint8_t                 I [],           // [in out]
+        uint8_t                 J [],           // [in out]
+        uint32_t                Size            // [in]
+    )
+{
+    uint8_t*    S0 = S[0];
+    uint8_t*    S1 = S[1];
+    uint8_t*    S2 = S[2];
+    uint8_t*    S3 = S[3];
+    uint8_t*    S4 = S[4];
+    uint8_t*    S5 = S[5];
+    uint8_t*    S6 = S[6];
+    uint8_t*    S7 = S[7];
+    uint8_t     i0 = I[0];
+    uint8_t     i1 = I[1];
+    uint8_t     i2 = I[2];
+    uint8_t     i3 = I[3];
+    uint8_t     i4 = I[4];
+    uint8_t     i5 = I[5];
+    uint8_t     i6 = I[6];
+    uint8_t     i7 = I[7];
+    uint8_t     j0 = J[0];
+    uint8_t     j1 = J[1];
+    uint8_t     j2 = J[2];
+    uint8_t     j3 = J[3];
+    uint8_t     j4 = J[4];
+    uint8_t     j5 = J[5];
+    uint8_t     j6 = J[6];
+    uint8_t     j7 = J[7];
+    uint32_t    n;
+
+    for( n=0; n<Size; n++ )
+    {
+        LaneStep( 0 );
+        LaneStep( 1 );
+        LaneStep( 2 );
+        LaneStep( 3 );
+        LaneStep( 4 );
+        LaneStep( 5 );
+        LaneStep( 6 );
+        LaneStep( 7 );
+    }
+
+    I[0] = i0;  I[1] = i1;  I[2] = i2;  I[3] = i3;  I[4] = i4;  I[5] = i5;  I[6] = i6;  I[7] = i7;
+    J[0] = j0;  J[1] = j1;  J[2] = j2;  J[3] = j3;  J[4] = j4;  J[5] = j5;  J[6] = j6;  J[7] = j7;
+}
+
+#undef LaneStep
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  XorLanes
+//
+//  Performs Rc4Xor on NumLanes (up to MULTI_STREAM_LANES) streams, each with its own size. Every pass produces one
+//  byte of each stream that still has bytes left before moving on to the next byte. Within a stream each byte depends
+//  on the swap made for the previous one, but the streams do not depend on each other, so their S-box loads overlap
+//  instead of each waiting on the one before.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    XorLanes
+    (
+        Rc4Context* const   Contexts [],        // [in out]
+        void const* const   InBuffers [],       // [in]
+        void* const         OutBuffers [],      // [out]
+        uint32_t const      Sizes [],           // [in]
+        uint32_t            NumLanes            // [in]
+    )
+{
+    Rc4Context*     contexts [MULTI_STREAM_LANES];
+    uint8_t*        S [MULTI_STREAM_LANES];
+    uint8_t const*  in [MULTI_STREAM_LANES];
+    uint8_t*        out [MULTI_STREAM_LANES];
+    uint32_t        amountLeft [MULTI_STREAM_LANES];
+    uint8_t         i [MULTI_STREAM_LANES];
+    uint8_t         j [MULTI_STREAM_LANES];
+    uint32_t        numActive = 0;
+    uint32_t        lane;
+    uint32_t        chunkSize;
+    uint32_t        n;
+    uint8_t         si;
+    uint8_t         sj;
+
+    for( lane=0; lane<NumLanes; lane++ )
+    {
+        if( Sizes[lane] > 0 )
+        {
+            contexts[numActive] = Contexts[lane];
+            S[numActive] = Contexts[lane]->S;
+            in[numActive] = (uint8_t const*)InBuffers[lane];
+            out[numActive] = (uint8_t*)OutBuffers[lane];
+            amountLeft[numActive] = Sizes[lane];
+            i[numActive] = (uint8_t)Contexts[lane]->i;
+            j[numActive] = (uint8_t)Contexts[lane]->j;
+            numActive += 1;
+        }
+    }
+
+    while( numActive > 0 )
+    {
+        // Run all the active streams together until the shortest one finishes
+        chunkSize = amountLeft[0];
+        for( lane=1; lane<numActive; lane++ )
+        {
+            chunkSize = MIN( chunkSize, amountLeft[lane] );
+        }
+
+        if( MULTI_STREAM_LANES == numActive )
+        {
+            XorEightLanes( S, in, out, i, j, chunkSize );
+        }
+        else
+        {
+            for( n=0; n<chunkSize; n++ )
+            {
+                for( lane=0; lane<numActive; lane++ )
+                {
+                    i[lane] += 1;
+                    si = S[lane][i[lane]];
+                    j[lane] += si;
+                    sj = S[lane][j[lane]];
+                    S[lane][i[lane]] = sj;
+                    S[lane][j[lane]] = si;
+
+                    out[lane][n] = in[lane][n] ^ S[lane][(uint8_t)( si + sj )];
+                }
+            }
+        }
+
+        // Store the state of the finished streams and remove them from the active set
+        lane = 0;
+        while( lane < numActive )
+        {
+            in[lane] += chunkSize;
+            out[lane] += chunkSize;
+            amountLeft[lane] -= chunkSize;
+            if( 0 == amountLeft[lane] )
+            {
+                contexts[lane]->i = i[lane];
+                contexts[lane]->j = j[lane];
+
+                numActive -= 1;
+                contexts[lane] = contexts[numActive];
+                S[lane] = S[numActive];
+                in[lane] = in[numActive];
+                out[lane] = out[numActive];
+                amountLeft[lane] = amountLeft[numActive];
+                i[lane] = i[numActive];
+                j[lane] = j[numActive];
+            }
+            else
+            {
+                lane += 1;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ExpandKey
+//
+//  Repeats the key to fill the 256 bytes the key schedule uses, so that the schedule does not need a division for
+//  each byte. Only the first 256 bytes of a longer key are used.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    ExpandKey
+    (
+        uint8_t             ExpandedKey [RC4_MAX_KEY_SIZE],     // [out]
+        uint8_t const*      Key,                                // [in]
+        uint32_t            KeySize                             // [in]
+    )
+{
+    uint32_t    size = MIN( KeySize, RC4_MAX_KEY_SIZE );
+    uint32_t    i;
+
+    memcpy( ExpandedKey, Key, size );
+    for( i=size; i<RC4_MAX_KEY_SIZE; i++ )
+    {
+        ExpandedKey[i] = ExpandedKey[i - size];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  InitialiseEightLanes
+//
+//  Performs Rc4Initialise on eight contexts at once. All eight run the key schedule and then the drop together, so
+//  they are always at the same i and only j and the S-box differ between lanes. As in XorEightLanes the lanes are
+//  independent and their S-box loads overlap.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#define KeyScheduleStep( Lane )                                         \
+{                                                                       \
+    uint8_t si = S##Lane[i];                                            \
+                                                                        \
+    j##Lane += si + expandedKeys[Lane][i];                              \
+    S##Lane[i] = S##Lane[j##Lane];                                      \
+    S##Lane[j##Lane] = si;                                              \
+}
+
+#define DropStep( Lane )                                                \
+{                                                                       \
+    uint8_t si = S##Lane[i];                                            \
+                                                                        \
+    j##Lane += si;                                                      \
+    S##Lane[i] = S##Lane[j##Lane];                                      \
+    S##Lane[j##Lane] = si;                                              \
+}
+
+static
+void
+    InitialiseEightLanes
+    (
+        Rc4Context* const       Contexts [],    // [out]
+        uint8_t const* const    Keys [],        // [in]
+        uint32_t const          KeySizes [],    // [in]
+        uint32_t                DropN           // [in]
+    )
+{
+    uint8_t     expandedKeys [MULTI_STREAM_LANES][RC4_MAX_KEY_SIZE];
+    uint8_t*    S0 = Contexts[0]->S;
+    uint8_t*    S1 = Contexts[1]->S;
+    uint8_t*    S2 = Contexts[2]->S;
+    uint8_t*    S3 = Contexts[3]->S;
+    uint8_t*    S4 = Contexts[4]->S;
+    uint8_t*    S5 = Contexts[5]->S;
+    uint8_t*    S6 = Contexts[6]->S;
+    uint8_t*    S7 = Contexts[7]->S;
+    uint8_t     j0 = 0;
+    uint8_t     j1 = 0;
+    uint8_t     j2 = 0;
+    uint8_t     j3 = 0;
+    uint8_t     j4 = 0;
+    uint8_t     j5 = 0;
+    uint8_t     j6 = 0;
+    uint8_t     j7 = 0;
+    uint32_t    lane;
+    uint32_t    n;
+    uint8_t     i;
+
+    for( lane=0; lane<MULTI_STREAM_LANES; lane++ )
+    {
+        ExpandKey( expandedKeys[lane], Keys[lane], KeySizes[lane] );
+        for( n=0; n<256; n++ )
+        {
+            Contexts[lane]->S[n] = (uint8_t)n;
+        }
+    }
+
+    // Key schedule
+    for( n=0; n<256; n++ )
+    {
+        i = (uint8_t)n;
+        KeyScheduleStep( 0 );
+        KeyScheduleStep( 1 );
+        KeyScheduleStep( 2 );
+        KeyScheduleStep( 3 );
+        KeyScheduleStep( 4 );
+        KeyScheduleStep( 5 );
+        KeyScheduleStep( 6 );
+        KeyScheduleStep( 7 );
+    }
+
+    j0 = 0;  j1 = 0;  j2 = 0;  j3 = 0;  j4 = 0;  j5 = 0;  j6 = 0;  j7 = 0;
+
+    // Drop first bytes
+    i = 0;
+    for( n=0; n<DropN; n++ )
+    {
+        i += 1;
+        DropStep( 0 );
+        DropStep( 1 );
+        DropStep( 2 );
+        DropStep( 3 );
+        DropStep( 4 );
+        DropStep( 5 );
+        DropStep( 6 );
+        DropStep( 7 );
+    }
+
+    Contexts[0]->j = j0;
+    Contexts[1]->j = j1;
+    Contexts[2]->j = j2;
+    Contexts[3]->j = j3;
+    Contexts[4]->j = j4;
+    Contexts[5]->j = j5;
+    Contexts[6]->j = j6;
+    Contexts[7]->j = j7;
+    for( lane=0; lane<MULTI_STREAM_LANES; lane++ )
+    {
+        Contexts[lane]->i = i;
+    }
+}
+
+#undef KeyScheduleStep
+#undef DropStep
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  InitialiseLanes
+//
+//  Performs Rc4Initialise on NumLanes (up to MULTI_STREAM_LANES) contexts, interleaved when there are eight. The key
+//  sizes must already have been checked.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    InitialiseLanes
+    (
+        Rc4Context* const       Contexts [],    // [out]
+        uint8_t const* const    Keys [],        // [in]
+        uint32_t const          KeySizes [],    // [in]
+        uint32_t                DropN,          // [in]
+        uint32_t                NumLanes        // [in]
+    )
+{
+    uint32_t    lane;
+
+    if( MULTI_STREAM_LANES == NumLanes )
+    {
+        InitialiseEightLanes( Contexts, Keys, KeySizes, DropN );
+    }
+    else
+    {
+        for( lane=0; lane<NumLanes; lane++ )
+        {
+            Rc4Initialise( Contexts[lane], Keys[lane], KeySizes[lane], DropN );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HashKey
+//
+//  Returns the 32 bit FNV-1a hash of the key bytes, used to pick a state cache entry.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    HashKey
+    (
+        uint8_t const*      Key,            // [in]
+        uint32_t            KeySize         // [in]
+    )
+{
+    uint32_t    hash = 2166136261u;
+    uint32_t    i;
+
+    for( i=0; i<KeySize; i++ )
+    {
+        hash = ( hash ^ Key[i] ) * 16777619u;
+    }
+
+    return hash;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -44,9 +438,11 @@ int
         uint32_t        DropN           // [in]
     )
 {
+    uint8_t         expandedKey [RC4_MAX_KEY_SIZE];
     uint32_t        i;
     uint32_t        j;
     uint32_t        n;
+    STATS_BEGIN( startCycles );
 
     if( 0 == KeySize )
     {
@@ -60,10 +456,11 @@ int
         Context->S[i] = (uint8_t)i;
     }
 
+    ExpandKey( expandedKey, Key, KeySize );
     j = 0;
     for( i=0; i<256; i++ )
     {
-        j = ( j + Context->S[i] + ((uint8_t*)Key)[i % KeySize] ) % 256;
+        j = ( j + Context->S[i] + expandedKey[i] ) % 256;
         SwapBytes( Context->S[i], Context->S[j] );
     }
 
@@ -81,6 +478,53 @@ int
     Context->i = i;
     Context->j = j;
 
+    STATS_END( STATS_RC4_KEY_SETUP, startCycles, KeySize );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4InitialiseMultiple
+//
+//  Performs Rc4Initialise on NumContexts contexts, all with the same DropN: Contexts[i] is initialised with the key of
+//  KeySizes[i] bytes at Keys[i]. Groups of eight contexts run the key schedule and drop interleaved so that the
+//  S-box lookups of different keys overlap. When built with OpenMP separate groups run on separate threads.
+//  Returns 0 if successful, or -1 if any KeySize is 0, in which case no context is initialised.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Rc4InitialiseMultiple
+    (
+        Rc4Context* const       Contexts [],        // [out]
+        uint8_t const* const    Keys [],            // [in]
+        uint32_t const          KeySizes [],        // [in]
+        uint32_t                DropN,              // [in]
+        uint32_t                NumContexts         // [in]
+    )
+{
+    int         numGroups = (int)( (NumContexts + MULTI_STREAM_LANES - 1) / MULTI_STREAM_LANES );
+    int         group;
+    uint32_t    i;
+    STATS_BEGIN( startCycles );
+
+    for( i=0; i<NumContexts; i++ )
+    {
+        if( 0 == KeySizes[i] )
+        {
+            return -1;
+        }
+    }
+
+    #ifdef _OPENMP
+        #pragma omp parallel for if( numGroups > 1 )
+    #endif
+    for( group=0; group<numGroups; group++ )
+    {
+        uint32_t first = (uint32_t)group * MULTI_STREAM_LANES;
+
+        InitialiseLanes( Contexts + first, Keys + first, KeySizes + first, DropN,
+            MIN( NumContexts - first, MULTI_STREAM_LANES ) );
+    }
+
+    STATS_END( STATS_RC4_KEY_SETUP, startCycles, StatsTotalSize( KeySizes, NumContexts ) );
     return 0;
 }
 
@@ -97,16 +541,26 @@ void
         uint32_t        Size            // [in]
     )
 {
+    uint8_t*    S = Context->S;
+    uint8_t     i = (uint8_t)Context->i;
+    uint8_t     j = (uint8_t)Context->j;
     uint32_t    n;
+    STATS_BEGIN( startCycles );
 
+    // i and j are kept in locals: as fields they would have to be reloaded after every byte written to Buffer, in
+    // case Buffer overlaps the context.
     for( n=0; n<Size; n++ )
     {
-        Context->i = ( Context->i + 1 ) % 256;
-        Context->j = ( Context->j + Context->S[Context->i] ) % 256;
-        SwapBytes( Context->S[Context->i], Context->S[Context->j] );
+        i += 1;
+        j += S[i];
+        SwapBytes( S[i], S[j] );
 
-        ((uint8_t*)Buffer)[n] = Context->S[ (Context->S[Context->i] + Context->S[Context->j]) % 256 ];
+        ((uint8_t*)Buffer)[n] = S[ (uint8_t)( S[i] + S[j] ) ];
     }
+
+    Context->i = i;
+    Context->j = j;
+    STATS_END( STATS_RC4, startCycles, Size );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -124,17 +578,68 @@ void
         uint32_t        Size            // [in]
     )
 {
+    uint8_t*    S = Context->S;
+    uint8_t     i = (uint8_t)Context->i;
+    uint8_t     j = (uint8_t)Context->j;
     uint32_t    n;
+    STATS_BEGIN( startCycles );
 
     for( n=0; n<Size; n++ )
     {
-        Context->i = ( Context->i + 1 ) % 256;
-        Context->j = ( Context->j + Context->S[Context->i] ) % 256;
-        SwapBytes( Context->S[Context->i], Context->S[Context->j] );
+        i += 1;
+        j += S[i];
+        SwapBytes( S[i], S[j] );
 
-        ((uint8_t*)OutBuffer)[n] = ((uint8_t*)InBuffer)[n]
-            ^ ( Context->S[ (Context->S[Context->i] + Context->S[Context->j]) % 256 ] );
+        ((uint8_t*)OutBuffer)[n] = ((uint8_t*)InBuffer)[n] ^ S[ (uint8_t)( S[i] + S[j] ) ];
     }
+
+    Context->i = i;
+    Context->j = j;
+    STATS_END( STATS_RC4, startCycles, Size );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4XorMultiple
+//
+//  XORs Size bytes of each of NumStreams independent RC4 streams onto its own buffer: stream i is Contexts[i] and is
+//  XORed from InBuffers[i] into OutBuffers[i]. Each stream advances by Size bytes and produces exactly what Rc4Xor
+//  would. Up to eight streams are advanced in an interleaved fashion so that the S-box lookups of different streams
+//  overlap. When built with OpenMP separate groups of eight streams run on separate threads.
+//  Each context must appear only once in Contexts.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Rc4XorMultiple
+    (
+        Rc4Context* const   Contexts [],            // [in out]
+        void const* const   InBuffers [],           // [in]
+        void* const         OutBuffers [],          // [out]
+        uint32_t            NumStreams,             // [in]
+        uint32_t            Size                    // [in]
+    )
+{
+    int     numGroups = (int)( (NumStreams + MULTI_STREAM_LANES - 1) / MULTI_STREAM_LANES );
+    int     group;
+    STATS_BEGIN( startCycles );
+
+    #ifdef _OPENMP
+        #pragma omp parallel for if( numGroups > 1 )
+    #endif
+    for( group=0; group<numGroups; group++ )
+    {
+        uint32_t    first = (uint32_t)group * MULTI_STREAM_LANES;
+        uint32_t    sizes [MULTI_STREAM_LANES];
+        uint32_t    lane;
+
+        for( lane=0; lane<MULTI_STREAM_LANES; lane++ )
+        {
+            sizes[lane] = Size;
+        }
+
+        XorLanes( Contexts + first, InBuffers + first, OutBuffers + first, sizes,
+            MIN( NumStreams - first, MULTI_STREAM_LANES ) );
+    }
+
+    STATS_END( STATS_RC4, startCycles, (uint64_t)NumStreams * Size );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -165,3 +670,150 @@ int
     Rc4Xor( &context, InBuffer, OutBuffer, BufferSize );
     return 0;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4XorWithKeyMultiple
+//
+//  Performs Rc4XorWithKey on NumBuffers independent (key, buffer) pairs, all with the same DropN: buffer i is
+//  BufferSizes[i] bytes XORed from InBuffers[i] into OutBuffers[i] using the key of KeySizes[i] bytes at Keys[i]. The
+//  contexts are initialised as with Rc4InitialiseMultiple and the streams generated in interleaved groups of eight as
+//  with Rc4XorMultiple. Buffers of similar sizes keep the groups full for longest.
+//  Returns 0 if successful, or -1 if any KeySize is 0, in which case no buffer is processed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Rc4XorWithKeyMultiple
+    (
+        uint8_t const* const    Keys [],            // [in]
+        uint32_t const          KeySizes [],        // [in]
+        uint32_t                DropN,              // [in]
+        void const* const       InBuffers [],       // [in]
+        void* const             OutBuffers [],      // [out]
+        uint32_t const          BufferSizes [],     // [in]
+        uint32_t                NumBuffers          // [in]
+    )
+{
+    int         numGroups = (int)( (NumBuffers + MULTI_STREAM_LANES - 1) / MULTI_STREAM_LANES );
+    int         group;
+    uint32_t    i;
+    STATS_BEGIN( startCycles );
+
+    for( i=0; i<NumBuffers; i++ )
+    {
+        if( 0 == KeySizes[i] )
+        {
+            return -1;
+        }
+    }
+
+    #ifdef _OPENMP
+        #pragma omp parallel for if( numGroups > 1 )
+    #endif
+    for( group=0; group<numGroups; group++ )
+    {
+        uint32_t        first = (uint32_t)group * MULTI_STREAM_LANES;
+        uint32_t        numLanes = MIN( NumBuffers - first, MULTI_STREAM_LANES );
+        Rc4Context      contexts [MULTI_STREAM_LANES];
+        Rc4Context*     contextPointers [MULTI_STREAM_LANES];
+        uint32_t        lane;
+
+        for( lane=0; lane<numLanes; lane++ )
+        {
+            contextPointers[lane] = &contexts[lane];
+        }
+
+        InitialiseLanes( contextPointers, Keys + first, KeySizes + first, DropN, numLanes );
+        XorLanes( contextPointers, InBuffers + first, OutBuffers + first, BufferSizes + first, numLanes );
+    }
+
+    // The key schedules are interleaved with the streams so are counted as part of them
+    STATS_END( STATS_RC4, startCycles, StatsTotalSize( BufferSizes, NumBuffers ) );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4StateCacheInitialise
+//
+//  Initialises an empty cache of RC4 states after the key schedule and the drop of DropN bytes, stored in the caller
+//  provided table Entries of NumEntries entries. The table must remain valid until Rc4StateCacheUninitialise.
+//  Returns 0 if successful, or -1 if Entries is NULL or NumEntries is 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Rc4StateCacheInitialise
+    (
+        Rc4StateCache*          Cache,              // [out]
+        Rc4StateCacheEntry*     Entries,            // [in]
+        uint32_t                NumEntries,         // [in]
+        uint32_t                DropN               // [in]
+    )
+{
+    uint32_t    i;
+
+    if( NULL == Entries || 0 == NumEntries )
+    {
+        return -1;
+    }
+
+    for( i=0; i<NumEntries; i++ )
+    {
+        Entries[i].KeySize = 0;
+    }
+
+    Cache->Entries = Entries;
+    Cache->NumEntries = NumEntries;
+    Cache->DropN = DropN;
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4InitialiseWithCache
+//
+//  Initialises Context exactly as Rc4Initialise with the cache's DropN would. If the key is in the cache its stored
+//  state is copied, otherwise the key schedule and drop are run and the result stored in the cache, replacing the
+//  entry previously in that slot. Keys longer than RC4_MAX_KEY_SIZE are cached by their first RC4_MAX_KEY_SIZE bytes,
+//  which are the only ones RC4 uses. The cache is not locked, use one per thread.
+//  Returns 0 if successful, or -1 if KeySize is 0.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Rc4InitialiseWithCache
+    (
+        Rc4StateCache*      Cache,                  // [in out]
+        Rc4Context*         Context,                // [out]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize                 // [in]
+    )
+{
+    uint32_t                size = MIN( KeySize, RC4_MAX_KEY_SIZE );
+    Rc4StateCacheEntry*     entry;
+
+    if( 0 == KeySize )
+    {
+        return -1;
+    }
+
+    entry = &Cache->Entries[ HashKey( Key, size ) % Cache->NumEntries ];
+    if( entry->KeySize != size || 0 != memcmp( entry->Key, Key, size ) )
+    {
+        Rc4Initialise( &entry->State, Key, size, Cache->DropN );
+        memcpy( entry->Key, Key, size );
+        entry->KeySize = size;
+    }
+
+    *Context = entry->State;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4StateCacheUninitialise
+//
+//  Wipes the keys and states held in the cache's table.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Rc4StateCacheUninitialise
+    (
+        Rc4StateCache*      Cache                   // [in out]
+    )
+{
+    memset( Cache->Entries, 0, Cache->NumEntries * sizeof(Rc4StateCacheEntry) );
+    memset( Cache, 0, sizeof(*Cache) );
+}
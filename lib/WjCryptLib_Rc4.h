@@ -26,6 +26,28 @@ typedef struct
     uint8_t      S[256];
 } Rc4Context;
 
+// Longest key RC4 uses. Bytes of a longer key beyond this have no effect.
+#define RC4_MAX_KEY_SIZE    256
+
+// Rc4StateCacheEntry - One entry of the table used by Rc4StateCache.
+// Do not modify the contents of this structure directly.
+typedef struct
+{
+    Rc4Context      State;                      // State after the key schedule and drop
+    uint32_t        KeySize;                    // 0 if the entry is empty
+    uint8_t         Key [RC4_MAX_KEY_SIZE];
+} Rc4StateCacheEntry;
+
+// Rc4StateCache - Initialise with Rc4StateCacheInitialise. The cache is direct mapped: each key has one entry it can
+// be held in, chosen from a hash of the key. The entries hold keys, so wipe them with Rc4StateCacheUninitialise.
+// Do not modify the contents of this structure directly.
+typedef struct
+{
+    Rc4StateCacheEntry*     Entries;
+    uint32_t                NumEntries;
+    uint32_t                DropN;
+} Rc4StateCache;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,6 +68,24 @@ int
         uint32_t        DropN           // [in]
     );
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4InitialiseMultiple
+//
+//  Performs Rc4Initialise on NumContexts contexts, all with the same DropN: Contexts[i] is initialised with the key of
+//  KeySizes[i] bytes at Keys[i]. Groups of eight contexts run the key schedule and drop interleaved so that the
+//  S-box lookups of different keys overlap. When built with OpenMP separate groups run on separate threads.
+//  Returns 0 if successful, or -1 if any KeySize is 0, in which case no context is initialised.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Rc4InitialiseMultiple
+    (
+        Rc4Context* const       Contexts [],        // [out]
+        uint8_t const* const    Keys [],            // [in]
+        uint32_t const          KeySizes [],        // [in]
+        uint32_t                DropN,              // [in]
+        uint32_t                NumContexts         // [in]
+    );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Rc4Output
 //
@@ -74,6 +114,25 @@ void
         uint32_t        Size            // [in]
     );
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4XorMultiple
+//
+//  XORs Size bytes of each of NumStreams independent RC4 streams onto its own buffer: stream i is Contexts[i] and is
+//  XORed from InBuffers[i] into OutBuffers[i]. Each stream advances by Size bytes and produces exactly what Rc4Xor
+//  would. Up to eight streams are advanced in an interleaved fashion so that the S-box lookups of different streams
+//  overlap. When built with OpenMP separate groups of eight streams run on separate threads.
+//  Each context must appear only once in Contexts.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Rc4XorMultiple
+    (
+        Rc4Context* const   Contexts [],            // [in out]
+        void const* const   InBuffers [],           // [in]
+        void* const         OutBuffers [],          // [out]
+        uint32_t            NumStreams,             // [in]
+        uint32_t            Size                    // [in]
+    );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Rc4XorWithKey
 //
@@ -92,3 +151,69 @@ int
         void*               OutBuffer,              // [out]
         uint32_t            BufferSize              // [in]
     );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4XorWithKeyMultiple
+//
+//  Performs Rc4XorWithKey on NumBuffers independent (key, buffer) pairs, all with the same DropN: buffer i is
+//  BufferSizes[i] bytes XORed from InBuffers[i] into OutBuffers[i] using the key of KeySizes[i] bytes at Keys[i]. The
+//  contexts are initialised as with Rc4InitialiseMultiple and the streams generated in interleaved groups of eight as
+//  with Rc4XorMultiple. Buffers of similar sizes keep the groups full for longest.
+//  Returns 0 if successful, or -1 if any KeySize is 0, in which case no buffer is processed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Rc4XorWithKeyMultiple
+    (
+        uint8_t const* const    Keys [],            // [in]
+        uint32_t const          KeySizes [],        // [in]
+        uint32_t                DropN,              // [in]
+        void const* const       InBuffers [],       // [in]
+        void* const             OutBuffers [],      // [out]
+        uint32_t const          BufferSizes [],     // [in]
+        uint32_t                NumBuffers          // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4StateCacheInitialise
+//
+//  Initialises an empty cache of RC4 states after the key schedule and the drop of DropN bytes, stored in the caller
+//  provided table Entries of NumEntries entries. The table must remain valid until Rc4StateCacheUninitialise.
+//  Returns 0 if successful, or -1 if Entries is NULL or NumEntries is 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Rc4StateCacheInitialise
+    (
+        Rc4StateCache*          Cache,              // [out]
+        Rc4StateCacheEntry*     Entries,            // [in]
+        uint32_t                NumEntries,         // [in]
+        uint32_t                DropN               // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4InitialiseWithCache
+//
+//  Initialises Context exactly as Rc4Initialise with the cache's DropN would. If the key is in the cache its stored
+//  state is copied, otherwise the key schedule and drop are run and the result stored in the cache, replacing the
+//  entry previously in that slot. Keys longer than RC4_MAX_KEY_SIZE are cached by their first RC4_MAX_KEY_SIZE bytes,
+//  which are the only ones RC4 uses. The cache is not locked, use one per thread.
+//  Returns 0 if successful, or -1 if KeySize is 0.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Rc4InitialiseWithCache
+    (
+        Rc4StateCache*      Cache,                  // [in out]
+        Rc4Context*         Context,                // [out]
+        void const*         Key,                    // [in]
+        uint32_t            KeySize                 // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Rc4StateCacheUninitialise
+//
+//  Wipes the keys and states held in the cache's table.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Rc4StateCacheUninitialise
+    (
+        Rc4StateCache*      Cache                   // [in out]
+    );
@@ -7,6 +7,8 @@
 //  and Ralph Giles <giles@ghostscript.com>
 //  Modified by WaterJuice retaining Public Domain license.
 //
+//  Depends on: CryptoLib_Cpu
+//
 //  This is free and unencumbered software released into the public domain - June 2013 waterjuice.org
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -15,8 +17,19 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_Sha1.h"
+#include "WjCryptLib_Stats.h"
+#include "WjCryptLib_Cpu.h"
+#include "WjCryptLib_IsaVariants.h"
+#include <stdbool.h>
 #include <memory.h>
 
+// The SHA extensions transform is only built for x86 with gcc or clang, which allow individual functions to be
+// compiled for the SHA instructions while the rest of the file targets the baseline instruction set.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+    #define USE_SHANI_SHA1
+    #include <immintrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  DEFINES
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -42,6 +55,9 @@ typedef union
     uint32_t    l [16];
 } CHAR64LONG16;
 
+// Processes NumBlocks consecutive 64 byte blocks
+typedef void (*TransformBlocksFunc)( uint32_t State [5], uint8_t const* Buffer, uint32_t NumBlocks );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  INTERNAL FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -146,6 +162,250 @@ void
     state[4] += e;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformBlocksPortable
+//
+//  Hashes NumBlocks 512-bit blocks with the portable TransformFunction.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    TransformBlocksPortable
+    (
+        uint32_t            State [5],      // [in out]
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            NumBlocks       // [in]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<NumBlocks; i++ )
+    {
+        TransformFunction( State, Buffer + (i * 64) );
+    }
+}
+
+#ifdef WJCRYPTLIB_ISA_VARIANT
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha1TransformBlocksAvx2, Sha1TransformBlocksAvx512
+//
+//  When this file is compiled for a higher instruction set level it only provides TransformBlocksPortable, under the
+//  variant's name. See WjCryptLib_IsaVariants.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    ISA_VARIANT_NAME( Sha1TransformBlocks )
+    (
+        uint32_t            State [5],      // [in out]
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            NumBlocks       // [in]
+    )
+{
+    TransformBlocksPortable( State, Buffer, NumBlocks );
+}
+
+#else
+
+#ifdef USE_SHANI_SHA1
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - SHA extensions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Each of these performs 4 rounds. E0 and E1 alternate between holding the E value for the rounds being performed
+// and saving ABCD, from which SHA1NEXTE derives the E value for the following 4 rounds.
+#define ShaNiRoundsEven( Msg, Func )                    \
+    E0 = _mm_sha1nexte_epu32( E0, Msg );                \
+    E1 = ABCD;                                          \
+    ABCD = _mm_sha1rnds4_epu32( ABCD, E0, Func );
+
+#define ShaNiRoundsOdd( Msg, Func )                     \
+    E1 = _mm_sha1nexte_epu32( E1, Msg );                \
+    E0 = ABCD;                                          \
+    ABCD = _mm_sha1rnds4_epu32( ABCD, E1, Func );
+
+// Message schedule. Each group of 4 words W[t] is built over three steps from the previous 16 words:
+// SHA1MSG1, XOR, then SHA1MSG2. In group g, MsgCur holds W for group g and the others are at different stages.
+#define ShaNiSchedule( MsgNext, MsgCur, MsgPrev, MsgPrev2 )     \
+    MsgNext = _mm_sha1msg2_epu32( MsgNext, MsgCur );            \
+    MsgPrev = _mm_sha1msg1_epu32( MsgPrev, MsgCur );            \
+    MsgPrev2 = _mm_xor_si128( MsgPrev2, MsgCur );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformBlocksShaNi
+//
+//  Hashes NumBlocks 512-bit blocks using the SHA1RNDS4, SHA1NEXTE, SHA1MSG1, and SHA1MSG2 instructions. The state is
+//  kept in registers across all the blocks.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "sha,ssse3,sse4.1" ) ))
+static
+void
+    TransformBlocksShaNi
+    (
+        uint32_t            State [5],      // [in out]
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            NumBlocks       // [in]
+    )
+{
+    __m128i const   byteSwapMask = _mm_set_epi64x( 0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL );
+    __m128i         ABCD;
+    __m128i         ABCDSave;
+    __m128i         E0;
+    __m128i         E0Save;
+    __m128i         E1;
+    __m128i         MSG0;
+    __m128i         MSG1;
+    __m128i         MSG2;
+    __m128i         MSG3;
+    uint32_t        i;
+
+    // The instructions want A in the most significant word
+    ABCD = _mm_loadu_si128( (__m128i const*)State );
+    ABCD = _mm_shuffle_epi32( ABCD, 0x1b );
+    E0 = _mm_set_epi32( (int)State[4], 0, 0, 0 );
+
+    for( i=0; i<NumBlocks; i++ )
+    {
+        uint8_t const* block = Buffer + (i * 64);
+
+        ABCDSave = ABCD;
+        E0Save = E0;
+
+        // Rounds 0-15 use the message words directly
+        MSG0 = _mm_shuffle_epi8( _mm_loadu_si128( (__m128i const*)(block + 0) ), byteSwapMask );
+        E0 = _mm_add_epi32( E0, MSG0 );
+        E1 = ABCD;
+        ABCD = _mm_sha1rnds4_epu32( ABCD, E0, 0 );
+
+        MSG1 = _mm_shuffle_epi8( _mm_loadu_si128( (__m128i const*)(block + 16) ), byteSwapMask );
+        ShaNiRoundsOdd( MSG1, 0 );
+        MSG0 = _mm_sha1msg1_epu32( MSG0, MSG1 );
+
+        MSG2 = _mm_shuffle_epi8( _mm_loadu_si128( (__m128i const*)(block + 32) ), byteSwapMask );
+        ShaNiRoundsEven( MSG2, 0 );
+        MSG1 = _mm_sha1msg1_epu32( MSG1, MSG2 );
+        MSG0 = _mm_xor_si128( MSG0, MSG2 );
+
+        MSG3 = _mm_shuffle_epi8( _mm_loadu_si128( (__m128i const*)(block + 48) ), byteSwapMask );
+        ShaNiRoundsOdd( MSG3, 0 );
+        ShaNiSchedule( MSG0, MSG3, MSG2, MSG1 );
+
+        // Rounds 16-67 expand the message as they go
+        ShaNiRoundsEven( MSG0, 0 );     ShaNiSchedule( MSG1, MSG0, MSG3, MSG2 );
+        ShaNiRoundsOdd( MSG1, 1 );      ShaNiSchedule( MSG2, MSG1, MSG0, MSG3 );
+        ShaNiRoundsEven( MSG2, 1 );     ShaNiSchedule( MSG3, MSG2, MSG1, MSG0 );
+        ShaNiRoundsOdd( MSG3, 1 );      ShaNiSchedule( MSG0, MSG3, MSG2, MSG1 );
+        ShaNiRoundsEven( MSG0, 1 );     ShaNiSchedule( MSG1, MSG0, MSG3, MSG2 );
+        ShaNiRoundsOdd( MSG1, 1 );      ShaNiSchedule( MSG2, MSG1, MSG0, MSG3 );
+        ShaNiRoundsEven( MSG2, 2 );     ShaNiSchedule( MSG3, MSG2, MSG1, MSG0 );
+        ShaNiRoundsOdd( MSG3, 2 );      ShaNiSchedule( MSG0, MSG3, MSG2, MSG1 );
+        ShaNiRoundsEven( MSG0, 2 );     ShaNiSchedule( MSG1, MSG0, MSG3, MSG2 );
+        ShaNiRoundsOdd( MSG1, 2 );      ShaNiSchedule( MSG2, MSG1, MSG0, MSG3 );
+        ShaNiRoundsEven( MSG2, 2 );     ShaNiSchedule( MSG3, MSG2, MSG1, MSG0 );
+        ShaNiRoundsOdd( MSG3, 3 );      ShaNiSchedule( MSG0, MSG3, MSG2, MSG1 );
+        ShaNiRoundsEven( MSG0, 3 );     ShaNiSchedule( MSG1, MSG0, MSG3, MSG2 );
+
+        // Rounds 68-79 only need to finish off the last message words
+        ShaNiRoundsOdd( MSG1, 3 );
+        MSG2 = _mm_sha1msg2_epu32( MSG2, MSG1 );
+        MSG3 = _mm_xor_si128( MSG3, MSG1 );
+        ShaNiRoundsEven( MSG2, 3 );
+        MSG3 = _mm_sha1msg2_epu32( MSG3, MSG2 );
+        ShaNiRoundsOdd( MSG3, 3 );
+
+        // Add this block's result to the state. E0 holds A from before the last 4 rounds, from which SHA1NEXTE
+        // recovers the final E.
+        E0 = _mm_sha1nexte_epu32( E0, E0Save );
+        ABCD = _mm_add_epi32( ABCD, ABCDSave );
+    }
+
+    ABCD = _mm_shuffle_epi32( ABCD, 0x1b );
+    _mm_storeu_si128( (__m128i*)State, ABCD );
+    State[4] = (uint32_t)_mm_extract_epi32( E0, 3 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CpuHasShaNi
+//
+//  Returns true if the processor supports the SHA extensions, SSSE3, and SSE4.1.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    CpuHasShaNi
+    (
+        void
+    )
+{
+    uint32_t const  required = CPU_FEATURE_SHA | CPU_FEATURE_SSSE3 | CPU_FEATURE_SSE41;
+
+    return required == ( CpuGetFeatures( ) & required );
+}
+
+#endif // USE_SHANI_SHA1
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Transform dispatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static TransformBlocksFunc      gTransformBlocks = NULL;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PortableTransformBlocks
+//
+//  Returns the copy of TransformBlocksPortable compiled for the highest instruction set level the processor supports,
+//  when the library is built with WJCRYPTLIB_ISA_VARIANTS. Its name for the statistics is written to *pName.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+TransformBlocksFunc
+    PortableTransformBlocks
+    (
+        char const**        pName           // [out]
+    )
+{
+#ifdef WJCRYPTLIB_ISA_VARIANTS
+    switch( CpuGetIsaLevel( ) )
+    {
+    case CPU_ISA_AVX512:    *pName = "avx512";      return Sha1TransformBlocksAvx512;
+    case CPU_ISA_AVX2:      *pName = "avx2";        return Sha1TransformBlocksAvx2;
+    default:                break;
+    }
+#endif
+
+    *pName = "portable";
+    return TransformBlocksPortable;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SelectImplementation
+//
+//  Chooses the block transform on first use (see CpuGetFeatures on threads racing through here).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    SelectImplementation
+    (
+        void
+    )
+{
+    char const*     name;
+
+    if( NULL != gTransformBlocks )
+    {
+        return;
+    }
+
+#ifdef USE_SHANI_SHA1
+    if( CpuHasShaNi( ) )
+    {
+        gTransformBlocks = TransformBlocksShaNi;
+        STATS_SET_BACKEND( STATS_SHA1, "shani" );
+        return;
+    }
+#endif
+
+    gTransformBlocks = PortableTransformBlocks( &name );
+    STATS_SET_BACKEND( STATS_SHA1, name );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -169,6 +429,8 @@ void
     Context->State[4] = 0xC3D2E1F0;
     Context->Count[0] = 0;
     Context->Count[1] = 0;
+
+    SelectImplementation( );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -187,6 +449,8 @@ void
 {
     uint32_t    i;
     uint32_t    j;
+    uint32_t    numBlocks;
+    STATS_BEGIN( startCycles );
 
     j = (Context->Count[0] >> 3) & 63;
     if( (Context->Count[0] += BufferSize << 3) < (BufferSize << 3) )
@@ -195,23 +459,77 @@ void
     }
 
     Context->Count[1] += (BufferSize >> 29);
-    if( (j + BufferSize) > 63 )
+
+    // Complete a partial block left over from a previous call
+    i = 0;
+    if( j > 0 )
     {
-        i = 64 - j;
-        memcpy( &Context->Buffer[j], Buffer, i );
-        TransformFunction(Context->State, Context->Buffer);
-        for( ; i + 63 < BufferSize; i += 64 )
+        if( (j + BufferSize) < 64 )
         {
-            TransformFunction(Context->State, (uint8_t*)Buffer + i);
+            memcpy( &Context->Buffer[j], Buffer, BufferSize );
+            STATS_END( STATS_SHA1, startCycles, BufferSize );
+            return;
         }
-        j = 0;
+        i = 64 - j;
+        memcpy( &Context->Buffer[j], Buffer, i );
+        gTransformBlocks( Context->State, Context->Buffer, 1 );
     }
-    else
+
+    // Hash all the whole blocks directly from the caller's buffer in one call.
+    numBlocks = (BufferSize - i) / 64;
+    if( numBlocks > 0 )
     {
-        i = 0;
+        gTransformBlocks( Context->State, (uint8_t const*)Buffer + i, numBlocks );
+        i += numBlocks * 64;
     }
 
-    memcpy( &Context->Buffer[j], &((uint8_t*)Buffer)[i], BufferSize - i );
+    // Keep the remainder for the next call or Finalise
+    memcpy( Context->Buffer, (uint8_t const*)Buffer + i, BufferSize - i );
+    STATS_END( STATS_SHA1, startCycles, BufferSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha1SetImplementation
+//
+//  Selects the block transform used by all SHA1 contexts. SHA1_IMPLEMENTATION_AUTO (the default) uses the SHA
+//  extensions when the processor supports them, otherwise the portable implementation. The others force a particular
+//  one, which is intended for testing and benchmarking. This must not be called while another thread is hashing.
+//  Returns 0 if successful, or -1 if the implementation is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Sha1SetImplementation
+    (
+        uint32_t            Implementation  // [in]
+    )
+{
+    char const*     name;
+
+    switch( Implementation )
+    {
+    case SHA1_IMPLEMENTATION_AUTO:
+        gTransformBlocks = NULL;
+        SelectImplementation( );
+        return 0;
+
+    case SHA1_IMPLEMENTATION_PORTABLE:
+        gTransformBlocks = PortableTransformBlocks( &name );
+        STATS_SET_BACKEND( STATS_SHA1, name );
+        return 0;
+
+#ifdef USE_SHANI_SHA1
+    case SHA1_IMPLEMENTATION_SHANI:
+        if( CpuHasShaNi( ) )
+        {
+            gTransformBlocks = TransformBlocksShaNi;
+            STATS_SET_BACKEND( STATS_SHA1, "shani" );
+            return 0;
+        }
+        return -1;
+#endif
+
+    default:
+        return -1;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -228,6 +546,7 @@ void
     )
 {
     uint32_t    i;
+    uint32_t    j;
     uint8_t     finalcount[8];
 
     for( i=0; i<8; i++ )
@@ -235,13 +554,20 @@ void
         finalcount[i] = (unsigned char)((Context->Count[(i >= 4 ? 0 : 1)]
          >> ((3-(i & 3)) * 8) ) & 255);  // Endian independent
     }
-    Sha1Update( Context, (uint8_t*)"\x80", 1 );
-    while( (Context->Count[0] & 504) != 448 )
+
+    // Pad in place: the '1' bit, zeros up to 56 bytes into a block, then the length. This may take two blocks.
+    j = (Context->Count[0] >> 3) & 63;
+    Context->Buffer[j++] = 0x80;
+    if( j > 56 )
     {
-        Sha1Update( Context, (uint8_t*)"\0", 1 );
+        memset( &Context->Buffer[j], 0, 64 - j );
+        gTransformBlocks( Context->State, Context->Buffer, 1 );
+        j = 0;
     }
+    memset( &Context->Buffer[j], 0, 56 - j );
+    memcpy( &Context->Buffer[56], finalcount, 8 );
+    gTransformBlocks( Context->State, Context->Buffer, 1 );
 
-    Sha1Update( Context, finalcount, 8 );  // Should cause a Sha1TransformFunction()
     for( i=0; i<SHA1_HASH_SIZE; i++ )
     {
         Digest->bytes[i] = (uint8_t)((Context->State[i>>2] >> ((3-(i & 3)) * 8) ) & 255);
@@ -267,3 +593,5 @@ void
     Sha1Update( &context, Buffer, BufferSize );
     Sha1Finalise( &context, Digest );
 }
+
+#endif // WJCRYPTLIB_ISA_VARIANT
@@ -7,6 +7,8 @@
 //  and Ralph Giles <giles@ghostscript.com>
 //  Modified by WaterJuice retaining Public Domain license.
 //
+//  Depends on: CryptoLib_Cpu
+//
 //  This is free and unencumbered software released into the public domain - June 2013 waterjuice.org
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -38,6 +40,11 @@ typedef struct
     uint8_t      bytes [SHA1_HASH_SIZE];
 } SHA1_HASH;
 
+// Block transform implementations for Sha1SetImplementation
+#define SHA1_IMPLEMENTATION_AUTO        0       // SHA extensions if the processor has them, otherwise portable
+#define SHA1_IMPLEMENTATION_PORTABLE    1       // Portable C
+#define SHA1_IMPLEMENTATION_SHANI       2       // x86 SHA extensions (SHA1RNDS4 etc)
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -67,6 +74,20 @@ void
         uint32_t            BufferSize      // [in]
     );
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha1SetImplementation
+//
+//  Selects the block transform used by all SHA1 contexts. SHA1_IMPLEMENTATION_AUTO (the default) uses the SHA
+//  extensions when the processor supports them, otherwise the portable implementation. The others force a particular
+//  one, which is intended for testing and benchmarking. This must not be called while another thread is hashing.
+//  Returns 0 if successful, or -1 if the implementation is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Sha1SetImplementation
+    (
+        uint32_t            Implementation  // [in]
+    );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Sha1Finalise
 //
@@ -1,10 +1,12 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  WjCryptLib_Sha256
 //
-//  Implementation of SHA256 hash function.
+//  Implementation of SHA256 hash function, and SHA224 which differs only in initial state and digest size.
 //  Original author: Tom St Denis, tomstdenis@gmail.com, http://libtom.org
 //  Modified by WaterJuice retaining Public Domain license.
 //
+//  Depends on: CryptoLib_Cpu
+//
 //  This is free and unencumbered software released into the public domain - June 2013 waterjuice.org
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -13,6 +15,9 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_Sha256.h"
+#include "WjCryptLib_Stats.h"
+#include "WjCryptLib_Cpu.h"
+#include "WjCryptLib_IsaVariants.h"
 #include <memory.h>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -60,6 +65,14 @@ static const uint32_t K[64] = {
     0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
 };
 
+#ifndef WJCRYPTLIB_ISA_VARIANT
+// Initial state of SHA224 (FIPS 180-4 section 5.3.2)
+static const uint32_t gSha224InitialState[8] = {
+    0xc1059ed8UL, 0x367cd507UL, 0x3070dd17UL, 0xf70e5939UL,
+    0xffc00b31UL, 0x68581511UL, 0x64f98fa7UL, 0xbefa4fa4UL
+};
+#endif
+
 #define BLOCK_SIZE          64
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -76,70 +89,179 @@ static const uint32_t K[64] = {
 #define Gamma0( x )       (S(x, 7) ^ S(x, 18) ^ R(x, 3))
 #define Gamma1( x )       (S(x, 17) ^ S(x, 19) ^ R(x, 10))
 
-#define Sha256Round( a, b, c, d, e, f, g, h, i )       \
-     t0 = h + Sigma1(e) + Ch(e, f, g) + K[i] + W[i];   \
+// One round. KW is the message word with the round constant added. The caller rotates the variable names rather than
+// moving the values: the new a is stored in h and d becomes e.
+#define Sha256Round( a, b, c, d, e, f, g, h, KW )      \
+     t0 = h + Sigma1(e) + Ch(e, f, g) + (KW);          \
      t1 = Sigma0(a) + Maj(a, b, c);                    \
      d += t0;                                          \
      h  = t0 + t1;
 
+// Eight rounds starting at round i, after which the names are back in their original positions. KW( n ) gives the
+// message word with the round constant added for round n.
+#define Sha256EightRounds( i, KW )                                  \
+    Sha256Round( a, b, c, d, e, f, g, h, KW( (i) + 0 ) )            \
+    Sha256Round( h, a, b, c, d, e, f, g, KW( (i) + 1 ) )            \
+    Sha256Round( g, h, a, b, c, d, e, f, KW( (i) + 2 ) )            \
+    Sha256Round( f, g, h, a, b, c, d, e, KW( (i) + 3 ) )            \
+    Sha256Round( e, f, g, h, a, b, c, d, KW( (i) + 4 ) )            \
+    Sha256Round( d, e, f, g, h, a, b, c, KW( (i) + 5 ) )            \
+    Sha256Round( c, d, e, f, g, h, a, b, KW( (i) + 6 ) )            \
+    Sha256Round( b, c, d, e, f, g, h, a, KW( (i) + 7 ) )
+
+// Only 16 words of the message schedule are kept. W[n & 15] holds W[n-16] until round n replaces it with W[n].
+#define KW_LOADED( n )      ( K[n] + W[n] )
+#define KW_EXPANDED( n )    ( K[n] + ( W[(n) & 15] += Gamma1( W[((n) - 2) & 15] ) + W[((n) - 7) & 15]   \
+                                                    + Gamma0( W[((n) - 15) & 15] ) ) )
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  TransformFunction
 //
-//  Compress 512-bits
+//  Compresses NumBlocks consecutive 512-bit blocks. The 64 rounds are fully unrolled with the working variables
+//  rotated by name, and the message schedule is expanded as it is used in a 16 word window. The state is kept in
+//  locals across all the blocks and only written back to the context at the end. This does NOT update the length.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 static
 void
     TransformFunction
     (
         Sha256Context*      Context,
-        uint8_t const*      Buffer
+        uint8_t const*      Buffer,
+        uint32_t            NumBlocks
     )
 {
-    uint32_t    S[8];
-    uint32_t    W[64];
+    uint32_t    state[8];
+    uint32_t    a;
+    uint32_t    b;
+    uint32_t    c;
+    uint32_t    d;
+    uint32_t    e;
+    uint32_t    f;
+    uint32_t    g;
+    uint32_t    h;
+    uint32_t    W[16];
     uint32_t    t0;
     uint32_t    t1;
-    uint32_t    t;
+    uint32_t    block;
     int         i;
 
-    // Copy state into S
     for( i=0; i<8; i++ )
     {
-        S[i] = Context->state[i];
+        state[i] = Context->state[i];
     }
 
-    // Copy the state into 512-bits into W[0..15]
-    for( i=0; i<16; i++ )
+    for( block=0; block<NumBlocks; block++ )
     {
-        LOAD32H( W[i], Buffer + (4*i) );
+        // Copy the 512-bits into W[0..15]
+        for( i=0; i<16; i++ )
+        {
+            LOAD32H( W[i], Buffer + (4*i) );
+        }
+
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        f = state[5];
+        g = state[6];
+        h = state[7];
+
+        Sha256EightRounds(  0, KW_LOADED )
+        Sha256EightRounds(  8, KW_LOADED )
+        Sha256EightRounds( 16, KW_EXPANDED )
+        Sha256EightRounds( 24, KW_EXPANDED )
+        Sha256EightRounds( 32, KW_EXPANDED )
+        Sha256EightRounds( 40, KW_EXPANDED )
+        Sha256EightRounds( 48, KW_EXPANDED )
+        Sha256EightRounds( 56, KW_EXPANDED )
+
+        // Feedback
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+
+        Buffer += BLOCK_SIZE;
     }
 
-    // Fill W[16..63]
-    for( i=16; i<64; i++ )
+    for( i=0; i<8; i++ )
     {
-        W[i] = Gamma1( W[i-2]) + W[i-7] + Gamma0( W[i-15] ) + W[i-16];
+        Context->state[i] = state[i];
     }
+}
+
+#ifdef WJCRYPTLIB_ISA_VARIANT
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha256TransformAvx2, Sha256TransformAvx512
+//
+//  When this file is compiled for a higher instruction set level it only provides TransformFunction, under the
+//  variant's name. See WjCryptLib_IsaVariants.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    ISA_VARIANT_NAME( Sha256Transform )
+    (
+        Sha256Context*      Context,        // [in out]
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            NumBlocks       // [in]
+    )
+{
+    TransformFunction( Context, Buffer, NumBlocks );
+}
+
+#else
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Transform dispatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Compresses NumBlocks consecutive 512-bit blocks
+typedef void (*TransformFunc)( Sha256Context* Context, uint8_t const* Buffer, uint32_t NumBlocks );
 
-    // Compress
-    for( i=0; i<64; i++ )
+static TransformFunc    gTransform = NULL;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SelectTransform
+//
+//  Chooses on first use the copy of TransformFunction compiled for the highest instruction set level the processor
+//  supports, when the library is built with WJCRYPTLIB_ISA_VARIANTS (see CpuGetFeatures on threads racing through
+//  here).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    SelectTransform
+    (
+        void
+    )
+{
+    if( NULL != gTransform )
     {
-        Sha256Round( S[0], S[1], S[2], S[3], S[4], S[5], S[6], S[7], i );
-        t = S[7];
-        S[7] = S[6];
-        S[6] = S[5];
-        S[5] = S[4];
-        S[4] = S[3];
-        S[3] = S[2];
-        S[2] = S[1];
-        S[1] = S[0];
-        S[0] = t;
+        return;
     }
 
-    // Feedback
-    for( i=0; i<8; i++ )
+#ifdef WJCRYPTLIB_ISA_VARIANTS
+    switch( CpuGetIsaLevel( ) )
     {
-        Context->state[i] = Context->state[i] + S[i];
+    case CPU_ISA_AVX512:
+        gTransform = Sha256TransformAvx512;
+        STATS_SET_BACKEND( STATS_SHA256, "avx512" );
+        return;
+    case CPU_ISA_AVX2:
+        gTransform = Sha256TransformAvx2;
+        STATS_SET_BACKEND( STATS_SHA256, "avx2" );
+        return;
+    default:
+        break;
     }
+#endif
+
+    gTransform = TransformFunction;
+    STATS_SET_BACKEND( STATS_SHA256, "portable" );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -167,6 +289,8 @@ void
     Context->state[5] = 0x9B05688CUL;
     Context->state[6] = 0x1F83D9ABUL;
     Context->state[7] = 0x5BE0CD19UL;
+
+    SelectTransform( );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -183,37 +307,47 @@ void
         uint32_t            BufferSize      // [in]
     )
 {
-    uint32_t n;
+    uint32_t    n = 0;
+    uint32_t    numBlocks;
+    STATS_BEGIN( startCycles );
 
     if( Context->curlen >= sizeof(Context->buf) )
     {
        return;
     }
 
-    while( BufferSize > 0 )
+    // Complete a partial block left over from a previous call
+    if( Context->curlen > 0 )
     {
-        if( Context->curlen == 0 && BufferSize >= BLOCK_SIZE )
+        n = MIN( BufferSize, (BLOCK_SIZE - Context->curlen) );
+        memcpy( Context->buf + Context->curlen, Buffer, (size_t)n );
+        Context->curlen += n;
+        Buffer = (uint8_t const*)Buffer + n;
+        BufferSize -= n;
+        if( Context->curlen < BLOCK_SIZE )
         {
-           TransformFunction( Context, (uint8_t*)Buffer );
-           Context->length += BLOCK_SIZE * 8;
-           Buffer = (uint8_t*)Buffer + BLOCK_SIZE;
-           BufferSize -= BLOCK_SIZE;
+            STATS_END( STATS_SHA256, startCycles, n );
+            return;
         }
-        else
-        {
-           n = MIN( BufferSize, (BLOCK_SIZE - Context->curlen) );
-           memcpy( Context->buf + Context->curlen, Buffer, (size_t)n );
-           Context->curlen += n;
-           Buffer = (uint8_t*)Buffer + n;
-           BufferSize -= n;
-           if( Context->curlen == BLOCK_SIZE )
-           {
-              TransformFunction( Context, Context->buf );
-              Context->length += 8*BLOCK_SIZE;
-              Context->curlen = 0;
-           }
-       }
+        gTransform( Context, Context->buf, 1 );
+        Context->length += 8*BLOCK_SIZE;
+        Context->curlen = 0;
     }
+
+    // Hash all the whole blocks directly from the caller's buffer in one call
+    numBlocks = BufferSize / BLOCK_SIZE;
+    if( numBlocks > 0 )
+    {
+        gTransform( Context, (uint8_t const*)Buffer, numBlocks );
+        Context->length += (uint64_t)numBlocks * BLOCK_SIZE * 8;
+        Buffer = (uint8_t const*)Buffer + ( numBlocks * BLOCK_SIZE );
+        BufferSize -= numBlocks * BLOCK_SIZE;
+    }
+
+    // Keep the remainder for the next call or Finalise
+    memcpy( Context->buf, Buffer, (size_t)BufferSize );
+    Context->curlen = BufferSize;
+    STATS_END( STATS_SHA256, startCycles, (uint64_t)n + (uint64_t)numBlocks * BLOCK_SIZE + BufferSize );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -251,7 +385,7 @@ void
         {
             Context->buf[Context->curlen++] = (uint8_t)0;
         }
-        TransformFunction(Context, Context->buf);
+        gTransform( Context, Context->buf, 1 );
         Context->curlen = 0;
     }
 
@@ -263,7 +397,7 @@ void
 
     // Store length
     STORE64H( Context->length, Context->buf+56 );
-    TransformFunction( Context, Context->buf );
+    gTransform( Context, Context->buf, 1 );
 
     // Copy output
     for( i=0; i<8; i++ )
@@ -292,3 +426,77 @@ void
     Sha256Update( &context, Buffer, BufferSize );
     Sha256Finalise( &context, Digest );
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha224Initialise
+//
+//  Initialises a SHA224 Context. Use this to initialise/reset a context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha224Initialise
+    (
+        Sha224Context*      Context         // [out]
+    )
+{
+    Sha256Initialise( Context );
+    memcpy( Context->state, gSha224InitialState, sizeof(Context->state) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha224Update
+//
+//  Adds data to the SHA224 context. This will process the data and update the internal state of the context. Keep on
+//  calling this function until all the data has been added. Then call Sha224Finalise to calculate the hash.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha224Update
+    (
+        Sha224Context*      Context,        // [in out]
+        void const*         Buffer,         // [in]
+        uint32_t            BufferSize      // [in]
+    )
+{
+    Sha256Update( Context, Buffer, BufferSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha224Finalise
+//
+//  Performs the final calculation of the hash and returns the digest (28 byte buffer containing 224bit hash). After
+//  calling this, Sha224Initialise must be used to reuse the context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha224Finalise
+    (
+        Sha224Context*      Context,        // [in out]
+        SHA224_HASH*        Digest          // [out]
+    )
+{
+    SHA256_HASH fullDigest;
+
+    Sha256Finalise( Context, &fullDigest );
+    memcpy( Digest->bytes, fullDigest.bytes, sizeof(Digest->bytes) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha224Calculate
+//
+//  Combines Sha224Initialise, Sha224Update, and Sha224Finalise into one function. Calculates the SHA224 hash of the
+//  buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha224Calculate
+    (
+        void  const*        Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        SHA224_HASH*        Digest          // [out]
+    )
+{
+    Sha224Context context;
+
+    Sha224Initialise( &context );
+    Sha224Update( &context, Buffer, BufferSize );
+    Sha224Finalise( &context, Digest );
+}
+
+#endif // WJCRYPTLIB_ISA_VARIANT
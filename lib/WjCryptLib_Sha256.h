@@ -1,7 +1,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  WjCryptLib_Sha256
 //
-//  Implementation of SHA256 hash function.
+//  Implementation of SHA256 hash function, and SHA224 which differs only in initial state and digest size.
 //  Original author: Tom St Denis, tomstdenis@gmail.com, http://libtom.org
 //  Modified by WaterJuice retaining Public Domain license.
 //
@@ -32,6 +32,16 @@ typedef struct
     uint8_t      bytes [SHA256_HASH_SIZE];
 } SHA256_HASH;
 
+// SHA224 is SHA256 with a different initial state and the digest truncated, so it shares the context and transform.
+typedef Sha256Context Sha224Context;
+
+#define SHA224_HASH_SIZE           ( 224 / 8 )
+
+typedef struct
+{
+    uint8_t      bytes [SHA224_HASH_SIZE];
+} SHA224_HASH;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -87,3 +97,55 @@ void
         uint32_t            BufferSize,     // [in]
         SHA256_HASH*        Digest          // [out]
     );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha224Initialise
+//
+//  Initialises a SHA224 Context. Use this to initialise/reset a context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha224Initialise
+    (
+        Sha224Context*      Context         // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha224Update
+//
+//  Adds data to the SHA224 context. This will process the data and update the internal state of the context. Keep on
+//  calling this function until all the data has been added. Then call Sha224Finalise to calculate the hash.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha224Update
+    (
+        Sha224Context*      Context,        // [in out]
+        void const*         Buffer,         // [in]
+        uint32_t            BufferSize      // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha224Finalise
+//
+//  Performs the final calculation of the hash and returns the digest (28 byte buffer containing 224bit hash). After
+//  calling this, Sha224Initialise must be used to reuse the context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha224Finalise
+    (
+        Sha224Context*      Context,        // [in out]
+        SHA224_HASH*        Digest          // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha224Calculate
+//
+//  Combines Sha224Initialise, Sha224Update, and Sha224Finalise into one function. Calculates the SHA224 hash of the
+//  buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha224Calculate
+    (
+        void  const*        Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        SHA224_HASH*        Digest          // [out]
+    );
@@ -1,10 +1,12 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  WjCryptLib_Sha512
 //
-//  Implementation of SHA512 hash function.
+//  Implementation of SHA512 hash function, and the SHA384, SHA512/224, and SHA512/256 variants of it.
 //  Original author: Tom St Denis, tomstdenis@gmail.com, http://libtom.org
 //  Modified by WaterJuice retaining Public Domain license.
 //
+//  Depends on: CryptoLib_Cpu
+//
 //  This is free and unencumbered software released into the public domain - June 2013 waterjuice.org
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -13,8 +15,18 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "WjCryptLib_Sha512.h"
+#include "WjCryptLib_Stats.h"
+#include "WjCryptLib_Cpu.h"
+#include <stdbool.h>
 #include <memory.h>
 
+// The AVX2 and AVX-512 code is only built for x86 with gcc or clang, which allow individual functions to be compiled
+// for those instruction sets while the rest of the file targets the baseline instruction set.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+    #define USE_SIMD_SHA512
+    #include <immintrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  MACROS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -63,8 +75,59 @@ static const uint64_t K[80] = {
     0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
 };
 
+// Initial states of the truncated variants (FIPS 180-4 sections 5.3.4 and 5.3.6)
+static const uint64_t gSha384InitialState[8] = {
+    0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL, 0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+    0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL, 0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+};
+
+static const uint64_t gSha512_224InitialState[8] = {
+    0x8c3d37c819544da2ULL, 0x73e1996689dcd4d6ULL, 0x1dfab7ae32ff9c82ULL, 0x679dd514582f9fcfULL,
+    0x0f6d2b697bd44da8ULL, 0x77e36f7304c48942ULL, 0x3f9d85a86a1d36c8ULL, 0x1112e6ad91d692a1ULL
+};
+
+static const uint64_t gSha512_256InitialState[8] = {
+    0x22312194fc2bf72cULL, 0x9f555fa3c84c64c2ULL, 0x2393b86b6f53b151ULL, 0x963877195940eabdULL,
+    0x96283ee2a88effe3ULL, 0xbe5e1e2553863992ULL, 0x2b0199fc2c85b8aaULL, 0x0eb72ddc81c52ca2ULL
+};
+
 #define BLOCK_SIZE          128
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Processes NumBlocks consecutive 128 byte blocks
+typedef void (*TransformBlocksFunc)( uint64_t State [8], uint8_t const* Buffer, uint32_t NumBlocks );
+
+// The most lanes (independent messages) any multi-buffer transform processes at once
+#define MULTIPLE_MAX_LANES      8
+
+// Performs one SHA512 block on each of the lanes. State holds the 8 state words of each lane and Words holds the 16
+// message words of each lane's block, transposed so that each row is one word across all the lanes.
+typedef void (*TransformLanesFunc)(
+    uint64_t State [8][MULTIPLE_MAX_LANES], uint64_t const Words [16][MULTIPLE_MAX_LANES] );
+
+typedef struct
+{
+    TransformBlocksFunc     TransformBlocks;
+    uint32_t                NumLanes;
+    TransformLanesFunc      TransformLanes;         // NULL to use Sha512Calculate on each buffer
+    char const*             Name;
+} ImplementationDetails;
+
+// Progress of one message within a multi-buffer calculation
+typedef struct
+{
+    bool                Active;
+    uint32_t            BufferIndex;
+    uint8_t const*      Data;                   // Next whole block of the caller's buffer
+    uint32_t            WholeBlocksLeft;
+    uint32_t            TailBlocksLeft;
+    uint32_t            TailIndex;
+    uint8_t             Tail [2 * BLOCK_SIZE];  // Last partial block with padding and length (1 or 2 blocks)
+} MultipleLane;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  INTERNAL FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -79,66 +142,554 @@ static const uint64_t K[80] = {
 #define Gamma0( x )       (S(x, 1) ^ S(x, 8) ^ R(x, 7))
 #define Gamma1( x )       (S(x, 19) ^ S(x, 61) ^ R(x, 6))
 
-#define Sha512Round( a, b, c, d, e, f, g, h, i )       \
-     t0 = h + Sigma1(e) + Ch(e, f, g) + K[i] + W[i];   \
+// One round. KW is the message word with the round constant added. The caller rotates the variable names rather than
+// moving the values: the new a is stored in h and d becomes e.
+#define Sha512Round( a, b, c, d, e, f, g, h, KW )      \
+     t0 = h + Sigma1(e) + Ch(e, f, g) + (KW);          \
      t1 = Sigma0(a) + Maj(a, b, c);                    \
      d += t0;                                          \
      h  = t0 + t1;
 
+// Eight rounds starting at round i, after which the names are back in their original positions. KW( n ) gives the
+// message word with the round constant added for round n.
+#define Sha512EightRounds( i, KW )                                  \
+    Sha512Round( a, b, c, d, e, f, g, h, KW( (i) + 0 ) )            \
+    Sha512Round( h, a, b, c, d, e, f, g, KW( (i) + 1 ) )            \
+    Sha512Round( g, h, a, b, c, d, e, f, KW( (i) + 2 ) )            \
+    Sha512Round( f, g, h, a, b, c, d, e, KW( (i) + 3 ) )            \
+    Sha512Round( e, f, g, h, a, b, c, d, KW( (i) + 4 ) )            \
+    Sha512Round( d, e, f, g, h, a, b, c, KW( (i) + 5 ) )            \
+    Sha512Round( c, d, e, f, g, h, a, b, KW( (i) + 6 ) )            \
+    Sha512Round( b, c, d, e, f, g, h, a, KW( (i) + 7 ) )
+
+// The portable transform keeps only 16 words of the message schedule. W[n & 15] holds W[n-16] until round n
+// replaces it with W[n].
+#define KW_LOADED( n )      ( K[n] + W[n] )
+#define KW_EXPANDED( n )    ( K[n] + ( W[(n) & 15] += Gamma1( W[((n) - 2) & 15] ) + W[((n) - 7) & 15]   \
+                                                    + Gamma0( W[((n) - 15) & 15] ) ) )
+
+// Loads the working variables from the state, and adds them back into it after a block
+#define LoadWorkingVariables( State )                                           \
+    a = State[0]; b = State[1]; c = State[2]; d = State[3];                     \
+    e = State[4]; f = State[5]; g = State[6]; h = State[7];
+
+#define AddWorkingVariables( State )                                            \
+    State[0] += a; State[1] += b; State[2] += c; State[3] += d;                 \
+    State[4] += e; State[5] += f; State[6] += g; State[7] += h;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformBlocksPortable
+//
+//  Compresses NumBlocks consecutive 1024-bit blocks. The 80 rounds are fully unrolled with the working variables
+//  rotated by name, and the message schedule is expanded as it is used in a 16 word window.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    TransformBlocksPortable
+    (
+        uint64_t            State [8],      // [in out]
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            NumBlocks       // [in]
+    )
+{
+    uint64_t    a;
+    uint64_t    b;
+    uint64_t    c;
+    uint64_t    d;
+    uint64_t    e;
+    uint64_t    f;
+    uint64_t    g;
+    uint64_t    h;
+    uint64_t    W[16];
+    uint64_t    t0;
+    uint64_t    t1;
+    uint32_t    block;
+    int         i;
+
+    for( block=0; block<NumBlocks; block++ )
+    {
+        for( i=0; i<16; i++ )
+        {
+            LOAD64H( W[i], Buffer + (8*i) );
+        }
+
+        LoadWorkingVariables( State )
+
+        Sha512EightRounds(  0, KW_LOADED )
+        Sha512EightRounds(  8, KW_LOADED )
+        Sha512EightRounds( 16, KW_EXPANDED )
+        Sha512EightRounds( 24, KW_EXPANDED )
+        Sha512EightRounds( 32, KW_EXPANDED )
+        Sha512EightRounds( 40, KW_EXPANDED )
+        Sha512EightRounds( 48, KW_EXPANDED )
+        Sha512EightRounds( 56, KW_EXPANDED )
+        Sha512EightRounds( 64, KW_EXPANDED )
+        Sha512EightRounds( 72, KW_EXPANDED )
+
+        AddWorkingVariables( State )
+
+        Buffer += BLOCK_SIZE;
+    }
+}
+
+#ifdef USE_SIMD_SHA512
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//  TransformFunction
+//  INTERNAL FUNCTIONS - AVX2 and AVX-512
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define AVX2_ROR64( x, n )      _mm256_or_si256( _mm256_srli_epi64( x, n ), _mm256_slli_epi64( x, 64 - (n) ) )
+#define AVX2_GAMMA0( x )        _mm256_xor_si256( _mm256_xor_si256( AVX2_ROR64( x, 1 ), AVX2_ROR64( x, 8 ) ),   \
+                                    _mm256_srli_epi64( x, 7 ) )
+#define AVX2_GAMMA1( x )        _mm256_xor_si256( _mm256_xor_si256( AVX2_ROR64( x, 19 ), AVX2_ROR64( x, 61 ) ), \
+                                    _mm256_srli_epi64( x, 6 ) )
+
+#define SSE_ROR64( x, n )       _mm_or_si128( _mm_srli_epi64( x, n ), _mm_slli_epi64( x, 64 - (n) ) )
+#define SSE_GAMMA0( x )         _mm_xor_si128( _mm_xor_si128( SSE_ROR64( x, 1 ), SSE_ROR64( x, 8 ) ),   \
+                                    _mm_srli_epi64( x, 7 ) )
+#define SSE_GAMMA1( x )         _mm_xor_si128( _mm_xor_si128( SSE_ROR64( x, 19 ), SSE_ROR64( x, 61 ) ), \
+                                    _mm_srli_epi64( x, 6 ) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ScheduleAvx2
 //
-//  Compress 1024-bits
+//  Computes the message schedule W[0..79] for a block using AVX2, with the round constants added. The block is loaded
+//  and byte swapped four words at a time. As W[i] depends on W[i-2] the expansion produces two words per step, and
+//  the round constants are added four at a time at the end, leaving the rounds with a single addition.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "avx2" ) ))
 static
 void
-    TransformFunction
+    ScheduleAvx2
     (
-        Sha512Context*          Context,
-        uint8_t const*          Buffer
+        uint64_t            WK [80],        // [out]
+        uint8_t const*      Buffer          // [in]
     )
 {
-    uint64_t    S[8];
-    uint64_t    W[80];
+    __m256i const   byteSwapMask = _mm256_set_epi64x( 0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL,
+                                                      0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL );
+    __m128i         w;
+    int             i;
+
+    for( i=0; i<16; i+=4 )
+    {
+        _mm256_storeu_si256( (__m256i*)(WK + i),
+            _mm256_shuffle_epi8( _mm256_loadu_si256( (__m256i const*)(Buffer + (8*i)) ), byteSwapMask ) );
+    }
+
+    for( i=16; i<80; i+=2 )
+    {
+        w = _mm_add_epi64( SSE_GAMMA1( _mm_loadu_si128( (__m128i const*)(WK + i - 2) ) ),
+                           _mm_loadu_si128( (__m128i const*)(WK + i - 7) ) );
+        w = _mm_add_epi64( w, SSE_GAMMA0( _mm_loadu_si128( (__m128i const*)(WK + i - 15) ) ) );
+        w = _mm_add_epi64( w, _mm_loadu_si128( (__m128i const*)(WK + i - 16) ) );
+        _mm_storeu_si128( (__m128i*)(WK + i), w );
+    }
+
+    for( i=0; i<80; i+=4 )
+    {
+        _mm256_storeu_si256( (__m256i*)(WK + i), _mm256_add_epi64( _mm256_loadu_si256( (__m256i const*)(WK + i) ),
+            _mm256_loadu_si256( (__m256i const*)(K + i) ) ) );
+    }
+}
+
+// The scheduled transform reads the precomputed message words with the round constants added
+#define KW_SCHEDULED( n )   ( WK[n] )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformBlocksAvx2
+//
+//  Compresses NumBlocks consecutive 1024-bit blocks. The whole message schedule of each block is computed up front
+//  with ScheduleAvx2, then the rounds are the same as TransformBlocksPortable.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "avx2" ) ))
+static
+void
+    TransformBlocksAvx2
+    (
+        uint64_t            State [8],      // [in out]
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            NumBlocks       // [in]
+    )
+{
+    uint64_t    a;
+    uint64_t    b;
+    uint64_t    c;
+    uint64_t    d;
+    uint64_t    e;
+    uint64_t    f;
+    uint64_t    g;
+    uint64_t    h;
+    uint64_t    WK[80];
     uint64_t    t0;
     uint64_t    t1;
+    uint32_t    block;
+
+    for( block=0; block<NumBlocks; block++ )
+    {
+        ScheduleAvx2( WK, Buffer );
+
+        LoadWorkingVariables( State )
+
+        Sha512EightRounds(  0, KW_SCHEDULED )
+        Sha512EightRounds(  8, KW_SCHEDULED )
+        Sha512EightRounds( 16, KW_SCHEDULED )
+        Sha512EightRounds( 24, KW_SCHEDULED )
+        Sha512EightRounds( 32, KW_SCHEDULED )
+        Sha512EightRounds( 40, KW_SCHEDULED )
+        Sha512EightRounds( 48, KW_SCHEDULED )
+        Sha512EightRounds( 56, KW_SCHEDULED )
+        Sha512EightRounds( 64, KW_SCHEDULED )
+        Sha512EightRounds( 72, KW_SCHEDULED )
+
+        AddWorkingVariables( State )
+
+        Buffer += BLOCK_SIZE;
+    }
+}
+
+// Multi-buffer round functions. Each lane of a vector is a different message.
+#define AVX2_CH( x, y, z )      _mm256_xor_si256( z, _mm256_and_si256( x, _mm256_xor_si256( y, z ) ) )
+#define AVX2_MAJ( x, y, z )     _mm256_or_si256( _mm256_and_si256( _mm256_or_si256( x, y ), z ),                 \
+                                    _mm256_and_si256( x, y ) )
+#define AVX2_SIGMA0( x )        _mm256_xor_si256( _mm256_xor_si256( AVX2_ROR64( x, 28 ), AVX2_ROR64( x, 34 ) ), \
+                                    AVX2_ROR64( x, 39 ) )
+#define AVX2_SIGMA1( x )        _mm256_xor_si256( _mm256_xor_si256( AVX2_ROR64( x, 14 ), AVX2_ROR64( x, 18 ) ), \
+                                    AVX2_ROR64( x, 41 ) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformLanesAvx2
+//
+//  Performs one SHA512 block on each of 4 lanes.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "avx2" ) ))
+static
+void
+    TransformLanesAvx2
+    (
+        uint64_t            State [8][MULTIPLE_MAX_LANES],      // [in out]
+        uint64_t const      Words [16][MULTIPLE_MAX_LANES]      // [in]
+    )
+{
+    __m256i     s [8];
+    __m256i     W [16];
+    __m256i     t0;
+    __m256i     t1;
     int         i;
 
-    // Copy state into S
     for( i=0; i<8; i++ )
     {
-        S[i] = Context->state[i];
+        s[i] = _mm256_loadu_si256( (__m256i const*)State[i] );
     }
 
-    // Copy the state into 1024-bits into W[0..15]
-    for( i=0; i<16; i++ )
+    for( i=0; i<80; i++ )
     {
-        LOAD64H(W[i], Buffer + (8*i));
+        if( i < 16 )
+        {
+            W[i] = _mm256_loadu_si256( (__m256i const*)Words[i] );
+        }
+        else
+        {
+            W[i&15] = _mm256_add_epi64( _mm256_add_epi64( AVX2_GAMMA1( W[(i-2)&15] ), W[(i-7)&15] ),
+                                        _mm256_add_epi64( AVX2_GAMMA0( W[(i-15)&15] ), W[i&15] ) );
+        }
+
+        t0 = _mm256_add_epi64( _mm256_add_epi64( s[7], AVX2_SIGMA1( s[4] ) ),
+                               _mm256_add_epi64( AVX2_CH( s[4], s[5], s[6] ),
+                                                 _mm256_add_epi64( _mm256_set1_epi64x( (long long)K[i] ), W[i&15] ) ) );
+        t1 = _mm256_add_epi64( AVX2_SIGMA0( s[0] ), AVX2_MAJ( s[0], s[1], s[2] ) );
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = s[4];
+        s[4] = _mm256_add_epi64( s[3], t0 );
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = s[0];
+        s[0] = _mm256_add_epi64( t0, t1 );
     }
 
-    // Fill W[16..79]
-    for( i=16; i<80; i++ )
+    for( i=0; i<8; i++ )
     {
-        W[i] = Gamma1(W[i - 2]) + W[i - 7] + Gamma0(W[i - 15]) + W[i - 16];
+        _mm256_storeu_si256( (__m256i*)State[i],
+            _mm256_add_epi64( s[i], _mm256_loadu_si256( (__m256i const*)State[i] ) ) );
     }
+}
+
+// AVX-512 has native rotates, and Ch and Maj are each a single ternary logic instruction.
+#define AVX512_CH( x, y, z )    _mm512_ternarylogic_epi64( x, y, z, 0xca )
+#define AVX512_MAJ( x, y, z )   _mm512_ternarylogic_epi64( x, y, z, 0xe8 )
+#define AVX512_XOR3( x, y, z )  _mm512_ternarylogic_epi64( x, y, z, 0x96 )
+#define AVX512_SIGMA0( x )      AVX512_XOR3( _mm512_ror_epi64( x, 28 ), _mm512_ror_epi64( x, 34 ),     \
+                                             _mm512_ror_epi64( x, 39 ) )
+#define AVX512_SIGMA1( x )      AVX512_XOR3( _mm512_ror_epi64( x, 14 ), _mm512_ror_epi64( x, 18 ),     \
+                                             _mm512_ror_epi64( x, 41 ) )
+#define AVX512_GAMMA0( x )      AVX512_XOR3( _mm512_ror_epi64( x, 1 ), _mm512_ror_epi64( x, 8 ),       \
+                                             _mm512_srli_epi64( x, 7 ) )
+#define AVX512_GAMMA1( x )      AVX512_XOR3( _mm512_ror_epi64( x, 19 ), _mm512_ror_epi64( x, 61 ),     \
+                                             _mm512_srli_epi64( x, 6 ) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TransformLanesAvx512
+//
+//  Performs one SHA512 block on each of 8 lanes.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+__attribute__(( target( "avx512f" ) ))
+static
+void
+    TransformLanesAvx512
+    (
+        uint64_t            State [8][MULTIPLE_MAX_LANES],      // [in out]
+        uint64_t const      Words [16][MULTIPLE_MAX_LANES]      // [in]
+    )
+{
+    __m512i     s [8];
+    __m512i     W [16];
+    __m512i     t0;
+    __m512i     t1;
+    int         i;
 
-    // Compress
-     for( i=0; i<80; i+=8 )
-     {
-         Sha512Round(S[0],S[1],S[2],S[3],S[4],S[5],S[6],S[7],i+0);
-         Sha512Round(S[7],S[0],S[1],S[2],S[3],S[4],S[5],S[6],i+1);
-         Sha512Round(S[6],S[7],S[0],S[1],S[2],S[3],S[4],S[5],i+2);
-         Sha512Round(S[5],S[6],S[7],S[0],S[1],S[2],S[3],S[4],i+3);
-         Sha512Round(S[4],S[5],S[6],S[7],S[0],S[1],S[2],S[3],i+4);
-         Sha512Round(S[3],S[4],S[5],S[6],S[7],S[0],S[1],S[2],i+5);
-         Sha512Round(S[2],S[3],S[4],S[5],S[6],S[7],S[0],S[1],i+6);
-         Sha512Round(S[1],S[2],S[3],S[4],S[5],S[6],S[7],S[0],i+7);
-     }
-
-    // Feedback
     for( i=0; i<8; i++ )
     {
-        Context->state[i] = Context->state[i] + S[i];
+        s[i] = _mm512_loadu_si512( (void const*)State[i] );
+    }
+
+    for( i=0; i<80; i++ )
+    {
+        if( i < 16 )
+        {
+            W[i] = _mm512_loadu_si512( (void const*)Words[i] );
+        }
+        else
+        {
+            W[i&15] = _mm512_add_epi64( _mm512_add_epi64( AVX512_GAMMA1( W[(i-2)&15] ), W[(i-7)&15] ),
+                                        _mm512_add_epi64( AVX512_GAMMA0( W[(i-15)&15] ), W[i&15] ) );
+        }
+
+        t0 = _mm512_add_epi64( _mm512_add_epi64( s[7], AVX512_SIGMA1( s[4] ) ),
+                               _mm512_add_epi64( AVX512_CH( s[4], s[5], s[6] ),
+                                                 _mm512_add_epi64( _mm512_set1_epi64( (long long)K[i] ), W[i&15] ) ) );
+        t1 = _mm512_add_epi64( AVX512_SIGMA0( s[0] ), AVX512_MAJ( s[0], s[1], s[2] ) );
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = s[4];
+        s[4] = _mm512_add_epi64( s[3], t0 );
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = s[0];
+        s[0] = _mm512_add_epi64( t0, t1 );
+    }
+
+    for( i=0; i<8; i++ )
+    {
+        _mm512_storeu_si512( (void*)State[i], _mm512_add_epi64( s[i], _mm512_loadu_si512( (void const*)State[i] ) ) );
+    }
+}
+
+#endif // USE_SIMD_SHA512
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Dispatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static ImplementationDetails const      gPortable = { TransformBlocksPortable, 1, NULL, "portable" };
+#ifdef USE_SIMD_SHA512
+static ImplementationDetails const      gAvx2 = { TransformBlocksAvx2, 4, TransformLanesAvx2, "avx2" };
+// AVX-512F processors all have AVX2, which is used for the single stream schedule.
+static ImplementationDetails const      gAvx512 = { TransformBlocksAvx2, 8, TransformLanesAvx512, "avx512" };
+#endif
+
+// Chosen on first use (see CpuGetFeatures on threads racing to set it)
+static ImplementationDetails const*     gImplementation = NULL;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetImplementation
+//
+//  Returns one of the implementations, or NULL if it is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+ImplementationDetails const*
+    GetImplementation
+    (
+        uint32_t                Implementation      // [in]
+    )
+{
+#ifdef USE_SIMD_SHA512
+    uint32_t    features = CpuGetFeatures( );
+    bool        hasAvx2 = ( 0 != (features & CPU_FEATURE_AVX2) );
+    bool        hasAvx512 = ( 0 != (features & CPU_FEATURE_AVX512F) );
+
+    if( SHA512_IMPLEMENTATION_AUTO == Implementation )
+    {
+        Implementation = ( hasAvx512 && hasAvx2 ) ? SHA512_IMPLEMENTATION_AVX512
+                       : hasAvx2                ? SHA512_IMPLEMENTATION_AVX2
+                       :                          SHA512_IMPLEMENTATION_PORTABLE;
+    }
+
+    switch( Implementation )
+    {
+    case SHA512_IMPLEMENTATION_AVX2:    return hasAvx2 ? &gAvx2 : NULL;
+    case SHA512_IMPLEMENTATION_AVX512:  return ( hasAvx512 && hasAvx2 ) ? &gAvx512 : NULL;
+    default:                            break;
+    }
+#endif
+
+    if( SHA512_IMPLEMENTATION_AUTO == Implementation || SHA512_IMPLEMENTATION_PORTABLE == Implementation )
+    {
+        return &gPortable;
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StartLane
+//
+//  Sets up a lane to hash a buffer. The whole blocks are read directly from the buffer, the remaining bytes are
+//  copied into the lane's tail along with the padding and the length.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    StartLane
+    (
+        MultipleLane*       Lane,                               // [out]
+        uint64_t            State [8][MULTIPLE_MAX_LANES],      // [out]
+        uint32_t            LaneIndex,                          // [in]
+        uint32_t            BufferIndex,                        // [in]
+        void const*         Buffer,                             // [in]
+        uint32_t            BufferSize                          // [in]
+    )
+{
+    static uint64_t const   initialState [8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL };
+    uint32_t    remainder = BufferSize % BLOCK_SIZE;
+    uint64_t    bitLength = (uint64_t)BufferSize * 8;
+    uint32_t    tailSize;
+    uint32_t    i;
+
+    Lane->Active = true;
+    Lane->BufferIndex = BufferIndex;
+    Lane->Data = (uint8_t const*)Buffer;
+    Lane->WholeBlocksLeft = BufferSize / BLOCK_SIZE;
+    Lane->TailBlocksLeft = ( remainder + 1 + 16 > BLOCK_SIZE ) ? 2 : 1;
+    Lane->TailIndex = 0;
+
+    // The length is 128 bits, of which only the low 64 can be non zero.
+    tailSize = Lane->TailBlocksLeft * BLOCK_SIZE;
+    memset( Lane->Tail, 0, tailSize );
+    memcpy( Lane->Tail, (uint8_t const*)Buffer + (BufferSize - remainder), remainder );
+    Lane->Tail[remainder] = 0x80;
+    STORE64H( bitLength, Lane->Tail + tailSize - 8 );
+
+    for( i=0; i<8; i++ )
+    {
+        State[i][LaneIndex] = initialState[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CalculateMultipleLanes
+//
+//  Hashes the buffers with a multi-buffer transform. Each lane works through one buffer; as soon as a lane finishes
+//  its digest is written and it starts on the next buffer not yet hashed, so buffers of different lengths keep all
+//  the lanes busy until the last few.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    CalculateMultipleLanes
+    (
+        ImplementationDetails const*    Details,            // [in]
+        void const* const               Buffers [],         // [in]
+        uint32_t const                  BufferSizes [],     // [in]
+        uint32_t                        NumBuffers,         // [in]
+        SHA512_HASH                     Digests []          // [out]
+    )
+{
+    static uint8_t const    idleBlock [BLOCK_SIZE] = { 0 };
+    MultipleLane            lanes [MULTIPLE_MAX_LANES];
+    uint64_t                state [8][MULTIPLE_MAX_LANES];
+    uint64_t                words [16][MULTIPLE_MAX_LANES];
+    uint8_t const*          block;
+    uint32_t                nextBuffer = 0;
+    uint32_t                numActive;
+    uint32_t                lane;
+    uint32_t                i;
+
+    memset( state, 0, sizeof(state) );
+    for( lane=0; lane<MULTIPLE_MAX_LANES; lane++ )
+    {
+        lanes[lane].Active = false;
+    }
+
+    for( ;; )
+    {
+        // Give any idle lanes the next buffers, and gather each lane's next block into the word rows.
+        numActive = 0;
+        for( lane=0; lane<Details->NumLanes; lane++ )
+        {
+            if( !lanes[lane].Active && nextBuffer < NumBuffers )
+            {
+                StartLane( &lanes[lane], state, lane, nextBuffer, Buffers[nextBuffer], BufferSizes[nextBuffer] );
+                nextBuffer += 1;
+            }
+
+            if( !lanes[lane].Active )
+            {
+                block = idleBlock;
+            }
+            else if( lanes[lane].WholeBlocksLeft > 0 )
+            {
+                block = lanes[lane].Data;
+                numActive += 1;
+            }
+            else
+            {
+                block = lanes[lane].Tail + (lanes[lane].TailIndex * BLOCK_SIZE);
+                numActive += 1;
+            }
+
+            for( i=0; i<16; i++ )
+            {
+                LOAD64H( words[i][lane], block + (8*i) );
+            }
+        }
+
+        if( 0 == numActive )
+        {
+            break;
+        }
+
+        Details->TransformLanes( state, (uint64_t const (*)[MULTIPLE_MAX_LANES])words );
+
+        // Advance each lane, and output the digests of those that have finished.
+        for( lane=0; lane<Details->NumLanes; lane++ )
+        {
+            MultipleLane* current = &lanes[lane];
+
+            if( !current->Active )
+            {
+                continue;
+            }
+
+            if( current->WholeBlocksLeft > 0 )
+            {
+                current->Data += BLOCK_SIZE;
+                current->WholeBlocksLeft -= 1;
+            }
+            else
+            {
+                current->TailIndex += 1;
+                current->TailBlocksLeft -= 1;
+                if( 0 == current->TailBlocksLeft )
+                {
+                    for( i=0; i<8; i++ )
+                    {
+                        STORE64H( state[i][lane], Digests[current->BufferIndex].bytes + (8*i) );
+                    }
+                    current->Active = false;
+                }
+            }
+        }
     }
 }
 
@@ -167,6 +718,12 @@ void
     Context->state[5] = 0x9b05688c2b3e6c1fULL;
     Context->state[6] = 0x1f83d9abfb41bd6bULL;
     Context->state[7] = 0x5be0cd19137e2179ULL;
+
+    if( NULL == gImplementation )
+    {
+        gImplementation = GetImplementation( SHA512_IMPLEMENTATION_AUTO );
+        STATS_SET_BACKEND( STATS_SHA512, gImplementation->Name );
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -183,37 +740,47 @@ void
         uint32_t            BufferSize      // [in]
     )
 {
-    uint32_t    n;
+    uint32_t    n = 0;
+    uint32_t    numBlocks;
+    STATS_BEGIN( startCycles );
 
     if( Context->curlen >= sizeof(Context->buf) )
     {
        return;
     }
 
-    while( BufferSize > 0 )
+    // Complete a partial block left over from a previous call
+    if( Context->curlen > 0 )
     {
-        if( Context->curlen == 0 && BufferSize >= BLOCK_SIZE )
+        n = MIN( BufferSize, (BLOCK_SIZE - Context->curlen) );
+        memcpy( Context->buf + Context->curlen, Buffer, (size_t)n );
+        Context->curlen += n;
+        Buffer = (uint8_t const*)Buffer + n;
+        BufferSize -= n;
+        if( Context->curlen < BLOCK_SIZE )
         {
-           TransformFunction( Context, (uint8_t *)Buffer );
-           Context->length += BLOCK_SIZE * 8;
-           Buffer = (uint8_t*)Buffer + BLOCK_SIZE;
-           BufferSize -= BLOCK_SIZE;
+            STATS_END( STATS_SHA512, startCycles, n );
+            return;
         }
-        else
-        {
-           n = MIN( BufferSize, (BLOCK_SIZE - Context->curlen) );
-           memcpy( Context->buf + Context->curlen, Buffer, (size_t)n );
-           Context->curlen += n;
-           Buffer = (uint8_t*)Buffer + n;
-           BufferSize -= n;
-           if( Context->curlen == BLOCK_SIZE )
-           {
-              TransformFunction( Context, Context->buf );
-              Context->length += 8*BLOCK_SIZE;
-              Context->curlen = 0;
-           }
-       }
+        gImplementation->TransformBlocks( Context->state, Context->buf, 1 );
+        Context->length += 8*BLOCK_SIZE;
+        Context->curlen = 0;
     }
+
+    // Hash all the whole blocks directly from the caller's buffer in one call
+    numBlocks = BufferSize / BLOCK_SIZE;
+    if( numBlocks > 0 )
+    {
+        gImplementation->TransformBlocks( Context->state, (uint8_t const*)Buffer, numBlocks );
+        Context->length += (uint64_t)numBlocks * BLOCK_SIZE * 8;
+        Buffer = (uint8_t const*)Buffer + ( numBlocks * BLOCK_SIZE );
+        BufferSize -= numBlocks * BLOCK_SIZE;
+    }
+
+    // Keep the remainder for the next call or Finalise
+    memcpy( Context->buf, Buffer, (size_t)BufferSize );
+    Context->curlen = BufferSize;
+    STATS_END( STATS_SHA512, startCycles, (uint64_t)n + (uint64_t)numBlocks * BLOCK_SIZE + BufferSize );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -251,7 +818,7 @@ void
         {
             Context->buf[Context->curlen++] = (uint8_t)0;
         }
-        TransformFunction( Context, Context->buf );
+        gImplementation->TransformBlocks( Context->state, Context->buf, 1 );
         Context->curlen = 0;
     }
 
@@ -265,7 +832,7 @@ void
 
     // Store length
     STORE64H( Context->length, Context->buf+120 );
-    TransformFunction( Context, Context->buf );
+    gImplementation->TransformBlocks( Context->state, Context->buf, 1 );
 
     // Copy output
     for( i=0; i<8; i++ )
@@ -294,3 +861,287 @@ void
     Sha512Update( &context, Buffer, BufferSize );
     Sha512Finalise( &context, Digest );
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512CalculateMultiple
+//
+//  Calculates the SHA512 hashes of NumBuffers independent buffers: Digests[i] is the SHA512 of BufferSizes[i] bytes
+//  of Buffers[i], identical to Sha512Calculate. The buffers may all be different lengths. Where the processor supports
+//  it several buffers are hashed at once in SIMD lanes (4 with AVX2, 8 with AVX-512).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512CalculateMultiple
+    (
+        void const* const   Buffers [],     // [in]
+        uint32_t const      BufferSizes [], // [in]
+        uint32_t            NumBuffers,     // [in]
+        SHA512_HASH         Digests []      // [out]
+    )
+{
+    ImplementationDetails const*    implementation = gImplementation;
+    uint32_t                        i;
+
+    if( NULL == implementation )
+    {
+        implementation = GetImplementation( SHA512_IMPLEMENTATION_AUTO );
+        gImplementation = implementation;
+        STATS_SET_BACKEND( STATS_SHA512, implementation->Name );
+    }
+
+    if( NULL == implementation->TransformLanes || NumBuffers < 2 )
+    {
+        for( i=0; i<NumBuffers; i++ )
+        {
+            Sha512Calculate( Buffers[i], BufferSizes[i], &Digests[i] );
+        }
+    }
+    else
+    {
+        STATS_BEGIN( startCycles );
+        CalculateMultipleLanes( implementation, Buffers, BufferSizes, NumBuffers, Digests );
+        STATS_END( STATS_SHA512, startCycles, StatsTotalSize( BufferSizes, NumBuffers ) );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512SetImplementation
+//
+//  Selects the implementation used for the message schedule of single stream hashing and for
+//  Sha512CalculateMultiple. SHA512_IMPLEMENTATION_AUTO (the default) uses the widest SIMD the processor supports.
+//  The others force a particular one, which is intended for testing and benchmarking. This must not be called while
+//  another thread is hashing.
+//  Returns 0 if successful, or -1 if the implementation is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Sha512SetImplementation
+    (
+        uint32_t            Implementation  // [in]
+    )
+{
+    ImplementationDetails const*    implementation = GetImplementation( Implementation );
+
+    if( NULL == implementation )
+    {
+        return -1;
+    }
+
+    gImplementation = implementation;
+    STATS_SET_BACKEND( STATS_SHA512, implementation->Name );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha384Initialise
+//
+//  Initialises a SHA384 Context. Use this to initialise/reset a context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha384Initialise
+    (
+        Sha384Context*      Context         // [out]
+    )
+{
+    Sha512Initialise( Context );
+    memcpy( Context->state, gSha384InitialState, sizeof(Context->state) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha384Update
+//
+//  Adds data to the SHA384 context. This will process the data and update the internal state of the context. Keep on
+//  calling this function until all the data has been added. Then call Sha384Finalise to calculate the hash.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha384Update
+    (
+        Sha384Context*      Context,        // [in out]
+        void const*         Buffer,         // [in]
+        uint32_t            BufferSize      // [in]
+    )
+{
+    Sha512Update( Context, Buffer, BufferSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha384Finalise
+//
+//  Performs the final calculation of the hash and returns the digest (48 byte buffer containing 384bit hash). After
+//  calling this, Sha384Initialise must be used to reuse the context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha384Finalise
+    (
+        Sha384Context*      Context,        // [in out]
+        SHA384_HASH*        Digest          // [out]
+    )
+{
+    SHA512_HASH fullDigest;
+
+    Sha512Finalise( Context, &fullDigest );
+    memcpy( Digest->bytes, fullDigest.bytes, sizeof(Digest->bytes) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha384Calculate
+//
+//  Combines Sha384Initialise, Sha384Update, and Sha384Finalise into one function. Calculates the SHA384 hash of the
+//  buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha384Calculate
+    (
+        void  const*        Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        SHA384_HASH*        Digest          // [out]
+    )
+{
+    Sha384Context context;
+
+    Sha384Initialise( &context );
+    Sha384Update( &context, Buffer, BufferSize );
+    Sha384Finalise( &context, Digest );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_224Initialise
+//
+//  Initialises a SHA512/224 Context. Use this to initialise/reset a context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_224Initialise
+    (
+        Sha512_224Context*  Context         // [out]
+    )
+{
+    Sha512Initialise( Context );
+    memcpy( Context->state, gSha512_224InitialState, sizeof(Context->state) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_224Update
+//
+//  Adds data to the SHA512/224 context. This will process the data and update the internal state of the context. Keep
+//  on calling this function until all the data has been added. Then call Sha512_224Finalise to calculate the hash.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_224Update
+    (
+        Sha512_224Context*  Context,        // [in out]
+        void const*         Buffer,         // [in]
+        uint32_t            BufferSize      // [in]
+    )
+{
+    Sha512Update( Context, Buffer, BufferSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_224Finalise
+//
+//  Performs the final calculation of the hash and returns the digest (28 byte buffer containing 224bit hash). After
+//  calling this, Sha512_224Initialise must be used to reuse the context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_224Finalise
+    (
+        Sha512_224Context*  Context,        // [in out]
+        SHA512_224_HASH*    Digest          // [out]
+    )
+{
+    SHA512_HASH fullDigest;
+
+    Sha512Finalise( Context, &fullDigest );
+    memcpy( Digest->bytes, fullDigest.bytes, sizeof(Digest->bytes) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_224Calculate
+//
+//  Combines Sha512_224Initialise, Sha512_224Update, and Sha512_224Finalise into one function. Calculates the SHA512/224
+//  hash of the buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_224Calculate
+    (
+        void  const*        Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        SHA512_224_HASH*    Digest          // [out]
+    )
+{
+    Sha512_224Context context;
+
+    Sha512_224Initialise( &context );
+    Sha512_224Update( &context, Buffer, BufferSize );
+    Sha512_224Finalise( &context, Digest );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_256Initialise
+//
+//  Initialises a SHA512/256 Context. Use this to initialise/reset a context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_256Initialise
+    (
+        Sha512_256Context*  Context         // [out]
+    )
+{
+    Sha512Initialise( Context );
+    memcpy( Context->state, gSha512_256InitialState, sizeof(Context->state) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_256Update
+//
+//  Adds data to the SHA512/256 context. This will process the data and update the internal state of the context. Keep
+//  on calling this function until all the data has been added. Then call Sha512_256Finalise to calculate the hash.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_256Update
+    (
+        Sha512_256Context*  Context,        // [in out]
+        void const*         Buffer,         // [in]
+        uint32_t            BufferSize      // [in]
+    )
+{
+    Sha512Update( Context, Buffer, BufferSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_256Finalise
+//
+//  Performs the final calculation of the hash and returns the digest (32 byte buffer containing 256bit hash). After
+//  calling this, Sha512_256Initialise must be used to reuse the context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_256Finalise
+    (
+        Sha512_256Context*  Context,        // [in out]
+        SHA512_256_HASH*    Digest          // [out]
+    )
+{
+    SHA512_HASH fullDigest;
+
+    Sha512Finalise( Context, &fullDigest );
+    memcpy( Digest->bytes, fullDigest.bytes, sizeof(Digest->bytes) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_256Calculate
+//
+//  Combines Sha512_256Initialise, Sha512_256Update, and Sha512_256Finalise into one function. Calculates the SHA512/256
+//  hash of the buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_256Calculate
+    (
+        void  const*        Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        SHA512_256_HASH*    Digest          // [out]
+    )
+{
+    Sha512_256Context context;
+
+    Sha512_256Initialise( &context );
+    Sha512_256Update( &context, Buffer, BufferSize );
+    Sha512_256Finalise( &context, Digest );
+}
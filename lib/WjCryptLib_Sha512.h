@@ -1,10 +1,12 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  WjCryptLib_Sha512
 //
-//  Implementation of SHA512 hash function.
+//  Implementation of SHA512 hash function, and the SHA384, SHA512/224, and SHA512/256 variants of it.
 //  Original author: Tom St Denis, tomstdenis@gmail.com, http://libtom.org
 //  Modified by WaterJuice retaining Public Domain license.
 //
+//  Depends on: CryptoLib_Cpu
+//
 //  This is free and unencumbered software released into the public domain - June 2013 waterjuice.org
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -32,6 +34,37 @@ typedef struct
     uint8_t      bytes [SHA512_HASH_SIZE];
 } SHA512_HASH;
 
+// SHA384, SHA512/224, and SHA512/256 are SHA512 with a different initial state and the digest truncated, so they
+// share the context and transform (and any SIMD implementation selected with Sha512SetImplementation).
+typedef Sha512Context Sha384Context;
+typedef Sha512Context Sha512_224Context;
+typedef Sha512Context Sha512_256Context;
+
+#define SHA384_HASH_SIZE           ( 384 / 8 )
+#define SHA512_224_HASH_SIZE       ( 224 / 8 )
+#define SHA512_256_HASH_SIZE       ( 256 / 8 )
+
+typedef struct
+{
+    uint8_t      bytes [SHA384_HASH_SIZE];
+} SHA384_HASH;
+
+typedef struct
+{
+    uint8_t      bytes [SHA512_224_HASH_SIZE];
+} SHA512_224_HASH;
+
+typedef struct
+{
+    uint8_t      bytes [SHA512_256_HASH_SIZE];
+} SHA512_256_HASH;
+
+// Implementations for Sha512SetImplementation
+#define SHA512_IMPLEMENTATION_AUTO          0       // Widest SIMD the processor supports
+#define SHA512_IMPLEMENTATION_PORTABLE      1       // Portable C, one buffer at a time
+#define SHA512_IMPLEMENTATION_AVX2          2       // x86 AVX2 schedule, 4 buffers at once
+#define SHA512_IMPLEMENTATION_AVX512        3       // x86 AVX2 schedule, AVX-512F 8 buffers at once
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -87,3 +120,190 @@ void
         uint32_t            BufferSize,     // [in]
         SHA512_HASH*        Digest          // [out]
     );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512CalculateMultiple
+//
+//  Calculates the SHA512 hashes of NumBuffers independent buffers: Digests[i] is the SHA512 of BufferSizes[i] bytes
+//  of Buffers[i], identical to Sha512Calculate. The buffers may all be different lengths. Where the processor supports
+//  it several buffers are hashed at once in SIMD lanes (4 with AVX2, 8 with AVX-512).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512CalculateMultiple
+    (
+        void const* const   Buffers [],     // [in]
+        uint32_t const      BufferSizes [], // [in]
+        uint32_t            NumBuffers,     // [in]
+        SHA512_HASH         Digests []      // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512SetImplementation
+//
+//  Selects the implementation used for the message schedule of single stream hashing and for
+//  Sha512CalculateMultiple. SHA512_IMPLEMENTATION_AUTO (the default) uses the widest SIMD the processor supports.
+//  The others force a particular one, which is intended for testing and benchmarking. This must not be called while
+//  another thread is hashing.
+//  Returns 0 if successful, or -1 if the implementation is not available on this processor or build.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    Sha512SetImplementation
+    (
+        uint32_t            Implementation  // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha384Initialise
+//
+//  Initialises a SHA384 Context. Use this to initialise/reset a context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha384Initialise
+    (
+        Sha384Context*      Context         // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha384Update
+//
+//  Adds data to the SHA384 context. This will process the data and update the internal state of the context. Keep on
+//  calling this function until all the data has been added. Then call Sha384Finalise to calculate the hash.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha384Update
+    (
+        Sha384Context*      Context,        // [in out]
+        void const*         Buffer,         // [in]
+        uint32_t            BufferSize      // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha384Finalise
+//
+//  Performs the final calculation of the hash and returns the digest (48 byte buffer containing 384bit hash). After
+//  calling this, Sha384Initialise must be used to reuse the context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha384Finalise
+    (
+        Sha384Context*      Context,        // [in out]
+        SHA384_HASH*        Digest          // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha384Calculate
+//
+//  Combines Sha384Initialise, Sha384Update, and Sha384Finalise into one function. Calculates the SHA384 hash of the
+//  buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha384Calculate
+    (
+        void  const*        Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        SHA384_HASH*        Digest          // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_224Initialise
+//
+//  Initialises a SHA512/224 Context. Use this to initialise/reset a context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_224Initialise
+    (
+        Sha512_224Context*  Context         // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_224Update
+//
+//  Adds data to the SHA512/224 context. This will process the data and update the internal state of the context. Keep
+//  on calling this function until all the data has been added. Then call Sha512_224Finalise to calculate the hash.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_224Update
+    (
+        Sha512_224Context*  Context,        // [in out]
+        void const*         Buffer,         // [in]
+        uint32_t            BufferSize      // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_224Finalise
+//
+//  Performs the final calculation of the hash and returns the digest (28 byte buffer containing 224bit hash). After
+//  calling this, Sha512_224Initialise must be used to reuse the context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_224Finalise
+    (
+        Sha512_224Context*  Context,        // [in out]
+        SHA512_224_HASH*    Digest          // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_224Calculate
+//
+//  Combines Sha512_224Initialise, Sha512_224Update, and Sha512_224Finalise into one function. Calculates the SHA512/224
+//  hash of the buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_224Calculate
+    (
+        void  const*        Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        SHA512_224_HASH*    Digest          // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_256Initialise
+//
+//  Initialises a SHA512/256 Context. Use this to initialise/reset a context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_256Initialise
+    (
+        Sha512_256Context*  Context         // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_256Update
+//
+//  Adds data to the SHA512/256 context. This will process the data and update the internal state of the context. Keep
+//  on calling this function until all the data has been added. Then call Sha512_256Finalise to calculate the hash.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_256Update
+    (
+        Sha512_256Context*  Context,        // [in out]
+        void const*         Buffer,         // [in]
+        uint32_t            BufferSize      // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_256Finalise
+//
+//  Performs the final calculation of the hash and returns the digest (32 byte buffer containing 256bit hash). After
+//  calling this, Sha512_256Initialise must be used to reuse the context.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_256Finalise
+    (
+        Sha512_256Context*  Context,        // [in out]
+        SHA512_256_HASH*    Digest          // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Sha512_256Calculate
+//
+//  Combines Sha512_256Initialise, Sha512_256Update, and Sha512_256Finalise into one function. Calculates the SHA512/256
+//  hash of the buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    Sha512_256Calculate
+    (
+        void  const*        Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        SHA512_256_HASH*    Digest          // [out]
+    );
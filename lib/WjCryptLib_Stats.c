@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_Stats
+//
+//  Optional performance counters for the library's primitives.
+//
+//  The counters are global and added to atomically (with gcc, clang, or MSVC), so operations on any thread are
+//  counted. Reading them with StatsGet while other threads are counting gives a value that may be part way through an
+//  update of the three counters, which is fine for sampling.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WjCryptLib_Stats.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+// Time stamp counter on x86 with gcc or clang
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+    #define USE_RDTSC
+    #include <x86intrin.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// USDT probes where the SystemTap header is available
+#if defined(WJCRYPTLIB_STATS) && defined(__has_include)
+    #if __has_include(<sys/sdt.h>)
+        #define USE_USDT
+        #include <sys/sdt.h>
+    #endif
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__GNUC__)
+    #define ATOMIC_ADD( Variable, Value )   __atomic_fetch_add( &(Variable), (Value), __ATOMIC_RELAXED )
+#elif defined(_MSC_VER)
+    #define ATOMIC_ADD( Variable, Value )   \
+        _InterlockedExchangeAdd64( (__int64 volatile*)&(Variable), (__int64)(Value) )
+#else
+    #define ATOMIC_ADD( Variable, Value )   ( (Variable) += (Value) )
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static char const* const gPrimitiveNames [STATS_NUM_PRIMITIVES] =
+{
+    "AES key setup",
+    "AES-CBC",
+    "AES-CTR",
+    "AES-OFB",
+    "AES-CCM",
+    "AES-GCM-SIV",
+    "AES Key Wrap",
+    "MD5",
+    "SHA1",
+    "SHA256",
+    "SHA512",
+    "RC4 key setup",
+    "RC4",
+};
+
+#ifdef WJCRYPTLIB_STATS
+static StatsCounter         gCounters [STATS_NUM_PRIMITIVES];
+static StatsCallbackFunc    gCallback = NULL;
+static void*                gCallbackContext = NULL;
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsGet
+//
+//  Gets the counters of one of the STATS_ primitives.
+//  Returns 0 if successful, or -1 if the library was built without WJCRYPTLIB_STATS or Primitive is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    StatsGet
+    (
+        uint32_t            Primitive,          // [in]
+        StatsCounter*       pCounter            // [out]
+    )
+{
+#ifdef WJCRYPTLIB_STATS
+    if( Primitive >= STATS_NUM_PRIMITIVES )
+    {
+        return -1;
+    }
+
+    *pCounter = gCounters[Primitive];
+    if( NULL == pCounter->Backend )
+    {
+        pCounter->Backend = "portable";
+    }
+    return 0;
+#else
+    (void)Primitive;
+    (void)pCounter;
+    return -1;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsReset
+//
+//  Sets the calls, bytes, and cycles of every primitive to zero. The backends are kept.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    StatsReset
+    (
+        void
+    )
+{
+#ifdef WJCRYPTLIB_STATS
+    uint32_t    i;
+
+    for( i=0; i<STATS_NUM_PRIMITIVES; i++ )
+    {
+        gCounters[i].Calls = 0;
+        gCounters[i].Bytes = 0;
+        gCounters[i].Cycles = 0;
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsSetCallback
+//
+//  Sets a function to be called after every counted operation, or NULL for none. This must not be called while
+//  another thread is using the library. The callback is never called when built without WJCRYPTLIB_STATS.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    StatsSetCallback
+    (
+        StatsCallbackFunc   Callback,           // [in optional]
+        void*               CallbackContext     // [in optional]
+    )
+{
+#ifdef WJCRYPTLIB_STATS
+    gCallback = Callback;
+    gCallbackContext = CallbackContext;
+#else
+    (void)Callback;
+    (void)CallbackContext;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsGetPrimitiveName
+//
+//  Returns the name of one of the STATS_ primitives (eg "AES-CTR"), or NULL if Primitive is invalid.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+char const*
+    StatsGetPrimitiveName
+    (
+        uint32_t            Primitive           // [in]
+    )
+{
+    return ( Primitive < STATS_NUM_PRIMITIVES ) ? gPrimitiveNames[Primitive] : NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsGetCycles
+//
+//  Returns the current time in the units of the Cycles counters.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint64_t
+    StatsGetCycles
+    (
+        void
+    )
+{
+#ifdef USE_RDTSC
+    return (uint64_t)__rdtsc( );
+#else
+    struct timespec     now;
+
+    timespec_get( &now, TIME_UTC );
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsRecord
+//
+//  Counts one operation of Primitive that processed Bytes and took Cycles. Used by the STATS_END macro. Safe to call
+//  from several threads at once.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    StatsRecord
+    (
+        uint32_t            Primitive,          // [in]
+        uint64_t            Bytes,              // [in]
+        uint64_t            Cycles              // [in]
+    )
+{
+#ifdef WJCRYPTLIB_STATS
+    ATOMIC_ADD( gCounters[Primitive].Calls, 1 );
+    ATOMIC_ADD( gCounters[Primitive].Bytes, Bytes );
+    ATOMIC_ADD( gCounters[Primitive].Cycles, Cycles );
+
+    #ifdef USE_USDT
+        DTRACE_PROBE3( wjcryptlib, operation, Primitive, Bytes, Cycles );
+    #endif
+
+    if( NULL != gCallback )
+    {
+        gCallback( Primitive, Bytes, Cycles, gCallbackContext );
+    }
+#else
+    (void)Primitive;
+    (void)Bytes;
+    (void)Cycles;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsSetBackend
+//
+//  Records the implementation now used by Primitive. Backend must be a string constant. Used by the
+//  STATS_SET_BACKEND macro.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    StatsSetBackend
+    (
+        uint32_t            Primitive,          // [in]
+        char const*         Backend             // [in]
+    )
+{
+#ifdef WJCRYPTLIB_STATS
+    gCounters[Primitive].Backend = Backend;
+#else
+    (void)Primitive;
+    (void)Backend;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsTotalSize
+//
+//  Returns the sum of NumSizes sizes. Used by the modules to count the bytes of their multi-buffer functions.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint64_t
+    StatsTotalSize
+    (
+        uint32_t const      Sizes [],           // [in]
+        uint32_t            NumSizes            // [in]
+    )
+{
+    uint64_t    total = 0;
+    uint32_t    i;
+
+    for( i=0; i<NumSizes; i++ )
+    {
+        total += Sizes[i];
+    }
+
+    return total;
+}
@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLib_Stats
+//
+//  Optional performance counters for the library's primitives: for each one the number of calls, the bytes processed,
+//  the cumulative time spent, and the implementation (backend) in use.
+//
+//  The counters are only compiled in when the library is built with WJCRYPTLIB_STATS defined (the CMake option of
+//  the same name). Otherwise the STATS_ macros the modules use expand to nothing and StatsGet returns -1, so there is
+//  no cost at all, and the modules only need this header and not WjCryptLib_Stats.c.
+//
+//  Each operation can also be passed to a callback set with StatsSetCallback, for example to feed a metrics agent.
+//  On Linux, if <sys/sdt.h> is available, a USDT probe wjcryptlib:operation (arguments: primitive, bytes, cycles) is
+//  also fired for each operation, which perf and bpftrace can attach to. Probes that nothing is attached to cost a
+//  single no-op instruction.
+//
+//  Times are in processor cycles (the time stamp counter) on x86 with gcc or clang, and nanoseconds elsewhere.
+//  Primitives built on others count under those as well, eg HMAC-SHA256 counts as SHA256 and AES GCM-SIV as AES CTR.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Primitives that are counted. Names are given by StatsGetPrimitiveName.
+#define STATS_AES_KEY_SETUP         0       // AesInitialise (bytes are key bytes)
+#define STATS_AES_CBC               1
+#define STATS_AES_CTR               2
+#define STATS_AES_OFB               3
+#define STATS_AES_CCM               4
+#define STATS_AES_GCM_SIV           5
+#define STATS_AES_KEY_WRAP          6
+#define STATS_MD5                   7
+#define STATS_SHA1                  8
+#define STATS_SHA256                9
+#define STATS_SHA512                10
+#define STATS_RC4_KEY_SETUP         11      // RC4 key schedules (bytes are key bytes)
+#define STATS_RC4                   12
+
+#define STATS_NUM_PRIMITIVES        13
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The counters of one primitive
+typedef struct
+{
+    uint64_t        Calls;
+    uint64_t        Bytes;
+    uint64_t        Cycles;
+    char const*     Backend;        // Implementation in use, eg "portable" or "avx2"
+} StatsCounter;
+
+// Called after every counted operation, on the thread that performed it
+typedef void (*StatsCallbackFunc)( uint32_t Primitive, uint64_t Bytes, uint64_t Cycles, void* CallbackContext );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS - Used by the modules
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// STATS_BEGIN declares StartVariable holding the time an operation started. STATS_END counts the operation.
+#ifdef WJCRYPTLIB_STATS
+    #define STATS_BEGIN( StartVariable )                    uint64_t const StartVariable = StatsGetCycles( )
+    #define STATS_END( Primitive, StartVariable, Bytes )    \
+        StatsRecord( (Primitive), (uint64_t)(Bytes), StatsGetCycles( ) - (StartVariable) )
+    #define STATS_SET_BACKEND( Primitive, Backend )         StatsSetBackend( (Primitive), (Backend) )
+#else
+    #define STATS_BEGIN( StartVariable )                    ((void)0)
+    #define STATS_END( Primitive, StartVariable, Bytes )    ((void)0)
+    #define STATS_SET_BACKEND( Primitive, Backend )         ((void)0)
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsGet
+//
+//  Gets the counters of one of the STATS_ primitives.
+//  Returns 0 if successful, or -1 if the library was built without WJCRYPTLIB_STATS or Primitive is invalid
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    StatsGet
+    (
+        uint32_t            Primitive,          // [in]
+        StatsCounter*       pCounter            // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsReset
+//
+//  Sets the calls, bytes, and cycles of every primitive to zero. The backends are kept.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    StatsReset
+    (
+        void
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsSetCallback
+//
+//  Sets a function to be called after every counted operation, or NULL for none. This must not be called while
+//  another thread is using the library. The callback is never called when built without WJCRYPTLIB_STATS.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    StatsSetCallback
+    (
+        StatsCallbackFunc   Callback,           // [in optional]
+        void*               CallbackContext     // [in optional]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsGetPrimitiveName
+//
+//  Returns the name of one of the STATS_ primitives (eg "AES-CTR"), or NULL if Primitive is invalid.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+char const*
+    StatsGetPrimitiveName
+    (
+        uint32_t            Primitive           // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsGetCycles
+//
+//  Returns the current time in the units of the Cycles counters.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint64_t
+    StatsGetCycles
+    (
+        void
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsRecord
+//
+//  Counts one operation of Primitive that processed Bytes and took Cycles. Used by the STATS_END macro. Safe to call
+//  from several threads at once.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    StatsRecord
+    (
+        uint32_t            Primitive,          // [in]
+        uint64_t            Bytes,              // [in]
+        uint64_t            Cycles              // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsSetBackend
+//
+//  Records the implementation now used by Primitive. Backend must be a string constant. Used by the
+//  STATS_SET_BACKEND macro.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    StatsSetBackend
+    (
+        uint32_t            Primitive,          // [in]
+        char const*         Backend             // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StatsTotalSize
+//
+//  Returns the sum of NumSizes sizes. Used by the modules to count the bytes of their multi-buffer functions.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint64_t
+    StatsTotalSize
+    (
+        uint32_t const      Sizes [],           // [in]
+        uint32_t            NumSizes            // [in]
+    );
@@ -0,0 +1,666 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AesCtrEncrypt
+//
+//  Encrypts or decrypts a file (or stdin to stdout) with AES-CTR. Key and IV are taken from command line. The work is
+//  a three stage pipeline: a reader thread fills buffers, a number of encryptor threads each XOR the keystream over
+//  whole buffers (each buffer is a separate range of the counter), and the main thread writes the buffers out in
+//  order. There are two buffers for every encryptor so reading and writing overlap with encrypting. The throughput
+//  is reported on stderr.
+//  This program uses POSIX threads and file IO, and O_DIRECT where the platform has it.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "WjCryptLib_AesCtr.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define DEFAULT_BUFFER_MB       4
+#define MAX_BUFFER_MB           1024
+#define MAX_THREADS             64
+
+// Buffers are aligned to this, and their sizes are multiples of it, as required for O_DIRECT
+#define BUFFER_ALIGNMENT        4096
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+    SLOT_EMPTY,                                 // Waiting for the reader
+    SLOT_FILLED,                                // Read, waiting to be encrypted
+    SLOT_ENCRYPTED                              // Encrypted, waiting for the writer
+} SlotState;
+
+typedef struct
+{
+    uint8_t*        Buffer;
+    uint32_t        Size;
+    uint64_t        StreamIndex;                // Position in the stream of the first byte
+    SlotState       State;
+} Slot;
+
+// State shared by the threads. Everything after the lock is protected by it.
+typedef struct
+{
+    AesCtrContext       AesCtr;                 // Initialised context, copied by each encryptor
+    int                 InFile;
+    int                 OutFile;
+    uint32_t            BufferSize;
+    uint32_t            NumSlots;
+    Slot*               Slots;
+
+    pthread_mutex_t     Lock;
+    pthread_cond_t      Changed;                // Broadcast whenever any of the following change
+    uint64_t            NumChunksRead;
+    bool                ReadFinished;
+    uint64_t            NextToEncrypt;
+    bool                Failed;
+} Pipeline;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ReadHexData
+//
+//  Reads a string as hex and places it in Data. *pDataSize on entry specifies maximum number of bytes that can be
+//  read, and on return is set to how many were read. This will be zero if it failed to read any.
+//  This function ignores any character that isn't a hex character.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    ReadHexData
+    (
+        char const*         HexString,          // [in]
+        uint8_t*            Data,               // [out]
+        uint32_t*           pDataSize           // [in out]
+    )
+{
+    uint32_t        i;
+    char            holdingBuffer [3] = {0};
+    uint32_t        holdingBufferIndex = 0;
+    unsigned        hexToNumber;
+    unsigned        outputIndex = 0;
+
+    for( i=0; i<strlen(HexString); i++ )
+    {
+        if(     ( HexString[i] >= '0' && HexString[i] <= '9' )
+            ||  ( HexString[i] >= 'A' && HexString[i] <= 'F' )
+            ||  ( HexString[i] >= 'a' && HexString[i] <= 'f' ) )
+        {
+            holdingBuffer[holdingBufferIndex] = HexString[i];
+            holdingBufferIndex += 1;
+
+            if( 2 == holdingBufferIndex )
+            {
+                // Have two digits now so read it as a byte.
+                sscanf( holdingBuffer, "%x", &hexToNumber );
+                Data[outputIndex] = (uint8_t) hexToNumber;
+                outputIndex += 1;
+                if( outputIndex == *pDataSize )
+                {
+                    // No more space so stop reading
+                    break;
+                }
+                holdingBufferIndex = 0;
+            }
+        }
+    }
+
+    *pDataSize = outputIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DisableDirectIo
+//
+//  Turns off O_DIRECT on File. Direct IO needs aligned file positions and sizes, which the end of a file usually is
+//  not, so the last partial buffer is transferred without it.
+//  Returns true if O_DIRECT was on and has been turned off
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    DisableDirectIo
+    (
+        int         File                        // [in]
+    )
+{
+#ifdef O_DIRECT
+    int     flags = fcntl( File, F_GETFL );
+
+    if( flags >= 0 && 0 != ( flags & O_DIRECT ) )
+    {
+        return 0 == fcntl( File, F_SETFL, flags & ~O_DIRECT );
+    }
+#else
+    (void)File;
+#endif
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ReadFully
+//
+//  Reads until Buffer is full or the end of the file is reached (pipes and terminals return less than asked for).
+//  Returns the number of bytes read, or -1 on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int64_t
+    ReadFully
+    (
+        int             File,                   // [in]
+        uint8_t*        Buffer,                 // [out]
+        uint32_t        Size                    // [in]
+    )
+{
+    uint32_t    amountRead = 0;
+    ssize_t     result;
+
+    while( amountRead < Size )
+    {
+        result = read( File, Buffer + amountRead, Size - amountRead );
+        if( result > 0 )
+        {
+            amountRead += (uint32_t)result;
+        }
+        else if( 0 == result )
+        {
+            break;
+        }
+        else if( EINTR != errno && !( EINVAL == errno && DisableDirectIo( File ) ) )
+        {
+            return -1;
+        }
+    }
+
+    return amountRead;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WriteFully
+//
+//  Writes all of Buffer.
+//  Returns 0 if successful, or -1 on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    WriteFully
+    (
+        int             File,                   // [in]
+        uint8_t const*  Buffer,                 // [in]
+        uint32_t        Size                    // [in]
+    )
+{
+    uint32_t    amountWritten = 0;
+    ssize_t     result;
+
+    if( 0 != Size % BUFFER_ALIGNMENT )
+    {
+        DisableDirectIo( File );
+    }
+
+    while( amountWritten < Size )
+    {
+        result = write( File, Buffer + amountWritten, Size - amountWritten );
+        if( result > 0 )
+        {
+            amountWritten += (uint32_t)result;
+        }
+        else if( result < 0 && EINTR != errno )
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SetFailed
+//
+//  Stops the pipeline after an error. Every thread returns as soon as it next waits.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    SetFailed
+    (
+        Pipeline*       Pipe                    // [in out]
+    )
+{
+    pthread_mutex_lock( &Pipe->Lock );
+    Pipe->Failed = true;
+    pthread_cond_broadcast( &Pipe->Changed );
+    pthread_mutex_unlock( &Pipe->Lock );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ReaderThread
+//
+//  Reads the input into the slots in turn, each as soon as the writer has emptied it.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void*
+    ReaderThread
+    (
+        void*           Parameter               // [in]
+    )
+{
+    Pipeline*   pipe = (Pipeline*)Parameter;
+    uint64_t    sequence = 0;
+    uint64_t    streamIndex = 0;
+    Slot*       slot;
+    int64_t     size;
+    bool        failed;
+
+    for( ;; )
+    {
+        slot = &pipe->Slots[ sequence % pipe->NumSlots ];
+
+        pthread_mutex_lock( &pipe->Lock );
+        while( !pipe->Failed && SLOT_EMPTY != slot->State )
+        {
+            pthread_cond_wait( &pipe->Changed, &pipe->Lock );
+        }
+        failed = pipe->Failed;
+        pthread_mutex_unlock( &pipe->Lock );
+        if( failed )
+        {
+            break;
+        }
+
+        size = ReadFully( pipe->InFile, slot->Buffer, pipe->BufferSize );
+        if( size < 0 )
+        {
+            fprintf( stderr, "Read failed: %s\n", strerror( errno ) );
+            SetFailed( pipe );
+            break;
+        }
+
+        pthread_mutex_lock( &pipe->Lock );
+        if( size > 0 )
+        {
+            slot->Size = (uint32_t)size;
+            slot->StreamIndex = streamIndex;
+            slot->State = SLOT_FILLED;
+            pipe->NumChunksRead = sequence + 1;
+        }
+        // A short read means the end of the input
+        pipe->ReadFinished = ( size < pipe->BufferSize );
+        pthread_cond_broadcast( &pipe->Changed );
+        pthread_mutex_unlock( &pipe->Lock );
+
+        if( size < pipe->BufferSize )
+        {
+            break;
+        }
+        streamIndex += (uint64_t)size;
+        sequence += 1;
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  EncryptorThread
+//
+//  Takes the next filled slot and encrypts it in place, until the input is finished. Each slot is a separate range
+//  of the stream so the encryptors do not depend on each other.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void*
+    EncryptorThread
+    (
+        void*           Parameter               // [in]
+    )
+{
+    Pipeline*       pipe = (Pipeline*)Parameter;
+    AesCtrContext   aesCtr = pipe->AesCtr;
+    Slot*           slot;
+
+    for( ;; )
+    {
+        pthread_mutex_lock( &pipe->Lock );
+        while( !pipe->Failed && pipe->NextToEncrypt >= pipe->NumChunksRead && !pipe->ReadFinished )
+        {
+            pthread_cond_wait( &pipe->Changed, &pipe->Lock );
+        }
+        if( pipe->Failed || pipe->NextToEncrypt >= pipe->NumChunksRead )
+        {
+            pthread_mutex_unlock( &pipe->Lock );
+            break;
+        }
+        slot = &pipe->Slots[ pipe->NextToEncrypt % pipe->NumSlots ];
+        pipe->NextToEncrypt += 1;
+        pthread_mutex_unlock( &pipe->Lock );
+
+        AesCtrSetStreamIndex( &aesCtr, slot->StreamIndex );
+        AesCtrXor( &aesCtr, slot->Buffer, slot->Buffer, slot->Size );
+
+        pthread_mutex_lock( &pipe->Lock );
+        slot->State = SLOT_ENCRYPTED;
+        pthread_cond_broadcast( &pipe->Changed );
+        pthread_mutex_unlock( &pipe->Lock );
+    }
+
+    memset( &aesCtr, 0, sizeof(aesCtr) );
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WriteOutput
+//
+//  Writes the slots out in order as they are encrypted, and hands each back to the reader.
+//  Returns the number of bytes written, or -1 on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int64_t
+    WriteOutput
+    (
+        Pipeline*       Pipe                    // [in out]
+    )
+{
+    uint64_t    sequence = 0;
+    uint64_t    totalSize = 0;
+    Slot*       slot;
+    bool        ready;
+    bool        failed;
+
+    for( ;; )
+    {
+        slot = &Pipe->Slots[ sequence % Pipe->NumSlots ];
+
+        pthread_mutex_lock( &Pipe->Lock );
+        while(      !Pipe->Failed
+                &&  SLOT_ENCRYPTED != slot->State
+                &&  !( Pipe->ReadFinished && sequence >= Pipe->NumChunksRead ) )
+        {
+            pthread_cond_wait( &Pipe->Changed, &Pipe->Lock );
+        }
+        failed = Pipe->Failed;
+        ready = !failed && SLOT_ENCRYPTED == slot->State;
+        pthread_mutex_unlock( &Pipe->Lock );
+        if( !ready )
+        {
+            break;
+        }
+
+        if( 0 != WriteFully( Pipe->OutFile, slot->Buffer, slot->Size ) )
+        {
+            fprintf( stderr, "Write failed: %s\n", strerror( errno ) );
+            SetFailed( Pipe );
+            failed = true;
+            break;
+        }
+        totalSize += slot->Size;
+
+        pthread_mutex_lock( &Pipe->Lock );
+        slot->State = SLOT_EMPTY;
+        pthread_cond_broadcast( &Pipe->Changed );
+        pthread_mutex_unlock( &Pipe->Lock );
+        sequence += 1;
+    }
+
+    return failed ? -1 : (int64_t)totalSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  OpenFile
+//
+//  Opens FileName for reading or writing, with O_DIRECT if requested. "-" is stdin or stdout.
+//  Returns the file descriptor, or -1 on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    OpenFile
+    (
+        char const*     FileName,               // [in]
+        bool            Write,                  // [in]
+        bool            DirectIo                // [in]
+    )
+{
+    int     flags = Write ? ( O_WRONLY | O_CREAT | O_TRUNC ) : O_RDONLY;
+    int     file;
+
+    if( 0 == strcmp( FileName, "-" ) )
+    {
+        return Write ? STDOUT_FILENO : STDIN_FILENO;
+    }
+
+#ifdef O_DIRECT
+    if( DirectIo )
+    {
+        flags |= O_DIRECT;
+    }
+#else
+    (void)DirectIo;
+#endif
+
+    file = open( FileName, flags, 0644 );
+    if( file < 0 )
+    {
+        fprintf( stderr, "Unable to open %s: %s\n", FileName, strerror( errno ) );
+    }
+    return file;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetTime
+//
+//  Returns a monotonic time in seconds
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+double
+    GetTime
+    (
+        void
+    )
+{
+    struct timespec     now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (double)now.tv_sec + ( (double)now.tv_nsec / 1e9 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  main
+//
+//  Program entry point
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    main
+    (
+        int             ArgC,
+        char**          ArgV
+    )
+{
+    Pipeline        pipe = {0};
+    uint8_t         key [AES_KEY_SIZE_256];
+    uint32_t        keySize = sizeof(key);
+    uint8_t         IV [AES_CTR_IV_SIZE];
+    uint32_t        IVSize = sizeof(IV);
+    long            numThreads = sysconf( _SC_NPROCESSORS_ONLN );
+    long            bufferMegaBytes = DEFAULT_BUFFER_MB;
+    bool            directIo = false;
+    pthread_t       reader;
+    pthread_t       encryptors [MAX_THREADS];
+    int             arg = 1;
+    int             i;
+    int64_t         totalSize;
+    double          startTime;
+    double          elapsed;
+
+    // Options
+    while( arg < ArgC && '-' == ArgV[arg][0] && 0 != ArgV[arg][1] )
+    {
+        if( 0 == strcmp( ArgV[arg], "-t" ) && arg + 1 < ArgC )
+        {
+            numThreads = atol( ArgV[arg+1] );
+            arg += 2;
+        }
+        else if( 0 == strcmp( ArgV[arg], "-b" ) && arg + 1 < ArgC )
+        {
+            bufferMegaBytes = atol( ArgV[arg+1] );
+            arg += 2;
+        }
+        else if( 0 == strcmp( ArgV[arg], "-d" ) )
+        {
+            directIo = true;
+            arg += 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if( 4 != ArgC - arg )
+    {
+        fprintf( stderr,
+            "Syntax\n"
+            "   AesCtrEncrypt [-t Threads] [-b BufferMB] [-d] <Key> <IV> <InFile> <OutFile>\n"
+            "     -t Threads  - Number of encryptor threads (default: number of processors)\n"
+            "     -b BufferMB - Size of each buffer in MB (default %u)\n"
+            "     -d          - Use O_DIRECT for files, bypassing the page cache\n"
+            "     <Key>       - 128, 192, or 256 bit written as hex\n"
+            "     <IV>        - 64 bit written as hex\n"
+            "     <InFile>    - File to encrypt or decrypt, or - for stdin\n"
+            "     <OutFile>   - File to write, or - for stdout\n",
+            DEFAULT_BUFFER_MB );
+        return 1;
+    }
+
+    if( numThreads < 1 || numThreads > MAX_THREADS )
+    {
+        fprintf( stderr, "Invalid number of threads. Must be 1 to %u\n", MAX_THREADS );
+        return 1;
+    }
+    if( bufferMegaBytes < 1 || bufferMegaBytes > MAX_BUFFER_MB )
+    {
+        fprintf( stderr, "Invalid buffer size. Must be 1 to %u MB\n", MAX_BUFFER_MB );
+        return 1;
+    }
+
+    ReadHexData( ArgV[arg], key, &keySize );
+    if( AES_KEY_SIZE_128 != keySize && AES_KEY_SIZE_192 != keySize && AES_KEY_SIZE_256 != keySize )
+    {
+        fprintf( stderr, "Invalid key size. Must be 128, 192, or 256 bits\n" );
+        return 1;
+    }
+
+    ReadHexData( ArgV[arg+1], IV, &IVSize );
+    if( AES_CTR_IV_SIZE != IVSize )
+    {
+        fprintf( stderr, "Invalid IV size. Must be 64 bits\n" );
+        return 1;
+    }
+
+    AesCtrInitialiseWithKey( &pipe.AesCtr, key, keySize, IV );
+    memset( key, 0, sizeof(key) );
+
+    pipe.InFile = OpenFile( ArgV[arg+2], false, directIo );
+    pipe.OutFile = OpenFile( ArgV[arg+3], true, directIo );
+    if( pipe.InFile < 0 || pipe.OutFile < 0 )
+    {
+        return 1;
+    }
+
+    // Two buffers per encryptor, so that one can be read or written while the other is encrypted
+    pipe.BufferSize = (uint32_t)bufferMegaBytes * 1024 * 1024;
+    pipe.NumSlots = 2 * (uint32_t)numThreads;
+    pipe.Slots = calloc( pipe.NumSlots, sizeof(Slot) );
+    if( NULL == pipe.Slots )
+    {
+        fprintf( stderr, "Out of memory\n" );
+        return 1;
+    }
+    for( i=0; i<(int)pipe.NumSlots; i++ )
+    {
+        if( 0 != posix_memalign( (void**)&pipe.Slots[i].Buffer, BUFFER_ALIGNMENT, pipe.BufferSize ) )
+        {
+            fprintf( stderr, "Out of memory\n" );
+            return 1;
+        }
+        pipe.Slots[i].State = SLOT_EMPTY;
+    }
+
+    pthread_mutex_init( &pipe.Lock, NULL );
+    pthread_cond_init( &pipe.Changed, NULL );
+
+    startTime = GetTime( );
+
+    if( 0 != pthread_create( &reader, NULL, ReaderThread, &pipe ) )
+    {
+        fprintf( stderr, "Unable to create thread\n" );
+        return 1;
+    }
+    for( i=0; i<numThreads; i++ )
+    {
+        if( 0 != pthread_create( &encryptors[i], NULL, EncryptorThread, &pipe ) )
+        {
+            fprintf( stderr, "Unable to create thread\n" );
+            SetFailed( &pipe );
+            numThreads = i;
+            break;
+        }
+    }
+
+    totalSize = WriteOutput( &pipe );
+
+    pthread_join( reader, NULL );
+    for( i=0; i<numThreads; i++ )
+    {
+        pthread_join( encryptors[i], NULL );
+    }
+
+    elapsed = GetTime( ) - startTime;
+
+    if( STDOUT_FILENO != pipe.OutFile && 0 != close( pipe.OutFile ) )
+    {
+        fprintf( stderr, "Write failed: %s\n", strerror( errno ) );
+        totalSize = -1;
+    }
+    if( STDIN_FILENO != pipe.InFile )
+    {
+        close( pipe.InFile );
+    }
+
+    for( i=0; i<(int)pipe.NumSlots; i++ )
+    {
+        free( pipe.Slots[i].Buffer );
+    }
+    free( pipe.Slots );
+    pthread_cond_destroy( &pipe.Changed );
+    pthread_mutex_destroy( &pipe.Lock );
+    memset( &pipe.AesCtr, 0, sizeof(pipe.AesCtr) );
+
+    if( totalSize < 0 )
+    {
+        return 1;
+    }
+
+    fprintf( stderr, "%llu bytes in %.3f seconds: %.2f GiB/s (%ld threads)\n",
+        (unsigned long long)totalSize, elapsed,
+        elapsed > 0 ? (double)totalSize / ( 1024.0 * 1024.0 * 1024.0 ) / elapsed : 0.0, numThreads );
+
+    return 0;
+}
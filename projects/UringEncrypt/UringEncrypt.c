@@ -0,0 +1,815 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringEncrypt
+//
+//  Hashes (SHA-256) and encrypts (AES-CTR) a file on Linux, with all reads and writes driven through io_uring into a
+//  queue of registered buffers. The main thread owns the ring: it keeps a read in flight for every free buffer and
+//  queues the write of each buffer as soon as it has been encrypted. As reads complete the buffers are handed to a
+//  hashing thread, which hashes them in file order, and then to encryptor threads, which each encrypt whichever
+//  buffer is next (each buffer is a separate range of the counter). Workers wake the main thread through an eventfd
+//  read queued on the ring, so storage latency overlaps with Sha256Update and AesCtrXor. The SHA-256 of the input
+//  and the throughput are printed.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_Sha256.h"
+#include "UringIo.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+// Completions are identified by their type and buffer index
+#define MakeTag( Type, Index )      ( ((uint64_t)(Type) << 32) | (uint32_t)(Index) )
+#define TagType( Tag )              ( (uint32_t)( (Tag) >> 32 ) )
+#define TagIndex( Tag )             ( (uint32_t)(Tag) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define DEFAULT_BUFFER_KB       1024
+#define MAX_BUFFER_KB           ( 64 * 1024 )
+#define DEFAULT_QUEUE_DEPTH     16
+#define MAX_QUEUE_DEPTH         1024
+#define MAX_THREADS             64
+
+// Buffers are aligned to this, and direct IO is only used for file ranges aligned to it
+#define BUFFER_ALIGNMENT        4096
+
+#define TAG_READ                1
+#define TAG_WRITE               2
+#define TAG_WAKE                3
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+    BUFFER_FREE,
+    BUFFER_READING,                             // Read in flight
+    BUFFER_READ,                                // Waiting to be hashed
+    BUFFER_HASHED,                              // Waiting for an encryptor
+    BUFFER_ENCRYPTING,
+    BUFFER_ENCRYPTED,                           // Waiting for the main thread to queue the write
+    BUFFER_WRITING                              // Write in flight
+} BufferState;
+
+typedef struct
+{
+    uint8_t*        Data;
+    uint64_t        Chunk;                      // Which BufferSize piece of the file this holds
+    uint32_t        Size;                       // Bytes in the chunk (less than BufferSize only for the last)
+    uint32_t        Done;                       // Bytes of the current read or write completed so far
+    BufferState     State;
+} Buffer;
+
+// State shared by the threads. Buffer states and everything after the lock are protected by it.
+typedef struct
+{
+    AesCtrContext       AesCtr;                 // Initialised context, copied by each encryptor
+    Sha256Context       Sha256;                 // Used only by the hashing thread
+    int                 InFile;
+    int                 InFileUnaligned;        // Same file without O_DIRECT (or InFile if not using direct IO)
+    int                 OutFile;
+    int                 OutFileUnaligned;
+    int                 WakeFile;               // eventfd the workers use to wake the main thread
+    uint64_t            WakeValue;              // Target of the WakeFile read, which may be pending until the ring is
+                                                // torn down, so it must outlive DriveRing
+    uint64_t            FileSize;
+    uint64_t            NumChunks;
+    uint32_t            BufferSize;
+    uint32_t            NumBuffers;
+    Buffer*             Buffers;
+
+    pthread_mutex_t     Lock;
+    pthread_cond_t      Changed;                // Broadcast whenever a buffer state or any of the following change
+    uint64_t            NextToHash;
+    uint64_t            NumEncryptTaken;
+    bool                Failed;
+} Pipeline;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ReadHexData
+//
+//  Reads a string as hex and places it in Data. *pDataSize on entry specifies maximum number of bytes that can be
+//  read, and on return is set to how many were read. This will be zero if it failed to read any.
+//  This function ignores any character that isn't a hex character.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    ReadHexData
+    (
+        char const*         HexString,          // [in]
+        uint8_t*            Data,               // [out]
+        uint32_t*           pDataSize           // [in out]
+    )
+{
+    uint32_t        i;
+    char            holdingBuffer [3] = {0};
+    uint32_t        holdingBufferIndex = 0;
+    unsigned        hexToNumber;
+    unsigned        outputIndex = 0;
+
+    for( i=0; i<strlen(HexString); i++ )
+    {
+        if(     ( HexString[i] >= '0' && HexString[i] <= '9' )
+            ||  ( HexString[i] >= 'A' && HexString[i] <= 'F' )
+            ||  ( HexString[i] >= 'a' && HexString[i] <= 'f' ) )
+        {
+            holdingBuffer[holdingBufferIndex] = HexString[i];
+            holdingBufferIndex += 1;
+
+            if( 2 == holdingBufferIndex )
+            {
+                // Have two digits now so read it as a byte.
+                sscanf( holdingBuffer, "%x", &hexToNumber );
+                Data[outputIndex] = (uint8_t) hexToNumber;
+                outputIndex += 1;
+                if( outputIndex == *pDataSize )
+                {
+                    // No more space so stop reading
+                    break;
+                }
+                holdingBufferIndex = 0;
+            }
+        }
+    }
+
+    *pDataSize = outputIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SetFailed
+//
+//  Stops the pipeline after an error. Every thread returns as soon as it next waits.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    SetFailed
+    (
+        Pipeline*       Pipe                    // [in out]
+    )
+{
+    pthread_mutex_lock( &Pipe->Lock );
+    Pipe->Failed = true;
+    pthread_cond_broadcast( &Pipe->Changed );
+    pthread_mutex_unlock( &Pipe->Lock );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SetBufferState
+//
+//  Changes the state of a buffer and wakes any thread waiting for it.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    SetBufferState
+    (
+        Pipeline*       Pipe,                   // [in out]
+        Buffer*         Buf,                    // [in out]
+        BufferState     State                   // [in]
+    )
+{
+    pthread_mutex_lock( &Pipe->Lock );
+    Buf->State = State;
+    pthread_cond_broadcast( &Pipe->Changed );
+    pthread_mutex_unlock( &Pipe->Lock );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HashThread
+//
+//  Hashes the chunks in file order as their reads complete.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void*
+    HashThread
+    (
+        void*           Parameter               // [in]
+    )
+{
+    Pipeline*   pipe = (Pipeline*)Parameter;
+    Buffer*     buf;
+    uint32_t    i;
+
+    for( ;; )
+    {
+        buf = NULL;
+
+        pthread_mutex_lock( &pipe->Lock );
+        while( !pipe->Failed && pipe->NextToHash < pipe->NumChunks && NULL == buf )
+        {
+            for( i=0; i<pipe->NumBuffers; i++ )
+            {
+                if( BUFFER_READ == pipe->Buffers[i].State && pipe->NextToHash == pipe->Buffers[i].Chunk )
+                {
+                    buf = &pipe->Buffers[i];
+                    break;
+                }
+            }
+            if( NULL == buf )
+            {
+                pthread_cond_wait( &pipe->Changed, &pipe->Lock );
+            }
+        }
+        pthread_mutex_unlock( &pipe->Lock );
+        if( NULL == buf )
+        {
+            break;
+        }
+
+        Sha256Update( &pipe->Sha256, buf->Data, buf->Size );
+
+        pthread_mutex_lock( &pipe->Lock );
+        buf->State = BUFFER_HASHED;
+        pipe->NextToHash += 1;
+        pthread_cond_broadcast( &pipe->Changed );
+        pthread_mutex_unlock( &pipe->Lock );
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  EncryptorThread
+//
+//  Encrypts hashed buffers in place, earliest chunk first, and wakes the main thread to write each one.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void*
+    EncryptorThread
+    (
+        void*           Parameter               // [in]
+    )
+{
+    Pipeline*       pipe = (Pipeline*)Parameter;
+    AesCtrContext   aesCtr = pipe->AesCtr;
+    uint64_t const  one = 1;
+    Buffer*         buf;
+    uint32_t        i;
+
+    for( ;; )
+    {
+        buf = NULL;
+
+        pthread_mutex_lock( &pipe->Lock );
+        while( !pipe->Failed && pipe->NumEncryptTaken < pipe->NumChunks && NULL == buf )
+        {
+            for( i=0; i<pipe->NumBuffers; i++ )
+            {
+                if(     BUFFER_HASHED == pipe->Buffers[i].State
+                    &&  ( NULL == buf || pipe->Buffers[i].Chunk < buf->Chunk ) )
+                {
+                    buf = &pipe->Buffers[i];
+                }
+            }
+            if( NULL == buf )
+            {
+                pthread_cond_wait( &pipe->Changed, &pipe->Lock );
+            }
+        }
+        if( NULL != buf )
+        {
+            buf->State = BUFFER_ENCRYPTING;
+            pipe->NumEncryptTaken += 1;
+        }
+        pthread_mutex_unlock( &pipe->Lock );
+        if( NULL == buf )
+        {
+            break;
+        }
+
+        AesCtrSetStreamIndex( &aesCtr, buf->Chunk * pipe->BufferSize );
+        AesCtrXor( &aesCtr, buf->Data, buf->Data, buf->Size );
+
+        SetBufferState( pipe, buf, BUFFER_ENCRYPTED );
+        if( sizeof(one) != write( pipe->WakeFile, &one, sizeof(one) ) )
+        {
+            SetFailed( pipe );
+            break;
+        }
+    }
+
+    memset( &aesCtr, 0, sizeof(aesCtr) );
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  QueueTransfer
+//
+//  Queues the rest of the read or write of buffer Index (from Done bytes into the chunk). Direct IO needs aligned
+//  file positions and sizes, so anything that is not aligned (the end of the file) goes through the unaligned file.
+//  Reads of the last chunk are rounded up to whole aligned blocks; the read just stops at the end of the file.
+//  Returns 0 if successful, or -1 if the ring is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    QueueTransfer
+    (
+        Pipeline*       Pipe,                   // [in]
+        UringIo*        Ring,                   // [in out]
+        uint32_t        Index,                  // [in]
+        bool            Write                   // [in]
+    )
+{
+    Buffer*     buf = &Pipe->Buffers[Index];
+    uint64_t    offset = buf->Chunk * Pipe->BufferSize + buf->Done;
+    uint32_t    size = buf->Size - buf->Done;
+    bool        aligned = 0 == offset % BUFFER_ALIGNMENT && 0 == buf->Done;
+
+    if( Write )
+    {
+        aligned = aligned && 0 == size % BUFFER_ALIGNMENT;
+        return UringIoQueueWriteFixed( Ring, aligned ? Pipe->OutFile : Pipe->OutFileUnaligned,
+            buf->Data + buf->Done, size, offset, Index, MakeTag( TAG_WRITE, Index ) );
+    }
+    else
+    {
+        if( aligned )
+        {
+            size = ( size + BUFFER_ALIGNMENT - 1 ) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+        }
+        return UringIoQueueReadFixed( Ring, aligned ? Pipe->InFile : Pipe->InFileUnaligned,
+            buf->Data + buf->Done, size, offset, Index, MakeTag( TAG_READ, Index ) );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  StartRead
+//
+//  Assigns Chunk to buffer Index and queues its read.
+//  Returns 0 if successful, or -1 if the ring is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    StartRead
+    (
+        Pipeline*       Pipe,                   // [in out]
+        UringIo*        Ring,                   // [in out]
+        uint32_t        Index,                  // [in]
+        uint64_t        Chunk                   // [in]
+    )
+{
+    Buffer*     buf = &Pipe->Buffers[Index];
+
+    pthread_mutex_lock( &Pipe->Lock );
+    buf->Chunk = Chunk;
+    buf->Size = (uint32_t)MIN( (uint64_t)Pipe->BufferSize, Pipe->FileSize - Chunk * Pipe->BufferSize );
+    buf->Done = 0;
+    buf->State = BUFFER_READING;
+    pthread_mutex_unlock( &Pipe->Lock );
+
+    return QueueTransfer( Pipe, Ring, Index, false );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DriveRing
+//
+//  Runs the main thread's part of the pipeline: keeps reads in flight for every free buffer, queues writes of
+//  encrypted buffers when woken, and recycles each buffer for the next chunk when its write completes.
+//  Returns 0 if successful, or -1 on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    DriveRing
+    (
+        Pipeline*       Pipe,                   // [in out]
+        UringIo*        Ring                    // [in out]
+    )
+{
+    uint64_t    nextChunk = 0;
+    uint64_t    numChunksWritten = 0;
+    uint64_t    tag;
+    int32_t     result;
+    uint32_t    index;
+    uint32_t    i;
+    Buffer*     buf;
+    int         error = 0;
+
+    for( i=0; i<Pipe->NumBuffers && nextChunk<Pipe->NumChunks && 0 == error; i++ )
+    {
+        error = StartRead( Pipe, Ring, i, nextChunk );
+        nextChunk += 1;
+    }
+    if( 0 == error )
+    {
+        error = UringIoQueueRead( Ring, Pipe->WakeFile, &Pipe->WakeValue, sizeof(Pipe->WakeValue), 0,
+            MakeTag( TAG_WAKE, 0 ) );
+    }
+
+    while( 0 == error && numChunksWritten < Pipe->NumChunks )
+    {
+        if( 0 != UringIoWaitCompletion( Ring, &tag, &result ) )
+        {
+            fprintf( stderr, "io_uring failed: %s\n", strerror( errno ) );
+            error = -1;
+            break;
+        }
+        index = TagIndex( tag );
+        buf = &Pipe->Buffers[ MIN( index, Pipe->NumBuffers - 1 ) ];
+
+        if( result < 0 || ( 0 == result && TAG_WAKE != TagType( tag ) ) )
+        {
+            fprintf( stderr, "%s failed: %s\n", ( TAG_WRITE == TagType( tag ) ) ? "Write" : "Read",
+                ( result < 0 ) ? strerror( -result ) : "unexpected end of file" );
+            error = -1;
+        }
+        else if( TAG_WAKE == TagType( tag ) )
+        {
+            // Queue the writes of every buffer encrypted since the last wake
+            for( i=0; i<Pipe->NumBuffers && 0 == error; i++ )
+            {
+                pthread_mutex_lock( &Pipe->Lock );
+                buf = &Pipe->Buffers[i];
+                if( BUFFER_ENCRYPTED == buf->State )
+                {
+                    buf->State = BUFFER_WRITING;
+                    buf->Done = 0;
+                    pthread_mutex_unlock( &Pipe->Lock );
+                    error = QueueTransfer( Pipe, Ring, i, true );
+                }
+                else
+                {
+                    pthread_mutex_unlock( &Pipe->Lock );
+                }
+            }
+            if( 0 == error )
+            {
+                error = UringIoQueueRead( Ring, Pipe->WakeFile, &Pipe->WakeValue, sizeof(Pipe->WakeValue), 0,
+                    MakeTag( TAG_WAKE, 0 ) );
+            }
+        }
+        else if( TAG_READ == TagType( tag ) )
+        {
+            buf->Done = MIN( buf->Done + (uint32_t)result, buf->Size );
+            if( buf->Done < buf->Size )
+            {
+                error = QueueTransfer( Pipe, Ring, index, false );
+            }
+            else
+            {
+                SetBufferState( Pipe, buf, BUFFER_READ );
+            }
+        }
+        else
+        {
+            buf->Done += (uint32_t)result;
+            if( buf->Done < buf->Size )
+            {
+                error = QueueTransfer( Pipe, Ring, index, true );
+            }
+            else
+            {
+                numChunksWritten += 1;
+                if( nextChunk < Pipe->NumChunks )
+                {
+                    error = StartRead( Pipe, Ring, index, nextChunk );
+                    nextChunk += 1;
+                }
+                else
+                {
+                    SetBufferState( Pipe, buf, BUFFER_FREE );
+                }
+            }
+        }
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  OpenFile
+//
+//  Opens FileName for reading or writing, with O_DIRECT if requested.
+//  Returns the file descriptor, or -1 on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    OpenFile
+    (
+        char const*     FileName,               // [in]
+        bool            Write,                  // [in]
+        bool            DirectIo                // [in]
+    )
+{
+    int     flags = Write ? ( O_WRONLY | O_CREAT ) : O_RDONLY;
+    int     file;
+
+    if( DirectIo )
+    {
+        flags |= O_DIRECT;
+    }
+
+    file = open( FileName, flags, 0644 );
+    if( file < 0 )
+    {
+        fprintf( stderr, "Unable to open %s: %s\n", FileName, strerror( errno ) );
+    }
+    return file;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetTime
+//
+//  Returns a monotonic time in seconds
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+double
+    GetTime
+    (
+        void
+    )
+{
+    struct timespec     now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (double)now.tv_sec + ( (double)now.tv_nsec / 1e9 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  main
+//
+//  Program entry point
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    main
+    (
+        int             ArgC,
+        char**          ArgV
+    )
+{
+    Pipeline        pipe = {0};
+    UringIo         ring;
+    uint8_t         key [AES_KEY_SIZE_256];
+    uint32_t        keySize = sizeof(key);
+    uint8_t         IV [AES_CTR_IV_SIZE];
+    uint32_t        IVSize = sizeof(IV);
+    long            numThreads = sysconf( _SC_NPROCESSORS_ONLN );
+    long            bufferKiloBytes = DEFAULT_BUFFER_KB;
+    long            queueDepth = DEFAULT_QUEUE_DEPTH;
+    bool            directIo = false;
+    pthread_t       hasher;
+    pthread_t       encryptors [MAX_THREADS];
+    void**          bufferPointers;
+    struct stat     inStat;
+    struct stat     outStat;
+    SHA256_HASH     hash;
+    int             arg = 1;
+    int             i;
+    int             error;
+    double          startTime;
+    double          elapsed;
+
+    // Options
+    while( arg < ArgC && '-' == ArgV[arg][0] )
+    {
+        if( 0 == strcmp( ArgV[arg], "-t" ) && arg + 1 < ArgC )
+        {
+            numThreads = atol( ArgV[arg+1] );
+            arg += 2;
+        }
+        else if( 0 == strcmp( ArgV[arg], "-b" ) && arg + 1 < ArgC )
+        {
+            bufferKiloBytes = atol( ArgV[arg+1] );
+            arg += 2;
+        }
+        else if( 0 == strcmp( ArgV[arg], "-q" ) && arg + 1 < ArgC )
+        {
+            queueDepth = atol( ArgV[arg+1] );
+            arg += 2;
+        }
+        else if( 0 == strcmp( ArgV[arg], "-d" ) )
+        {
+            directIo = true;
+            arg += 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if( 4 != ArgC - arg )
+    {
+        fprintf( stderr,
+            "Syntax\n"
+            "   UringEncrypt [-t Threads] [-b BufferKB] [-q QueueDepth] [-d] <Key> <IV> <InFile> <OutFile>\n"
+            "     -t Threads    - Number of encryptor threads (default: number of processors)\n"
+            "     -b BufferKB   - Size of each buffer in KB, a multiple of 4 (default %u)\n"
+            "     -q QueueDepth - Number of buffers, each with one read or write in flight (default %u)\n"
+            "     -d            - Use O_DIRECT, bypassing the page cache\n"
+            "     <Key>         - 128, 192, or 256 bit written as hex\n"
+            "     <IV>          - 64 bit written as hex\n"
+            "     <InFile>      - File to hash and encrypt\n"
+            "     <OutFile>     - File to write\n",
+            DEFAULT_BUFFER_KB, DEFAULT_QUEUE_DEPTH );
+        return 1;
+    }
+
+    if( numThreads < 1 || numThreads > MAX_THREADS )
+    {
+        fprintf( stderr, "Invalid number of threads. Must be 1 to %u\n", MAX_THREADS );
+        return 1;
+    }
+    if( bufferKiloBytes < 4 || bufferKiloBytes > MAX_BUFFER_KB || 0 != bufferKiloBytes % 4 )
+    {
+        fprintf( stderr, "Invalid buffer size. Must be a multiple of 4 from 4 to %u KB\n", MAX_BUFFER_KB );
+        return 1;
+    }
+    if( queueDepth < 1 || queueDepth > MAX_QUEUE_DEPTH )
+    {
+        fprintf( stderr, "Invalid queue depth. Must be 1 to %u\n", MAX_QUEUE_DEPTH );
+        return 1;
+    }
+
+    ReadHexData( ArgV[arg], key, &keySize );
+    if( AES_KEY_SIZE_128 != keySize && AES_KEY_SIZE_192 != keySize && AES_KEY_SIZE_256 != keySize )
+    {
+        fprintf( stderr, "Invalid key size. Must be 128, 192, or 256 bits\n" );
+        return 1;
+    }
+
+    ReadHexData( ArgV[arg+1], IV, &IVSize );
+    if( AES_CTR_IV_SIZE != IVSize )
+    {
+        fprintf( stderr, "Invalid IV size. Must be 64 bits\n" );
+        return 1;
+    }
+
+    AesCtrInitialiseWithKey( &pipe.AesCtr, key, keySize, IV );
+    memset( key, 0, sizeof(key) );
+    Sha256Initialise( &pipe.Sha256 );
+
+    // Open the files, and a second handle on each without O_DIRECT for the unaligned end of the file
+    pipe.InFile = OpenFile( ArgV[arg+2], false, directIo );
+    pipe.OutFile = OpenFile( ArgV[arg+3], true, directIo );
+    if( pipe.InFile < 0 || pipe.OutFile < 0 )
+    {
+        return 1;
+    }
+    pipe.InFileUnaligned = directIo ? OpenFile( ArgV[arg+2], false, false ) : pipe.InFile;
+    pipe.OutFileUnaligned = directIo ? OpenFile( ArgV[arg+3], true, false ) : pipe.OutFile;
+    if( pipe.InFileUnaligned < 0 || pipe.OutFileUnaligned < 0 )
+    {
+        return 1;
+    }
+
+    if( 0 != fstat( pipe.InFile, &inStat ) || !S_ISREG( inStat.st_mode ) )
+    {
+        fprintf( stderr, "%s is not a regular file\n", ArgV[arg+2] );
+        return 1;
+    }
+    if( 0 == fstat( pipe.OutFile, &outStat ) && S_ISREG( outStat.st_mode ) && 0 != ftruncate( pipe.OutFile, 0 ) )
+    {
+        fprintf( stderr, "Unable to truncate %s: %s\n", ArgV[arg+3], strerror( errno ) );
+        return 1;
+    }
+
+    pipe.FileSize = (uint64_t)inStat.st_size;
+    pipe.BufferSize = (uint32_t)bufferKiloBytes * 1024;
+    pipe.NumChunks = ( pipe.FileSize + pipe.BufferSize - 1 ) / pipe.BufferSize;
+    pipe.NumBuffers = (uint32_t)queueDepth;
+    pipe.Buffers = calloc( pipe.NumBuffers, sizeof(Buffer) );
+    bufferPointers = calloc( pipe.NumBuffers, sizeof(void*) );
+    if( NULL == pipe.Buffers || NULL == bufferPointers )
+    {
+        fprintf( stderr, "Out of memory\n" );
+        return 1;
+    }
+    for( i=0; i<(int)pipe.NumBuffers; i++ )
+    {
+        if( 0 != posix_memalign( (void**)&pipe.Buffers[i].Data, BUFFER_ALIGNMENT, pipe.BufferSize ) )
+        {
+            fprintf( stderr, "Out of memory\n" );
+            return 1;
+        }
+        bufferPointers[i] = pipe.Buffers[i].Data;
+    }
+
+    // One read or write in flight per buffer, plus the wake read
+    if( 0 != UringIoInitialise( &ring, pipe.NumBuffers + 1 ) )
+    {
+        fprintf( stderr, "Unable to set up io_uring: %s\n", strerror( errno ) );
+        return 1;
+    }
+    if( 0 != UringIoRegisterBuffers( &ring, bufferPointers, pipe.BufferSize, pipe.NumBuffers ) )
+    {
+        fprintf( stderr, "Unable to register buffers: %s\n", strerror( errno ) );
+        return 1;
+    }
+
+    pipe.WakeFile = eventfd( 0, 0 );
+    if( pipe.WakeFile < 0 )
+    {
+        fprintf( stderr, "Unable to create eventfd: %s\n", strerror( errno ) );
+        return 1;
+    }
+
+    pthread_mutex_init( &pipe.Lock, NULL );
+    pthread_cond_init( &pipe.Changed, NULL );
+
+    startTime = GetTime( );
+
+    if( 0 != pthread_create( &hasher, NULL, HashThread, &pipe ) )
+    {
+        fprintf( stderr, "Unable to create thread\n" );
+        return 1;
+    }
+    for( i=0; i<numThreads; i++ )
+    {
+        if( 0 != pthread_create( &encryptors[i], NULL, EncryptorThread, &pipe ) )
+        {
+            fprintf( stderr, "Unable to create thread\n" );
+            SetFailed( &pipe );
+            numThreads = i;
+            break;
+        }
+    }
+
+    error = DriveRing( &pipe, &ring );
+    if( 0 != error )
+    {
+        SetFailed( &pipe );
+    }
+
+    pthread_join( hasher, NULL );
+    for( i=0; i<numThreads; i++ )
+    {
+        pthread_join( encryptors[i], NULL );
+    }
+
+    elapsed = GetTime( ) - startTime;
+
+    UringIoUninitialise( &ring );
+    close( pipe.WakeFile );
+    if( pipe.OutFileUnaligned != pipe.OutFile && 0 != close( pipe.OutFileUnaligned ) )
+    {
+        error = -1;
+    }
+    if( 0 != close( pipe.OutFile ) )
+    {
+        error = -1;
+    }
+    if( pipe.InFileUnaligned != pipe.InFile )
+    {
+        close( pipe.InFileUnaligned );
+    }
+    close( pipe.InFile );
+
+    for( i=0; i<(int)pipe.NumBuffers; i++ )
+    {
+        free( pipe.Buffers[i].Data );
+    }
+    free( pipe.Buffers );
+    free( bufferPointers );
+    pthread_cond_destroy( &pipe.Changed );
+    pthread_mutex_destroy( &pipe.Lock );
+    memset( &pipe.AesCtr, 0, sizeof(pipe.AesCtr) );
+
+    if( 0 != error )
+    {
+        return 1;
+    }
+
+    Sha256Finalise( &pipe.Sha256, &hash );
+    printf( "SHA-256 of input: " );
+    for( i=0; i<SHA256_HASH_SIZE; i++ )
+    {
+        printf( "%2.2x", hash.bytes[i] );
+    }
+    printf( "\n" );
+
+    printf( "%llu bytes in %.3f seconds: %.2f GiB/s (%ld threads, queue depth %u)\n",
+        (unsigned long long)pipe.FileSize, elapsed,
+        elapsed > 0 ? (double)pipe.FileSize / ( 1024.0 * 1024.0 * 1024.0 ) / elapsed : 0.0,
+        numThreads, pipe.NumBuffers );
+
+    return 0;
+}
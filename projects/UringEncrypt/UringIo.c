@@ -0,0 +1,422 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIo
+//
+//  A minimal io_uring layer for Linux using the system calls directly (no liburing).
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UringIo.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MAX( x, y ) ( ((x)>(y))?(x):(y) )
+
+// The ring indices are shared with the kernel. The tails are published and the heads read with release and acquire
+// ordering so that the entries themselves are visible before the index that covers them.
+#define LoadAcquire( Pointer )              __atomic_load_n( (Pointer), __ATOMIC_ACQUIRE )
+#define StoreRelease( Pointer, Value )      __atomic_store_n( (Pointer), (Value), __ATOMIC_RELEASE )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetSqe
+//
+//  Returns the next free submission queue entry, cleared, or NULL if the queue is full.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+struct io_uring_sqe*
+    GetSqe
+    (
+        UringIo*            Ring                    // [in out]
+    )
+{
+    uint32_t                index;
+    struct io_uring_sqe*    sqe;
+
+    if( Ring->SqLocalTail - LoadAcquire( Ring->SqHead ) >= Ring->SqEntries )
+    {
+        return NULL;
+    }
+
+    index = Ring->SqLocalTail & *Ring->SqRingMask;
+    sqe = &Ring->Sqes[index];
+    memset( sqe, 0, sizeof(*sqe) );
+    Ring->SqArray[index] = index;
+    Ring->SqLocalTail += 1;
+    Ring->SqNumQueued += 1;
+
+    return sqe;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  QueueReadWrite
+//
+//  Fills in a read or write submission queue entry.
+//  Returns 0 if successful, or -1 if the submission queue is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    QueueReadWrite
+    (
+        UringIo*            Ring,                   // [in out]
+        uint8_t             Opcode,                 // [in]
+        int                 File,                   // [in]
+        void const*         Buffer,                 // [in]
+        uint32_t            Size,                   // [in]
+        uint64_t            Offset,                 // [in]
+        uint32_t            BufferIndex,            // [in]
+        uint64_t            UserData                // [in]
+    )
+{
+    struct io_uring_sqe*    sqe = GetSqe( Ring );
+
+    if( NULL == sqe )
+    {
+        return -1;
+    }
+
+    sqe->opcode = Opcode;
+    sqe->fd = File;
+    sqe->addr = (uint64_t)(uintptr_t)Buffer;
+    sqe->len = Size;
+    sqe->off = Offset;
+    sqe->buf_index = (uint16_t)BufferIndex;
+    sqe->user_data = UserData;
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoInitialise
+//
+//  Creates a ring with room for at least NumEntries queued operations.
+//  Returns 0 if successful, or -1 with errno set if the kernel does not support io_uring or it could not be set up
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoInitialise
+    (
+        UringIo*            Ring,                   // [out]
+        uint32_t            NumEntries              // [in]
+    )
+{
+    struct io_uring_params  params;
+    uint8_t*                sqRing;
+    uint8_t*                cqRing;
+
+    memset( Ring, 0, sizeof(*Ring) );
+    memset( &params, 0, sizeof(params) );
+
+    Ring->RingFile = (int)syscall( __NR_io_uring_setup, NumEntries, &params );
+    if( Ring->RingFile < 0 )
+    {
+        return -1;
+    }
+
+    Ring->SqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    Ring->CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if( params.features & IORING_FEAT_SINGLE_MMAP )
+    {
+        // Both queues are in one mapping
+        Ring->SqRingSize = MAX( Ring->SqRingSize, Ring->CqRingSize );
+        Ring->CqRingSize = 0;
+    }
+
+    Ring->SqRing = mmap( NULL, Ring->SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        Ring->RingFile, IORING_OFF_SQ_RING );
+    if( MAP_FAILED == Ring->SqRing )
+    {
+        Ring->SqRing = NULL;
+        UringIoUninitialise( Ring );
+        return -1;
+    }
+
+    if( 0 == Ring->CqRingSize )
+    {
+        Ring->CqRing = Ring->SqRing;
+    }
+    else
+    {
+        Ring->CqRing = mmap( NULL, Ring->CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            Ring->RingFile, IORING_OFF_CQ_RING );
+        if( MAP_FAILED == Ring->CqRing )
+        {
+            Ring->CqRing = NULL;
+            UringIoUninitialise( Ring );
+            return -1;
+        }
+    }
+
+    Ring->SqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    Ring->Sqes = mmap( NULL, Ring->SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        Ring->RingFile, IORING_OFF_SQES );
+    if( MAP_FAILED == Ring->Sqes )
+    {
+        Ring->Sqes = NULL;
+        UringIoUninitialise( Ring );
+        return -1;
+    }
+
+    sqRing = (uint8_t*)Ring->SqRing;
+    Ring->SqHead = (uint32_t*)( sqRing + params.sq_off.head );
+    Ring->SqTail = (uint32_t*)( sqRing + params.sq_off.tail );
+    Ring->SqRingMask = (uint32_t*)( sqRing + params.sq_off.ring_mask );
+    Ring->SqArray = (uint32_t*)( sqRing + params.sq_off.array );
+    Ring->SqEntries = params.sq_entries;
+    Ring->SqLocalTail = *Ring->SqTail;
+
+    cqRing = (uint8_t*)Ring->CqRing;
+    Ring->CqHead = (uint32_t*)( cqRing + params.cq_off.head );
+    Ring->CqTail = (uint32_t*)( cqRing + params.cq_off.tail );
+    Ring->CqRingMask = (uint32_t*)( cqRing + params.cq_off.ring_mask );
+    Ring->Cqes = (struct io_uring_cqe*)( cqRing + params.cq_off.cqes );
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoRegisterBuffers
+//
+//  Registers NumBuffers buffers of BufferSize bytes with the kernel, so that fixed reads and writes into them do not
+//  have to map the pages for every operation. Buffer i is referred to by BufferIndex i.
+//  Returns 0 if successful, or -1 with errno set on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoRegisterBuffers
+    (
+        UringIo*            Ring,                   // [in out]
+        void* const         Buffers [],             // [in]
+        uint32_t            BufferSize,             // [in]
+        uint32_t            NumBuffers              // [in]
+    )
+{
+    struct iovec*   iovecs;
+    uint32_t        i;
+    long            result;
+
+    iovecs = calloc( NumBuffers, sizeof(struct iovec) );
+    if( NULL == iovecs )
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    for( i=0; i<NumBuffers; i++ )
+    {
+        iovecs[i].iov_base = Buffers[i];
+        iovecs[i].iov_len = BufferSize;
+    }
+
+    result = syscall( __NR_io_uring_register, Ring->RingFile, IORING_REGISTER_BUFFERS, iovecs, NumBuffers );
+    free( iovecs );
+
+    return ( result < 0 ) ? -1 : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoQueueReadFixed
+//
+//  Queues a read of Size bytes at Offset of File into Buffer, which must lie within registered buffer BufferIndex.
+//  UserData is returned with the completion. The read is passed to the kernel by the next UringIoSubmit.
+//  Returns 0 if successful, or -1 if the submission queue is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoQueueReadFixed
+    (
+        UringIo*            Ring,                   // [in out]
+        int                 File,                   // [in]
+        void*               Buffer,                 // [out]
+        uint32_t            Size,                   // [in]
+        uint64_t            Offset,                 // [in]
+        uint32_t            BufferIndex,            // [in]
+        uint64_t            UserData                // [in]
+    )
+{
+    return QueueReadWrite( Ring, IORING_OP_READ_FIXED, File, Buffer, Size, Offset, BufferIndex, UserData );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoQueueWriteFixed
+//
+//  Queues a write of Size bytes from Buffer, which must lie within registered buffer BufferIndex, to Offset of File.
+//  UserData is returned with the completion. The write is passed to the kernel by the next UringIoSubmit.
+//  Returns 0 if successful, or -1 if the submission queue is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoQueueWriteFixed
+    (
+        UringIo*            Ring,                   // [in out]
+        int                 File,                   // [in]
+        void const*         Buffer,                 // [in]
+        uint32_t            Size,                   // [in]
+        uint64_t            Offset,                 // [in]
+        uint32_t            BufferIndex,            // [in]
+        uint64_t            UserData                // [in]
+    )
+{
+    return QueueReadWrite( Ring, IORING_OP_WRITE_FIXED, File, Buffer, Size, Offset, BufferIndex, UserData );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoQueueRead
+//
+//  Queues a read of Size bytes into Buffer, which need not be registered (eg an eventfd counter). Offset is ignored
+//  by files that have no position.
+//  Returns 0 if successful, or -1 if the submission queue is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoQueueRead
+    (
+        UringIo*            Ring,                   // [in out]
+        int                 File,                   // [in]
+        void*               Buffer,                 // [out]
+        uint32_t            Size,                   // [in]
+        uint64_t            Offset,                 // [in]
+        uint64_t            UserData                // [in]
+    )
+{
+    return QueueReadWrite( Ring, IORING_OP_READ, File, Buffer, Size, Offset, 0, UserData );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoSubmit
+//
+//  Passes the queued operations to the kernel. Any it does not take yet stay queued for the next call. Fails with
+//  errno EBUSY when the completion queue is full, in which case completions must be reaped before submitting again.
+//  Returns 0 if successful, or -1 with errno set on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoSubmit
+    (
+        UringIo*            Ring                    // [in out]
+    )
+{
+    long    result;
+
+    StoreRelease( Ring->SqTail, Ring->SqLocalTail );
+
+    while( Ring->SqNumQueued > 0 )
+    {
+        result = syscall( __NR_io_uring_enter, Ring->RingFile, Ring->SqNumQueued, 0, 0, NULL, 0 );
+        if( result < 0 )
+        {
+            if( EINTR == errno || EAGAIN == errno )
+            {
+                continue;
+            }
+            return -1;
+        }
+        if( 0 == result )
+        {
+            // Nothing taken, try again on the next call
+            break;
+        }
+        Ring->SqNumQueued -= (uint32_t)result;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoWaitCompletion
+//
+//  Waits for the next completed operation and returns its UserData and result (bytes transferred, or a negative
+//  errno value). Any queued operations are submitted first, as far as the completion queue has room.
+//  Returns 0 if successful, or -1 with errno set on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoWaitCompletion
+    (
+        UringIo*            Ring,                   // [in out]
+        uint64_t*           pUserData,              // [out]
+        int32_t*            pResult                 // [out]
+    )
+{
+    uint32_t                head;
+    struct io_uring_cqe*    cqe;
+    long                    result;
+
+    // A full completion queue is drained here and the rest submitted on the next call
+    if( 0 != UringIoSubmit( Ring ) && EBUSY != errno )
+    {
+        return -1;
+    }
+
+    for( ;; )
+    {
+        head = *Ring->CqHead;
+        if( head != LoadAcquire( Ring->CqTail ) )
+        {
+            cqe = &Ring->Cqes[ head & *Ring->CqRingMask ];
+            *pUserData = cqe->user_data;
+            *pResult = cqe->res;
+            StoreRelease( Ring->CqHead, head + 1 );
+            return 0;
+        }
+
+        // Submits anything still queued while waiting, so it cannot wait for operations the kernel has not got
+        result = syscall( __NR_io_uring_enter, Ring->RingFile, Ring->SqNumQueued, 1, IORING_ENTER_GETEVENTS, NULL, 0 );
+        if( result < 0 )
+        {
+            if( EINTR != errno && EBUSY != errno )
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            Ring->SqNumQueued -= (uint32_t)result;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoUninitialise
+//
+//  Closes the ring and unmaps its queues. Registered buffers are unregistered by the kernel, but not freed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    UringIoUninitialise
+    (
+        UringIo*            Ring                    // [in out]
+    )
+{
+    if( NULL != Ring->Sqes )
+    {
+        munmap( Ring->Sqes, Ring->SqesSize );
+    }
+    if( NULL != Ring->CqRing && Ring->CqRing != Ring->SqRing )
+    {
+        munmap( Ring->CqRing, Ring->CqRingSize );
+    }
+    if( NULL != Ring->SqRing )
+    {
+        munmap( Ring->SqRing, Ring->SqRingSize );
+    }
+    if( Ring->RingFile >= 0 )
+    {
+        close( Ring->RingFile );
+    }
+
+    memset( Ring, 0, sizeof(*Ring) );
+    Ring->RingFile = -1;
+}
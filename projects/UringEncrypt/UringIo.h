@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIo
+//
+//  A minimal io_uring layer for Linux using the system calls directly (no liburing). It sets up a ring, registers
+//  fixed buffers, queues reads and writes, and reaps completions.
+//
+//  A ring is not locked. Queue and submit from one thread, and reap completions from one thread (which may be the
+//  same one). Other threads should hand work to that thread, for example with an eventfd read queued on the ring.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+#include <linux/io_uring.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// UringIo - Initialise with UringIoInitialise. Do not modify the contents of this structure directly.
+typedef struct
+{
+    int                     RingFile;
+
+    // Submission queue (shared with the kernel)
+    uint32_t*               SqHead;
+    uint32_t*               SqTail;
+    uint32_t*               SqRingMask;
+    uint32_t*               SqArray;
+    struct io_uring_sqe*    Sqes;
+    uint32_t                SqEntries;
+    uint32_t                SqLocalTail;        // Next entry to fill, ahead of *SqTail until submitted
+    uint32_t                SqNumQueued;        // Entries queued and not yet passed to the kernel
+
+    // Completion queue (shared with the kernel)
+    uint32_t*               CqHead;
+    uint32_t*               CqTail;
+    uint32_t*               CqRingMask;
+    struct io_uring_cqe*    Cqes;
+
+    void*                   SqRing;
+    size_t                  SqRingSize;
+    void*                   CqRing;
+    size_t                  CqRingSize;
+    size_t                  SqesSize;
+} UringIo;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoInitialise
+//
+//  Creates a ring with room for at least NumEntries queued operations.
+//  Returns 0 if successful, or -1 with errno set if the kernel does not support io_uring or it could not be set up
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoInitialise
+    (
+        UringIo*            Ring,                   // [out]
+        uint32_t            NumEntries              // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoRegisterBuffers
+//
+//  Registers NumBuffers buffers of BufferSize bytes with the kernel, so that fixed reads and writes into them do not
+//  have to map the pages for every operation. Buffer i is referred to by BufferIndex i.
+//  Returns 0 if successful, or -1 with errno set on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoRegisterBuffers
+    (
+        UringIo*            Ring,                   // [in out]
+        void* const         Buffers [],             // [in]
+        uint32_t            BufferSize,             // [in]
+        uint32_t            NumBuffers              // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoQueueReadFixed
+//
+//  Queues a read of Size bytes at Offset of File into Buffer, which must lie within registered buffer BufferIndex.
+//  UserData is returned with the completion. The read is passed to the kernel by the next UringIoSubmit.
+//  Returns 0 if successful, or -1 if the submission queue is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoQueueReadFixed
+    (
+        UringIo*            Ring,                   // [in out]
+        int                 File,                   // [in]
+        void*               Buffer,                 // [out]
+        uint32_t            Size,                   // [in]
+        uint64_t            Offset,                 // [in]
+        uint32_t            BufferIndex,            // [in]
+        uint64_t            UserData                // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoQueueWriteFixed
+//
+//  Queues a write of Size bytes from Buffer, which must lie within registered buffer BufferIndex, to Offset of File.
+//  UserData is returned with the completion. The write is passed to the kernel by the next UringIoSubmit.
+//  Returns 0 if successful, or -1 if the submission queue is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoQueueWriteFixed
+    (
+        UringIo*            Ring,                   // [in out]
+        int                 File,                   // [in]
+        void const*         Buffer,                 // [in]
+        uint32_t            Size,                   // [in]
+        uint64_t            Offset,                 // [in]
+        uint32_t            BufferIndex,            // [in]
+        uint64_t            UserData                // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoQueueRead
+//
+//  Queues a read of Size bytes into Buffer, which need not be registered (eg an eventfd counter). Offset is ignored
+//  by files that have no position.
+//  Returns 0 if successful, or -1 if the submission queue is full
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoQueueRead
+    (
+        UringIo*            Ring,                   // [in out]
+        int                 File,                   // [in]
+        void*               Buffer,                 // [out]
+        uint32_t            Size,                   // [in]
+        uint64_t            Offset,                 // [in]
+        uint64_t            UserData                // [in]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoSubmit
+//
+//  Passes the queued operations to the kernel. Any it does not take yet stay queued for the next call. Fails with
+//  errno EBUSY when the completion queue is full, in which case completions must be reaped before submitting again.
+//  Returns 0 if successful, or -1 with errno set on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoSubmit
+    (
+        UringIo*            Ring                    // [in out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoWaitCompletion
+//
+//  Waits for the next completed operation and returns its UserData and result (bytes transferred, or a negative
+//  errno value). Any queued operations are submitted first, as far as the completion queue has room.
+//  Returns 0 if successful, or -1 with errno set on error
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    UringIoWaitCompletion
+    (
+        UringIo*            Ring,                   // [in out]
+        uint64_t*           pUserData,              // [out]
+        int32_t*            pResult                 // [out]
+    );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UringIoUninitialise
+//
+//  Closes the ring and unmaps its queues. Registered buffers are unregistered by the kernel, but not freed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+    UringIoUninitialise
+    (
+        UringIo*            Ring                    // [in out]
+    );
@@ -0,0 +1,631 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibBench
+//
+//  Measures the throughput of the library's algorithms, including each implementation of those that have more than
+//  one (eg the portable C and processor specific versions). Results are printed in MB/s.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "WjCryptLib_AesCtrDrbg.h"
+#include "WjCryptLib_AesCtrSha256.h"
+#include "WjCryptLib_Cpu.h"
+#include "WjCryptLib_HmacDrbg.h"
+#include "WjCryptLib_Md5.h"
+#include "WjCryptLib_Rc4.h"
+#include "WjCryptLib_Sha1.h"
+#include "WjCryptLib_Sha512.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Prepares for a benchmark (eg selecting an implementation). Returns 0 if the benchmark can run, or -1 to skip it.
+typedef int (*BenchmarkSetupFunc)( void );
+
+// Processes Size bytes of Buffer once
+typedef void (*BenchmarkFunc)( uint8_t const* Buffer, uint32_t Size );
+
+typedef struct
+{
+    char const*             Name;
+    BenchmarkSetupFunc      Setup;
+    BenchmarkFunc           Function;
+    uint32_t                BytesPerKey;        // If not 0 the result is in keys/s, one key per this many bytes
+} Benchmark;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define BUFFER_SIZE             ( 1024 * 1024 )
+#define DEFAULT_MEGABYTES       64
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetTime
+//
+//  Returns a wall clock time in seconds
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+double
+    GetTime
+    (
+        void
+    )
+{
+    struct timespec     now;
+
+    timespec_get( &now, TIME_UTC );
+    return (double)now.tv_sec + ( (double)now.tv_nsec / 1e9 );
+}
+
+// Setup for benchmarks that have only one implementation
+static int SetupNone( void ) { return 0; }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MD5
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of each object in the multi-buffer benchmark (a typical small object hashed for an ETag)
+#define MD5_OBJECT_SIZE         4096
+#define MD5_NUM_OBJECTS         ( BUFFER_SIZE / MD5_OBJECT_SIZE )
+
+static int SetupMd5Portable( void ) { return Md5SetImplementation( MD5_IMPLEMENTATION_PORTABLE ); }
+static int SetupMd5Sse2( void ) { return Md5SetImplementation( MD5_IMPLEMENTATION_SSE2 ); }
+static int SetupMd5Avx2( void ) { return Md5SetImplementation( MD5_IMPLEMENTATION_AVX2 ); }
+static int SetupMd5Avx512( void ) { return Md5SetImplementation( MD5_IMPLEMENTATION_AVX512 ); }
+
+static
+void
+    BenchmarkMd5
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    MD5_HASH    hash;
+
+    Md5Calculate( Buffer, Size, &hash );
+}
+
+static
+void
+    BenchmarkMd5Multiple
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    void const*     buffers [MD5_NUM_OBJECTS];
+    uint32_t        sizes [MD5_NUM_OBJECTS];
+    MD5_HASH        hashes [MD5_NUM_OBJECTS];
+    uint32_t        i;
+
+    // Size is always BUFFER_SIZE, which is split into objects
+    (void)Size;
+    for( i=0; i<MD5_NUM_OBJECTS; i++ )
+    {
+        buffers[i] = Buffer + (i * MD5_OBJECT_SIZE);
+        sizes[i] = MD5_OBJECT_SIZE;
+    }
+
+    Md5CalculateMultiple( buffers, sizes, MD5_NUM_OBJECTS, hashes );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SHA1
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int SetupSha1Portable( void ) { return Sha1SetImplementation( SHA1_IMPLEMENTATION_PORTABLE ); }
+static int SetupSha1ShaNi( void ) { return Sha1SetImplementation( SHA1_IMPLEMENTATION_SHANI ); }
+
+static
+void
+    BenchmarkSha1
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    SHA1_HASH   hash;
+
+    Sha1Calculate( Buffer, Size, &hash );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SHA512
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of each payload in the multi-buffer benchmark
+#define SHA512_OBJECT_SIZE      2048
+#define SHA512_NUM_OBJECTS      ( BUFFER_SIZE / SHA512_OBJECT_SIZE )
+
+static int SetupSha512Portable( void ) { return Sha512SetImplementation( SHA512_IMPLEMENTATION_PORTABLE ); }
+static int SetupSha512Avx2( void ) { return Sha512SetImplementation( SHA512_IMPLEMENTATION_AVX2 ); }
+static int SetupSha512Avx512( void ) { return Sha512SetImplementation( SHA512_IMPLEMENTATION_AVX512 ); }
+
+static
+void
+    BenchmarkSha512
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    SHA512_HASH     hash;
+
+    Sha512Calculate( Buffer, Size, &hash );
+}
+
+static
+void
+    BenchmarkSha512Multiple
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    void const*     buffers [SHA512_NUM_OBJECTS];
+    uint32_t        sizes [SHA512_NUM_OBJECTS];
+    SHA512_HASH     hashes [SHA512_NUM_OBJECTS];
+    uint32_t        i;
+
+    // Size is always BUFFER_SIZE, which is split into objects
+    (void)Size;
+    for( i=0; i<SHA512_NUM_OBJECTS; i++ )
+    {
+        buffers[i] = Buffer + (i * SHA512_OBJECT_SIZE);
+        sizes[i] = SHA512_OBJECT_SIZE;
+    }
+
+    Sha512CalculateMultiple( buffers, sizes, SHA512_NUM_OBJECTS, hashes );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  RC4
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of each record in the RC4 benchmarks, each of which has its own key
+#define RC4_RECORD_SIZE         4096
+#define RC4_NUM_RECORDS         ( BUFFER_SIZE / RC4_RECORD_SIZE )
+#define RC4_KEY_SIZE            16
+
+static uint8_t              gRc4Output [BUFFER_SIZE];
+
+static
+void
+    BenchmarkRc4Records
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    uint32_t    i;
+
+    // Size is always BUFFER_SIZE, which is split into records. The key of each record is taken from its start.
+    (void)Size;
+    for( i=0; i<RC4_NUM_RECORDS; i++ )
+    {
+        Rc4XorWithKey( Buffer + (i * RC4_RECORD_SIZE), RC4_KEY_SIZE, 0,
+            Buffer + (i * RC4_RECORD_SIZE), gRc4Output + (i * RC4_RECORD_SIZE), RC4_RECORD_SIZE );
+    }
+}
+
+static
+void
+    BenchmarkRc4RecordsMultiple
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    uint8_t const*  keys [RC4_NUM_RECORDS];
+    uint32_t        keySizes [RC4_NUM_RECORDS];
+    void const*     inBuffers [RC4_NUM_RECORDS];
+    void*           outBuffers [RC4_NUM_RECORDS];
+    uint32_t        sizes [RC4_NUM_RECORDS];
+    uint32_t        i;
+
+    (void)Size;
+    for( i=0; i<RC4_NUM_RECORDS; i++ )
+    {
+        keys[i] = Buffer + (i * RC4_RECORD_SIZE);
+        keySizes[i] = RC4_KEY_SIZE;
+        inBuffers[i] = Buffer + (i * RC4_RECORD_SIZE);
+        outBuffers[i] = gRc4Output + (i * RC4_RECORD_SIZE);
+        sizes[i] = RC4_RECORD_SIZE;
+    }
+
+    Rc4XorWithKeyMultiple( keys, keySizes, 0, inBuffers, outBuffers, sizes, RC4_NUM_RECORDS );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  RC4 key setup
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// RC4-drop[3072] key setup: one key of RC4_KEY_SIZE bytes for every RC4_BYTES_PER_KEY bytes of the buffer. The cached
+// benchmark uses only RC4_NUM_DISTINCT_KEYS different keys, which all fit in its cache.
+#define RC4_DROP                3072
+#define RC4_BYTES_PER_KEY       1024
+#define RC4_NUM_KEYS            ( BUFFER_SIZE / RC4_BYTES_PER_KEY )
+#define RC4_NUM_DISTINCT_KEYS   64
+#define RC4_CACHE_ENTRIES       1024
+
+static Rc4Context           gRc4Contexts [RC4_NUM_KEYS];
+static uint8_t              gRc4Keys [RC4_NUM_KEYS][RC4_KEY_SIZE];
+static Rc4StateCacheEntry   gRc4CacheEntries [RC4_CACHE_ENTRIES];
+static Rc4StateCache        gRc4Cache;
+
+// Makes every key different by putting its index in its first bytes
+static
+void
+    MakeRc4Keys
+    (
+        uint8_t const*      Buffer          // [in]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<RC4_NUM_KEYS; i++ )
+    {
+        memcpy( gRc4Keys[i], Buffer + (i * RC4_BYTES_PER_KEY), RC4_KEY_SIZE );
+        gRc4Keys[i][0] = (uint8_t)i;
+        gRc4Keys[i][1] = (uint8_t)( i >> 8 );
+    }
+}
+
+static
+void
+    BenchmarkRc4KeySetup
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    uint32_t    i;
+
+    (void)Size;
+    MakeRc4Keys( Buffer );
+    for( i=0; i<RC4_NUM_KEYS; i++ )
+    {
+        Rc4Initialise( &gRc4Contexts[i], gRc4Keys[i], RC4_KEY_SIZE, RC4_DROP );
+    }
+}
+
+static
+void
+    BenchmarkRc4KeySetupMultiple
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    Rc4Context*     contexts [RC4_NUM_KEYS];
+    uint8_t const*  keys [RC4_NUM_KEYS];
+    uint32_t        keySizes [RC4_NUM_KEYS];
+    uint32_t        i;
+
+    (void)Size;
+    MakeRc4Keys( Buffer );
+    for( i=0; i<RC4_NUM_KEYS; i++ )
+    {
+        contexts[i] = &gRc4Contexts[i];
+        keys[i] = gRc4Keys[i];
+        keySizes[i] = RC4_KEY_SIZE;
+    }
+
+    Rc4InitialiseMultiple( contexts, keys, keySizes, RC4_DROP, RC4_NUM_KEYS );
+}
+
+static
+int
+    SetupRc4Cache
+    (
+        void
+    )
+{
+    return Rc4StateCacheInitialise( &gRc4Cache, gRc4CacheEntries, RC4_CACHE_ENTRIES, RC4_DROP );
+}
+
+static
+void
+    BenchmarkRc4KeySetupCached
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    uint32_t    i;
+
+    (void)Size;
+    MakeRc4Keys( Buffer );
+    for( i=0; i<RC4_NUM_KEYS; i++ )
+    {
+        Rc4InitialiseWithCache( &gRc4Cache, &gRc4Contexts[i], gRc4Keys[i % RC4_NUM_DISTINCT_KEYS], RC4_KEY_SIZE );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  AES-CTR + SHA256
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static AesCtrContext        gAesCtr;
+static Sha256Context        gAesCtrSha256;
+static uint8_t              gAesCtrOutput [BUFFER_SIZE];
+
+static
+int
+    SetupAesCtrSha256
+    (
+        void
+    )
+{
+    static uint8_t const    key [AES_KEY_SIZE_256] = {0};
+    static uint8_t const    iv [AES_CTR_IV_SIZE] = {0};
+
+    Sha256Initialise( &gAesCtrSha256 );
+    return AesCtrInitialiseWithKey( &gAesCtr, key, sizeof(key), iv );
+}
+
+static
+void
+    BenchmarkAesCtrThenSha256
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    // Two passes: encrypt the whole buffer, then hash the ciphertext
+    AesCtrXor( &gAesCtr, Buffer, gAesCtrOutput, Size );
+    Sha256Update( &gAesCtrSha256, gAesCtrOutput, Size );
+}
+
+static
+void
+    BenchmarkAesCtrSha256
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    AesCtrSha256Encrypt( &gAesCtr, &gAesCtrSha256, Buffer, gAesCtrOutput, Size );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  DRBG
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of each request in the DRBG benchmarks (eg a nonce), and of the output buffer when buffered
+#define DRBG_REQUEST_SIZE       16
+#define DRBG_OUTPUT_BUFFER_SIZE 4096
+
+static AesCtrDrbgContext    gAesCtrDrbg;
+static HmacDrbgContext      gHmacDrbg;
+static uint8_t              gDrbgOutputBuffer [DRBG_OUTPUT_BUFFER_SIZE];
+static uint8_t const        gDrbgEntropy [32] = {0};
+
+static
+int
+    SetupAesCtrDrbg
+    (
+        void
+    )
+{
+    AesCtrDrbgInitialise( &gAesCtrDrbg, AES_KEY_SIZE_256, gDrbgEntropy, sizeof(gDrbgEntropy), NULL, 0, NULL, 0 );
+    return 0;
+}
+
+static
+int
+    SetupAesCtrDrbgBuffered
+    (
+        void
+    )
+{
+    SetupAesCtrDrbg( );
+    return AesCtrDrbgSetOutputBuffer( &gAesCtrDrbg, gDrbgOutputBuffer, sizeof(gDrbgOutputBuffer) );
+}
+
+static
+void
+    BenchmarkAesCtrDrbg
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    uint8_t     output [DRBG_REQUEST_SIZE];
+    uint32_t    i;
+
+    // The input is not used, Size is the amount of output to generate
+    (void)Buffer;
+    for( i=0; i<Size/DRBG_REQUEST_SIZE; i++ )
+    {
+        AesCtrDrbgRandom( &gAesCtrDrbg, output, sizeof(output) );
+    }
+}
+
+static
+int
+    SetupHmacDrbg
+    (
+        void
+    )
+{
+    HmacDrbgInitialise( &gHmacDrbg, gDrbgEntropy, sizeof(gDrbgEntropy), NULL, 0, NULL, 0 );
+    return 0;
+}
+
+static
+int
+    SetupHmacDrbgBuffered
+    (
+        void
+    )
+{
+    SetupHmacDrbg( );
+    return HmacDrbgSetOutputBuffer( &gHmacDrbg, gDrbgOutputBuffer, sizeof(gDrbgOutputBuffer) );
+}
+
+static
+void
+    BenchmarkHmacDrbg
+    (
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            Size            // [in]
+    )
+{
+    uint8_t     output [DRBG_REQUEST_SIZE];
+    uint32_t    i;
+
+    // The input is not used, Size is the amount of output to generate
+    (void)Buffer;
+    for( i=0; i<Size/DRBG_REQUEST_SIZE; i++ )
+    {
+        HmacDrbgRandom( &gHmacDrbg, output, sizeof(output) );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static Benchmark gBenchmarks [] =
+{
+    { "MD5",                                SetupNone,              BenchmarkMd5,                   0 },
+    { "MD5 multi-buffer (portable)",        SetupMd5Portable,       BenchmarkMd5Multiple,           0 },
+    { "MD5 multi-buffer (SSE2 x4)",         SetupMd5Sse2,           BenchmarkMd5Multiple,           0 },
+    { "MD5 multi-buffer (AVX2 x8)",         SetupMd5Avx2,           BenchmarkMd5Multiple,           0 },
+    { "MD5 multi-buffer (AVX-512 x16)",     SetupMd5Avx512,         BenchmarkMd5Multiple,           0 },
+    { "SHA1 (portable)",                    SetupSha1Portable,      BenchmarkSha1,                  0 },
+    { "SHA1 (SHA extensions)",              SetupSha1ShaNi,         BenchmarkSha1,                  0 },
+    { "SHA512 (portable)",                  SetupSha512Portable,    BenchmarkSha512,                0 },
+    { "SHA512 (AVX2 schedule)",             SetupSha512Avx2,        BenchmarkSha512,                0 },
+    { "SHA512 multi-buffer (AVX2 x4)",      SetupSha512Avx2,        BenchmarkSha512Multiple,        0 },
+    { "SHA512 multi-buffer (AVX-512 x8)",   SetupSha512Avx512,      BenchmarkSha512Multiple,        0 },
+    { "RC4 4KB records",                    SetupNone,              BenchmarkRc4Records,            0 },
+    { "RC4 4KB records (multi-stream)",     SetupNone,              BenchmarkRc4RecordsMultiple,    0 },
+    { "RC4-drop3072 key setup",             SetupNone,              BenchmarkRc4KeySetup,           RC4_BYTES_PER_KEY },
+    { "RC4-drop3072 key setup (batched)",   SetupNone,              BenchmarkRc4KeySetupMultiple,   RC4_BYTES_PER_KEY },
+    { "RC4-drop3072 key setup (cached)",    SetupRc4Cache,          BenchmarkRc4KeySetupCached,     RC4_BYTES_PER_KEY },
+    { "AES-CTR then SHA256",                SetupAesCtrSha256,      BenchmarkAesCtrThenSha256,      0 },
+    { "AES-CTR then SHA256 (fused)",        SetupAesCtrSha256,      BenchmarkAesCtrSha256,          0 },
+    { "CTR_DRBG 16B requests",              SetupAesCtrDrbg,        BenchmarkAesCtrDrbg,            0 },
+    { "CTR_DRBG 16B requests (buffered)",   SetupAesCtrDrbgBuffered, BenchmarkAesCtrDrbg,           0 },
+    { "HMAC_DRBG 16B requests",             SetupHmacDrbg,          BenchmarkHmacDrbg,              0 },
+    { "HMAC_DRBG 16B (buffered)",           SetupHmacDrbgBuffered,  BenchmarkHmacDrbg,              0 },
+};
+#define NUM_BENCHMARKS ( sizeof(gBenchmarks) / sizeof(gBenchmarks[0]) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  RestoreDefaults
+//
+//  Returns every algorithm to its automatically selected implementation
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    RestoreDefaults
+    (
+        void
+    )
+{
+    Md5SetImplementation( MD5_IMPLEMENTATION_AUTO );
+    Sha1SetImplementation( SHA1_IMPLEMENTATION_AUTO );
+    Sha512SetImplementation( SHA512_IMPLEMENTATION_AUTO );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  main
+//
+//  Program entry point
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    main
+    (
+        int             ArgC,
+        char**          ArgV
+    )
+{
+    uint32_t        megabytes = DEFAULT_MEGABYTES;
+    uint8_t*        buffer;
+    uint32_t        i;
+    uint32_t        n;
+    double          startTime;
+    double          elapsed;
+    uint32_t        feature;
+
+    if( ArgC > 2 || ( 2 == ArgC && 0 == ( megabytes = (uint32_t)atoi( ArgV[1] ) ) ) )
+    {
+        printf(
+            "Syntax\n"
+            "   WjCryptLibBench [MegaBytes]\n"
+            "     [MegaBytes] - Amount of data to process for each benchmark (default %u)\n",
+            DEFAULT_MEGABYTES );
+        return 1;
+    }
+
+    buffer = malloc( BUFFER_SIZE );
+    if( NULL == buffer )
+    {
+        printf( "Out of memory\n" );
+        return 1;
+    }
+    for( i=0; i<BUFFER_SIZE; i++ )
+    {
+        buffer[i] = (uint8_t)( i * 31 + 7 );
+    }
+
+    // Show which processor features the implementations may use, and any disabled with WJCRYPTLIB_CPU_DISABLE
+    printf( "CPU features:" );
+    for( feature=1; 0 != (feature & CPU_FEATURE_ALL); feature<<=1 )
+    {
+        if( 0 != (feature & CpuGetDetectedFeatures( )) )
+        {
+            printf( " %s%s", CpuGetFeatureName( feature ), 0 != (feature & CpuGetDisabledFeatures( )) ? "(off)" : "" );
+        }
+    }
+    printf( "\n\n" );
+
+    for( i=0; i<NUM_BENCHMARKS; i++ )
+    {
+        if( 0 != gBenchmarks[i].Setup( ) )
+        {
+            printf( "%-32s  not supported\n", gBenchmarks[i].Name );
+            continue;
+        }
+
+        startTime = GetTime( );
+        for( n=0; n<megabytes; n++ )
+        {
+            gBenchmarks[i].Function( buffer, BUFFER_SIZE );
+        }
+        elapsed = GetTime( ) - startTime;
+
+        if( 0 != gBenchmarks[i].BytesPerKey )
+        {
+            printf( "%-32s  %9.0f keys/s\n", gBenchmarks[i].Name,
+                elapsed > 0 ? (double)megabytes * ( BUFFER_SIZE / gBenchmarks[i].BytesPerKey ) / elapsed : 0.0 );
+        }
+        else
+        {
+            printf( "%-32s  %9.1f MB/s\n", gBenchmarks[i].Name, elapsed > 0 ? megabytes / elapsed : 0.0 );
+        }
+        RestoreDefaults( );
+    }
+
+    free( buffer );
+    return 0;
+}
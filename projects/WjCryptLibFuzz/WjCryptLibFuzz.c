@@ -0,0 +1,1132 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibFuzz
+//
+//  Differential fuzz target for libFuzzer. The first byte of an input selects a primitive, the next four seed the
+//  sizes of the chunks the message is fed in, and the rest supply keys and the message. Each primitive is then run in
+//  several ways that must give identical results:
+//     one call against many calls on random split points (Update, Xor, Output, Encrypt)
+//     every implementation available on this processor against the portable one
+//     multi-buffer and batch functions against one buffer at a time
+//     decrypting or unwrapping against the original, and corrupted input against rejection
+//  Any disagreement aborts, which libFuzzer reports with the input that caused it.
+//
+//  Built with clang the library and this file are compiled with -fsanitize=fuzzer. With other compilers
+//  WjCryptLibFuzzMain.c supplies a main that runs random or given inputs.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "WjCryptLibFuzz.h"
+#include "WjCryptLib_Aes.h"
+#include "WjCryptLib_AesCbc.h"
+#include "WjCryptLib_AesCcm.h"
+#include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_AesCtrSha256.h"
+#include "WjCryptLib_AesGcmSiv.h"
+#include "WjCryptLib_AesKeyWrap.h"
+#include "WjCryptLib_AesOfb.h"
+#include "WjCryptLib_Hmac.h"
+#include "WjCryptLib_Md5.h"
+#include "WjCryptLib_Rc4.h"
+#include "WjCryptLib_Sha1.h"
+#include "WjCryptLib_Sha256.h"
+#include "WjCryptLib_Sha512.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Longest message used. Longer inputs are truncated.
+#define MAX_MESSAGE_SIZE        ( 64 * 1024 )
+
+// Most buffers or streams given to the multi-buffer and batch functions, and the most bytes in each stream
+#define MAX_PIECES              20
+#define MAX_STREAMS             12
+#define MAX_STREAM_SIZE         4096
+
+#define FUZZ_TARGET_MD5             0
+#define FUZZ_TARGET_SHA1            1
+#define FUZZ_TARGET_SHA256          2
+#define FUZZ_TARGET_SHA512          3
+#define FUZZ_TARGET_RC4             4
+#define FUZZ_TARGET_AES_CTR         5
+#define FUZZ_TARGET_AES_CTR_SHA256  6
+#define FUZZ_TARGET_AES_OFB         7
+#define FUZZ_TARGET_AES_CBC         8
+#define FUZZ_TARGET_AES_CCM         9
+#define FUZZ_TARGET_AES_GCM_SIV     10
+#define FUZZ_TARGET_AES_KEY_WRAP    11
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+#define FUZZ_CHECK( Condition, Description )                                                \
+    if( !(Condition) )                                                                      \
+    {                                                                                       \
+        fprintf( stderr, "WjCryptLibFuzz: %s (line %d)\n", (Description), __LINE__ );      \
+        abort( );                                                                           \
+    }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The part of the input not yet used, and the state of the generator of chunk sizes
+typedef struct
+{
+    uint8_t const*  Data;
+    size_t          Size;
+    uint32_t        SplitState;
+} FuzzInput;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// libFuzzer runs inputs one at a time, so the buffers are shared by all the targets
+static uint8_t      gMessage [MAX_MESSAGE_SIZE];
+static uint8_t      gExpected [MAX_MESSAGE_SIZE + AES_BLOCK_SIZE];
+static uint8_t      gOutput [MAX_MESSAGE_SIZE + AES_BLOCK_SIZE];
+static uint8_t      gStreams [MAX_STREAMS * MAX_STREAM_SIZE];
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Input
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TakeByte
+//
+//  Returns the next byte of the input, or 0 once it is used up.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint8_t
+    TakeByte
+    (
+        FuzzInput*      Input           // [in out]
+    )
+{
+    uint8_t     value = 0;
+
+    if( Input->Size > 0 )
+    {
+        value = Input->Data[0];
+        Input->Data += 1;
+        Input->Size -= 1;
+    }
+
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TakeBytes
+//
+//  Copies the next Size bytes of the input to Buffer, zero filling any beyond the end of the input.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    TakeBytes
+    (
+        FuzzInput*      Input,          // [in out]
+        void*           Buffer,         // [out]
+        uint32_t        Size            // [in]
+    )
+{
+    uint32_t    amount = (uint32_t)MIN( (size_t)Size, Input->Size );
+
+    memcpy( Buffer, Input->Data, amount );
+    memset( (uint8_t*)Buffer + amount, 0, Size - amount );
+    Input->Data += amount;
+    Input->Size -= amount;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TakeMessage
+//
+//  Copies the rest of the input (up to MAX_MESSAGE_SIZE bytes) to gMessage.
+//  Returns the size of the message
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    TakeMessage
+    (
+        FuzzInput*      Input           // [in out]
+    )
+{
+    uint32_t    size = (uint32_t)MIN( Input->Size, (size_t)MAX_MESSAGE_SIZE );
+
+    TakeBytes( Input, gMessage, size );
+    return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  NextChunk
+//
+//  Returns the size of the next chunk to process, at most Remaining. Mostly small chunks that split blocks in odd
+//  places, sometimes zero, sometimes larger, and sometimes everything left.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    NextChunk
+    (
+        FuzzInput*      Input,          // [in out]
+        uint32_t        Remaining       // [in]
+    )
+{
+    uint32_t    x = Input->SplitState;
+    uint32_t    size;
+
+    // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    Input->SplitState = x;
+
+    switch( x & 3 )
+    {
+    case 0:     size = ( x >> 8 ) % 17;                 break;
+    case 1:     size = ( x >> 8 ) % 200 + 1;            break;
+    case 2:     size = ( x >> 8 ) % 4096 + 1;           break;
+    default:    size = Remaining;                       break;
+    }
+
+    return MIN( size, Remaining );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  NextBlockChunk
+//
+//  Returns the size of the next chunk to process as a whole number of AES blocks, at most Remaining (which is also a
+//  whole number of blocks).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    NextBlockChunk
+    (
+        FuzzInput*      Input,          // [in out]
+        uint32_t        Remaining       // [in]
+    )
+{
+    return NextChunk( Input, Remaining / AES_BLOCK_SIZE ) * AES_BLOCK_SIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SplitPieces
+//
+//  Splits Size bytes at Message into at most MaxPieces consecutive pieces of random sizes.
+//  Returns the number of pieces
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    SplitPieces
+    (
+        FuzzInput*      Input,                  // [in out]
+        uint8_t const*  Message,                // [in]
+        uint32_t        Size,                   // [in]
+        uint32_t        MaxPieces,              // [in]
+        void const*     Pieces [],              // [out]
+        uint32_t        PieceSizes []           // [out]
+    )
+{
+    uint32_t    numPieces = 1 + TakeByte( Input ) % MaxPieces;
+    uint32_t    offset = 0;
+    uint32_t    i;
+
+    for( i=0; i<numPieces; i++ )
+    {
+        Pieces[i] = Message + offset;
+        PieceSizes[i] = ( i == numPieces - 1 ) ? ( Size - offset ) : NextChunk( Input, Size - offset );
+        offset += PieceSizes[i];
+    }
+
+    return numPieces;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TakeAesKeySize
+//
+//  Returns AES_KEY_SIZE_128, 192, or 256 chosen by the next byte of the input.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    TakeAesKeySize
+    (
+        FuzzInput*      Input           // [in out]
+    )
+{
+    uint32_t const  keySizes [] = { AES_KEY_SIZE_128, AES_KEY_SIZE_192, AES_KEY_SIZE_256 };
+
+    return keySizes[ TakeByte( Input ) % 3 ];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Hashes
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzMd5
+//
+//  MD5 streaming against one call, and Md5CalculateMultiple with every implementation against Md5Calculate.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzMd5
+    (
+        FuzzInput*      Input           // [in out]
+    )
+{
+    uint32_t const  implementations [] = { MD5_IMPLEMENTATION_PORTABLE, MD5_IMPLEMENTATION_SSE2,
+                                           MD5_IMPLEMENTATION_AVX2, MD5_IMPLEMENTATION_AVX512 };
+    void const*     pieces [MAX_PIECES];
+    uint32_t        pieceSizes [MAX_PIECES];
+    uint32_t        numPieces;
+    MD5_HASH        expected [MAX_PIECES];
+    MD5_HASH        digests [MAX_PIECES];
+    Md5Context      context;
+    uint32_t        size;
+    uint32_t        offset;
+    uint32_t        chunk;
+    uint32_t        i;
+
+    size = TakeMessage( Input );
+    numPieces = SplitPieces( Input, gMessage, size, MAX_PIECES, pieces, pieceSizes );
+
+    Md5Calculate( gMessage, size, &expected[0] );
+    Md5Initialise( &context );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        Md5Update( &context, gMessage + offset, chunk );
+    }
+    Md5Finalise( &context, &digests[0] );
+    FUZZ_CHECK( 0 == memcmp( &digests[0], &expected[0], sizeof(MD5_HASH) ), "MD5 streaming differs" );
+
+    for( i=0; i<numPieces; i++ )
+    {
+        Md5Calculate( pieces[i], pieceSizes[i], &expected[i] );
+    }
+    for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+    {
+        if( 0 != Md5SetImplementation( implementations[i] ) )
+        {
+            continue;
+        }
+        Md5CalculateMultiple( pieces, pieceSizes, numPieces, digests );
+        FUZZ_CHECK( 0 == memcmp( digests, expected, numPieces * sizeof(MD5_HASH) ), "MD5 multiple differs" );
+    }
+    Md5SetImplementation( MD5_IMPLEMENTATION_AUTO );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzSha1
+//
+//  SHA1 streaming and one call with every implementation against the portable one call.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzSha1
+    (
+        FuzzInput*      Input           // [in out]
+    )
+{
+    uint32_t const  implementations [] = { SHA1_IMPLEMENTATION_PORTABLE, SHA1_IMPLEMENTATION_SHANI };
+    SHA1_HASH       expected;
+    SHA1_HASH       digest;
+    Sha1Context     context;
+    uint32_t        size = TakeMessage( Input );
+    uint32_t        offset;
+    uint32_t        chunk;
+    uint32_t        i;
+
+    Sha1SetImplementation( SHA1_IMPLEMENTATION_PORTABLE );
+    Sha1Calculate( gMessage, size, &expected );
+
+    for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+    {
+        if( 0 != Sha1SetImplementation( implementations[i] ) )
+        {
+            continue;
+        }
+        Sha1Calculate( gMessage, size, &digest );
+        FUZZ_CHECK( 0 == memcmp( &digest, &expected, sizeof(digest) ), "SHA1 implementation differs" );
+
+        Sha1Initialise( &context );
+        for( offset=0; offset<size; offset+=chunk )
+        {
+            chunk = NextChunk( Input, size - offset );
+            Sha1Update( &context, gMessage + offset, chunk );
+        }
+        Sha1Finalise( &context, &digest );
+        FUZZ_CHECK( 0 == memcmp( &digest, &expected, sizeof(digest) ), "SHA1 streaming differs" );
+    }
+    Sha1SetImplementation( SHA1_IMPLEMENTATION_AUTO );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzSha256
+//
+//  SHA256, SHA224, and HMAC-SHA256 streaming against one call.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzSha256
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint8_t             key [200];
+    uint32_t            keySize = TakeByte( Input ) % sizeof(key);
+    SHA256_HASH         expected;
+    SHA256_HASH         digest;
+    SHA224_HASH         expected224;
+    SHA224_HASH         digest224;
+    SHA256_HASH         expectedMac;
+    SHA256_HASH         mac;
+    Sha256Context       context;
+    Sha224Context       context224;
+    HmacSha256Context   hmacContext;
+    uint32_t            size;
+    uint32_t            offset;
+    uint32_t            chunk;
+
+    TakeBytes( Input, key, keySize );
+    size = TakeMessage( Input );
+
+    Sha256Calculate( gMessage, size, &expected );
+    Sha224Calculate( gMessage, size, &expected224 );
+    HmacSha256Calculate( key, keySize, gMessage, size, &expectedMac );
+
+    Sha256Initialise( &context );
+    Sha224Initialise( &context224 );
+    HmacSha256Initialise( &hmacContext, key, keySize );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        Sha256Update( &context, gMessage + offset, chunk );
+        Sha224Update( &context224, gMessage + offset, chunk );
+        HmacSha256Update( &hmacContext, gMessage + offset, chunk );
+    }
+    Sha256Finalise( &context, &digest );
+    Sha224Finalise( &context224, &digest224 );
+    HmacSha256Finalise( &hmacContext, &mac );
+
+    FUZZ_CHECK( 0 == memcmp( &digest, &expected, sizeof(digest) ), "SHA256 streaming differs" );
+    FUZZ_CHECK( 0 == memcmp( &digest224, &expected224, sizeof(digest224) ), "SHA224 streaming differs" );
+    FUZZ_CHECK( 0 == memcmp( &mac, &expectedMac, sizeof(mac) ), "HMAC-SHA256 streaming differs" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzSha512
+//
+//  SHA512, SHA384, SHA512/224, SHA512/256, and HMAC-SHA512 streaming and one call with every implementation against
+//  the portable one call, and Sha512CalculateMultiple against Sha512Calculate.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzSha512
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint32_t const      implementations [] = { SHA512_IMPLEMENTATION_PORTABLE, SHA512_IMPLEMENTATION_AVX2,
+                                               SHA512_IMPLEMENTATION_AVX512 };
+    uint8_t             key [200];
+    uint32_t            keySize = TakeByte( Input ) % sizeof(key);
+    void const*         pieces [MAX_PIECES];
+    uint32_t            pieceSizes [MAX_PIECES];
+    uint32_t            numPieces;
+    SHA512_HASH         expectedPieces [MAX_PIECES];
+    SHA512_HASH         digests [MAX_PIECES];
+    SHA512_HASH         expected;
+    SHA384_HASH         expected384;
+    SHA512_224_HASH     expected224;
+    SHA512_256_HASH     expected256;
+    SHA512_HASH         expectedMac;
+    SHA512_HASH         digest;
+    SHA384_HASH         digest384;
+    SHA512_224_HASH     digest224;
+    SHA512_256_HASH     digest256;
+    SHA512_HASH         mac;
+    Sha512Context       context;
+    Sha384Context       context384;
+    Sha512_224Context   context224;
+    Sha512_256Context   context256;
+    HmacSha512Context   hmacContext;
+    uint32_t            size;
+    uint32_t            offset;
+    uint32_t            chunk;
+    uint32_t            i;
+    uint32_t            p;
+
+    TakeBytes( Input, key, keySize );
+    size = TakeMessage( Input );
+    numPieces = SplitPieces( Input, gMessage, size, MAX_PIECES, pieces, pieceSizes );
+
+    Sha512SetImplementation( SHA512_IMPLEMENTATION_PORTABLE );
+    Sha512Calculate( gMessage, size, &expected );
+    Sha384Calculate( gMessage, size, &expected384 );
+    Sha512_224Calculate( gMessage, size, &expected224 );
+    Sha512_256Calculate( gMessage, size, &expected256 );
+    HmacSha512Calculate( key, keySize, gMessage, size, &expectedMac );
+    for( p=0; p<numPieces; p++ )
+    {
+        Sha512Calculate( pieces[p], pieceSizes[p], &expectedPieces[p] );
+    }
+
+    for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+    {
+        if( 0 != Sha512SetImplementation( implementations[i] ) )
+        {
+            continue;
+        }
+
+        Sha512Calculate( gMessage, size, &digest );
+        FUZZ_CHECK( 0 == memcmp( &digest, &expected, sizeof(digest) ), "SHA512 implementation differs" );
+
+        Sha512Initialise( &context );
+        Sha384Initialise( &context384 );
+        Sha512_224Initialise( &context224 );
+        Sha512_256Initialise( &context256 );
+        HmacSha512Initialise( &hmacContext, key, keySize );
+        for( offset=0; offset<size; offset+=chunk )
+        {
+            chunk = NextChunk( Input, size - offset );
+            Sha512Update( &context, gMessage + offset, chunk );
+            Sha384Update( &context384, gMessage + offset, chunk );
+            Sha512_224Update( &context224, gMessage + offset, chunk );
+            Sha512_256Update( &context256, gMessage + offset, chunk );
+            HmacSha512Update( &hmacContext, gMessage + offset, chunk );
+        }
+        Sha512Finalise( &context, &digest );
+        Sha384Finalise( &context384, &digest384 );
+        Sha512_224Finalise( &context224, &digest224 );
+        Sha512_256Finalise( &context256, &digest256 );
+        HmacSha512Finalise( &hmacContext, &mac );
+
+        FUZZ_CHECK( 0 == memcmp( &digest, &expected, sizeof(digest) ), "SHA512 streaming differs" );
+        FUZZ_CHECK( 0 == memcmp( &digest384, &expected384, sizeof(digest384) ), "SHA384 streaming differs" );
+        FUZZ_CHECK( 0 == memcmp( &digest224, &expected224, sizeof(digest224) ), "SHA512/224 streaming differs" );
+        FUZZ_CHECK( 0 == memcmp( &digest256, &expected256, sizeof(digest256) ), "SHA512/256 streaming differs" );
+        FUZZ_CHECK( 0 == memcmp( &mac, &expectedMac, sizeof(mac) ), "HMAC-SHA512 streaming differs" );
+
+        Sha512CalculateMultiple( pieces, pieceSizes, numPieces, digests );
+        FUZZ_CHECK( 0 == memcmp( digests, expectedPieces, numPieces * sizeof(SHA512_HASH) ),
+            "SHA512 multiple differs" );
+    }
+    Sha512SetImplementation( SHA512_IMPLEMENTATION_AUTO );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Stream ciphers
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzRc4
+//
+//  RC4 Xor and Output in chunks, from a cached state, and the multi-stream functions against Rc4XorWithKey.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzRc4
+    (
+        FuzzInput*              Input           // [in out]
+    )
+{
+    uint8_t                 key [RC4_MAX_KEY_SIZE + 8];
+    uint32_t                keySize = 1 + TakeByte( Input ) % sizeof(key);
+    uint32_t                dropN = TakeByte( Input ) * 4;
+    static uint8_t          streamKeys [MAX_STREAMS][RC4_MAX_KEY_SIZE + 8];
+    uint8_t const*          keys [MAX_STREAMS];
+    uint32_t                keySizes [MAX_STREAMS];
+    Rc4Context              contexts [MAX_STREAMS];
+    Rc4Context*             contextPointers [MAX_STREAMS];
+    void const*             inBuffers [MAX_STREAMS];
+    void*                   outBuffers [MAX_STREAMS];
+    uint32_t                bufferSizes [MAX_STREAMS];
+    uint32_t                numStreams = 1 + TakeByte( Input ) % MAX_STREAMS;
+    Rc4StateCacheEntry      entries [3];
+    Rc4StateCache           cache;
+    Rc4Context              context;
+    uint32_t                size;
+    uint32_t                streamSize;
+    uint32_t                offset;
+    uint32_t                chunk;
+    uint32_t                i;
+    uint32_t                s;
+
+    TakeBytes( Input, key, keySize );
+    size = TakeMessage( Input );
+
+    FUZZ_CHECK( 0 == Rc4XorWithKey( key, keySize, dropN, gMessage, gExpected, size ), "RC4 key rejected" );
+
+    // Xor in chunks
+    Rc4Initialise( &context, key, keySize, dropN );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        Rc4Xor( &context, gMessage + offset, gOutput + offset, chunk );
+    }
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "RC4 Xor in chunks differs" );
+
+    // Output in chunks from a state taken from the cache, once missing and once hitting
+    Rc4StateCacheInitialise( &cache, entries, sizeof(entries)/sizeof(entries[0]), dropN );
+    for( i=0; i<2; i++ )
+    {
+        Rc4InitialiseWithCache( &cache, &context, key, keySize );
+        for( offset=0; offset<size; offset+=chunk )
+        {
+            chunk = NextChunk( Input, size - offset );
+            Rc4Output( &context, gOutput + offset, chunk );
+        }
+        for( offset=0; offset<size; offset++ )
+        {
+            gOutput[offset] ^= gMessage[offset];
+        }
+        FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "RC4 Output from cache differs" );
+    }
+    Rc4StateCacheUninitialise( &cache );
+
+    // Several streams, each with its own key, stepped together in chunks
+    streamSize = MIN( size, MAX_STREAM_SIZE );
+    for( s=0; s<numStreams; s++ )
+    {
+        memcpy( streamKeys[s], key, keySize );
+        streamKeys[s][0] ^= (uint8_t)s;
+        keys[s] = streamKeys[s];
+        keySizes[s] = keySize;
+        contextPointers[s] = &contexts[s];
+        inBuffers[s] = gMessage;
+        outBuffers[s] = gStreams + s * MAX_STREAM_SIZE;
+    }
+    Rc4InitialiseMultiple( contextPointers, keys, keySizes, dropN, numStreams );
+    for( offset=0; offset<streamSize; offset+=chunk )
+    {
+        chunk = NextChunk( Input, streamSize - offset );
+        for( s=0; s<numStreams; s++ )
+        {
+            inBuffers[s] = gMessage + offset;
+            outBuffers[s] = gStreams + s * MAX_STREAM_SIZE + offset;
+        }
+        Rc4XorMultiple( contextPointers, inBuffers, outBuffers, numStreams, chunk );
+    }
+    for( s=0; s<numStreams; s++ )
+    {
+        Rc4XorWithKey( keys[s], keySize, dropN, gMessage, gExpected, streamSize );
+        FUZZ_CHECK( 0 == memcmp( gStreams + s * MAX_STREAM_SIZE, gExpected, streamSize ), "RC4 multiple differs" );
+    }
+
+    // Several keys and buffers of different sizes at once
+    for( s=0; s<numStreams; s++ )
+    {
+        inBuffers[s] = gMessage + NextChunk( Input, size - streamSize );
+        outBuffers[s] = gStreams + s * MAX_STREAM_SIZE;
+        bufferSizes[s] = NextChunk( Input, streamSize );
+    }
+    Rc4XorWithKeyMultiple( keys, keySizes, dropN, inBuffers, outBuffers, bufferSizes, numStreams );
+    for( s=0; s<numStreams; s++ )
+    {
+        Rc4XorWithKey( keys[s], keySize, dropN, inBuffers[s], gExpected, bufferSizes[s] );
+        FUZZ_CHECK( 0 == memcmp( outBuffers[s], gExpected, bufferSizes[s] ), "RC4 XorWithKeyMultiple differs" );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzAesCtr
+//
+//  AES-CTR Xor and Output in chunks, with and without a precomputed keystream buffer, and after seeking, against
+//  AesCtrXorWithKey.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzAesCtr
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint8_t             key [AES_KEY_SIZE_256];
+    uint32_t            keySize = TakeAesKeySize( Input );
+    uint8_t             iv [AES_CTR_IV_SIZE];
+    uint8_t             keyStream [8 * AES_BLOCK_SIZE];
+    uint32_t            keyStreamSize = ( 1 + TakeByte( Input ) % 8 ) * AES_BLOCK_SIZE;
+    AesCtrContext       context;
+    uint32_t            size;
+    uint32_t            offset;
+    uint32_t            chunk;
+
+    TakeBytes( Input, key, keySize );
+    TakeBytes( Input, iv, sizeof(iv) );
+    size = TakeMessage( Input );
+
+    FUZZ_CHECK( 0 == AesCtrXorWithKey( key, keySize, iv, gMessage, gExpected, size ), "AES-CTR key rejected" );
+
+    // Xor in chunks
+    AesCtrInitialiseWithKey( &context, key, keySize, iv );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        AesCtrXor( &context, gMessage + offset, gOutput + offset, chunk );
+    }
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "AES-CTR Xor in chunks differs" );
+
+    // Output in chunks
+    AesCtrInitialiseWithKey( &context, key, keySize, iv );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        AesCtrOutput( &context, gOutput + offset, chunk );
+    }
+    for( offset=0; offset<size; offset++ )
+    {
+        gOutput[offset] ^= gMessage[offset];
+    }
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "AES-CTR Output in chunks differs" );
+
+    // Xor in chunks with keystream precomputed in between
+    AesCtrInitialiseWithKey( &context, key, keySize, iv );
+    AesCtrSetKeyStreamBuffer( &context, keyStream, keyStreamSize );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        AesCtrFillKeyStream( &context, NextChunk( Input, keyStreamSize ) );
+        chunk = NextChunk( Input, size - offset );
+        AesCtrXor( &context, gMessage + offset, gOutput + offset, chunk );
+    }
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "AES-CTR Xor with keystream buffer differs" );
+
+    // Seek somewhere, with the keystream buffer still attached, and Xor the rest
+    offset = NextChunk( Input, size );
+    AesCtrSetStreamIndex( &context, offset );
+    AesCtrFillKeyStream( &context, keyStreamSize );
+    AesCtrSetStreamIndex( &context, offset + NextChunk( Input, 40 ) );
+    AesCtrSetStreamIndex( &context, offset );
+    AesCtrXor( &context, gMessage + offset, gOutput + offset, size - offset );
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "AES-CTR Xor after seeking differs" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzAesCtrSha256
+//
+//  Fused AES-CTR + SHA-256 in chunks against AesCtrXor and Sha256Calculate, both directions.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzAesCtrSha256
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint8_t             key [AES_KEY_SIZE_256];
+    uint32_t            keySize = TakeAesKeySize( Input );
+    uint8_t             iv [AES_CTR_IV_SIZE];
+    AesCtrContext       aesCtr;
+    Sha256Context       sha256;
+    SHA256_HASH         expected;
+    SHA256_HASH         digest;
+    uint32_t            size;
+    uint32_t            offset;
+    uint32_t            chunk;
+
+    TakeBytes( Input, key, keySize );
+    TakeBytes( Input, iv, sizeof(iv) );
+    size = TakeMessage( Input );
+
+    AesCtrXorWithKey( key, keySize, iv, gMessage, gExpected, size );
+    Sha256Calculate( gExpected, size, &expected );
+
+    FUZZ_CHECK( 0 == AesCtrSha256EncryptWithKey( key, keySize, iv, gMessage, gOutput, size, &digest )
+             && 0 == memcmp( gOutput, gExpected, size )
+             && 0 == memcmp( &digest, &expected, sizeof(digest) ), "AES-CTR + SHA256 encrypt differs" );
+
+    AesCtrInitialiseWithKey( &aesCtr, key, keySize, iv );
+    Sha256Initialise( &sha256 );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        AesCtrSha256Encrypt( &aesCtr, &sha256, gMessage + offset, gOutput + offset, chunk );
+    }
+    Sha256Finalise( &sha256, &digest );
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ) && 0 == memcmp( &digest, &expected, sizeof(digest) ),
+        "AES-CTR + SHA256 encrypt in chunks differs" );
+
+    // Decrypt in place
+    AesCtrInitialiseWithKey( &aesCtr, key, keySize, iv );
+    Sha256Initialise( &sha256 );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        AesCtrSha256Decrypt( &aesCtr, &sha256, gOutput + offset, gOutput + offset, chunk );
+    }
+    Sha256Finalise( &sha256, &digest );
+    FUZZ_CHECK( 0 == memcmp( gOutput, gMessage, size ) && 0 == memcmp( &digest, &expected, sizeof(digest) ),
+        "AES-CTR + SHA256 decrypt in chunks differs" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzAesOfb
+//
+//  AES-OFB Xor and Output in chunks, and several streams stepped together, against AesOfbXorWithKey.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzAesOfb
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint8_t             key [AES_KEY_SIZE_256];
+    uint32_t            keySize = TakeAesKeySize( Input );
+    uint8_t             iv [AES_OFB_IV_SIZE];
+    uint8_t             streamIvs [MAX_STREAMS][AES_OFB_IV_SIZE];
+    uint32_t            numStreams = 1 + TakeByte( Input ) % MAX_STREAMS;
+    AesContext          aes;
+    AesOfbContext       contexts [MAX_STREAMS];
+    AesOfbContext*      contextPointers [MAX_STREAMS];
+    void const*         inBuffers [MAX_STREAMS];
+    void*               outBuffers [MAX_STREAMS];
+    AesOfbContext       context;
+    uint32_t            size;
+    uint32_t            streamSize;
+    uint32_t            offset;
+    uint32_t            chunk;
+    uint32_t            s;
+
+    TakeBytes( Input, key, keySize );
+    TakeBytes( Input, iv, sizeof(iv) );
+    size = TakeMessage( Input );
+
+    FUZZ_CHECK( 0 == AesOfbXorWithKey( key, keySize, iv, gMessage, gExpected, size ), "AES-OFB key rejected" );
+
+    // Xor in chunks
+    AesOfbInitialiseWithKey( &context, key, keySize, iv );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        AesOfbXor( &context, gMessage + offset, gOutput + offset, chunk );
+    }
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "AES-OFB Xor in chunks differs" );
+
+    // Output in chunks
+    AesOfbInitialiseWithKey( &context, key, keySize, iv );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextChunk( Input, size - offset );
+        AesOfbOutput( &context, gOutput + offset, chunk );
+    }
+    for( offset=0; offset<size; offset++ )
+    {
+        gOutput[offset] ^= gMessage[offset];
+    }
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "AES-OFB Output in chunks differs" );
+
+    // Several streams, each with its own IV, stepped together in chunks
+    streamSize = MIN( size, MAX_STREAM_SIZE );
+    AesInitialise( &aes, key, keySize );
+    for( s=0; s<numStreams; s++ )
+    {
+        memcpy( streamIvs[s], iv, sizeof(iv) );
+        streamIvs[s][0] ^= (uint8_t)s;
+        AesOfbInitialise( &contexts[s], &aes, streamIvs[s] );
+        contextPointers[s] = &contexts[s];
+    }
+    for( offset=0; offset<streamSize; offset+=chunk )
+    {
+        chunk = NextChunk( Input, streamSize - offset );
+        for( s=0; s<numStreams; s++ )
+        {
+            inBuffers[s] = gMessage + offset;
+            outBuffers[s] = gStreams + s * MAX_STREAM_SIZE + offset;
+        }
+        AesOfbXorMultiple( contextPointers, inBuffers, outBuffers, numStreams, chunk );
+    }
+    for( s=0; s<numStreams; s++ )
+    {
+        AesOfbXorWithKey( key, keySize, streamIvs[s], gMessage, gExpected, streamSize );
+        FUZZ_CHECK( 0 == memcmp( gStreams + s * MAX_STREAM_SIZE, gExpected, streamSize ),
+            "AES-OFB multiple differs" );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Block cipher modes
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzAesCbc
+//
+//  AES-CBC encrypt and decrypt in chunks of whole blocks against one call, and decrypting against the original.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzAesCbc
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint8_t             key [AES_KEY_SIZE_256];
+    uint32_t            keySize = TakeAesKeySize( Input );
+    uint8_t             iv [AES_CBC_IV_SIZE];
+    AesCbcContext       context;
+    uint32_t            size;
+    uint32_t            offset;
+    uint32_t            chunk;
+
+    TakeBytes( Input, key, keySize );
+    TakeBytes( Input, iv, sizeof(iv) );
+    size = TakeMessage( Input ) / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
+
+    FUZZ_CHECK( 0 == AesCbcEncryptWithKey( key, keySize, iv, gMessage, gExpected, size ), "AES-CBC key rejected" );
+
+    AesCbcInitialiseWithKey( &context, key, keySize, iv );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextBlockChunk( Input, size - offset );
+        FUZZ_CHECK( 0 == AesCbcEncrypt( &context, gMessage + offset, gOutput + offset, chunk ),
+            "AES-CBC whole blocks rejected" );
+    }
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ), "AES-CBC encrypt in chunks differs" );
+
+    // Decrypt in place
+    AesCbcInitialiseWithKey( &context, key, keySize, iv );
+    for( offset=0; offset<size; offset+=chunk )
+    {
+        chunk = NextBlockChunk( Input, size - offset );
+        AesCbcDecrypt( &context, gOutput + offset, gOutput + offset, chunk );
+    }
+    FUZZ_CHECK( 0 == memcmp( gOutput, gMessage, size ), "AES-CBC decrypt in chunks differs" );
+
+    FUZZ_CHECK( 0 == AesCbcDecryptWithKey( key, keySize, iv, gExpected, gOutput, size )
+             && 0 == memcmp( gOutput, gMessage, size ), "AES-CBC decrypt differs" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzAesCcm
+//
+//  AES-CCM in place against out of place, decrypting against the original, and a corrupted tag against rejection.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzAesCcm
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint8_t             key [AES_KEY_SIZE_256];
+    uint32_t            keySize = TakeAesKeySize( Input );
+    uint8_t             nonce [AES_CCM_NONCE_SIZE_MAX];
+    uint32_t            nonceSize = AES_CCM_NONCE_SIZE_MIN + TakeByte( Input ) % 7;
+    uint8_t             tag [AES_CCM_TAG_SIZE_MAX];
+    uint8_t             tag2 [AES_CCM_TAG_SIZE_MAX];
+    uint32_t            tagSize = AES_CCM_TAG_SIZE_MIN + TakeByte( Input ) % 7 * 2;
+    AesContext          aes;
+    uint32_t            size;
+    uint32_t            aDataSize;
+
+    TakeBytes( Input, key, keySize );
+    TakeBytes( Input, nonce, nonceSize );
+    size = TakeMessage( Input );
+    aDataSize = NextChunk( Input, size );
+    size -= aDataSize;
+
+    AesInitialise( &aes, key, keySize );
+    if( 0 != AesCcmEncrypt( &aes, nonce, nonceSize, gMessage + size, aDataSize, gMessage, gExpected, size,
+                            tag, tagSize ) )
+    {
+        // Message too long for the nonce size
+        FUZZ_CHECK( 15 - nonceSize < 4 && size >= ( 1u << ( 8 * ( 15 - nonceSize ) ) ), "AES-CCM rejected" );
+        return;
+    }
+
+    memcpy( gOutput, gMessage, size );
+    AesCcmEncrypt( &aes, nonce, nonceSize, gMessage + size, aDataSize, gOutput, gOutput, size, tag2, tagSize );
+    FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ) && 0 == memcmp( tag2, tag, tagSize ),
+        "AES-CCM in place differs" );
+
+    FUZZ_CHECK( 0 == AesCcmDecrypt( &aes, nonce, nonceSize, gMessage + size, aDataSize, gExpected, gOutput, size,
+                                    tag, tagSize )
+             && 0 == memcmp( gOutput, gMessage, size ), "AES-CCM decrypt differs" );
+
+    tag[ NextChunk( Input, tagSize - 1 ) ] ^= 1 << ( TakeByte( Input ) % 8 );
+    FUZZ_CHECK( 0 != AesCcmDecrypt( &aes, nonce, nonceSize, gMessage + size, aDataSize, gExpected, gOutput, size,
+                                    tag, tagSize ), "AES-CCM accepted a corrupted tag" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzAesGcmSiv
+//
+//  AES GCM-SIV with every POLYVAL implementation against the portable one, decrypting against the original, and
+//  corrupted ciphertext against rejection.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzAesGcmSiv
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint32_t const      implementations [] = { AES_GCM_SIV_IMPLEMENTATION_PORTABLE, AES_GCM_SIV_IMPLEMENTATION_PCLMUL };
+    uint8_t             key [AES_KEY_SIZE_256];
+    uint32_t            keySize = ( 0 == TakeByte( Input ) % 2 ) ? AES_KEY_SIZE_128 : AES_KEY_SIZE_256;
+    uint8_t             nonce [AES_GCM_SIV_NONCE_SIZE];
+    uint8_t             expectedTag [AES_GCM_SIV_TAG_SIZE];
+    uint8_t             tag [AES_GCM_SIV_TAG_SIZE];
+    AesGcmSivContext    context;
+    uint32_t            size;
+    uint32_t            aDataSize;
+    uint32_t            i;
+
+    TakeBytes( Input, key, keySize );
+    TakeBytes( Input, nonce, sizeof(nonce) );
+    size = TakeMessage( Input );
+    aDataSize = NextChunk( Input, size );
+    size -= aDataSize;
+
+    AesGcmSivSetImplementation( AES_GCM_SIV_IMPLEMENTATION_PORTABLE );
+    AesGcmSivInitialise( &context, key, keySize );
+    AesGcmSivEncrypt( &context, nonce, gMessage + size, aDataSize, gMessage, gExpected, size, expectedTag );
+
+    for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+    {
+        if( 0 != AesGcmSivSetImplementation( implementations[i] ) )
+        {
+            continue;
+        }
+
+        memcpy( gOutput, gMessage, size );
+        AesGcmSivEncrypt( &context, nonce, gMessage + size, aDataSize, gOutput, gOutput, size, tag );
+        FUZZ_CHECK( 0 == memcmp( gOutput, gExpected, size ) && 0 == memcmp( tag, expectedTag, sizeof(tag) ),
+            "AES GCM-SIV implementation differs" );
+
+        FUZZ_CHECK( 0 == AesGcmSivDecrypt( &context, nonce, gMessage + size, aDataSize, gExpected, gOutput, size,
+                                           expectedTag )
+                 && 0 == memcmp( gOutput, gMessage, size ), "AES GCM-SIV decrypt differs" );
+
+        if( size > 0 )
+        {
+            memcpy( gOutput, gExpected, size );
+            gOutput[ NextChunk( Input, size - 1 ) ] ^= 1 << ( TakeByte( Input ) % 8 );
+            FUZZ_CHECK( 0 != AesGcmSivDecrypt( &context, nonce, gMessage + size, aDataSize, gOutput, gOutput, size,
+                                               expectedTag ), "AES GCM-SIV accepted corrupted ciphertext" );
+        }
+    }
+    AesGcmSivSetImplementation( AES_GCM_SIV_IMPLEMENTATION_AUTO );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FuzzAesKeyWrap
+//
+//  AES Key Wrap with and without padding against unwrapping, the batch functions against one key at a time, and a
+//  corrupted wrapped key against rejection.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    FuzzAesKeyWrap
+    (
+        FuzzInput*          Input           // [in out]
+    )
+{
+    uint8_t             kek [AES_KEY_SIZE_256];
+    uint32_t            kekSize = TakeAesKeySize( Input );
+    uint32_t            keySize = AES_KEY_WRAP_MIN_KEY_SIZE + ( TakeByte( Input ) % 16 ) * AES_KEY_WRAP_SEMIBLOCK_SIZE;
+    uint32_t            wrappedSize = keySize + AES_KEY_WRAP_OVERHEAD;
+    uint32_t            numKeys = 1 + TakeByte( Input ) % MAX_PIECES;
+    AesContext          aes;
+    uint32_t            size;
+    uint32_t            unwrappedSize;
+    uint32_t            k;
+
+    TakeBytes( Input, kek, kekSize );
+    size = MIN( TakeMessage( Input ), (uint32_t)MAX_STREAM_SIZE );
+    AesInitialise( &aes, kek, kekSize );
+
+    // Padded wrap of the whole message
+    if( size > 0 )
+    {
+        FUZZ_CHECK( 0 == AesKeyWrapPadded( &aes, gMessage, size, gExpected ), "AES Key Wrap padded rejected" );
+        FUZZ_CHECK( 0 == AesKeyUnwrapPadded( &aes, gExpected, AES_KEY_WRAP_PADDED_SIZE( size ), gOutput,
+                                             &unwrappedSize )
+                 && size == unwrappedSize
+                 && 0 == memcmp( gOutput, gMessage, size ), "AES Key Wrap padded unwrap differs" );
+
+        gExpected[ NextChunk( Input, AES_KEY_WRAP_PADDED_SIZE( size ) - 1 ) ] ^= 1 << ( TakeByte( Input ) % 8 );
+        FUZZ_CHECK( 0 != AesKeyUnwrapPadded( &aes, gExpected, AES_KEY_WRAP_PADDED_SIZE( size ), gOutput,
+                                             &unwrappedSize ), "AES Key Wrap padded accepted a corrupted key" );
+    }
+
+    // Batch of keys against one at a time. Keys past the end of the message are zero.
+    memset( gMessage + size, 0, numKeys * keySize );
+    FUZZ_CHECK( 0 == AesKeyWrapBatch( &aes, gMessage, keySize, numKeys, gExpected ), "AES Key Wrap batch rejected" );
+    for( k=0; k<numKeys; k++ )
+    {
+        AesKeyWrap( &aes, gMessage + k * keySize, keySize, gOutput );
+        FUZZ_CHECK( 0 == memcmp( gOutput, gExpected + k * wrappedSize, wrappedSize ), "AES Key Wrap batch differs" );
+        FUZZ_CHECK( 0 == AesKeyUnwrap( &aes, gOutput, wrappedSize, gOutput + wrappedSize )
+                 && 0 == memcmp( gOutput + wrappedSize, gMessage + k * keySize, keySize ),
+            "AES Key Wrap unwrap differs" );
+    }
+    FUZZ_CHECK( 0 == AesKeyUnwrapBatch( &aes, gExpected, wrappedSize, numKeys, gOutput )
+             && 0 == memcmp( gOutput, gMessage, numKeys * keySize ), "AES Key Wrap unwrap batch differs" );
+
+    gExpected[ NextChunk( Input, wrappedSize - 1 ) ] ^= 1 << ( TakeByte( Input ) % 8 );
+    FUZZ_CHECK( 0 != AesKeyUnwrap( &aes, gExpected, wrappedSize, gOutput ), "AES Key Wrap accepted a corrupted key" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LLVMFuzzerTestOneInput
+//
+//  Runs one input. Any disagreement between results that must match aborts the process.
+//  Returns 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    LLVMFuzzerTestOneInput
+    (
+        uint8_t const*      Data,           // [in]
+        size_t              Size            // [in]
+    )
+{
+    FuzzInput   input;
+    uint8_t     target;
+    uint8_t     seed [4];
+
+    input.Data = Data;
+    input.Size = Size;
+    target = TakeByte( &input );
+    TakeBytes( &input, seed, sizeof(seed) );
+    input.SplitState = ( (uint32_t)seed[0] << 24 ) | ( (uint32_t)seed[1] << 16 ) | ( (uint32_t)seed[2] << 8 ) | seed[3];
+    if( 0 == input.SplitState )
+    {
+        // xorshift never leaves zero
+        input.SplitState = 1;
+    }
+
+    switch( target % FUZZ_NUM_TARGETS )
+    {
+    case FUZZ_TARGET_MD5:               FuzzMd5( &input );              break;
+    case FUZZ_TARGET_SHA1:              FuzzSha1( &input );             break;
+    case FUZZ_TARGET_SHA256:            FuzzSha256( &input );           break;
+    case FUZZ_TARGET_SHA512:            FuzzSha512( &input );           break;
+    case FUZZ_TARGET_RC4:               FuzzRc4( &input );              break;
+    case FUZZ_TARGET_AES_CTR:           FuzzAesCtr( &input );           break;
+    case FUZZ_TARGET_AES_CTR_SHA256:    FuzzAesCtrSha256( &input );     break;
+    case FUZZ_TARGET_AES_OFB:           FuzzAesOfb( &input );           break;
+    case FUZZ_TARGET_AES_CBC:           FuzzAesCbc( &input );           break;
+    case FUZZ_TARGET_AES_CCM:           FuzzAesCcm( &input );           break;
+    case FUZZ_TARGET_AES_GCM_SIV:       FuzzAesGcmSiv( &input );        break;
+    default:                            FuzzAesKeyWrap( &input );       break;
+    }
+
+    return 0;
+}
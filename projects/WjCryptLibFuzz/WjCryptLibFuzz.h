@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibFuzz
+//
+//  Differential fuzz target for the library. See WjCryptLibFuzz.c.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stddef.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The first byte of an input, modulo this, selects the primitive tested
+#define FUZZ_NUM_TARGETS        12
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPORTED FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LLVMFuzzerTestOneInput
+//
+//  Runs one input. Any disagreement between results that must match aborts the process.
+//  Returns 0
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    LLVMFuzzerTestOneInput
+    (
+        uint8_t const*      Data,           // [in]
+        size_t              Size            // [in]
+    );
\ No newline at end of file
@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibFuzzMain
+//
+//  Runs the WjCryptLibFuzz target without libFuzzer, for compilers that do not have it. Given files, each is run as
+//  one input (eg to reproduce a crash found by libFuzzer). Otherwise random inputs are generated, taking each
+//  primitive in turn, with sizes up to a few times the longest message so truncation is also covered.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "WjCryptLibFuzz.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_INPUT_SIZE              ( 96 * 1024 )
+#define DEFAULT_NUM_ITERATIONS      10000
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t      gInput [MAX_INPUT_SIZE];
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Random
+//
+//  Returns the next value of a xorshift64 generator. State must not be zero.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    Random
+    (
+        uint64_t*       pState          // [in out]
+    )
+{
+    uint64_t    x = *pState;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *pState = x;
+
+    return (uint32_t)( x >> 32 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  RunFile
+//
+//  Runs the contents of a file as one input.
+//  Returns 0 if successful, or -1 if the file could not be read
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    RunFile
+    (
+        char const*     FileName        // [in]
+    )
+{
+    FILE*       file;
+    size_t      size;
+
+    file = fopen( FileName, "rb" );
+    if( NULL == file )
+    {
+        printf( "Could not open %s\n", FileName );
+        return -1;
+    }
+    size = fread( gInput, 1, sizeof(gInput), file );
+    fclose( file );
+
+    LLVMFuzzerTestOneInput( gInput, size );
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  RunRandom
+//
+//  Runs NumIterations random inputs. Most are short, where the splitting into chunks matters most.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    RunRandom
+    (
+        uint32_t        NumIterations,  // [in]
+        uint64_t        Seed            // [in]
+    )
+{
+    uint64_t    state = ( 0 != Seed ) ? Seed : 1;
+    uint32_t    iteration;
+    uint32_t    size;
+    uint32_t    i;
+
+    for( iteration=0; iteration<NumIterations; iteration++ )
+    {
+        switch( Random( &state ) % 4 )
+        {
+        case 0:     size = Random( &state ) % 64;                   break;
+        case 1:     size = Random( &state ) % 1024;                 break;
+        case 2:     size = Random( &state ) % 8192;                 break;
+        default:    size = Random( &state ) % MAX_INPUT_SIZE;       break;
+        }
+
+        for( i=0; i<size; i++ )
+        {
+            gInput[i] = (uint8_t)Random( &state );
+        }
+        if( size > 0 )
+        {
+            // Every primitive in turn
+            gInput[0] = (uint8_t)( iteration % FUZZ_NUM_TARGETS );
+        }
+
+        LLVMFuzzerTestOneInput( gInput, size );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  main
+//
+//  Program entry point
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    main
+    (
+        int             ArgC,
+        char**          ArgV
+    )
+{
+    uint32_t        numIterations = DEFAULT_NUM_ITERATIONS;
+    uint64_t        seed = 1;
+    uint32_t        numFiles = 0;
+    int             i;
+
+    for( i=1; i<ArgC; i++ )
+    {
+        if( 0 == strcmp( ArgV[i], "-n" ) && i+1 < ArgC )
+        {
+            numIterations = (uint32_t)strtoul( ArgV[++i], NULL, 10 );
+        }
+        else if( 0 == strcmp( ArgV[i], "-s" ) && i+1 < ArgC )
+        {
+            seed = strtoull( ArgV[++i], NULL, 10 );
+        }
+        else if( '-' == ArgV[i][0] )
+        {
+            printf(
+                "Syntax\n"
+                "   WjCryptLibFuzz [-n Iterations] [-s Seed] [File ...]\n" );
+            return 1;
+        }
+        else
+        {
+            if( 0 != RunFile( ArgV[i] ) )
+            {
+                return 1;
+            }
+            numFiles += 1;
+        }
+    }
+
+    if( numFiles > 0 )
+    {
+        printf( "Ran %u files\n", numFiles );
+    }
+    else
+    {
+        RunRandom( numIterations, seed );
+        printf( "Ran %u random inputs (seed %llu)\n", numIterations, (unsigned long long)seed );
+    }
+
+    return 0;
+}
@@ -0,0 +1,999 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibPerf
+//
+//  Performance regression check. Runs a fixed workload for each algorithm and each of its implementations available
+//  on this processor, and compares the throughput with a baseline for the same machine stored in a JSON file:
+//
+//     {
+//       "<processor brand string> [<build options>]": {
+//         "SHA256 1 MiB x100": 412.5,
+//         ...
+//       },
+//       ...
+//     }
+//
+//  A machine is the processor together with the build options that change throughput (WJCRYPTLIB_PERF_BUILD, set by
+//  CMake, eg "isa-variants,openmp"). A plain build has just the brand string, and is never compared with another.
+//  Throughputs are in MB/s, the best of several runs. A workload slower than its baseline by more than the tolerance
+//  is a regression and the program exits with 1. Machines and workloads with no baseline are reported but not
+//  checked. -u replaces this machine's entry in the file with the new results, keeping those of other machines.
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "WjCryptLib_AesCbc.h"
+#include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_AesCtrSha256.h"
+#include "WjCryptLib_AesGcmSiv.h"
+#include "WjCryptLib_AesOfb.h"
+#include "WjCryptLib_Cpu.h"
+#include "WjCryptLib_Md5.h"
+#include "WjCryptLib_Rc4.h"
+#include "WjCryptLib_Sha1.h"
+#include "WjCryptLib_Sha256.h"
+#include "WjCryptLib_Sha512.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define BUFFER_SIZE                 ( 1024 * 1024 )
+#define MAX_BASELINE_ENTRIES        1024
+#define MAX_BASELINE_FILE_SIZE      ( 1024 * 1024 )
+
+#define DEFAULT_TOLERANCE_PERCENT   10.0
+#define DEFAULT_NUM_RUNS            3
+
+// Processor brand string and build options
+#define MACHINE_SIZE                ( CPU_BRAND_SIZE + 64 )
+
+#ifndef WJCRYPTLIB_PERF_BUILD
+    #define WJCRYPTLIB_PERF_BUILD   ""
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Prepares for a workload (eg selecting an implementation). Returns 0 if the workload can run, or -1 to skip it.
+typedef int (*WorkloadSetupFunc)( void );
+
+// Runs the whole workload once
+typedef void (*WorkloadFunc)( void );
+
+typedef struct
+{
+    char const*             Name;               // Key in the baseline file, so must not change
+    WorkloadSetupFunc       Setup;
+    WorkloadFunc            Function;
+    uint32_t                Megabytes;          // Amount processed by Function, in MiB
+} Workload;
+
+// One throughput in the baseline file
+typedef struct
+{
+    char                    Machine [MACHINE_SIZE];
+    char                    Name [64];
+    double                  Rate;
+} BaselineEntry;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t          gBuffer [BUFFER_SIZE];
+static uint8_t          gOutput [BUFFER_SIZE];
+
+static BaselineEntry    gBaseline [MAX_BASELINE_ENTRIES];
+static uint32_t         gNumBaselineEntries = 0;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Workloads
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GetTime
+//
+//  Returns a wall clock time in seconds
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+double
+    GetTime
+    (
+        void
+    )
+{
+    struct timespec     now;
+
+    timespec_get( &now, TIME_UTC );
+    return (double)now.tv_sec + ( (double)now.tv_nsec / 1e9 );
+}
+
+// Setup for workloads that have only one implementation
+static int SetupNone( void ) { return 0; }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Hashes
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Buffers hashed at once by the multi-buffer workloads
+#define NUM_OBJECTS                 16
+#define OBJECT_SIZE                 ( BUFFER_SIZE / NUM_OBJECTS )
+
+static int SetupMd5Portable( void ) { return Md5SetImplementation( MD5_IMPLEMENTATION_PORTABLE ); }
+static int SetupMd5Sse2( void ) { return Md5SetImplementation( MD5_IMPLEMENTATION_SSE2 ); }
+static int SetupMd5Avx2( void ) { return Md5SetImplementation( MD5_IMPLEMENTATION_AVX2 ); }
+static int SetupMd5Avx512( void ) { return Md5SetImplementation( MD5_IMPLEMENTATION_AVX512 ); }
+static int SetupSha1Portable( void ) { return Sha1SetImplementation( SHA1_IMPLEMENTATION_PORTABLE ); }
+static int SetupSha1ShaNi( void ) { return Sha1SetImplementation( SHA1_IMPLEMENTATION_SHANI ); }
+static int SetupSha512Portable( void ) { return Sha512SetImplementation( SHA512_IMPLEMENTATION_PORTABLE ); }
+static int SetupSha512Avx2( void ) { return Sha512SetImplementation( SHA512_IMPLEMENTATION_AVX2 ); }
+static int SetupSha512Avx512( void ) { return Sha512SetImplementation( SHA512_IMPLEMENTATION_AVX512 ); }
+
+static
+void
+    WorkloadMd5
+    (
+        void
+    )
+{
+    MD5_HASH    hash;
+    uint32_t    i;
+
+    for( i=0; i<100; i++ )
+    {
+        Md5Calculate( gBuffer, BUFFER_SIZE, &hash );
+    }
+}
+
+static
+void
+    WorkloadMd5Multiple
+    (
+        void
+    )
+{
+    void const*     buffers [NUM_OBJECTS];
+    uint32_t        sizes [NUM_OBJECTS];
+    MD5_HASH        hashes [NUM_OBJECTS];
+    uint32_t        i;
+
+    for( i=0; i<NUM_OBJECTS; i++ )
+    {
+        buffers[i] = gBuffer + i * OBJECT_SIZE;
+        sizes[i] = OBJECT_SIZE;
+    }
+    for( i=0; i<100; i++ )
+    {
+        Md5CalculateMultiple( buffers, sizes, NUM_OBJECTS, hashes );
+    }
+}
+
+static
+void
+    WorkloadSha1
+    (
+        void
+    )
+{
+    SHA1_HASH   hash;
+    uint32_t    i;
+
+    for( i=0; i<100; i++ )
+    {
+        Sha1Calculate( gBuffer, BUFFER_SIZE, &hash );
+    }
+}
+
+static
+void
+    WorkloadSha256
+    (
+        void
+    )
+{
+    SHA256_HASH     hash;
+    uint32_t        i;
+
+    for( i=0; i<100; i++ )
+    {
+        Sha256Calculate( gBuffer, BUFFER_SIZE, &hash );
+    }
+}
+
+static
+void
+    WorkloadSha512
+    (
+        void
+    )
+{
+    SHA512_HASH     hash;
+    uint32_t        i;
+
+    for( i=0; i<100; i++ )
+    {
+        Sha512Calculate( gBuffer, BUFFER_SIZE, &hash );
+    }
+}
+
+static
+void
+    WorkloadSha512Multiple
+    (
+        void
+    )
+{
+    void const*     buffers [NUM_OBJECTS];
+    uint32_t        sizes [NUM_OBJECTS];
+    SHA512_HASH     hashes [NUM_OBJECTS];
+    uint32_t        i;
+
+    for( i=0; i<NUM_OBJECTS; i++ )
+    {
+        buffers[i] = gBuffer + i * OBJECT_SIZE;
+        sizes[i] = OBJECT_SIZE;
+    }
+    for( i=0; i<100; i++ )
+    {
+        Sha512CalculateMultiple( buffers, sizes, NUM_OBJECTS, hashes );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Ciphers
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t const        gKey [AES_KEY_SIZE_256] = {0};
+static uint8_t const        gIv [AES_BLOCK_SIZE] = {0};
+
+static AesCtrContext        gAesCtr;
+static AesCbcContext        gAesCbc;
+static AesOfbContext        gAesOfb;
+static AesGcmSivContext     gAesGcmSiv;
+static Sha256Context        gSha256;
+static Rc4Context           gRc4;
+
+static int SetupAesCtr( void ) { return AesCtrInitialiseWithKey( &gAesCtr, gKey, sizeof(gKey), gIv ); }
+static int SetupAesCbc( void ) { return AesCbcInitialiseWithKey( &gAesCbc, gKey, sizeof(gKey), gIv ); }
+static int SetupAesOfb( void ) { return AesOfbInitialiseWithKey( &gAesOfb, gKey, sizeof(gKey), gIv ); }
+static int SetupRc4( void ) { return Rc4Initialise( &gRc4, gKey, sizeof(gKey), 0 ); }
+
+static
+int
+    SetupAesCtrSha256
+    (
+        void
+    )
+{
+    Sha256Initialise( &gSha256 );
+    return SetupAesCtr( );
+}
+
+static
+int
+    SetupAesGcmSivPortable
+    (
+        void
+    )
+{
+    AesGcmSivInitialise( &gAesGcmSiv, gKey, sizeof(gKey) );
+    return AesGcmSivSetImplementation( AES_GCM_SIV_IMPLEMENTATION_PORTABLE );
+}
+
+static
+int
+    SetupAesGcmSivPclmul
+    (
+        void
+    )
+{
+    AesGcmSivInitialise( &gAesGcmSiv, gKey, sizeof(gKey) );
+    return AesGcmSivSetImplementation( AES_GCM_SIV_IMPLEMENTATION_PCLMUL );
+}
+
+static
+void
+    WorkloadAesCtr
+    (
+        void
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<64; i++ )
+    {
+        AesCtrXor( &gAesCtr, gBuffer, gOutput, BUFFER_SIZE );
+    }
+}
+
+static
+void
+    WorkloadAesCbcEncrypt
+    (
+        void
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<64; i++ )
+    {
+        AesCbcEncrypt( &gAesCbc, gBuffer, gOutput, BUFFER_SIZE );
+    }
+}
+
+static
+void
+    WorkloadAesCbcDecrypt
+    (
+        void
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<64; i++ )
+    {
+        AesCbcDecrypt( &gAesCbc, gBuffer, gOutput, BUFFER_SIZE );
+    }
+}
+
+static
+void
+    WorkloadAesOfb
+    (
+        void
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<64; i++ )
+    {
+        AesOfbXor( &gAesOfb, gBuffer, gOutput, BUFFER_SIZE );
+    }
+}
+
+static
+void
+    WorkloadAesGcmSiv
+    (
+        void
+    )
+{
+    uint8_t     tag [AES_GCM_SIV_TAG_SIZE];
+    uint32_t    i;
+
+    for( i=0; i<16; i++ )
+    {
+        AesGcmSivEncrypt( &gAesGcmSiv, gIv, NULL, 0, gBuffer, gOutput, BUFFER_SIZE, tag );
+    }
+}
+
+static
+void
+    WorkloadAesCtrSha256
+    (
+        void
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<64; i++ )
+    {
+        AesCtrSha256Encrypt( &gAesCtr, &gSha256, gBuffer, gOutput, BUFFER_SIZE );
+    }
+}
+
+static
+void
+    WorkloadRc4
+    (
+        void
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<64; i++ )
+    {
+        Rc4Xor( &gRc4, gBuffer, gOutput, BUFFER_SIZE );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Workload table
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static Workload const gWorkloads [] =
+{
+    { "MD5 1 MiB x100",                             SetupNone,              WorkloadMd5,            100 },
+    { "MD5 16 x 64 KiB x100 (portable)",            SetupMd5Portable,       WorkloadMd5Multiple,    100 },
+    { "MD5 16 x 64 KiB x100 (SSE2)",                SetupMd5Sse2,           WorkloadMd5Multiple,    100 },
+    { "MD5 16 x 64 KiB x100 (AVX2)",                SetupMd5Avx2,           WorkloadMd5Multiple,    100 },
+    { "MD5 16 x 64 KiB x100 (AVX-512)",             SetupMd5Avx512,         WorkloadMd5Multiple,    100 },
+    { "SHA1 1 MiB x100 (portable)",                 SetupSha1Portable,      WorkloadSha1,           100 },
+    { "SHA1 1 MiB x100 (SHA extensions)",           SetupSha1ShaNi,         WorkloadSha1,           100 },
+    { "SHA256 1 MiB x100",                          SetupNone,              WorkloadSha256,         100 },
+    { "SHA512 1 MiB x100 (portable)",               SetupSha512Portable,    WorkloadSha512,         100 },
+    { "SHA512 1 MiB x100 (AVX2)",                   SetupSha512Avx2,        WorkloadSha512,         100 },
+    { "SHA512 16 x 64 KiB x100 (portable)",         SetupSha512Portable,    WorkloadSha512Multiple, 100 },
+    { "SHA512 16 x 64 KiB x100 (AVX2)",             SetupSha512Avx2,        WorkloadSha512Multiple, 100 },
+    { "SHA512 16 x 64 KiB x100 (AVX-512)",          SetupSha512Avx512,      WorkloadSha512Multiple, 100 },
+    { "AES-256-CTR 64 MiB",                         SetupAesCtr,            WorkloadAesCtr,         64 },
+    { "AES-256-CBC encrypt 64 MiB",                 SetupAesCbc,            WorkloadAesCbcEncrypt,  64 },
+    { "AES-256-CBC decrypt 64 MiB",                 SetupAesCbc,            WorkloadAesCbcDecrypt,  64 },
+    { "AES-256-OFB 64 MiB",                         SetupAesOfb,            WorkloadAesOfb,         64 },
+    { "AES-256-GCM-SIV 1 MiB x16 (portable)",       SetupAesGcmSivPortable, WorkloadAesGcmSiv,      16 },
+    { "AES-256-GCM-SIV 1 MiB x16 (PCLMUL)",         SetupAesGcmSivPclmul,   WorkloadAesGcmSiv,      16 },
+    { "AES-256-CTR + SHA256 64 MiB",                SetupAesCtrSha256,      WorkloadAesCtrSha256,   64 },
+    { "RC4 64 MiB",                                 SetupRc4,               WorkloadRc4,            64 },
+};
+#define NUM_WORKLOADS ( sizeof(gWorkloads) / sizeof(gWorkloads[0]) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  RestoreDefaults
+//
+//  Returns every algorithm to its automatically selected implementation
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    RestoreDefaults
+    (
+        void
+    )
+{
+    Md5SetImplementation( MD5_IMPLEMENTATION_AUTO );
+    Sha1SetImplementation( SHA1_IMPLEMENTATION_AUTO );
+    Sha512SetImplementation( SHA512_IMPLEMENTATION_AUTO );
+    AesGcmSivSetImplementation( AES_GCM_SIV_IMPLEMENTATION_AUTO );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  RunWorkload
+//
+//  Runs a workload NumRuns times and gets the best throughput in MB/s.
+//  Returns 0 if successful, or -1 if the workload is not supported on this processor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    RunWorkload
+    (
+        Workload const*     Work,           // [in]
+        uint32_t            NumRuns,        // [in]
+        double*             pRate           // [out]
+    )
+{
+    double      best = 0;
+    double      startTime;
+    double      elapsed;
+    uint32_t    run;
+
+    for( run=0; run<NumRuns; run++ )
+    {
+        if( 0 != Work->Setup( ) )
+        {
+            RestoreDefaults( );
+            return -1;
+        }
+
+        startTime = GetTime( );
+        Work->Function( );
+        elapsed = GetTime( ) - startTime;
+        RestoreDefaults( );
+
+        if( 0 == run || elapsed < best )
+        {
+            best = elapsed;
+        }
+    }
+
+    *pRate = ( best > 0 ) ? Work->Megabytes * ( 1048576.0 / 1e6 ) / best : 0.0;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS - Baseline file
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SkipSpace
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    SkipSpace
+    (
+        char const**        pText           // [in out]
+    )
+{
+    while( ' ' == **pText || '\t' == **pText || '\n' == **pText || '\r' == **pText )
+    {
+        *pText += 1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ParseChar
+//
+//  Skips space then the character Char.
+//  Returns 0 if successful, or -1 if Char is not next
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    ParseChar
+    (
+        char const**        pText,          // [in out]
+        char                Char            // [in]
+    )
+{
+    SkipSpace( pText );
+    if( Char != **pText )
+    {
+        return -1;
+    }
+
+    *pText += 1;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ParseString
+//
+//  Parses a JSON string into String. Only the \" and \\ escapes are supported, which are all that SaveBaseline writes.
+//  Returns 0 if successful, or -1 if not a string, or too long
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    ParseString
+    (
+        char const**        pText,          // [in out]
+        char*               String,         // [out]
+        uint32_t            StringSize      // [in]
+    )
+{
+    char const*     text;
+    uint32_t        length = 0;
+
+    if( 0 != ParseChar( pText, '"' ) )
+    {
+        return -1;
+    }
+
+    for( text=*pText; '"' != *text; text++ )
+    {
+        if( '\\' == *text && ( '"' == text[1] || '\\' == text[1] ) )
+        {
+            text += 1;
+        }
+        if( '\0' == *text || '\\' == *text || length + 1 >= StringSize )
+        {
+            return -1;
+        }
+        String[length++] = *text;
+    }
+    String[length] = 0;
+
+    *pText = text + 1;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ParseBaseline
+//
+//  Parses the baseline file's text into gBaseline.
+//  Returns 0 if successful, or -1 if the text is not in the expected form
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    ParseBaseline
+    (
+        char const*         Text            // [in]
+    )
+{
+    char            machine [MACHINE_SIZE];
+    BaselineEntry*  entry;
+    char*           end;
+
+    if( 0 != ParseChar( &Text, '{' ) )
+    {
+        return -1;
+    }
+    if( 0 == ParseChar( &Text, '}' ) )
+    {
+        return 0;
+    }
+
+    // Each machine
+    do
+    {
+        if( 0 != ParseString( &Text, machine, sizeof(machine) ) || 0 != ParseChar( &Text, ':' )
+            || 0 != ParseChar( &Text, '{' ) )
+        {
+            return -1;
+        }
+        if( 0 == ParseChar( &Text, '}' ) )
+        {
+            continue;
+        }
+
+        // Each workload
+        do
+        {
+            if( gNumBaselineEntries >= MAX_BASELINE_ENTRIES )
+            {
+                return -1;
+            }
+            entry = &gBaseline[gNumBaselineEntries];
+            memcpy( entry->Machine, machine, sizeof(machine) );
+            if( 0 != ParseString( &Text, entry->Name, sizeof(entry->Name) ) || 0 != ParseChar( &Text, ':' ) )
+            {
+                return -1;
+            }
+            SkipSpace( &Text );
+            entry->Rate = strtod( Text, &end );
+            if( end == Text )
+            {
+                return -1;
+            }
+            Text = end;
+            gNumBaselineEntries += 1;
+        } while( 0 == ParseChar( &Text, ',' ) );
+
+        if( 0 != ParseChar( &Text, '}' ) )
+        {
+            return -1;
+        }
+    } while( 0 == ParseChar( &Text, ',' ) );
+
+    if( 0 != ParseChar( &Text, '}' ) )
+    {
+        return -1;
+    }
+    SkipSpace( &Text );
+    return ( '\0' == *Text ) ? 0 : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LoadBaseline
+//
+//  Reads the baseline file into gBaseline. A file that does not exist is an empty baseline.
+//  Returns 0 if successful, or -1 if the file could not be read or parsed
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    LoadBaseline
+    (
+        char const*         FileName        // [in]
+    )
+{
+    FILE*       file;
+    char*       text;
+    size_t      size;
+    int         result;
+
+    gNumBaselineEntries = 0;
+    file = fopen( FileName, "rb" );
+    if( NULL == file )
+    {
+        return 0;
+    }
+
+    text = malloc( MAX_BASELINE_FILE_SIZE + 1 );
+    if( NULL == text )
+    {
+        fclose( file );
+        return -1;
+    }
+    size = fread( text, 1, MAX_BASELINE_FILE_SIZE + 1, file );
+    fclose( file );
+    if( size > MAX_BASELINE_FILE_SIZE )
+    {
+        free( text );
+        return -1;
+    }
+    text[size] = 0;
+
+    result = ParseBaseline( text );
+    free( text );
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FindBaseline
+//
+//  Returns the baseline entry of a workload on a machine, or NULL if there is none
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+BaselineEntry*
+    FindBaseline
+    (
+        char const*         Machine,        // [in]
+        char const*         Name            // [in]
+    )
+{
+    uint32_t    i;
+
+    for( i=0; i<gNumBaselineEntries; i++ )
+    {
+        if( 0 == strcmp( gBaseline[i].Machine, Machine ) && 0 == strcmp( gBaseline[i].Name, Name ) )
+        {
+            return &gBaseline[i];
+        }
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WriteString
+//
+//  Writes String as a JSON string
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    WriteString
+    (
+        FILE*               File,           // [in]
+        char const*         String          // [in]
+    )
+{
+    fputc( '"', File );
+    for( ; '\0' != *String; String++ )
+    {
+        if( '"' == *String || '\\' == *String )
+        {
+            fputc( '\\', File );
+        }
+        fputc( *String, File );
+    }
+    fputc( '"', File );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SaveBaseline
+//
+//  Writes gBaseline to the baseline file, grouped by machine in the order they appear in gBaseline.
+//  Returns 0 if successful, or -1 if the file could not be written
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    SaveBaseline
+    (
+        char const*         FileName        // [in]
+    )
+{
+    FILE*       file;
+    uint32_t    i;
+    uint32_t    first;
+
+    file = fopen( FileName, "wb" );
+    if( NULL == file )
+    {
+        return -1;
+    }
+
+    fprintf( file, "{" );
+    for( first=0; first<gNumBaselineEntries; first=i )
+    {
+        fprintf( file, "%s\n  ", ( 0 == first ) ? "" : "," );
+        WriteString( file, gBaseline[first].Machine );
+        fprintf( file, ": {" );
+        for( i=first; i<gNumBaselineEntries && 0 == strcmp( gBaseline[i].Machine, gBaseline[first].Machine ); i++ )
+        {
+            fprintf( file, "%s\n    ", ( i == first ) ? "" : "," );
+            WriteString( file, gBaseline[i].Name );
+            fprintf( file, ": %.1f", gBaseline[i].Rate );
+        }
+        fprintf( file, "\n  }" );
+    }
+    fprintf( file, "\n}\n" );
+
+    return ( 0 == fclose( file ) ) ? 0 : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  UpdateBaseline
+//
+//  Replaces the entries of Machine in gBaseline with Rates, at the place of the machine's first entry (or the end if
+//  it has none) so the file only changes where this machine's numbers do. Unsupported workloads have a rate of 0.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    UpdateBaseline
+    (
+        char const*         Machine,        // [in]
+        double const        Rates []        // [in]
+    )
+{
+    static BaselineEntry    others [MAX_BASELINE_ENTRIES];
+    uint32_t                numOthers = 0;
+    uint32_t                insertAt = MAX_BASELINE_ENTRIES;
+    uint32_t                i;
+    uint32_t                w;
+
+    for( i=0; i<gNumBaselineEntries; i++ )
+    {
+        if( 0 == strcmp( gBaseline[i].Machine, Machine ) )
+        {
+            if( MAX_BASELINE_ENTRIES == insertAt )
+            {
+                insertAt = numOthers;
+            }
+        }
+        else
+        {
+            others[numOthers++] = gBaseline[i];
+        }
+    }
+    if( MAX_BASELINE_ENTRIES == insertAt )
+    {
+        insertAt = numOthers;
+    }
+
+    gNumBaselineEntries = 0;
+    for( i=0; i<=numOthers; i++ )
+    {
+        if( i == insertAt )
+        {
+            for( w=0; w<NUM_WORKLOADS && gNumBaselineEntries<MAX_BASELINE_ENTRIES; w++ )
+            {
+                if( Rates[w] > 0 )
+                {
+                    snprintf( gBaseline[gNumBaselineEntries].Machine, MACHINE_SIZE, "%s", Machine );
+                    snprintf( gBaseline[gNumBaselineEntries].Name, sizeof(gBaseline[0].Name), "%s",
+                        gWorkloads[w].Name );
+                    gBaseline[gNumBaselineEntries].Rate = Rates[w];
+                    gNumBaselineEntries += 1;
+                }
+            }
+        }
+        if( i < numOthers && gNumBaselineEntries < MAX_BASELINE_ENTRIES )
+        {
+            gBaseline[gNumBaselineEntries++] = others[i];
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  main
+//
+//  Program entry point
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    main
+    (
+        int             ArgC,
+        char**          ArgV
+    )
+{
+    char const*         baselineFileName = NULL;
+    double              tolerance = DEFAULT_TOLERANCE_PERCENT;
+    uint32_t            numRuns = DEFAULT_NUM_RUNS;
+    int                 update = 0;
+    char                brand [CPU_BRAND_SIZE];
+    char                machine [MACHINE_SIZE];
+    double              rates [NUM_WORKLOADS];
+    BaselineEntry*      baseline;
+    uint32_t            numCompared = 0;
+    uint32_t            numRegressions = 0;
+    double              change;
+    uint32_t            i;
+    int                 arg;
+
+    for( arg=1; arg<ArgC; arg++ )
+    {
+        if( 0 == strcmp( ArgV[arg], "-b" ) && arg+1 < ArgC )
+        {
+            baselineFileName = ArgV[++arg];
+        }
+        else if( 0 == strcmp( ArgV[arg], "-t" ) && arg+1 < ArgC )
+        {
+            tolerance = atof( ArgV[++arg] );
+        }
+        else if( 0 == strcmp( ArgV[arg], "-r" ) && arg+1 < ArgC && 0 != ( numRuns = (uint32_t)atoi( ArgV[arg+1] ) ) )
+        {
+            arg += 1;
+        }
+        else if( 0 == strcmp( ArgV[arg], "-u" ) )
+        {
+            update = 1;
+        }
+        else
+        {
+            printf(
+                "Syntax\n"
+                "   WjCryptLibPerf [-b Baseline.json] [-t Tolerance] [-r Runs] [-u]\n"
+                "     -b - Baseline file to compare with (or update)\n"
+                "     -t - Percentage slower than the baseline that fails (default %.0f)\n"
+                "     -r - Runs of each workload, the fastest is used (default %u)\n"
+                "     -u - Store this machine's results in the baseline file\n",
+                DEFAULT_TOLERANCE_PERCENT, DEFAULT_NUM_RUNS );
+            return 1;
+        }
+    }
+
+    if( update && NULL == baselineFileName )
+    {
+        printf( "-u needs a baseline file\n" );
+        return 1;
+    }
+    if( NULL != baselineFileName && 0 != LoadBaseline( baselineFileName ) )
+    {
+        printf( "Could not read baseline file %s\n", baselineFileName );
+        return 1;
+    }
+
+    CpuGetBrand( brand );
+    if( '\0' != WJCRYPTLIB_PERF_BUILD[0] )
+    {
+        snprintf( machine, sizeof(machine), "%s [%s]", brand, WJCRYPTLIB_PERF_BUILD );
+    }
+    else
+    {
+        snprintf( machine, sizeof(machine), "%s", brand );
+    }
+    printf( "Machine: %s\n", machine );
+    printf( "Tolerance: %.1f%%, best of %u runs\n\n", tolerance, numRuns );
+    printf( "%-40s  %10s  %10s  %7s\n", "Workload", "Baseline", "MB/s", "Change" );
+
+    for( i=0; i<NUM_WORKLOADS; i++ )
+    {
+        if( 0 != RunWorkload( &gWorkloads[i], numRuns, &rates[i] ) )
+        {
+            rates[i] = 0;
+            printf( "%-40s  not supported\n", gWorkloads[i].Name );
+            continue;
+        }
+
+        baseline = FindBaseline( machine, gWorkloads[i].Name );
+        if( NULL == baseline || baseline->Rate <= 0 )
+        {
+            printf( "%-40s  %10s  %10.1f\n", gWorkloads[i].Name, "-", rates[i] );
+            continue;
+        }
+
+        numCompared += 1;
+        change = 100.0 * ( rates[i] - baseline->Rate ) / baseline->Rate;
+        printf( "%-40s  %10.1f  %10.1f  %+6.1f%%%s\n", gWorkloads[i].Name, baseline->Rate, rates[i], change,
+            ( change < -tolerance ) ? "  REGRESSION" : "" );
+        if( change < -tolerance )
+        {
+            numRegressions += 1;
+        }
+    }
+    printf( "\n" );
+
+    if( update )
+    {
+        UpdateBaseline( machine, rates );
+        if( 0 != SaveBaseline( baselineFileName ) )
+        {
+            printf( "Could not write baseline file %s\n", baselineFileName );
+            return 1;
+        }
+        printf( "Baseline for this machine stored in %s\n", baselineFileName );
+        return 0;
+    }
+
+    if( NULL != baselineFileName && 0 == numCompared )
+    {
+        printf( "No baseline for this machine. Run with -u to store one.\n" );
+    }
+    if( numRegressions > 0 )
+    {
+        printf( "%u workloads slower than the baseline by more than %.1f%%\n", numRegressions, tolerance );
+        return 1;
+    }
+
+    return 0;
+}
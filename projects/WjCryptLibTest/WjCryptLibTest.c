@@ -17,10 +17,19 @@
 #include <stdbool.h>
 #include "WjCryptLibTest_Aes.h"
 #include "WjCryptLibTest_AesCbc.h"
+#include "WjCryptLibTest_AesCcm.h"
+#include "WjCryptLibTest_AesGcmSiv.h"
+#include "WjCryptLibTest_AesKeyWrap.h"
 #include "WjCryptLibTest_AesCtr.h"
+#include "WjCryptLibTest_AesCtrSha256.h"
 #include "WjCryptLibTest_AesOfb.h"
+#include "WjCryptLibTest_Cpu.h"
+#include "WjCryptLibTest_Drbg.h"
 #include "WjCryptLibTest_Hashes.h"
+#include "WjCryptLibTest_Hkdf.h"
+#include "WjCryptLibTest_Hmac.h"
 #include "WjCryptLibTest_Rc4.h"
+#include "WjCryptLibTest_Stats.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  FUNCTIONS
@@ -48,6 +57,14 @@ int
     success = TestHashes( );
     if( !success ) { allSuccess = false; }
 
+    success = TestHmac( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test HMAC    - %s\n", success?"Pass":"Fail" );
+
+    success = TestHkdf( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test HKDF    - %s\n", success?"Pass":"Fail" );
+
     success = TestRc4( );
     if( !success ) { allSuccess = false; }
     printf( "Test RC4     - %s\n", success?"Pass":"Fail" );
@@ -64,10 +81,38 @@ int
     if( !success ) { allSuccess = false; }
     printf( "Test AES CTR - %s\n", success?"Pass":"Fail" );
 
+    success = TestAesCtrSha256( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test AES CTR SHA256 - %s\n", success?"Pass":"Fail" );
+
     success = TestAesOfb( );
     if( !success ) { allSuccess = false; }
     printf( "Test AES OFB - %s\n", success?"Pass":"Fail" );
 
+    success = TestAesCcm( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test AES CCM - %s\n", success?"Pass":"Fail" );
+
+    success = TestAesGcmSiv( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test AES GCM-SIV - %s\n", success?"Pass":"Fail" );
+
+    success = TestAesKeyWrap( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test AES Key Wrap - %s\n", success?"Pass":"Fail" );
+
+    success = TestDrbg( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test DRBG    - %s\n", success?"Pass":"Fail" );
+
+    success = TestCpu( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test CPU     - %s\n", success?"Pass":"Fail" );
+
+    success = TestStats( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test Stats   - %s\n", success?"Pass":"Fail" );
+
     printf( "\n" );
     if( allSuccess )
     {
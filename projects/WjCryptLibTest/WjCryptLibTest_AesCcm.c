@@ -0,0 +1,367 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_AesCcm
+//
+//  Tests the cryptography functions against known test vectors to verify algorithms are correct.
+//  Tests the following:
+//     AES CCM
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "WjCryptLib_AesCcm.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_TEST_DATA_SIZE      64
+
+typedef struct
+{
+    char*           KeyHex;
+    char*           NonceHex;
+    char*           ADataHex;
+    char*           PlainTextHex;
+    char*           CipherTextHex;
+    char*           TagHex;
+} TestVector;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The first three vectors are RFC 3610 packet vectors #1, #2, and #3. The next three are the examples from
+// NIST SP 800-38C Appendix C. The remaining two were created with openssl (EVP_aes_256_ccm and EVP_aes_192_ccm) to
+// cover an empty additional data and an empty plaintext.
+static TestVector gTestVectors [] =
+{
+    {
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf",
+        "00000003020100a0a1a2a3a4a5",
+        "0001020304050607",
+        "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e",
+        "588c979a61c663d2f066d0c2c0f989806d5f6b61dac384",
+        "17e8d12cfdf926e0"
+    },
+    {
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf",
+        "00000004030201a0a1a2a3a4a5",
+        "0001020304050607",
+        "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+        "72c91a36e135f8cf291ca894085c87e3cc15c439c9e43a3b",
+        "a091d56e10400916"
+    },
+    {
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf",
+        "00000005040302a0a1a2a3a4a5",
+        "0001020304050607",
+        "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f20",
+        "51b1e5f44a197d1da46b0f8e2d282ae871e838bb64da859657",
+        "4adaa76fbd9fb0c5"
+    },
+    {
+        "404142434445464748494a4b4c4d4e4f",
+        "10111213141516",
+        "0001020304050607",
+        "20212223",
+        "7162015b",
+        "4dac255d"
+    },
+    {
+        "404142434445464748494a4b4c4d4e4f",
+        "1011121314151617",
+        "000102030405060708090a0b0c0d0e0f",
+        "202122232425262728292a2b2c2d2e2f",
+        "d2a1f0e051ea5f62081a7792073d593d",
+        "1fc64fbfaccd"
+    },
+    {
+        "404142434445464748494a4b4c4d4e4f",
+        "101112131415161718191a1b",
+        "000102030405060708090a0b0c0d0e0f10111213",
+        "202122232425262728292a2b2c2d2e2f3031323334353637",
+        "e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5",
+        "484392fbc1b09951"
+    },
+    {
+        "0102030405060708a1a2a3a4a5a6a7a8b1b2b3b4b5b6b7b8c1c2c3c4c5c6c7c8",
+        "d1d2d3d4d5d6d7d8d9dadbdcdd",
+        "",
+        "000102030405060708090a0b0c0d0e0f1011121314151617",
+        "3f95aed5b2952ebc7e36a14b1bdf504e8abb16bab6d2664b",
+        "04e24ace388cbb7445027162347b51be"
+    },
+    {
+        "0102030405060708a1a2a3a4a5a6a7a8b1b2b3b4b5b6b7b8",
+        "e1e2e3e4e5e6e7e8e9ea",
+        "00010203",
+        "",
+        "",
+        "47b8c398b325122493aa"
+    },
+};
+
+#define NUM_TEST_VECTORS ( sizeof(gTestVectors) / sizeof(gTestVectors[0]) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HexToBytes
+//
+//  Reads a string as hex and places it in Data. The number of bytes represented in the input string must not exceed
+//  MaxDataSize, otherwise the function returns false without writing anything. On success *pDataSize is set to the
+//  number of bytes written.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    HexToBytes
+    (
+        char const*         HexString,              // [in]
+        uint8_t*            Data,                   // [out]
+        uint32_t            MaxDataSize,            // [in]
+        uint32_t*           pDataSize               // [out optional]
+    )
+{
+    uint32_t        i;
+    char            holdingBuffer [3] = {0};
+    unsigned        hexToNumber;
+    uint32_t        numBytes = (uint32_t)( strlen(HexString) / 2 );
+
+    if( numBytes > MaxDataSize )
+    {
+        return false;
+    }
+
+    for( i=0; i<numBytes; i++ )
+    {
+        holdingBuffer[0] = HexString[i*2 + 0];
+        holdingBuffer[1] = HexString[i*2 + 1];
+        sscanf( holdingBuffer, "%x", &hexToNumber );
+        Data[i] = (uint8_t) hexToNumber;
+    }
+
+    if( NULL != pDataSize )
+    {
+        *pDataSize = numBytes;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestVectors
+//
+//  Tests AES CCM against fixed test vectors. Each vector is encrypted, decrypted, and decrypted again with a
+//  corrupted tag which must be rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestVectors
+    (
+        void
+    )
+{
+    uint32_t        vectorIndex;
+    uint8_t         key [AES_KEY_SIZE_256];
+    uint32_t        keySize = 0;
+    uint8_t         nonce [AES_CCM_NONCE_SIZE_MAX];
+    uint32_t        nonceSize = 0;
+    uint8_t         aData [MAX_TEST_DATA_SIZE];
+    uint32_t        aDataSize = 0;
+    uint8_t         plainText [MAX_TEST_DATA_SIZE];
+    uint32_t        plainTextSize = 0;
+    uint8_t         cipherText [MAX_TEST_DATA_SIZE];
+    uint8_t         tag [AES_CCM_TAG_SIZE_MAX];
+    uint32_t        tagSize = 0;
+    uint8_t         output [MAX_TEST_DATA_SIZE];
+    uint8_t         outputTag [AES_CCM_TAG_SIZE_MAX];
+    uint32_t        i;
+
+    for( vectorIndex=0; vectorIndex<NUM_TEST_VECTORS; vectorIndex++ )
+    {
+        if( !HexToBytes( gTestVectors[vectorIndex].KeyHex,        key,        sizeof(key),        &keySize )
+         || !HexToBytes( gTestVectors[vectorIndex].NonceHex,      nonce,      sizeof(nonce),      &nonceSize )
+         || !HexToBytes( gTestVectors[vectorIndex].ADataHex,      aData,      sizeof(aData),      &aDataSize )
+         || !HexToBytes( gTestVectors[vectorIndex].PlainTextHex,  plainText,  sizeof(plainText),  &plainTextSize )
+         || !HexToBytes( gTestVectors[vectorIndex].CipherTextHex, cipherText, sizeof(cipherText), NULL )
+         || !HexToBytes( gTestVectors[vectorIndex].TagHex,        tag,        sizeof(tag),        &tagSize ) )
+        {
+            printf( "Test vector (index:%u) has a hex string too large for its buffer\n", vectorIndex );
+            return false;
+        }
+
+        if(     0 != AesCcmEncryptWithKey( key, keySize, nonce, nonceSize, aData, aDataSize,
+                        plainText, output, plainTextSize, outputTag, tagSize )
+            ||  0 != memcmp( output, cipherText, plainTextSize )
+            ||  0 != memcmp( outputTag, tag, tagSize ) )
+        {
+            printf( "Test vector (index:%u) failed\n", vectorIndex );
+            return false;
+        }
+
+        if(     0 != AesCcmDecryptWithKey( key, keySize, nonce, nonceSize, aData, aDataSize,
+                        cipherText, output, plainTextSize, tag, tagSize )
+            ||  0 != memcmp( output, plainText, plainTextSize ) )
+        {
+            printf( "Test vector (index:%u) failed decrypt\n", vectorIndex );
+            return false;
+        }
+
+        // Corrupt the tag and verify decryption is refused and no plaintext is released.
+        tag[tagSize-1] ^= 0x01;
+        if( 0 == AesCcmDecryptWithKey( key, keySize, nonce, nonceSize, aData, aDataSize,
+                     cipherText, output, plainTextSize, tag, tagSize ) )
+        {
+            printf( "Test vector (index:%u) accepted a corrupted tag\n", vectorIndex );
+            return false;
+        }
+        for( i=0; i<plainTextSize; i++ )
+        {
+            if( 0 != output[i] )
+            {
+                printf( "Test vector (index:%u) released plaintext on failure\n", vectorIndex );
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestLongAData
+//
+//  Tests the six byte encoding of the additional data length which is used for 0xff00 bytes or more. The tag was
+//  created with openssl (EVP_aes_128_ccm) using a zero key, a zero 13 byte nonce, 70000 bytes of additional data
+//  with byte n set to (n & 0xff), and 100 bytes of plaintext with byte n set to ((n * 3) & 0xff).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestLongAData
+    (
+        void
+    )
+{
+    uint8_t const   key [AES_KEY_SIZE_128] = {0};
+    uint8_t const   nonce [13] = {0};
+    uint8_t const   expectedTag [16] =
+        { 0x9c, 0x9a, 0xba, 0x2b, 0x7d, 0x5d, 0x0d, 0xf2, 0x2f, 0x3b, 0xb7, 0x11, 0x2f, 0xa1, 0x7e, 0x3a };
+    uint32_t const  aDataSize = 70000;
+    uint8_t*        aData = malloc( aDataSize );
+    uint8_t         plainText [100];
+    uint8_t         buffer [100];
+    uint8_t         tag [16];
+    uint32_t        i;
+    bool            success = true;
+
+    for( i=0; i<aDataSize; i++ )
+    {
+        aData[i] = (uint8_t)i;
+    }
+    for( i=0; i<sizeof(plainText); i++ )
+    {
+        plainText[i] = (uint8_t)( i * 3 );
+    }
+
+    // Encrypt in place then decrypt in place
+    memcpy( buffer, plainText, sizeof(buffer) );
+    AesCcmEncryptWithKey( key, sizeof(key), nonce, sizeof(nonce), aData, aDataSize, buffer, buffer, sizeof(buffer),
+        tag, sizeof(tag) );
+    if( 0 != memcmp( tag, expectedTag, sizeof(tag) ) )
+    {
+        printf( "Long additional data test failed\n" );
+        success = false;
+    }
+
+    if(     0 != AesCcmDecryptWithKey( key, sizeof(key), nonce, sizeof(nonce), aData, aDataSize,
+                    buffer, buffer, sizeof(buffer), tag, sizeof(tag) )
+        ||  0 != memcmp( buffer, plainText, sizeof(buffer) ) )
+    {
+        printf( "Long additional data test failed decrypt\n" );
+        success = false;
+    }
+
+    free( aData );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestInvalidParameters
+//
+//  Verifies that invalid nonce sizes, tag sizes, and messages too long for the length field are rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestInvalidParameters
+    (
+        void
+    )
+{
+    uint8_t const   key [AES_KEY_SIZE_128] = {0};
+    uint8_t const   nonce [16] = {0};
+    uint8_t         buffer [16] = {0};
+    uint8_t         tag [16];
+    bool            success = true;
+
+    if(     0 == AesCcmEncryptWithKey( key, sizeof(key), nonce, 6, NULL, 0, buffer, buffer, sizeof(buffer), tag, 8 )
+        ||  0 == AesCcmEncryptWithKey( key, sizeof(key), nonce, 14, NULL, 0, buffer, buffer, sizeof(buffer), tag, 8 )
+        ||  0 == AesCcmEncryptWithKey( key, sizeof(key), nonce, 13, NULL, 0, buffer, buffer, sizeof(buffer), tag, 2 )
+        ||  0 == AesCcmEncryptWithKey( key, sizeof(key), nonce, 13, NULL, 0, buffer, buffer, sizeof(buffer), tag, 7 )
+        ||  0 == AesCcmEncryptWithKey( key, sizeof(key), nonce, 13, NULL, 0, buffer, buffer, sizeof(buffer), tag, 18 )
+        ||  0 == AesCcmEncryptWithKey( key, 17, nonce, 13, NULL, 0, buffer, buffer, sizeof(buffer), tag, 8 ) )
+    {
+        printf( "AES CCM accepted invalid parameters\n" );
+        success = false;
+    }
+
+    // With a 13 byte nonce the length field is 2 bytes, so 65536 bytes can not be represented. The size check happens
+    // before any data is touched so the small buffer is never read.
+    if( 0 == AesCcmEncryptWithKey( key, sizeof(key), nonce, 13, NULL, 0, buffer, buffer, 65536, tag, 8 ) )
+    {
+        printf( "AES CCM accepted a message too long for the length field\n" );
+        success = false;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestAesCcm
+//
+//  Test AES CCM algorithm
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestAesCcm
+    (
+        void
+    )
+{
+    bool        totalSuccess = true;
+    bool        success;
+
+    success = TestVectors( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestLongAData( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestInvalidParameters( );
+    if( !success ) { totalSuccess = false; }
+
+    return totalSuccess;
+}
@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_AesCcm
+//
+//  Tests the cryptography functions against known test vectors to verify algorithms are correct.
+//  Tests the following:
+//     AES CCM
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  EXPORTED FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestAesCcm
+//
+//  Test AES CCM algorithm
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestAesCcm
+    (
+        void
+    );
\ No newline at end of file
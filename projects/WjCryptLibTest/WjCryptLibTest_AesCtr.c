@@ -39,6 +39,15 @@ typedef struct
     char*           CipherTextHex;
 } TestVector;
 
+typedef struct
+{
+    char*           InitialBlockHex;
+    uint32_t        CounterSize;
+    uint32_t        CounterEndian;
+    char*           SecondBlockHex;
+    char*           ThirdBlockHex;
+} CounterLayoutVector;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  GLOBALS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -88,6 +97,27 @@ static TestVector gTestVectors [] =
 #define NUM_TEST_VECTORS ( sizeof(gTestVectors) / sizeof(gTestVectors[0]) )
 #define TEST_VECTOR_OUTPUT_SIZE     48
 
+// Counter layouts with the counter blocks expected for the second and third blocks of the stream. Each initial counter
+// block is chosen so that incrementing it carries to the top of the counter field and wraps, which must not disturb
+// the bytes outside the field.
+static CounterLayoutVector gCounterLayoutVectors [] =
+{
+    {   "a0a1a2a3a4a5a6a7a8a9aaabfffffffe", 4, AES_CTR_COUNTER_BIG_ENDIAN,
+        "a0a1a2a3a4a5a6a7a8a9aaabffffffff", "a0a1a2a3a4a5a6a7a8a9aaab00000000" },
+    {   "a0a1a2a3a4a5a6a7fffffffffffffffe", 8, AES_CTR_COUNTER_BIG_ENDIAN,
+        "a0a1a2a3a4a5a6a7ffffffffffffffff", "a0a1a2a3a4a5a6a70000000000000000" },
+    {   "fffffffffffffffffffffffffffffffe", 16, AES_CTR_COUNTER_BIG_ENDIAN,
+        "ffffffffffffffffffffffffffffffff", "00000000000000000000000000000000" },
+    {   "feffffffa4a5a6a7a8a9aaabacadaeaf", 4, AES_CTR_COUNTER_LITTLE_ENDIAN,
+        "ffffffffa4a5a6a7a8a9aaabacadaeaf", "00000000a4a5a6a7a8a9aaabacadaeaf" },
+    {   "feffffffffffffffa8a9aaabacadaeaf", 8, AES_CTR_COUNTER_LITTLE_ENDIAN,
+        "ffffffffffffffffa8a9aaabacadaeaf", "0000000000000000a8a9aaabacadaeaf" },
+    {   "ff00ffffffffffffffffffffffffff7f", 16, AES_CTR_COUNTER_LITTLE_ENDIAN,
+        "0001ffffffffffffffffffffffffff7f", "0101ffffffffffffffffffffffffff7f" },
+};
+
+#define NUM_COUNTER_LAYOUT_VECTORS ( sizeof(gCounterLayoutVectors) / sizeof(gCounterLayoutVectors[0]) )
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  INTERNAL FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -415,6 +445,220 @@ bool
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestFullCounterVector
+//
+//  Tests a 128 bit big endian counter against a vector created with openssl, which increments the whole block:
+//   > openssl enc -aes-128-ctr -K 000102030405060708090a0b0c0d0e0f -iv ffffffffffffffffffffffffffffffff
+//  over 48 zero bytes. The counter wraps from all ones to all zeros after the first block.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestFullCounterVector
+    (
+        void
+    )
+{
+    AesContext      aes;
+    AesCtrContext   context;
+    uint8_t const   key [AES_KEY_SIZE_128] = { 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15 };
+    uint8_t         counterBlock [AES_BLOCK_SIZE];
+    uint8_t         vector [48];
+    uint8_t         output [48];
+
+    memset( counterBlock, 0xff, sizeof(counterBlock) );
+    HexToBytes( "3c441f32ce07822364d7a2990e50bb13c6a13b37878f5b826f4f8162a1c8d8797346139595c0b41e497bbde365f42d0a",
+        vector, sizeof(vector), NULL );
+
+    AesInitialise( &aes, key, sizeof(key) );
+    if( 0 != AesCtrInitialiseWithCounterBlock( &context, &aes, counterBlock, 16, AES_CTR_COUNTER_BIG_ENDIAN ) )
+    {
+        printf( "AesCtrInitialiseWithCounterBlock failed\n" );
+        return false;
+    }
+    AesCtrOutput( &context, output, sizeof(output) );
+
+    if( 0 != memcmp( vector, output, sizeof(vector) ) )
+    {
+        printf( "Fail on 128 bit counter test\n" );
+        return false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCounterLayouts
+//
+//  Tests each counter size and byte order by comparing the stream against AES encryptions of the expected counter
+//  blocks. The stream is read from a position part way through the first block so that both the current block and
+//  the generated blocks are checked.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestCounterLayouts
+    (
+        void
+    )
+{
+    AesContext      aes;
+    AesCtrContext   context;
+    uint8_t const   key [AES_KEY_SIZE_128] = { 1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4 };
+    uint8_t         blocks [3][AES_BLOCK_SIZE];
+    uint8_t         output [3 * AES_BLOCK_SIZE];
+    uint32_t        layoutIndex;
+
+    AesInitialise( &aes, key, sizeof(key) );
+
+    for( layoutIndex=0; layoutIndex<NUM_COUNTER_LAYOUT_VECTORS; layoutIndex++ )
+    {
+        HexToBytes( gCounterLayoutVectors[layoutIndex].InitialBlockHex, blocks[0], AES_BLOCK_SIZE, NULL );
+        HexToBytes( gCounterLayoutVectors[layoutIndex].SecondBlockHex, blocks[1], AES_BLOCK_SIZE, NULL );
+        HexToBytes( gCounterLayoutVectors[layoutIndex].ThirdBlockHex, blocks[2], AES_BLOCK_SIZE, NULL );
+
+        if( 0 != AesCtrInitialiseWithCounterBlock( &context, &aes, blocks[0],
+                     gCounterLayoutVectors[layoutIndex].CounterSize, gCounterLayoutVectors[layoutIndex].CounterEndian ) )
+        {
+            printf( "AesCtrInitialiseWithCounterBlock (index:%u) failed\n", layoutIndex );
+            return false;
+        }
+
+        AesCtrSetStreamIndex( &context, 5 );
+        AesCtrOutput( &context, output + 5, sizeof(output) - 5 );
+
+        AesEncryptInPlace( &aes, blocks[0] );
+        AesEncryptInPlace( &aes, blocks[1] );
+        AesEncryptInPlace( &aes, blocks[2] );
+        if( 0 != memcmp( output + 5, (uint8_t*)blocks + 5, sizeof(output) - 5 ) )
+        {
+            printf( "Fail on counter layout test (index:%u)\n", layoutIndex );
+            return false;
+        }
+    }
+
+    // Invalid layouts must be rejected
+    if(     0 == AesCtrInitialiseWithCounterBlock( &context, &aes, blocks[0], 12, AES_CTR_COUNTER_BIG_ENDIAN )
+        ||  0 == AesCtrInitialiseWithCounterBlock( &context, &aes, blocks[0], 4, 2 ) )
+    {
+        printf( "AesCtrInitialiseWithCounterBlock accepted an invalid layout\n" );
+        return false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestKeyStreamBuffer
+//
+//  Tests that the precomputed keystream buffer produces the same stream as the plain context. Requests of varying
+//  sizes are interleaved with partial fills so that requests are served from the buffer, from AES, and from both, and
+//  the ring wraps. Seeks within, before, and beyond the buffered range are also tested.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestKeyStreamBuffer
+    (
+        void
+    )
+{
+    #define KEYSTREAM_TEST_SIZE     4096
+    uint8_t const   key [AES_KEY_SIZE_128] = { 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 };
+    uint8_t const   iv [AES_CTR_IV_SIZE] = { 1,2,3,4,5,6,7,8 };
+    uint8_t*        stream = malloc( KEYSTREAM_TEST_SIZE );
+    uint8_t*        newStream = malloc( KEYSTREAM_TEST_SIZE );
+    uint8_t         ring [256];
+    AesCtrContext   context;
+    uint32_t        offset = 0;
+    uint32_t        chunkSize;
+    uint32_t        step = 0;
+    bool            success = true;
+
+    memset( stream, 0, KEYSTREAM_TEST_SIZE );
+    AesCtrXorWithKey( key, sizeof(key), iv, stream, stream, KEYSTREAM_TEST_SIZE );
+
+    AesCtrInitialiseWithKey( &context, key, sizeof(key), iv );
+    if(     0 == AesCtrSetKeyStreamBuffer( &context, ring, 0 )
+        ||  0 == AesCtrSetKeyStreamBuffer( &context, ring, 100 )
+        ||  0 != AesCtrSetKeyStreamBuffer( &context, ring, sizeof(ring) ) )
+    {
+        printf( "AesCtrSetKeyStreamBuffer size validation failed\n" );
+        success = false;
+    }
+
+    // Fill the whole ring and check a request of that size needs no AES
+    if(     sizeof(ring) != AesCtrFillKeyStream( &context, 0xffffffff )
+        ||  sizeof(ring) != AesCtrGetKeyStreamAvailable( &context )
+        ||  0 != AesCtrFillKeyStream( &context, 0xffffffff ) )
+    {
+        printf( "AesCtrFillKeyStream did not fill the buffer\n" );
+        success = false;
+    }
+
+    // Read the stream in chunks of 1 to 300 bytes, refilling by differing amounts in between.
+    memset( newStream, 0, KEYSTREAM_TEST_SIZE );
+    while( offset < KEYSTREAM_TEST_SIZE )
+    {
+        chunkSize = MIN( ((step * 37) % 300) + 1, KEYSTREAM_TEST_SIZE - offset );
+        AesCtrOutput( &context, newStream + offset, chunkSize );
+        offset += chunkSize;
+        AesCtrFillKeyStream( &context, (step * 53) % 200 );
+        step += 1;
+    }
+    if( 0 != memcmp( stream, newStream, KEYSTREAM_TEST_SIZE ) )
+    {
+        printf( "AES CTR keystream buffer stream not consistent\n" );
+        success = false;
+    }
+
+    // Seek within the buffered range: the keystream after the new position must be kept
+    AesCtrSetStreamIndex( &context, 1000 );
+    AesCtrFillKeyStream( &context, sizeof(ring) );
+    AesCtrSetStreamIndex( &context, 1100 );
+    if( sizeof(ring) - (1100 - (1000 - (1000 % AES_BLOCK_SIZE))) != AesCtrGetKeyStreamAvailable( &context ) )
+    {
+        printf( "AES CTR keystream buffer discarded data on forward seek\n" );
+        success = false;
+    }
+    AesCtrOutput( &context, newStream, 50 );
+
+    // Seek backwards then beyond the buffered range: the buffer must be emptied
+    AesCtrSetStreamIndex( &context, 900 );
+    if( 0 != AesCtrGetKeyStreamAvailable( &context ) )
+    {
+        printf( "AES CTR keystream buffer kept data on backward seek\n" );
+        success = false;
+    }
+    AesCtrOutput( &context, newStream + 900, 100 );
+    AesCtrFillKeyStream( &context, sizeof(ring) );
+    AesCtrSetStreamIndex( &context, 3000 );
+    if( 0 != AesCtrGetKeyStreamAvailable( &context ) )
+    {
+        printf( "AES CTR keystream buffer kept data on far seek\n" );
+        success = false;
+    }
+    AesCtrFillKeyStream( &context, 64 );
+    AesCtrOutput( &context, newStream + 3000, 1000 );
+
+    // Detach the buffer part way through a block and continue
+    AesCtrSetStreamIndex( &context, 1100 );
+    AesCtrFillKeyStream( &context, 64 );
+    AesCtrOutput( &context, newStream + 1100, 30 );
+    AesCtrSetKeyStreamBuffer( &context, NULL, 0 );
+    AesCtrOutput( &context, newStream + 1130, 70 );
+
+    if(     0 != memcmp( stream + 900, newStream + 900, 300 )
+        ||  0 != memcmp( stream + 3000, newStream + 3000, 1000 )
+        ||  0 != memcmp( stream + 1100, newStream, 50 ) )
+    {
+        printf( "AES CTR keystream buffer not consistent after seeking\n" );
+        success = false;
+    }
+
+    free( stream );
+    free( newStream );
+    return success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -448,5 +692,14 @@ bool
     success = TestEndianCorrectness( );
     if( !success ) { totalSuccess = false; }
 
+    success = TestFullCounterVector( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestCounterLayouts( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestKeyStreamBuffer( );
+    if( !success ) { totalSuccess = false; }
+
     return totalSuccess;
 }
@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_AesCtrSha256
+//
+//  Tests the cryptography functions against known test vectors to verify algorithms are correct.
+//  Tests the following:
+//     AES CTR + SHA256 encrypt-then-hash
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "WjCryptLib_AesCtrSha256.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MACROS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MIN( x, y ) ( ((x)<(y))?(x):(y) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Several tiles and a partial one, so that tile boundaries fall in the middle of chunks
+#define TEST_DATA_SIZE          ( 3 * AES_CTR_SHA256_TILE_SIZE + 1000 )
+
+// Known answer: SHA256 of AES-256-CTR (key 00..1f, IV f0..f7) of 20000 bytes of i % 251, from OpenSSL
+#define KNOWN_DATA_SIZE         20000
+#define KNOWN_DIGEST_HEX        "364a7c549ac3294628876941be56509f4b782f2ecd0e97fbdfd2fd9dc9248194"
+
+static uint8_t const gKey [AES_KEY_SIZE_256] =
+{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static uint8_t const gIv [AES_CTR_IV_SIZE] = { 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7 };
+
+// Sizes the data is passed in, including ones that are not a multiple of the AES or SHA256 block size
+static uint32_t const gChunkSizes [] =
+{
+    1, 15, 63, 64, 1000, AES_CTR_SHA256_TILE_SIZE - 1, AES_CTR_SHA256_TILE_SIZE, AES_CTR_SHA256_TILE_SIZE + 1,
+    TEST_DATA_SIZE
+};
+
+#define NUM_CHUNK_SIZES ( sizeof(gChunkSizes) / sizeof(gChunkSizes[0]) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestKnownAnswer
+//
+//  Tests the one call functions against a digest and ciphertext produced by OpenSSL, and that an invalid key size is
+//  rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestKnownAnswer
+    (
+        void
+    )
+{
+    bool            success = true;
+    uint8_t*        plainText;
+    uint8_t*        cipherText;
+    uint8_t*        decrypted;
+    uint32_t        i;
+    SHA256_HASH     digest;
+    SHA256_HASH     decryptDigest;
+    char            digestHex [SHA256_HASH_SIZE*2 + 1];
+
+    plainText = malloc( KNOWN_DATA_SIZE );
+    cipherText = malloc( KNOWN_DATA_SIZE );
+    decrypted = malloc( KNOWN_DATA_SIZE );
+    if( NULL == plainText || NULL == cipherText || NULL == decrypted )
+    {
+        printf( "AES CTR SHA256 - Out of memory\n" );
+        free( plainText );
+        free( cipherText );
+        free( decrypted );
+        return false;
+    }
+
+    for( i=0; i<KNOWN_DATA_SIZE; i++ )
+    {
+        plainText[i] = (uint8_t)( i % 251 );
+    }
+
+    if(     0 != AesCtrSha256EncryptWithKey( gKey, sizeof(gKey), gIv, plainText, cipherText, KNOWN_DATA_SIZE, &digest )
+        ||  0 != AesCtrSha256DecryptWithKey( gKey, sizeof(gKey), gIv, cipherText, decrypted, KNOWN_DATA_SIZE,
+                    &decryptDigest ) )
+    {
+        printf( "AES CTR SHA256 - One call functions failed\n" );
+        success = false;
+    }
+    else
+    {
+        for( i=0; i<SHA256_HASH_SIZE; i++ )
+        {
+            sprintf( digestHex + i*2, "%2.2x", digest.bytes[i] );
+        }
+
+        if(     0 != strcmp( digestHex, KNOWN_DIGEST_HEX )
+            ||  0 != memcmp( &digest, &decryptDigest, sizeof(digest) )
+            ||  0 != memcmp( decrypted, plainText, KNOWN_DATA_SIZE ) )
+        {
+            printf( "AES CTR SHA256 - Known answer test failed\n" );
+            success = false;
+        }
+    }
+
+    if(     -1 != AesCtrSha256EncryptWithKey( gKey, 15, gIv, plainText, cipherText, KNOWN_DATA_SIZE, &digest )
+        ||  -1 != AesCtrSha256DecryptWithKey( gKey, 15, gIv, cipherText, decrypted, KNOWN_DATA_SIZE, &digest ) )
+    {
+        printf( "AES CTR SHA256 - Invalid key size accepted\n" );
+        success = false;
+    }
+
+    free( plainText );
+    free( cipherText );
+    free( decrypted );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestMatchesSeparate
+//
+//  Tests that encrypting and decrypting in chunks of various sizes, both in place and into a separate buffer, gives
+//  the same data and hash as AesCtrXor followed by Sha256Update over the whole buffer.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestMatchesSeparate
+    (
+        void
+    )
+{
+    bool            success = true;
+    uint8_t*        plainText;
+    uint8_t*        expectedCipherText;
+    uint8_t*        buffer;
+    uint8_t*        output;
+    uint32_t        i;
+    uint32_t        chunkIndex;
+    uint32_t        inPlace;
+    SHA256_HASH     expectedDigest;
+    SHA256_HASH     digest;
+    AesCtrContext   aesCtr;
+    Sha256Context   sha256;
+
+    plainText = malloc( TEST_DATA_SIZE );
+    expectedCipherText = malloc( TEST_DATA_SIZE );
+    buffer = malloc( TEST_DATA_SIZE );
+    output = malloc( TEST_DATA_SIZE );
+    if( NULL == plainText || NULL == expectedCipherText || NULL == buffer || NULL == output )
+    {
+        printf( "AES CTR SHA256 - Out of memory\n" );
+        free( plainText );
+        free( expectedCipherText );
+        free( buffer );
+        free( output );
+        return false;
+    }
+
+    for( i=0; i<TEST_DATA_SIZE; i++ )
+    {
+        plainText[i] = (uint8_t)( i * 7 + 3 );
+    }
+
+    AesCtrXorWithKey( gKey, sizeof(gKey), gIv, plainText, expectedCipherText, TEST_DATA_SIZE );
+    Sha256Calculate( expectedCipherText, TEST_DATA_SIZE, &expectedDigest );
+
+    for( inPlace=0; inPlace<2 && success; inPlace++ )
+    {
+        for( chunkIndex=0; chunkIndex<NUM_CHUNK_SIZES && success; chunkIndex++ )
+        {
+            uint32_t chunkSize = gChunkSizes[chunkIndex];
+            uint8_t* out = inPlace ? buffer : output;
+
+            // Encrypt
+            memcpy( buffer, plainText, TEST_DATA_SIZE );
+            memset( output, 0, TEST_DATA_SIZE );
+            AesCtrInitialiseWithKey( &aesCtr, gKey, sizeof(gKey), gIv );
+            Sha256Initialise( &sha256 );
+            for( i=0; i<TEST_DATA_SIZE; i+=chunkSize )
+            {
+                AesCtrSha256Encrypt( &aesCtr, &sha256, buffer + i, out + i, MIN( chunkSize, TEST_DATA_SIZE - i ) );
+            }
+            Sha256Finalise( &sha256, &digest );
+
+            if(     0 != memcmp( out, expectedCipherText, TEST_DATA_SIZE )
+                ||  0 != memcmp( &digest, &expectedDigest, sizeof(digest) ) )
+            {
+                printf( "AES CTR SHA256 - Encrypt mismatch (chunk:%u inplace:%u)\n", chunkSize, inPlace );
+                success = false;
+                break;
+            }
+
+            // Decrypt
+            memcpy( buffer, expectedCipherText, TEST_DATA_SIZE );
+            memset( output, 0, TEST_DATA_SIZE );
+            AesCtrInitialiseWithKey( &aesCtr, gKey, sizeof(gKey), gIv );
+            Sha256Initialise( &sha256 );
+            for( i=0; i<TEST_DATA_SIZE; i+=chunkSize )
+            {
+                AesCtrSha256Decrypt( &aesCtr, &sha256, buffer + i, out + i, MIN( chunkSize, TEST_DATA_SIZE - i ) );
+            }
+            Sha256Finalise( &sha256, &digest );
+
+            if(     0 != memcmp( out, plainText, TEST_DATA_SIZE )
+                ||  0 != memcmp( &digest, &expectedDigest, sizeof(digest) ) )
+            {
+                printf( "AES CTR SHA256 - Decrypt mismatch (chunk:%u inplace:%u)\n", chunkSize, inPlace );
+                success = false;
+                break;
+            }
+        }
+    }
+
+    free( plainText );
+    free( expectedCipherText );
+    free( buffer );
+    free( output );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestAesCtrSha256
+//
+//  Test AES CTR + SHA256 encrypt-then-hash
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestAesCtrSha256
+    (
+        void
+    )
+{
+    bool        totalSuccess = true;
+    bool        success;
+
+    success = TestKnownAnswer( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestMatchesSeparate( );
+    if( !success ) { totalSuccess = false; }
+
+    return totalSuccess;
+}
@@ -0,0 +1,387 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_AesGcmSiv
+//
+//  Tests the cryptography functions against known test vectors to verify algorithms are correct.
+//  Tests the following:
+//     AES GCM-SIV
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "WjCryptLib_AesGcmSiv.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_TEST_DATA_SIZE      64
+
+typedef struct
+{
+    char*           KeyHex;
+    char*           NonceHex;
+    char*           ADataHex;
+    char*           PlainTextHex;
+    char*           CipherTextHex;
+    char*           TagHex;
+} TestVector;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Test vectors from RFC 8452 Appendix C.1 (AEAD_AES_128_GCM_SIV) and C.2 (AEAD_AES_256_GCM_SIV)
+static TestVector gTestVectors [] =
+{
+    {
+        "01000000000000000000000000000000",
+        "030000000000000000000000",
+        "",
+        "",
+        "",
+        "dc20e2d83f25705bb49e439eca56de25"
+    },
+    {
+        "01000000000000000000000000000000",
+        "030000000000000000000000",
+        "",
+        "0100000000000000",
+        "b5d839330ac7b786",
+        "578782fff6013b815b287c22493a364c"
+    },
+    {
+        "01000000000000000000000000000000",
+        "030000000000000000000000",
+        "",
+        "010000000000000000000000",
+        "7323ea61d05932260047d942",
+        "a4978db357391a0bc4fdec8b0d106639"
+    },
+    {
+        "01000000000000000000000000000000",
+        "030000000000000000000000",
+        "",
+        "01000000000000000000000000000000",
+        "743f7c8077ab25f8624e2e948579cf77",
+        "303aaf90f6fe21199c6068577437a0c4"
+    },
+    {
+        "01000000000000000000000000000000",
+        "030000000000000000000000",
+        "01",
+        "0200000000000000",
+        "1e6daba35669f427",
+        "3b0a1a2560969cdf790d99759abd1508"
+    },
+    {
+        "0100000000000000000000000000000000000000000000000000000000000000",
+        "030000000000000000000000",
+        "",
+        "",
+        "",
+        "07f5f4169bbf55a8400cd47ea6fd400f"
+    },
+    {
+        "0100000000000000000000000000000000000000000000000000000000000000",
+        "030000000000000000000000",
+        "",
+        "0100000000000000",
+        "c2ef328e5c71c83b",
+        "843122130f7364b761e0b97427e3df28"
+    },
+};
+
+#define NUM_TEST_VECTORS ( sizeof(gTestVectors) / sizeof(gTestVectors[0]) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HexToBytes
+//
+//  Reads a string as hex and places it in Data. The number of bytes represented in the input string must not exceed
+//  MaxDataSize, otherwise the function returns false without writing anything. On success *pDataSize is set to the
+//  number of bytes written.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    HexToBytes
+    (
+        char const*         HexString,              // [in]
+        uint8_t*            Data,                   // [out]
+        uint32_t            MaxDataSize,            // [in]
+        uint32_t*           pDataSize               // [out optional]
+    )
+{
+    uint32_t        i;
+    char            holdingBuffer [3] = {0};
+    unsigned        hexToNumber;
+    uint32_t        numBytes = (uint32_t)( strlen(HexString) / 2 );
+
+    if( numBytes > MaxDataSize )
+    {
+        return false;
+    }
+
+    for( i=0; i<numBytes; i++ )
+    {
+        holdingBuffer[0] = HexString[i*2 + 0];
+        holdingBuffer[1] = HexString[i*2 + 1];
+        sscanf( holdingBuffer, "%x", &hexToNumber );
+        Data[i] = (uint8_t) hexToNumber;
+    }
+
+    if( NULL != pDataSize )
+    {
+        *pDataSize = numBytes;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestVectors
+//
+//  Tests AES GCM-SIV against fixed test vectors. Each vector is encrypted, decrypted, and decrypted again with a
+//  corrupted tag which must be rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestVectors
+    (
+        void
+    )
+{
+    uint32_t        vectorIndex;
+    uint8_t         key [AES_KEY_SIZE_256];
+    uint32_t        keySize = 0;
+    uint8_t         nonce [AES_GCM_SIV_NONCE_SIZE];
+    uint8_t         aData [MAX_TEST_DATA_SIZE];
+    uint32_t        aDataSize = 0;
+    uint8_t         plainText [MAX_TEST_DATA_SIZE];
+    uint32_t        plainTextSize = 0;
+    uint8_t         cipherText [MAX_TEST_DATA_SIZE];
+    uint8_t         tag [AES_GCM_SIV_TAG_SIZE];
+    uint8_t         output [MAX_TEST_DATA_SIZE];
+    uint8_t         outputTag [AES_GCM_SIV_TAG_SIZE];
+    uint32_t        i;
+
+    for( vectorIndex=0; vectorIndex<NUM_TEST_VECTORS; vectorIndex++ )
+    {
+        if( !HexToBytes( gTestVectors[vectorIndex].KeyHex,        key,        sizeof(key),        &keySize )
+         || !HexToBytes( gTestVectors[vectorIndex].NonceHex,      nonce,      sizeof(nonce),      NULL )
+         || !HexToBytes( gTestVectors[vectorIndex].ADataHex,      aData,      sizeof(aData),      &aDataSize )
+         || !HexToBytes( gTestVectors[vectorIndex].PlainTextHex,  plainText,  sizeof(plainText),  &plainTextSize )
+         || !HexToBytes( gTestVectors[vectorIndex].CipherTextHex, cipherText, sizeof(cipherText), NULL )
+         || !HexToBytes( gTestVectors[vectorIndex].TagHex,        tag,        sizeof(tag),        NULL ) )
+        {
+            printf( "Test vector (index:%u) has a hex string too large for its buffer\n", vectorIndex );
+            return false;
+        }
+
+        if(     0 != AesGcmSivEncryptWithKey( key, keySize, nonce, aData, aDataSize,
+                        plainText, output, plainTextSize, outputTag )
+            ||  0 != memcmp( output, cipherText, plainTextSize )
+            ||  0 != memcmp( outputTag, tag, sizeof(tag) ) )
+        {
+            printf( "Test vector (index:%u) failed\n", vectorIndex );
+            return false;
+        }
+
+        if(     0 != AesGcmSivDecryptWithKey( key, keySize, nonce, aData, aDataSize,
+                        cipherText, output, plainTextSize, tag )
+            ||  0 != memcmp( output, plainText, plainTextSize ) )
+        {
+            printf( "Test vector (index:%u) failed decrypt\n", vectorIndex );
+            return false;
+        }
+
+        // Corrupt the tag and verify decryption is refused and no plaintext is released.
+        tag[0] ^= 0x01;
+        if( 0 == AesGcmSivDecryptWithKey( key, keySize, nonce, aData, aDataSize,
+                     cipherText, output, plainTextSize, tag ) )
+        {
+            printf( "Test vector (index:%u) accepted a corrupted tag\n", vectorIndex );
+            return false;
+        }
+        for( i=0; i<plainTextSize; i++ )
+        {
+            if( 0 != output[i] )
+            {
+                printf( "Test vector (index:%u) released plaintext on failure\n", vectorIndex );
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestLongMessage
+//
+//  Tests a message long enough to use the four block aggregated POLYVAL, with lengths that are not multiples of the
+//  block size. Uses a zero 256 bit key, a zero nonce, 1000 bytes of additional data with byte n set to (n & 0xff),
+//  and 5000 bytes of plaintext with byte n set to ((n * 3) & 0xff). The expected tag was produced by the table
+//  driven POLYVAL, which does not use aggregation, and checked to match the carry-less multiply version.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestLongMessage
+    (
+        void
+    )
+{
+    uint8_t const   key [AES_KEY_SIZE_256] = {0};
+    uint8_t const   nonce [AES_GCM_SIV_NONCE_SIZE] = {0};
+    uint8_t const   expectedTag [AES_GCM_SIV_TAG_SIZE] =
+        { 0xfe, 0xa3, 0xea, 0xb0, 0x17, 0x7a, 0x05, 0x9d, 0xa8, 0xcd, 0x60, 0x5b, 0x40, 0x66, 0x21, 0x11 };
+    uint32_t const  aDataSize = 1000;
+    uint32_t const  size = 5000;
+    uint8_t*        aData = malloc( aDataSize );
+    uint8_t*        plainText = malloc( size );
+    uint8_t*        buffer = malloc( size );
+    uint8_t         tag [AES_GCM_SIV_TAG_SIZE];
+    uint32_t        i;
+    bool            success = true;
+
+    for( i=0; i<aDataSize; i++ )
+    {
+        aData[i] = (uint8_t)i;
+    }
+    for( i=0; i<size; i++ )
+    {
+        plainText[i] = (uint8_t)( i * 3 );
+    }
+
+    // Encrypt in place then decrypt in place
+    memcpy( buffer, plainText, size );
+    AesGcmSivEncryptWithKey( key, sizeof(key), nonce, aData, aDataSize, buffer, buffer, size, tag );
+    if( 0 != memcmp( tag, expectedTag, sizeof(tag) ) )
+    {
+        printf( "Long message test failed\n" );
+        success = false;
+    }
+
+    if(     0 != AesGcmSivDecryptWithKey( key, sizeof(key), nonce, aData, aDataSize, buffer, buffer, size, tag )
+        ||  0 != memcmp( buffer, plainText, size ) )
+    {
+        printf( "Long message test failed decrypt\n" );
+        success = false;
+    }
+
+    free( aData );
+    free( plainText );
+    free( buffer );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestInvalidParameters
+//
+//  Verifies that key sizes other than 128 and 256 bits are rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestInvalidParameters
+    (
+        void
+    )
+{
+    uint8_t const   key [AES_KEY_SIZE_256] = {0};
+    uint8_t const   nonce [AES_GCM_SIV_NONCE_SIZE] = {0};
+    uint8_t         buffer [16] = {0};
+    uint8_t         tag [AES_GCM_SIV_TAG_SIZE];
+    bool            success = true;
+
+    if(     0 == AesGcmSivEncryptWithKey( key, AES_KEY_SIZE_192, nonce, NULL, 0, buffer, buffer, sizeof(buffer), tag )
+        ||  0 == AesGcmSivEncryptWithKey( key, 17, nonce, NULL, 0, buffer, buffer, sizeof(buffer), tag ) )
+    {
+        printf( "AES GCM-SIV accepted invalid parameters\n" );
+        success = false;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestImplementations
+//
+//  Runs the vector and long message tests with each POLYVAL implementation available on this processor.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestImplementations
+    (
+        void
+    )
+{
+    uint32_t const  implementations [] = { AES_GCM_SIV_IMPLEMENTATION_PORTABLE, AES_GCM_SIV_IMPLEMENTATION_PCLMUL };
+    uint32_t        i;
+    bool            success = true;
+
+    for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+    {
+        if( 0 != AesGcmSivSetImplementation( implementations[i] ) )
+        {
+            // Not supported on this processor
+            continue;
+        }
+
+        if( !TestVectors( ) || !TestLongMessage( ) )
+        {
+            printf( "AES GCM-SIV - Implementation %u failed\n", implementations[i] );
+            success = false;
+        }
+    }
+
+    if( 0 != AesGcmSivSetImplementation( AES_GCM_SIV_IMPLEMENTATION_AUTO ) )
+    {
+        success = false;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestAesGcmSiv
+//
+//  Test AES GCM-SIV algorithm
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestAesGcmSiv
+    (
+        void
+    )
+{
+    bool        totalSuccess = true;
+    bool        success;
+
+    success = TestVectors( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestLongMessage( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestInvalidParameters( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestImplementations( );
+    if( !success ) { totalSuccess = false; }
+
+    return totalSuccess;
+}
@@ -0,0 +1,362 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_AesKeyWrap
+//
+//  Tests the cryptography functions against known test vectors to verify algorithms are correct.
+//  Tests the following:
+//     AES Key Wrap
+//     AES Key Wrap with Padding
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "WjCryptLib_AesKeyWrap.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_TEST_DATA_SIZE      48
+
+typedef struct
+{
+    char*           KekHex;
+    char*           KeyHex;
+    char*           WrappedHex;
+} TestVector;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Test vectors from RFC 3394 section 4.1, 4.3, and 4.6
+static TestVector gTestVectors [] =
+{
+    {
+        "000102030405060708090a0b0c0d0e0f",
+        "00112233445566778899aabbccddeeff",
+        "1fa68b0a8112b447aef34bd8fb5a7b829d3e862371d2cfe5"
+    },
+    {
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+        "00112233445566778899aabbccddeeff",
+        "64e8c3f9ce0f5ba263e9777905818a2a93c8191e7d6e8ae7"
+    },
+    {
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+        "00112233445566778899aabbccddeeff000102030405060708090a0b0c0d0e0f",
+        "28c9f404c4b810f4cbccb35cfb87f8263f5786e2d80ed326cbc7f0e71a99f43bfb988b9b7a02dd21"
+    },
+};
+
+// Test vectors from RFC 5649 section 6
+static TestVector gPaddedTestVectors [] =
+{
+    {
+        "5840df6e29b02af1ab493b705bf16ea1ae8338f4dcc176a8",
+        "c37b7e6492584340bed12207808941155068f738",
+        "138bdeaa9b8fa7fc61f97742e72248ee5ae6ae5360d1ae6a5f54f373fa543b6a"
+    },
+    {
+        "5840df6e29b02af1ab493b705bf16ea1ae8338f4dcc176a8",
+        "466f7250617369",
+        "afbeb0f07dfbf5419200f2ccb50bb24f"
+    },
+};
+
+#define NUM_TEST_VECTORS        ( sizeof(gTestVectors) / sizeof(gTestVectors[0]) )
+#define NUM_PADDED_TEST_VECTORS ( sizeof(gPaddedTestVectors) / sizeof(gPaddedTestVectors[0]) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HexToBytes
+//
+//  Reads a string as hex and places it in Data. The number of bytes represented in the input string must not exceed
+//  MaxDataSize, otherwise the function returns false without writing anything. On success *pDataSize is set to the
+//  number of bytes written.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    HexToBytes
+    (
+        char const*         HexString,              // [in]
+        uint8_t*            Data,                   // [out]
+        uint32_t            MaxDataSize,            // [in]
+        uint32_t*           pDataSize               // [out optional]
+    )
+{
+    uint32_t        i;
+    char            holdingBuffer [3] = {0};
+    unsigned        hexToNumber;
+    uint32_t        numBytes = (uint32_t)( strlen(HexString) / 2 );
+
+    if( numBytes > MaxDataSize )
+    {
+        return false;
+    }
+
+    for( i=0; i<numBytes; i++ )
+    {
+        holdingBuffer[0] = HexString[i*2 + 0];
+        holdingBuffer[1] = HexString[i*2 + 1];
+        sscanf( holdingBuffer, "%x", &hexToNumber );
+        Data[i] = (uint8_t) hexToNumber;
+    }
+
+    if( NULL != pDataSize )
+    {
+        *pDataSize = numBytes;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestVectors
+//
+//  Tests AES Key Wrap and AES Key Wrap with Padding against fixed test vectors. Each vector is wrapped, unwrapped,
+//  and unwrapped again after corrupting a byte, which must be rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestVectors
+    (
+        void
+    )
+{
+    uint32_t        vectorIndex;
+    bool            padded;
+    TestVector*     vector;
+    uint8_t         kek [AES_KEY_SIZE_256];
+    uint32_t        kekSize = 0;
+    uint8_t         key [MAX_TEST_DATA_SIZE];
+    uint32_t        keySize = 0;
+    uint8_t         wrapped [MAX_TEST_DATA_SIZE];
+    uint32_t        wrappedSize = 0;
+    uint8_t         output [MAX_TEST_DATA_SIZE];
+    uint32_t        outputSize;
+    AesContext      aes;
+    int             result;
+    uint32_t        i;
+
+    for( vectorIndex=0; vectorIndex<NUM_TEST_VECTORS+NUM_PADDED_TEST_VECTORS; vectorIndex++ )
+    {
+        padded = vectorIndex >= NUM_TEST_VECTORS;
+        vector = padded ? &gPaddedTestVectors[vectorIndex - NUM_TEST_VECTORS] : &gTestVectors[vectorIndex];
+
+        if( !HexToBytes( vector->KekHex,     kek,     sizeof(kek),     &kekSize )
+         || !HexToBytes( vector->KeyHex,     key,     sizeof(key),     &keySize )
+         || !HexToBytes( vector->WrappedHex, wrapped, sizeof(wrapped), &wrappedSize ) )
+        {
+            printf( "Test vector (index:%u) has a hex string too large for its buffer\n", vectorIndex );
+            return false;
+        }
+
+        AesInitialise( &aes, kek, kekSize );
+
+        result = padded
+            ? AesKeyWrapPadded( &aes, key, keySize, output )
+            : AesKeyWrap( &aes, key, keySize, output );
+        if( 0 != result || 0 != memcmp( output, wrapped, wrappedSize ) )
+        {
+            printf( "Test vector (index:%u) failed\n", vectorIndex );
+            return false;
+        }
+
+        outputSize = wrappedSize - AES_KEY_WRAP_OVERHEAD;
+        result = padded
+            ? AesKeyUnwrapPadded( &aes, wrapped, wrappedSize, output, &outputSize )
+            : AesKeyUnwrap( &aes, wrapped, wrappedSize, output );
+        if( 0 != result || outputSize != keySize || 0 != memcmp( output, key, keySize ) )
+        {
+            printf( "Test vector (index:%u) failed unwrap\n", vectorIndex );
+            return false;
+        }
+
+        // Corrupt the wrapped key and verify it is rejected and no key material is released.
+        wrapped[wrappedSize-1] ^= 0x01;
+        result = padded
+            ? AesKeyUnwrapPadded( &aes, wrapped, wrappedSize, output, &outputSize )
+            : AesKeyUnwrap( &aes, wrapped, wrappedSize, output );
+        if( 0 == result )
+        {
+            printf( "Test vector (index:%u) accepted a corrupted wrapped key\n", vectorIndex );
+            return false;
+        }
+        for( i=0; i<wrappedSize-AES_KEY_WRAP_OVERHEAD; i++ )
+        {
+            if( 0 != output[i] )
+            {
+                printf( "Test vector (index:%u) released key material on failure\n", vectorIndex );
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestBatch
+//
+//  Verifies the batch functions produce the same output as wrapping each key individually, using a number of keys
+//  that is not a multiple of the batch width. One wrapped key is then corrupted and must be the only key rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestBatch
+    (
+        void
+    )
+{
+    uint8_t const   kek [AES_KEY_SIZE_256] = {0};
+    uint32_t const  numKeys = 19;
+    uint32_t const  keySize = 32;
+    uint32_t const  wrappedKeySize = keySize + AES_KEY_WRAP_OVERHEAD;
+    uint8_t*        keys = malloc( numKeys * keySize );
+    uint8_t*        wrappedKeys = malloc( numKeys * wrappedKeySize );
+    uint8_t*        unwrappedKeys = malloc( numKeys * keySize );
+    uint8_t         wrapped [32 + AES_KEY_WRAP_OVERHEAD];
+    AesContext      aes;
+    uint32_t        i;
+    bool            success = true;
+
+    AesInitialise( &aes, kek, sizeof(kek) );
+    for( i=0; i<numKeys*keySize; i++ )
+    {
+        keys[i] = (uint8_t)( i * 7 );
+    }
+
+    AesKeyWrapBatch( &aes, keys, keySize, numKeys, wrappedKeys );
+    for( i=0; i<numKeys; i++ )
+    {
+        AesKeyWrap( &aes, keys + (i * keySize), keySize, wrapped );
+        if( 0 != memcmp( wrapped, wrappedKeys + (i * wrappedKeySize), wrappedKeySize ) )
+        {
+            printf( "Batch wrap (index:%u) differs from single wrap\n", i );
+            success = false;
+        }
+    }
+
+    if(     0 != AesKeyUnwrapBatch( &aes, wrappedKeys, wrappedKeySize, numKeys, unwrappedKeys )
+        ||  0 != memcmp( unwrappedKeys, keys, numKeys * keySize ) )
+    {
+        printf( "Batch unwrap failed\n" );
+        success = false;
+    }
+
+    wrappedKeys[(10 * wrappedKeySize) + 3] ^= 0x80;
+    if( 0 == AesKeyUnwrapBatch( &aes, wrappedKeys, wrappedKeySize, numKeys, unwrappedKeys ) )
+    {
+        printf( "Batch unwrap accepted a corrupted wrapped key\n" );
+        success = false;
+    }
+    for( i=0; i<numKeys; i++ )
+    {
+        if( 10 == i )
+        {
+            memset( wrapped, 0, keySize );
+            if( 0 != memcmp( unwrappedKeys + (i * keySize), wrapped, keySize ) )
+            {
+                printf( "Batch unwrap released key material on failure\n" );
+                success = false;
+            }
+        }
+        else if( 0 != memcmp( unwrappedKeys + (i * keySize), keys + (i * keySize), keySize ) )
+        {
+            printf( "Batch unwrap (index:%u) failed alongside a corrupted key\n", i );
+            success = false;
+        }
+    }
+
+    free( keys );
+    free( wrappedKeys );
+    free( unwrappedKeys );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestInvalidParameters
+//
+//  Verifies that sizes not allowed by RFC 3394 and RFC 5649 are rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestInvalidParameters
+    (
+        void
+    )
+{
+    uint8_t const   kek [AES_KEY_SIZE_128] = {0};
+    uint8_t         buffer [64] = {0};
+    uint8_t         output [64];
+    uint32_t        outputSize;
+    AesContext      aes;
+    bool            success = true;
+
+    AesInitialise( &aes, kek, sizeof(kek) );
+
+    if(     0 == AesKeyWrap( &aes, buffer, 8, output )
+        ||  0 == AesKeyWrap( &aes, buffer, 20, output )
+        ||  0 == AesKeyUnwrap( &aes, buffer, 16, output )
+        ||  0 == AesKeyUnwrap( &aes, buffer, 28, output )
+        ||  0 == AesKeyWrapPadded( &aes, buffer, 0, output )
+        ||  0 == AesKeyUnwrapPadded( &aes, buffer, 8, output, &outputSize )
+        ||  0 == AesKeyUnwrapPadded( &aes, buffer, 20, output, &outputSize ) )
+    {
+        printf( "AES Key Wrap accepted invalid parameters\n" );
+        success = false;
+    }
+
+    // A key wrapped without padding must not be accepted by the padded unwrap, whose initial value differs.
+    AesKeyWrap( &aes, buffer, 16, output );
+    memcpy( buffer, output, 24 );
+    if( 0 == AesKeyUnwrapPadded( &aes, buffer, 24, output, &outputSize ) )
+    {
+        printf( "AES Key Wrap with Padding accepted the RFC 3394 initial value\n" );
+        success = false;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestAesKeyWrap
+//
+//  Test AES Key Wrap algorithms
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestAesKeyWrap
+    (
+        void
+    )
+{
+    bool        totalSuccess = true;
+    bool        success;
+
+    success = TestVectors( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestBatch( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestInvalidParameters( );
+    if( !success ) { totalSuccess = false; }
+
+    return totalSuccess;
+}
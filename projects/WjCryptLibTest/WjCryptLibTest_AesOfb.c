@@ -312,6 +312,232 @@ bool
     return success;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCheckpoints
+//
+//  Tests recording a checkpoint table while encrypting, then using it to seek and to decrypt ranges of the stream.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestCheckpoints
+    (
+        void
+    )
+{
+    bool            success = true;
+    uint8_t const   key[AES_KEY_SIZE_128] = { 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 };
+    uint8_t const   iv[AES_OFB_IV_SIZE] = { 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 };
+    #define STREAMSIZE          1000
+    #define BLOCKS_PER_CP       4
+    #define MAX_CPS             10
+    uint8_t         stream [STREAMSIZE];
+    uint8_t         newStream [STREAMSIZE];
+    uint8_t         checkpoints [MAX_CPS * AES_OFB_CHECKPOINT_SIZE];
+    uint8_t         buffer [64];
+    AesContext      aes;
+    AesOfbContext   context;
+    uint32_t        offset;
+    uint32_t        numCheckpoints;
+    uint32_t        i;
+    uint32_t const  seekOffsets [] = { 0, 1, 15, 16, 63, 64, 65, 200, 639, 640, 700, 900, 999 };
+    uint32_t const  ranges [][2] = { {0,1000}, {0,64}, {5,59}, {63,2}, {100,500}, {640,360}, {700,300}, {999,1} };
+
+    // Reference stream generated in one go.
+    memset( stream, 0, STREAMSIZE );
+    AesOfbXorWithKey( key, sizeof(key), iv, stream, stream, STREAMSIZE );
+
+    // Generate the stream again in uneven chunks while recording. The table only has room for the first 10
+    // checkpoints (640 bytes of the 1000 byte stream).
+    AesOfbInitialiseWithKey( &context, key, sizeof(key), iv );
+    if( 0 != AesOfbSetCheckpointRecording( &context, BLOCKS_PER_CP, checkpoints, MAX_CPS ) )
+    {
+        printf( "AesOfbSetCheckpointRecording failed\n" );
+        return false;
+    }
+    for( offset=0; offset<STREAMSIZE; offset+=MIN( 37, STREAMSIZE-offset ) )
+    {
+        AesOfbOutput( &context, newStream+offset, MIN( 37, STREAMSIZE-offset ) );
+    }
+    numCheckpoints = AesOfbGetNumCheckpoints( &context );
+    if(     0 != memcmp( stream, newStream, STREAMSIZE )
+        ||  MAX_CPS != numCheckpoints )
+    {
+        printf( "AES OFB stream with checkpoint recording incorrect\n" );
+        success = false;
+    }
+    for( i=0; i<MAX_CPS; i++ )
+    {
+        uint8_t keyStreamBlock [AES_BLOCK_SIZE];
+        if( 0 == i )
+        {
+            // Checkpoint 0 is the first keystream block, which is the encrypted IV.
+            AesInitialise( &aes, key, sizeof(key) );
+            AesEncrypt( &aes, iv, keyStreamBlock );
+        }
+        else
+        {
+            memcpy( keyStreamBlock, stream + (i * BLOCKS_PER_CP * AES_BLOCK_SIZE), AES_BLOCK_SIZE );
+        }
+        if( 0 != memcmp( checkpoints + (i * AES_OFB_CHECKPOINT_SIZE), keyStreamBlock, AES_BLOCK_SIZE ) )
+        {
+            printf( "AES OFB checkpoint %u incorrect\n", i );
+            success = false;
+        }
+    }
+
+    // Seek to various positions (including past the last checkpoint) and compare. Seeks go both forwards and
+    // backwards on the same context.
+    for( i=0; i<sizeof(seekOffsets)/sizeof(seekOffsets[0]); i++ )
+    {
+        uint32_t direction;
+        for( direction=0; direction<2; direction++ )
+        {
+            uint32_t pos = ( 0 == direction ) ? seekOffsets[i] : STREAMSIZE - seekOffsets[i] - 1;
+            uint32_t size = MIN( sizeof(buffer), STREAMSIZE - pos );
+            if( 0 != AesOfbSetStreamIndexFromCheckpoints( &context, pos, checkpoints, numCheckpoints, BLOCKS_PER_CP ) )
+            {
+                printf( "AesOfbSetStreamIndexFromCheckpoints failed\n" );
+                return false;
+            }
+            AesOfbOutput( &context, buffer, size );
+            if( 0 != memcmp( buffer, stream + pos, size ) )
+            {
+                printf( "AES OFB seek to %u incorrect\n", pos );
+                success = false;
+            }
+        }
+    }
+
+    // Decrypt ranges without a context. As the stream is all zero plaintext the output is the keystream.
+    AesInitialise( &aes, key, sizeof(key) );
+    for( i=0; i<sizeof(ranges)/sizeof(ranges[0]); i++ )
+    {
+        memset( newStream, 0, STREAMSIZE );
+        if( 0 != AesOfbXorFromCheckpoints( &aes, checkpoints, numCheckpoints, BLOCKS_PER_CP, ranges[i][0],
+                    newStream, newStream, ranges[i][1] ) )
+        {
+            printf( "AesOfbXorFromCheckpoints failed\n" );
+            return false;
+        }
+        if( 0 != memcmp( newStream, stream + ranges[i][0], ranges[i][1] ) )
+        {
+            printf( "AES OFB XOR from checkpoints at %u incorrect\n", ranges[i][0] );
+            success = false;
+        }
+    }
+
+    // Invalid parameters
+    if(     -1 != AesOfbSetCheckpointRecording( &context, 0, checkpoints, MAX_CPS )
+        ||  -1 != AesOfbSetStreamIndexFromCheckpoints( &context, 0, checkpoints, 0, BLOCKS_PER_CP )
+        ||  -1 != AesOfbSetStreamIndexFromCheckpoints( &context, 0, checkpoints, numCheckpoints, 0 )
+        ||  -1 != AesOfbXorFromCheckpoints( &aes, checkpoints, 0, BLOCKS_PER_CP, 0, stream, newStream, 1 )
+        ||  -1 != AesOfbXorFromCheckpoints( &aes, checkpoints, numCheckpoints, 0, 0, stream, newStream, 1 ) )
+    {
+        printf( "AES OFB checkpoint functions accepted invalid parameters\n" );
+        success = false;
+    }
+
+    #undef STREAMSIZE
+    #undef BLOCKS_PER_CP
+    #undef MAX_CPS
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestMultipleStreams
+//
+//  Tests that AesOfbXorMultiple produces the same output as AesOfbXor on each stream. The streams have different keys
+//  and are at different positions within their current block.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestMultipleStreams
+    (
+        void
+    )
+{
+    bool            success = true;
+    #define NUM_STREAMS     19
+    #define STREAMSIZE      300
+    uint8_t         key [AES_KEY_SIZE_256];
+    uint8_t         iv [AES_OFB_IV_SIZE];
+    AesOfbContext   contexts [NUM_STREAMS];
+    AesOfbContext   singleContexts [NUM_STREAMS];
+    AesOfbContext*  contextPointers [NUM_STREAMS];
+    uint8_t         inputs [NUM_STREAMS][STREAMSIZE];
+    uint8_t         outputs [NUM_STREAMS][STREAMSIZE];
+    uint8_t         expected [STREAMSIZE];
+    void const*     inPointers [NUM_STREAMS];
+    void*           outPointers [NUM_STREAMS];
+    uint32_t const  sizes [] = { 0, 1, 15, 16, 17, 100, 5, 32 };
+    uint32_t        stream;
+    uint32_t        i;
+    uint32_t        offset;
+
+    for( stream=0; stream<NUM_STREAMS; stream++ )
+    {
+        for( i=0; i<sizeof(key); i++ ) { key[i] = (uint8_t)( stream * 7 + i ); }
+        for( i=0; i<sizeof(iv); i++ ) { iv[i] = (uint8_t)( stream * 3 + i * 5 ); }
+        for( i=0; i<STREAMSIZE; i++ ) { inputs[stream][i] = (uint8_t)( stream + i ); }
+
+        // Alternate key sizes and start each stream at a different position.
+        AesOfbInitialiseWithKey( &contexts[stream], key, ( stream & 1 ) ? AES_KEY_SIZE_256 : AES_KEY_SIZE_128, iv );
+        AesOfbOutput( &contexts[stream], expected, stream );
+        singleContexts[stream] = contexts[stream];
+
+        contextPointers[stream] = &contexts[stream];
+        inPointers[stream] = inputs[stream];
+        outPointers[stream] = outputs[stream];
+    }
+
+    // Process the streams in several steps, covering all the partial and whole block cases.
+    offset = 0;
+    for( i=0; i<sizeof(sizes)/sizeof(sizes[0]) && success; i++ )
+    {
+        AesOfbXorMultiple( contextPointers, inPointers, outPointers, NUM_STREAMS, sizes[i] );
+
+        for( stream=0; stream<NUM_STREAMS; stream++ )
+        {
+            AesOfbXor( &singleContexts[stream], inputs[stream] + offset, expected, sizes[i] );
+            if( 0 != memcmp( expected, outputs[stream], sizes[i] ) )
+            {
+                printf( "AesOfbXorMultiple stream %u differs from AesOfbXor\n", stream );
+                success = false;
+                break;
+            }
+            inPointers[stream] = inputs[stream] + offset + sizes[i];
+        }
+        offset += sizes[i];
+    }
+
+    // A single stream and an uneven number of streams.
+    if( success )
+    {
+        AesOfbXorMultiple( contextPointers, inPointers, outPointers, 1, 40 );
+        AesOfbXor( &singleContexts[0], inPointers[0], expected, 40 );
+        AesOfbXorMultiple( contextPointers + 1, inPointers + 1, outPointers + 1, 11, 40 );
+        for( stream=0; stream<12; stream++ )
+        {
+            if( stream > 0 )
+            {
+                AesOfbXor( &singleContexts[stream], inPointers[stream], expected, 40 );
+            }
+            if( 0 != memcmp( expected, outputs[stream], 40 ) )
+            {
+                printf( "AesOfbXorMultiple stream %u differs from AesOfbXor\n", stream );
+                success = false;
+                break;
+            }
+        }
+    }
+
+    #undef NUM_STREAMS
+    #undef STREAMSIZE
+
+    return success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -339,5 +565,11 @@ bool
     success = TestStreamConsistency( );
     if( !success ) { totalSuccess = false; }
 
+    success = TestCheckpoints( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestMultipleStreams( );
+    if( !success ) { totalSuccess = false; }
+
     return totalSuccess;
 }
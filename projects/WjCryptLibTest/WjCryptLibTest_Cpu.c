@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_Cpu
+//
+//  Tests the processor feature detection and the overrides that force the portable implementations.
+//  Tests the following:
+//     CPU feature detection
+//     CPU brand string
+//     CPU instruction set level
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "WjCryptLib_Cpu.h"
+#include "WjCryptLib_Md5.h"
+#include "WjCryptLib_Sha1.h"
+#include "WjCryptLib_Sha512.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestFeatures
+//
+//  Tests that every feature has a name, that the usable features are the detected ones less the disabled ones (and
+//  less AVX-512F without AVX2), and that WJCRYPTLIB_CPU_DISABLE=all (as set by the portable run of the tests) disables
+//  everything.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestFeatures
+    (
+        void
+    )
+{
+    bool            success = true;
+    uint32_t        feature;
+    uint32_t        expected;
+    char const*     environment;
+
+    for( feature=1; 0 != (feature & CPU_FEATURE_ALL); feature<<=1 )
+    {
+        if( NULL == CpuGetFeatureName( feature ) )
+        {
+            printf( "CPU feature 0x%x has no name\n", feature );
+            success = false;
+        }
+    }
+    if( NULL != CpuGetFeatureName( 0 ) || NULL != CpuGetFeatureName( CPU_FEATURE_SSE2 | CPU_FEATURE_AVX2 ) )
+    {
+        printf( "CPU feature name returned for a value that is not a single feature\n" );
+        success = false;
+    }
+
+    expected = CpuGetDetectedFeatures( ) & ~CpuGetDisabledFeatures( );
+    if( 0 == (expected & CPU_FEATURE_AVX2) )
+    {
+        expected &= ~CPU_FEATURE_AVX512F;
+    }
+    if( CpuGetFeatures( ) != expected )
+    {
+        printf( "CPU features are not the detected features less the disabled ones\n" );
+        success = false;
+    }
+
+    environment = getenv( CPU_DISABLE_ENVIRONMENT_VARIABLE );
+    if( NULL != environment && 0 == strcmp( environment, "all" ) && CPU_FEATURE_ALL != CpuGetDisabledFeatures( ) )
+    {
+        printf( "CPU features not disabled by %s=all\n", CPU_DISABLE_ENVIRONMENT_VARIABLE );
+        success = false;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestDisable
+//
+//  Tests that disabling features makes the implementations that use them unavailable, and that enabling them again
+//  makes them available if the processor supports them. The original setting is restored afterwards.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestDisable
+    (
+        void
+    )
+{
+    bool            success = true;
+    uint32_t        originalDisabled = CpuGetDisabledFeatures( );
+    uint32_t        detected = CpuGetDetectedFeatures( );
+    bool            hasShaNi;
+
+    // Everything disabled: only the portable implementations are available
+    CpuSetDisabledFeatures( CPU_FEATURE_ALL );
+    if(     0 != CpuGetFeatures( )
+        ||  0 == Md5SetImplementation( MD5_IMPLEMENTATION_SSE2 )
+        ||  0 == Md5SetImplementation( MD5_IMPLEMENTATION_AVX2 )
+        ||  0 == Sha1SetImplementation( SHA1_IMPLEMENTATION_SHANI )
+        ||  0 == Sha512SetImplementation( SHA512_IMPLEMENTATION_AVX2 )
+        ||  0 != Md5SetImplementation( MD5_IMPLEMENTATION_AUTO )
+        ||  0 != Sha1SetImplementation( SHA1_IMPLEMENTATION_AUTO )
+        ||  0 != Sha512SetImplementation( SHA512_IMPLEMENTATION_AUTO ) )
+    {
+        printf( "CPU features all disabled but an accelerated implementation was available\n" );
+        success = false;
+    }
+
+    // Nothing disabled: the implementations are available when the processor supports them
+    CpuSetDisabledFeatures( 0 );
+    hasShaNi = ( CPU_FEATURE_SHA | CPU_FEATURE_SSSE3 | CPU_FEATURE_SSE41 )
+            == ( detected & ( CPU_FEATURE_SHA | CPU_FEATURE_SSSE3 | CPU_FEATURE_SSE41 ) );
+    if(     detected != CpuGetFeatures( )
+        ||  ( 0 != (detected & CPU_FEATURE_SSE2) ) != ( 0 == Md5SetImplementation( MD5_IMPLEMENTATION_SSE2 ) )
+        ||  hasShaNi != ( 0 == Sha1SetImplementation( SHA1_IMPLEMENTATION_SHANI ) )
+        ||  ( 0 != (detected & CPU_FEATURE_AVX2) ) != ( 0 == Sha512SetImplementation( SHA512_IMPLEMENTATION_AVX2 ) ) )
+    {
+        printf( "CPU features enabled but an implementation did not match the detected features\n" );
+        success = false;
+    }
+
+    // One feature disabled affects only the implementations that use it, and AVX-512 which depends on AVX2
+    CpuSetDisabledFeatures( CPU_FEATURE_AVX2 );
+    if(     0 != (CpuGetFeatures( ) & CPU_FEATURE_AVX512F)
+        ||  0 == Md5SetImplementation( MD5_IMPLEMENTATION_AVX2 )
+        ||  0 == Sha512SetImplementation( SHA512_IMPLEMENTATION_AVX512 )
+        ||  0 != Sha512SetImplementation( SHA512_IMPLEMENTATION_AUTO )
+        ||  ( 0 != (detected & CPU_FEATURE_SSE2) ) != ( 0 == Md5SetImplementation( MD5_IMPLEMENTATION_SSE2 ) ) )
+    {
+        printf( "CPU feature AVX2 disabled but the implementations available were wrong\n" );
+        success = false;
+    }
+
+    CpuSetDisabledFeatures( originalDisabled );
+    Md5SetImplementation( MD5_IMPLEMENTATION_AUTO );
+    Sha1SetImplementation( SHA1_IMPLEMENTATION_AUTO );
+    Sha512SetImplementation( SHA512_IMPLEMENTATION_AUTO );
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestBrand
+//
+//  Tests that the brand string is terminated, not empty, and does not start with a space.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestBrand
+    (
+        void
+    )
+{
+    char        brand [CPU_BRAND_SIZE + 1];
+
+    memset( brand, 'x', sizeof(brand) );
+    CpuGetBrand( brand );
+    if( 'x' != brand[CPU_BRAND_SIZE] || 0 == brand[0] || ' ' == brand[0] )
+    {
+        printf( "CPU brand string invalid\n" );
+        return false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestIsaLevel
+//
+//  Tests that the instruction set level follows the usable features, so that disabling a feature also stops the
+//  instruction set variants that need it being used. The original setting is restored afterwards.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestIsaLevel
+    (
+        void
+    )
+{
+    bool            success = true;
+    uint32_t        originalDisabled = CpuGetDisabledFeatures( );
+    uint32_t        detected = CpuGetDetectedFeatures( );
+    uint32_t        expected = CPU_ISA_BASELINE;
+
+    if( (CPU_FEATURE_AVX2 | CPU_FEATURE_BMI2) == (detected & (CPU_FEATURE_AVX2 | CPU_FEATURE_BMI2)) )
+    {
+        expected = ( 0 != (detected & CPU_FEATURE_AVX512F) ) ? CPU_ISA_AVX512 : CPU_ISA_AVX2;
+    }
+
+    CpuSetDisabledFeatures( 0 );
+    if( expected != CpuGetIsaLevel( ) )
+    {
+        printf( "CPU instruction set level %u does not match the detected features\n", CpuGetIsaLevel( ) );
+        success = false;
+    }
+
+    CpuSetDisabledFeatures( CPU_FEATURE_AVX512F );
+    if( ( expected > CPU_ISA_AVX2 ? CPU_ISA_AVX2 : expected ) != CpuGetIsaLevel( ) )
+    {
+        printf( "CPU feature AVX-512F disabled but the instruction set level was wrong\n" );
+        success = false;
+    }
+
+    CpuSetDisabledFeatures( CPU_FEATURE_BMI2 );
+    if( CPU_ISA_BASELINE != CpuGetIsaLevel( ) )
+    {
+        printf( "CPU feature BMI2 disabled but the instruction set level was not the baseline\n" );
+        success = false;
+    }
+
+    CpuSetDisabledFeatures( originalDisabled );
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCpu
+//
+//  Test CPU feature detection
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestCpu
+    (
+        void
+    )
+{
+    bool        totalSuccess = true;
+    bool        success;
+
+    success = TestFeatures( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestDisable( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestBrand( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestIsaLevel( );
+    if( !success ) { totalSuccess = false; }
+
+    return totalSuccess;
+}
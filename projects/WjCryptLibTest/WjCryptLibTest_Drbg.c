@@ -0,0 +1,590 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_Drbg
+//
+//  Tests the cryptography functions against known test vectors to verify algorithms are correct.
+//  Tests the following:
+//     AES CTR_DRBG
+//     HMAC_DRBG (HMAC-SHA256)
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "WjCryptLib_AesCtrDrbg.h"
+#include "WjCryptLib_HmacDrbg.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_TEST_DATA_SIZE      64
+
+// Each vector is instantiated, reseeded if ReseedEntropyHex is not empty, and then two requests are generated. The
+// output of the second request is compared.
+typedef struct
+{
+    uint32_t        KeySize;                // AES key size, unused for HMAC_DRBG
+    char*           EntropyHex;
+    char*           NonceHex;
+    char*           PersonalisationHex;
+    char*           ReseedEntropyHex;
+    char*           ReseedInputHex;
+    char*           Additional1Hex;
+    char*           Additional2Hex;
+    char*           OutputHex;
+} TestVector;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// CTR_DRBG with the derivation function. Known answers from the OpenSSL 3.0 CTR-DRBG.
+static TestVector gCtrDrbgTestVectors [] =
+{
+    // AES-128, no reseed or additional input
+    {
+        AES_KEY_SIZE_128,
+        "1f262d343b424950585f666d747b8289",
+        "3e454c535a61686f777e858c939aa1a8",
+        "5d646b727980878e969da4abb2b9c0c7cfd6dde4ebf2f900080f161d242b3239",
+        "",
+        "",
+        "",
+        "",
+        "ca36e512d29175d482f36e32cd8617b94c285c8766d29dc95e00e73af19e52a9db5f6b9b23e8ca30e100720f87196b41"
+        "a8d86a895c5f46474d324e21b89ba829"
+    },
+    // AES-192, reseed and additional input
+    {
+        AES_KEY_SIZE_192,
+        "9ba2a9b0b7bec5ccd4dbe2e9f0f7fe050d141b222930373e",
+        "bac1c8cfd6dde4ebf3fa01080f161d24",
+        "d9e0e7eef5fc030a121920272e353c434b525960676e757c848b9299a0a7aeb5",
+        "363d444b525960676f767d848b9299a0a8afb6bdc4cbd2d9",
+        "555c636a71787f868e959ca3aab1b8bfc7ced5dce3eaf1f800070e151c232a31",
+        "f8ff060d141b222931383f464d545b626a71787f868d949ba3aab1b8bfc6cdd4",
+        "171e252c333a414850575e656c737a818990979ea5acb3bac2c9d0d7dee5ecf3",
+        "02de3cef165cb8cedfcff20e33c93fbd7af25cda01544a09bf22b6b8e493fa275cd8cab80ae3c53f4c173adc4461ef46"
+        "363922d1b5a2545d3a445f2e527818b3"
+    },
+    // AES-256, additional input, output not a whole number of blocks
+    {
+        AES_KEY_SIZE_256,
+        "171e252c333a414850575e656c737a818990979ea5acb3bac2c9d0d7dee5ecf3",
+        "363d444b525960676f767d848b9299a0",
+        "555c636a71787f868e959ca3aab1b8bfc7ced5dce3eaf1f800070e151c232a31",
+        "",
+        "",
+        "747b828990979ea5adb4bbc2c9d0d7dee6edf4fb020910171f262d343b424950",
+        "939aa1a8afb6bdc4ccd3dae1e8eff6fd050c131a21282f363e454c535a61686f",
+        "0b09e58f5f59a06ad842345cceda3f7fa045a8dc6779881d8c552e9023255e188852815f98"
+    },
+    // AES-256, reseed
+    {
+        AES_KEY_SIZE_256,
+        "5d646b727980878e969da4abb2b9c0c7cfd6dde4ebf2f900080f161d242b3239",
+        "7c838a91989fa6adb5bcc3cad1d8dfe6",
+        "9ba2a9b0b7bec5ccd4dbe2e9f0f7fe050d141b222930373e464d545b62697077",
+        "f8ff060d141b222931383f464d545b626a71787f868d949ba3aab1b8bfc6cdd4",
+        "",
+        "",
+        "",
+        "264fccc27009a8ef1b99eed65ae38d1a14b2e11ffa948df5d4c6f404dd1be346dbe1a7e6c6c8928338c921a3528bee06"
+        "61780114529f80fe8617082e18cb5a52"
+    },
+};
+
+// HMAC_DRBG with SHA256. Known answers from the OpenSSL 3.0 HMAC-DRBG.
+static TestVector gHmacDrbgTestVectors [] =
+{
+    // No reseed or additional input
+    {
+        0,
+        "1f262d343b424950585f666d747b828991989fa6adb4bbc2cad1d8dfe6edf4fb",
+        "3e454c535a61686f777e858c939aa1a8",
+        "5d646b727980878e969da4abb2b9c0c7cfd6dde4ebf2f900080f161d242b3239",
+        "",
+        "",
+        "",
+        "",
+        "a6435a072e6b1161a2de7110f593ea70ca4844202b9b921592427630e127e2a6f575b6c37f369280a780cdfa401732bf"
+        "036e95996bb65de594bf945859470613"
+    },
+    // Reseed and additional input
+    {
+        0,
+        "9ba2a9b0b7bec5ccd4dbe2e9f0f7fe050d141b222930373e464d545b62697077",
+        "bac1c8cfd6dde4ebf3fa01080f161d24",
+        "d9e0e7eef5fc030a121920272e353c434b525960676e757c848b9299a0a7aeb5",
+        "363d444b525960676f767d848b9299a0a8afb6bdc4cbd2d9e1e8eff6fd040b12",
+        "555c636a71787f868e959ca3aab1b8bfc7ced5dce3eaf1f800070e151c232a31",
+        "f8ff060d141b222931383f464d545b626a71787f868d949ba3aab1b8bfc6cdd4",
+        "171e252c333a414850575e656c737a818990979ea5acb3bac2c9d0d7dee5ecf3",
+        "4b6571fd0a9c208df8bc5486d910bb3f54bd83b28f44a21aaabfc5ab5ce99cc73a97063367dd33b6d4e703ee02658711"
+        "a2321012da23fdf86c5af667b88a312f"
+    },
+    // Additional input, output not a whole number of blocks
+    {
+        0,
+        "171e252c333a414850575e656c737a818990979ea5acb3bac2c9d0d7dee5ecf3",
+        "363d444b525960676f767d848b9299a0",
+        "555c636a71787f868e959ca3aab1b8bfc7ced5dce3eaf1f800070e151c232a31",
+        "",
+        "",
+        "747b828990979ea5adb4bbc2c9d0d7dee6edf4fb020910171f262d343b424950",
+        "939aa1a8afb6bdc4ccd3dae1e8eff6fd050c131a21282f363e454c535a61686f",
+        "570f58a93fd415fee9255df665aecdd289d2d1f92a1a3f45fe7b96224a1857e12b5ae420c4"
+    },
+};
+
+#define NUM_CTR_DRBG_TEST_VECTORS   ( sizeof(gCtrDrbgTestVectors) / sizeof(gCtrDrbgTestVectors[0]) )
+#define NUM_HMAC_DRBG_TEST_VECTORS  ( sizeof(gHmacDrbgTestVectors) / sizeof(gHmacDrbgTestVectors[0]) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HexToBytes
+//
+//  Reads a string as hex and places it in Data. The number of bytes represented in the input string must not exceed
+//  MaxDataSize, otherwise the function returns false without writing anything. On success *pDataSize is set to the
+//  number of bytes written.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    HexToBytes
+    (
+        char const*         HexString,              // [in]
+        uint8_t*            Data,                   // [out]
+        uint32_t            MaxDataSize,            // [in]
+        uint32_t*           pDataSize               // [out optional]
+    )
+{
+    uint32_t        i;
+    char            holdingBuffer [3] = {0};
+    unsigned        hexToNumber;
+    uint32_t        numBytes = (uint32_t)( strlen(HexString) / 2 );
+
+    if( numBytes > MaxDataSize )
+    {
+        return false;
+    }
+
+    for( i=0; i<numBytes; i++ )
+    {
+        holdingBuffer[0] = HexString[i*2 + 0];
+        holdingBuffer[1] = HexString[i*2 + 1];
+        sscanf( holdingBuffer, "%x", &hexToNumber );
+        Data[i] = (uint8_t) hexToNumber;
+    }
+
+    if( NULL != pDataSize )
+    {
+        *pDataSize = numBytes;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestVectors
+//
+//  Tests CTR_DRBG and HMAC_DRBG against fixed test vectors.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestVectors
+    (
+        void
+    )
+{
+    uint32_t            vectorIndex;
+    bool                hmac;
+    TestVector*         vector;
+    uint8_t             entropy [MAX_TEST_DATA_SIZE];
+    uint32_t            entropySize = 0;
+    uint8_t             nonce [MAX_TEST_DATA_SIZE];
+    uint32_t            nonceSize = 0;
+    uint8_t             personalisation [MAX_TEST_DATA_SIZE];
+    uint32_t            personalisationSize = 0;
+    uint8_t             reseedEntropy [MAX_TEST_DATA_SIZE];
+    uint32_t            reseedEntropySize = 0;
+    uint8_t             reseedInput [MAX_TEST_DATA_SIZE];
+    uint32_t            reseedInputSize = 0;
+    uint8_t             additional1 [MAX_TEST_DATA_SIZE];
+    uint32_t            additional1Size = 0;
+    uint8_t             additional2 [MAX_TEST_DATA_SIZE];
+    uint32_t            additional2Size = 0;
+    uint8_t             expected [MAX_TEST_DATA_SIZE];
+    uint32_t            expectedSize = 0;
+    uint8_t             output [MAX_TEST_DATA_SIZE];
+    AesCtrDrbgContext   ctrDrbg;
+    HmacDrbgContext     hmacDrbg;
+    int                 result;
+
+    for( vectorIndex=0; vectorIndex<NUM_CTR_DRBG_TEST_VECTORS+NUM_HMAC_DRBG_TEST_VECTORS; vectorIndex++ )
+    {
+        hmac = vectorIndex >= NUM_CTR_DRBG_TEST_VECTORS;
+        vector = hmac
+            ? &gHmacDrbgTestVectors[vectorIndex - NUM_CTR_DRBG_TEST_VECTORS]
+            : &gCtrDrbgTestVectors[vectorIndex];
+
+        if( !HexToBytes( vector->EntropyHex,         entropy,         sizeof(entropy),         &entropySize )
+         || !HexToBytes( vector->NonceHex,           nonce,           sizeof(nonce),           &nonceSize )
+         || !HexToBytes( vector->PersonalisationHex, personalisation, sizeof(personalisation), &personalisationSize )
+         || !HexToBytes( vector->ReseedEntropyHex,   reseedEntropy,   sizeof(reseedEntropy),   &reseedEntropySize )
+         || !HexToBytes( vector->ReseedInputHex,     reseedInput,     sizeof(reseedInput),     &reseedInputSize )
+         || !HexToBytes( vector->Additional1Hex,     additional1,     sizeof(additional1),     &additional1Size )
+         || !HexToBytes( vector->Additional2Hex,     additional2,     sizeof(additional2),     &additional2Size )
+         || !HexToBytes( vector->OutputHex,          expected,        sizeof(expected),        &expectedSize ) )
+        {
+            printf( "Test vector (index:%u) has a hex string too large for its buffer\n", vectorIndex );
+            return false;
+        }
+
+        if( hmac )
+        {
+            result = HmacDrbgInitialise( &hmacDrbg, entropy, entropySize, nonce, nonceSize,
+                personalisation, personalisationSize );
+            if( 0 == result && reseedEntropySize > 0 )
+            {
+                result = HmacDrbgReseed( &hmacDrbg, reseedEntropy, reseedEntropySize,
+                    reseedInput, reseedInputSize );
+            }
+            result |= HmacDrbgGenerate( &hmacDrbg, additional1, additional1Size, output, expectedSize );
+            result |= HmacDrbgGenerate( &hmacDrbg, additional2, additional2Size, output, expectedSize );
+            HmacDrbgUninitialise( &hmacDrbg );
+        }
+        else
+        {
+            result = AesCtrDrbgInitialise( &ctrDrbg, vector->KeySize, entropy, entropySize, nonce, nonceSize,
+                personalisation, personalisationSize );
+            if( 0 == result && reseedEntropySize > 0 )
+            {
+                result = AesCtrDrbgReseed( &ctrDrbg, reseedEntropy, reseedEntropySize,
+                    reseedInput, reseedInputSize );
+            }
+            result |= AesCtrDrbgGenerate( &ctrDrbg, additional1, additional1Size, output, expectedSize );
+            result |= AesCtrDrbgGenerate( &ctrDrbg, additional2, additional2Size, output, expectedSize );
+            AesCtrDrbgUninitialise( &ctrDrbg );
+        }
+
+        if( 0 != result || 0 != memcmp( output, expected, expectedSize ) )
+        {
+            printf( "Test vector (index:%u) failed\n", vectorIndex );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestAesCtrDrbgOutputBuffer
+//
+//  Verifies that small requests served from the output buffer give the same bytes as generating the whole buffer
+//  size at a time, that served bytes are wiped from the buffer, and that a large request with the buffer empty is
+//  generated directly as a single request.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestAesCtrDrbgOutputBuffer
+    (
+        void
+    )
+{
+    uint32_t const      bufferSize = 100;
+    uint32_t const      streamSize = 10 * 100;
+    uint32_t const      largeSize = 300;
+    uint8_t             entropy [32];
+    uint8_t             outputBuffer [100];
+    uint8_t             expected [10 * 100];
+    uint8_t             output [300];
+    AesCtrDrbgContext   buffered;
+    AesCtrDrbgContext   direct;
+    uint32_t            offset;
+    uint32_t            n;
+    uint32_t            i;
+    bool                success = true;
+
+    for( i=0; i<sizeof(entropy); i++ )
+    {
+        entropy[i] = (uint8_t)( i * 5 );
+    }
+    AesCtrDrbgInitialise( &buffered, AES_KEY_SIZE_256, entropy, sizeof(entropy), NULL, 0, NULL, 0 );
+    AesCtrDrbgInitialise( &direct, AES_KEY_SIZE_256, entropy, sizeof(entropy), NULL, 0, NULL, 0 );
+    AesCtrDrbgSetOutputBuffer( &buffered, outputBuffer, bufferSize );
+
+    for( offset=0; offset<streamSize; offset+=bufferSize )
+    {
+        AesCtrDrbgGenerate( &direct, NULL, 0, expected + offset, bufferSize );
+    }
+
+    for( offset=0, i=0; offset<streamSize && success; offset+=n, i++ )
+    {
+        n = ( i % 7 ) + 1;
+        n = ( n < streamSize - offset ) ? n : streamSize - offset;
+        if(     0 != AesCtrDrbgRandom( &buffered, output, n )
+            ||  0 != memcmp( output, expected + offset, n ) )
+        {
+            printf( "CTR_DRBG buffered output (offset:%u) differs from generated output\n", offset );
+            success = false;
+        }
+    }
+
+    for( i=0; i<bufferSize; i++ )
+    {
+        if( 0 != outputBuffer[i] )
+        {
+            printf( "CTR_DRBG output buffer not wiped after use\n" );
+            success = false;
+            break;
+        }
+    }
+
+    AesCtrDrbgGenerate( &direct, NULL, 0, expected, largeSize );
+    if(     0 != AesCtrDrbgRandom( &buffered, output, largeSize )
+        ||  0 != memcmp( output, expected, largeSize )
+        ||  buffered.ReseedCounter != direct.ReseedCounter )
+    {
+        printf( "CTR_DRBG large buffered request differs from generated output\n" );
+        success = false;
+    }
+
+    AesCtrDrbgUninitialise( &buffered );
+    AesCtrDrbgUninitialise( &direct );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestAesCtrDrbgLimits
+//
+//  Verifies the reseed interval is enforced with and without an output buffer, and that invalid parameters are
+//  rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestAesCtrDrbgLimits
+    (
+        void
+    )
+{
+    uint8_t const       entropy [32] = {0};
+    uint8_t             outputBuffer [64];
+    uint8_t             output [64];
+    AesCtrDrbgContext   context;
+    bool                success = true;
+
+    if(     -1 != AesCtrDrbgInitialise( &context, 20, entropy, sizeof(entropy), NULL, 0, NULL, 0 )
+        ||  -1 != AesCtrDrbgInitialise( &context, AES_KEY_SIZE_256, entropy, AES_KEY_SIZE_256 - 1, NULL, 0, NULL, 0 )
+        ||   0 != AesCtrDrbgInitialise( &context, AES_KEY_SIZE_256, entropy, sizeof(entropy), NULL, 0, NULL, 0 )
+        ||  -1 != AesCtrDrbgReseed( &context, entropy, AES_KEY_SIZE_256 - 1, NULL, 0 )
+        ||  -1 != AesCtrDrbgGenerate( &context, NULL, 0, NULL, AES_CTR_DRBG_MAX_REQUEST_SIZE + 1 )
+        ||  -1 != AesCtrDrbgSetReseedInterval( &context, 0 )
+        ||  -1 != AesCtrDrbgSetReseedInterval( &context, AES_CTR_DRBG_MAX_RESEED_INTERVAL + 1 )
+        ||  -1 != AesCtrDrbgSetOutputBuffer( &context, outputBuffer, 0 )
+        ||  -1 != AesCtrDrbgSetOutputBuffer( &context, outputBuffer, AES_CTR_DRBG_MAX_REQUEST_SIZE + 1 ) )
+    {
+        printf( "CTR_DRBG accepted invalid parameters\n" );
+        success = false;
+    }
+
+    AesCtrDrbgSetReseedInterval( &context, 3 );
+    if(      0 != AesCtrDrbgGenerate( &context, NULL, 0, output, sizeof(output) )
+        ||   0 != AesCtrDrbgGenerate( &context, NULL, 0, output, sizeof(output) )
+        ||   0 != AesCtrDrbgGenerate( &context, NULL, 0, output, sizeof(output) )
+        ||  -1 != AesCtrDrbgGenerate( &context, NULL, 0, output, sizeof(output) ) )
+    {
+        printf( "CTR_DRBG reseed interval not enforced\n" );
+        success = false;
+    }
+
+    AesCtrDrbgSetOutputBuffer( &context, outputBuffer, sizeof(outputBuffer) );
+    if(     -1 != AesCtrDrbgRandom( &context, output, 1 )
+        ||   0 != AesCtrDrbgReseed( &context, entropy, sizeof(entropy), NULL, 0 )
+        ||   0 != AesCtrDrbgRandom( &context, output, 1 ) )
+    {
+        printf( "CTR_DRBG reseed interval not enforced with an output buffer\n" );
+        success = false;
+    }
+
+    AesCtrDrbgUninitialise( &context );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestHmacDrbgOutputBuffer
+//
+//  Verifies that small requests served from the output buffer give the same bytes as generating the whole buffer
+//  size at a time, that served bytes are wiped from the buffer, and that a large request with the buffer empty is
+//  generated directly as a single request.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestHmacDrbgOutputBuffer
+    (
+        void
+    )
+{
+    uint32_t const      bufferSize = 100;
+    uint32_t const      streamSize = 10 * 100;
+    uint32_t const      largeSize = 300;
+    uint8_t             entropy [32];
+    uint8_t             outputBuffer [100];
+    uint8_t             expected [10 * 100];
+    uint8_t             output [300];
+    HmacDrbgContext     buffered;
+    HmacDrbgContext     direct;
+    uint32_t            offset;
+    uint32_t            n;
+    uint32_t            i;
+    bool                success = true;
+
+    for( i=0; i<sizeof(entropy); i++ )
+    {
+        entropy[i] = (uint8_t)( i * 5 );
+    }
+    HmacDrbgInitialise( &buffered, entropy, sizeof(entropy), NULL, 0, NULL, 0 );
+    HmacDrbgInitialise( &direct, entropy, sizeof(entropy), NULL, 0, NULL, 0 );
+    HmacDrbgSetOutputBuffer( &buffered, outputBuffer, bufferSize );
+
+    for( offset=0; offset<streamSize; offset+=bufferSize )
+    {
+        HmacDrbgGenerate( &direct, NULL, 0, expected + offset, bufferSize );
+    }
+
+    for( offset=0, i=0; offset<streamSize && success; offset+=n, i++ )
+    {
+        n = ( i % 7 ) + 1;
+        n = ( n < streamSize - offset ) ? n : streamSize - offset;
+        if(     0 != HmacDrbgRandom( &buffered, output, n )
+            ||  0 != memcmp( output, expected + offset, n ) )
+        {
+            printf( "HMAC_DRBG buffered output (offset:%u) differs from generated output\n", offset );
+            success = false;
+        }
+    }
+
+    for( i=0; i<bufferSize; i++ )
+    {
+        if( 0 != outputBuffer[i] )
+        {
+            printf( "HMAC_DRBG output buffer not wiped after use\n" );
+            success = false;
+            break;
+        }
+    }
+
+    HmacDrbgGenerate( &direct, NULL, 0, expected, largeSize );
+    if(     0 != HmacDrbgRandom( &buffered, output, largeSize )
+        ||  0 != memcmp( output, expected, largeSize )
+        ||  buffered.ReseedCounter != direct.ReseedCounter )
+    {
+        printf( "HMAC_DRBG large buffered request differs from generated output\n" );
+        success = false;
+    }
+
+    HmacDrbgUninitialise( &buffered );
+    HmacDrbgUninitialise( &direct );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestHmacDrbgLimits
+//
+//  Verifies the reseed interval is enforced with and without an output buffer, and that invalid parameters are
+//  rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestHmacDrbgLimits
+    (
+        void
+    )
+{
+    uint8_t const       entropy [32] = {0};
+    uint8_t             outputBuffer [64];
+    uint8_t             output [64];
+    HmacDrbgContext     context;
+    bool                success = true;
+
+    if(     -1 != HmacDrbgInitialise( &context, entropy, HMAC_DRBG_MIN_ENTROPY_SIZE - 1, NULL, 0, NULL, 0 )
+        ||   0 != HmacDrbgInitialise( &context, entropy, sizeof(entropy), NULL, 0, NULL, 0 )
+        ||  -1 != HmacDrbgReseed( &context, entropy, HMAC_DRBG_MIN_ENTROPY_SIZE - 1, NULL, 0 )
+        ||  -1 != HmacDrbgGenerate( &context, NULL, 0, NULL, HMAC_DRBG_MAX_REQUEST_SIZE + 1 )
+        ||  -1 != HmacDrbgSetReseedInterval( &context, 0 )
+        ||  -1 != HmacDrbgSetReseedInterval( &context, HMAC_DRBG_MAX_RESEED_INTERVAL + 1 )
+        ||  -1 != HmacDrbgSetOutputBuffer( &context, outputBuffer, 0 )
+        ||  -1 != HmacDrbgSetOutputBuffer( &context, outputBuffer, HMAC_DRBG_MAX_REQUEST_SIZE + 1 ) )
+    {
+        printf( "HMAC_DRBG accepted invalid parameters\n" );
+        success = false;
+    }
+
+    HmacDrbgSetReseedInterval( &context, 3 );
+    if(      0 != HmacDrbgGenerate( &context, NULL, 0, output, sizeof(output) )
+        ||   0 != HmacDrbgGenerate( &context, NULL, 0, output, sizeof(output) )
+        ||   0 != HmacDrbgGenerate( &context, NULL, 0, output, sizeof(output) )
+        ||  -1 != HmacDrbgGenerate( &context, NULL, 0, output, sizeof(output) ) )
+    {
+        printf( "HMAC_DRBG reseed interval not enforced\n" );
+        success = false;
+    }
+
+    HmacDrbgSetOutputBuffer( &context, outputBuffer, sizeof(outputBuffer) );
+    if(     -1 != HmacDrbgRandom( &context, output, 1 )
+        ||   0 != HmacDrbgReseed( &context, entropy, sizeof(entropy), NULL, 0 )
+        ||   0 != HmacDrbgRandom( &context, output, 1 ) )
+    {
+        printf( "HMAC_DRBG reseed interval not enforced with an output buffer\n" );
+        success = false;
+    }
+
+    HmacDrbgUninitialise( &context );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestDrbg
+//
+//  Test DRBG algorithms
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestDrbg
+    (
+        void
+    )
+{
+    bool        totalSuccess = true;
+    bool        success;
+
+    success = TestVectors( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestAesCtrDrbgOutputBuffer( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestAesCtrDrbgLimits( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestHmacDrbgOutputBuffer( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestHmacDrbgLimits( );
+    if( !success ) { totalSuccess = false; }
+
+    return totalSuccess;
+}
\ No newline at end of file
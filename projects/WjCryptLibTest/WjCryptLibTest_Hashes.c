@@ -5,8 +5,8 @@
 //  Tests the following:
 //     MD5
 //     SHA1
-//     SHA256
-//     SHA512
+//     SHA224, SHA256
+//     SHA384, SHA512, SHA512/224, SHA512/256
 //
 //  This is free and unencumbered software released into the public domain - June 2013 waterjuice.org
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -42,6 +42,15 @@ typedef struct
     SHA512_HASH     Sha512Hash;
 } TestVector;
 
+typedef struct
+{
+    char const*     PlainText;
+    SHA224_HASH     Sha224Hash;
+    SHA384_HASH     Sha384Hash;
+    SHA512_224_HASH Sha512_224Hash;
+    SHA512_256_HASH Sha512_256Hash;
+} VariantTestVector;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  GLOBALS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -172,6 +181,61 @@ static TestVector gTestVectors [] =
 };
 #define NUM_TEST_VECTORS ( sizeof(gTestVectors) / sizeof(gTestVectors[0]) )
 
+// FIPS 180-4 example messages for the truncated variants
+static VariantTestVector gVariantTestVectors [] =
+{
+    {
+        "",
+        {{0xd1,0x4a,0x02,0x8c,0x2a,0x3a,0x2b,0xc9,0x47,0x61,0x02,0xbb,0x28,0x82,0x34,0xc4,
+          0x15,0xa2,0xb0,0x1f,0x82,0x8e,0xa6,0x2a,0xc5,0xb3,0xe4,0x2f}},  // sha224
+        {{0x38,0xb0,0x60,0xa7,0x51,0xac,0x96,0x38,0x4c,0xd9,0x32,0x7e,0xb1,0xb1,0xe3,0x6a,
+          0x21,0xfd,0xb7,0x11,0x14,0xbe,0x07,0x43,0x4c,0x0c,0xc7,0xbf,0x63,0xf6,0xe1,0xda,
+          0x27,0x4e,0xde,0xbf,0xe7,0x6f,0x65,0xfb,0xd5,0x1a,0xd2,0xf1,0x48,0x98,0xb9,0x5b}},  // sha384
+        {{0x6e,0xd0,0xdd,0x02,0x80,0x6f,0xa8,0x9e,0x25,0xde,0x06,0x0c,0x19,0xd3,0xac,0x86,
+          0xca,0xbb,0x87,0xd6,0xa0,0xdd,0xd0,0x5c,0x33,0x3b,0x84,0xf4}},  // sha512/224
+        {{0xc6,0x72,0xb8,0xd1,0xef,0x56,0xed,0x28,0xab,0x87,0xc3,0x62,0x2c,0x51,0x14,0x06,
+          0x9b,0xdd,0x3a,0xd7,0xb8,0xf9,0x73,0x74,0x98,0xd0,0xc0,0x1e,0xce,0xf0,0x96,0x7a}},  // sha512/256
+    },
+    {
+        "abc",
+        {{0x23,0x09,0x7d,0x22,0x34,0x05,0xd8,0x22,0x86,0x42,0xa4,0x77,0xbd,0xa2,0x55,0xb3,
+          0x2a,0xad,0xbc,0xe4,0xbd,0xa0,0xb3,0xf7,0xe3,0x6c,0x9d,0xa7}},  // sha224
+        {{0xcb,0x00,0x75,0x3f,0x45,0xa3,0x5e,0x8b,0xb5,0xa0,0x3d,0x69,0x9a,0xc6,0x50,0x07,
+          0x27,0x2c,0x32,0xab,0x0e,0xde,0xd1,0x63,0x1a,0x8b,0x60,0x5a,0x43,0xff,0x5b,0xed,
+          0x80,0x86,0x07,0x2b,0xa1,0xe7,0xcc,0x23,0x58,0xba,0xec,0xa1,0x34,0xc8,0x25,0xa7}},  // sha384
+        {{0x46,0x34,0x27,0x0f,0x70,0x7b,0x6a,0x54,0xda,0xae,0x75,0x30,0x46,0x08,0x42,0xe2,
+          0x0e,0x37,0xed,0x26,0x5c,0xee,0xe9,0xa4,0x3e,0x89,0x24,0xaa}},  // sha512/224
+        {{0x53,0x04,0x8e,0x26,0x81,0x94,0x1e,0xf9,0x9b,0x2e,0x29,0xb7,0x6b,0x4c,0x7d,0xab,
+          0xe4,0xc2,0xd0,0xc6,0x34,0xfc,0x6d,0x46,0xe0,0xe2,0xf1,0x31,0x07,0xe7,0xaf,0x23}},  // sha512/256
+    },
+    {
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        {{0x75,0x38,0x8b,0x16,0x51,0x27,0x76,0xcc,0x5d,0xba,0x5d,0xa1,0xfd,0x89,0x01,0x50,
+          0xb0,0xc6,0x45,0x5c,0xb4,0xf5,0x8b,0x19,0x52,0x52,0x25,0x25}},  // sha224
+        {{0x33,0x91,0xfd,0xdd,0xfc,0x8d,0xc7,0x39,0x37,0x07,0xa6,0x5b,0x1b,0x47,0x09,0x39,
+          0x7c,0xf8,0xb1,0xd1,0x62,0xaf,0x05,0xab,0xfe,0x8f,0x45,0x0d,0xe5,0xf3,0x6b,0xc6,
+          0xb0,0x45,0x5a,0x85,0x20,0xbc,0x4e,0x6f,0x5f,0xe9,0x5b,0x1f,0xe3,0xc8,0x45,0x2b}},  // sha384
+        {{0xe5,0x30,0x2d,0x6d,0x54,0xbb,0x24,0x22,0x75,0xd1,0xe7,0x62,0x2d,0x68,0xdf,0x6e,
+          0xb0,0x2d,0xed,0xd1,0x3f,0x56,0x4c,0x13,0xdb,0xda,0x21,0x74}},  // sha512/224
+        {{0xbd,0xe8,0xe1,0xf9,0xf1,0x9b,0xb9,0xfd,0x34,0x06,0xc9,0x0e,0xc6,0xbc,0x47,0xbd,
+          0x36,0xd8,0xad,0xa9,0xf1,0x18,0x80,0xdb,0xc8,0xa2,0x2a,0x70,0x78,0xb6,0xa4,0x61}},  // sha512/256
+    },
+    {
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+        "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+        {{0xc9,0x7c,0xa9,0xa5,0x59,0x85,0x0c,0xe9,0x7a,0x04,0xa9,0x6d,0xef,0x6d,0x99,0xa9,
+          0xe0,0xe0,0xe2,0xab,0x14,0xe6,0xb8,0xdf,0x26,0x5f,0xc0,0xb3}},  // sha224
+        {{0x09,0x33,0x0c,0x33,0xf7,0x11,0x47,0xe8,0x3d,0x19,0x2f,0xc7,0x82,0xcd,0x1b,0x47,
+          0x53,0x11,0x1b,0x17,0x3b,0x3b,0x05,0xd2,0x2f,0xa0,0x80,0x86,0xe3,0xb0,0xf7,0x12,
+          0xfc,0xc7,0xc7,0x1a,0x55,0x7e,0x2d,0xb9,0x66,0xc3,0xe9,0xfa,0x91,0x74,0x60,0x39}},  // sha384
+        {{0x23,0xfe,0xc5,0xbb,0x94,0xd6,0x0b,0x23,0x30,0x81,0x92,0x64,0x0b,0x0c,0x45,0x33,
+          0x35,0xd6,0x64,0x73,0x4f,0xe4,0x0e,0x72,0x68,0x67,0x4a,0xf9}},  // sha512/224
+        {{0x39,0x28,0xe1,0x84,0xfb,0x86,0x90,0xf8,0x40,0xda,0x39,0x88,0x12,0x1d,0x31,0xbe,
+          0x65,0xcb,0x9d,0x3e,0xf8,0x3e,0xe6,0x14,0x6f,0xea,0xc8,0x61,0xe1,0x9b,0x56,0x3a}},  // sha512/256
+    },
+};
+#define NUM_VARIANT_TEST_VECTORS ( sizeof(gVariantTestVectors) / sizeof(gVariantTestVectors[0]) )
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PRIVATE FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -251,6 +315,85 @@ bool
     return success;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestMd5Multiple
+//
+//  Tests Md5CalculateMultiple with each implementation available on this processor against Md5Calculate. The buffers
+//  cover every padding case (including lengths either side of 55 and 64 bytes) and a mix of long and short buffers, so
+//  lanes finish at different times and are refilled.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestMd5Multiple
+    (
+        void
+    )
+{
+    #define NUM_BUFFERS     150
+    #define DATA_SIZE       5000
+    uint32_t const  implementations [] = { MD5_IMPLEMENTATION_PORTABLE, MD5_IMPLEMENTATION_SSE2,
+                                           MD5_IMPLEMENTATION_AVX2, MD5_IMPLEMENTATION_AVX512 };
+    uint32_t const  numBuffersToTest [] = { NUM_BUFFERS, 3, 1, 0 };
+    static uint8_t  data [DATA_SIZE];
+    void const*     buffers [NUM_BUFFERS];
+    uint32_t        sizes [NUM_BUFFERS];
+    MD5_HASH        expected [NUM_BUFFERS];
+    MD5_HASH        digests [NUM_BUFFERS];
+    uint32_t        i;
+    uint32_t        n;
+    uint32_t        k;
+    bool            success = true;
+
+    for( i=0; i<DATA_SIZE; i++ )
+    {
+        data[i] = (uint8_t)( i * 13 + (i >> 8) );
+    }
+    for( i=0; i<NUM_BUFFERS; i++ )
+    {
+        // Lengths 0 to 129 in order, then a few long ones in amongst short ones.
+        sizes[i] = ( i < 130 ) ? i : ( (i % 2) ? (DATA_SIZE - i) : (i - 120) );
+        buffers[i] = data + (i % 7);
+        Md5Calculate( buffers[i], sizes[i], &expected[i] );
+    }
+
+    for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+    {
+        if( 0 != Md5SetImplementation( implementations[i] ) )
+        {
+            // Not supported on this processor
+            continue;
+        }
+
+        for( n=0; n<sizeof(numBuffersToTest)/sizeof(numBuffersToTest[0]); n++ )
+        {
+            uint32_t first = NUM_BUFFERS - numBuffersToTest[n];
+
+            memset( digests, 0, sizeof(digests) );
+            Md5CalculateMultiple( buffers + first, sizes + first, numBuffersToTest[n], digests );
+            for( k=0; k<numBuffersToTest[n]; k++ )
+            {
+                if( 0 != memcmp( &digests[k], &expected[first + k], sizeof(MD5_HASH) ) )
+                {
+                    printf( "TestMd5 - Implementation %u buffer %u of %u failed [Multiple]\n",
+                        implementations[i], first + k, numBuffersToTest[n] );
+                    success = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if( 0 != Md5SetImplementation( MD5_IMPLEMENTATION_AUTO ) )
+    {
+        success = false;
+    }
+
+    #undef NUM_BUFFERS
+    #undef DATA_SIZE
+
+    return success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  TestSha1
 //
@@ -326,6 +469,70 @@ bool
     return success;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha1Implementations
+//
+//  Runs the SHA1 tests with each block transform available on this processor. This also hashes one million 'a'
+//  characters (FIPS 180 example) in uneven chunks, so that multi-block updates start at different buffer offsets.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha1Implementations
+    (
+        void
+    )
+{
+    uint32_t const  implementations [] = { SHA1_IMPLEMENTATION_PORTABLE, SHA1_IMPLEMENTATION_SHANI };
+    SHA1_HASH const millionAHash = {{0x34,0xaa,0x97,0x3c,0xd4,0xc4,0xda,0xa4,0xf6,0x1e,
+                                     0xeb,0x2b,0xdb,0xad,0x27,0x31,0x65,0x34,0x01,0x6f}};
+    uint8_t         buffer [1000];
+    uint32_t        i;
+    uint32_t        amountLeft;
+    uint32_t        chunkSize;
+    Sha1Context     context;
+    SHA1_HASH       hash;
+    bool            success = true;
+
+    memset( buffer, 'a', sizeof(buffer) );
+
+    for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+    {
+        if( 0 != Sha1SetImplementation( implementations[i] ) )
+        {
+            // Not supported on this processor
+            continue;
+        }
+
+        if( !TestSha1( ) )
+        {
+            printf( "TestSha1 - Implementation %u failed\n", implementations[i] );
+            success = false;
+        }
+
+        Sha1Initialise( &context );
+        for( amountLeft=1000000, chunkSize=1; amountLeft>0; chunkSize=(chunkSize*7+3)%sizeof(buffer) )
+        {
+            chunkSize = chunkSize < amountLeft ? chunkSize : amountLeft;
+            Sha1Update( &context, buffer, chunkSize );
+            amountLeft -= chunkSize;
+        }
+        Sha1Finalise( &context, &hash );
+
+        if( 0 != memcmp( &hash, &millionAHash, sizeof(hash) ) )
+        {
+            printf( "TestSha1 - Implementation %u failed [million a]\n", implementations[i] );
+            success = false;
+        }
+    }
+
+    if( 0 != Sha1SetImplementation( SHA1_IMPLEMENTATION_AUTO ) )
+    {
+        success = false;
+    }
+
+    return success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  TestSha256
 //
@@ -401,6 +608,52 @@ bool
     return success;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha224
+//
+//  Test SHA224 algorithm against test vectors, both in one call and a byte at a time
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha224
+    (
+        void
+    )
+{
+    uint32_t        i;
+    uint32_t        k;
+    uint32_t        len;
+    Sha224Context   context;
+    SHA224_HASH     hash;
+    bool            success = true;
+
+    for( i=0; i<NUM_VARIANT_TEST_VECTORS; i++ )
+    {
+        len = (uint32_t)strlen( gVariantTestVectors[i].PlainText );
+
+        Sha224Calculate( gVariantTestVectors[i].PlainText, len, &hash );
+        if( 0 != memcmp( &hash, &gVariantTestVectors[i].Sha224Hash, sizeof(hash) ) )
+        {
+            printf( "TestSha224 - Test vector %u failed\n", i );
+            success = false;
+        }
+
+        Sha224Initialise( &context );
+        for( k=0; k<len; k++ )
+        {
+            Sha224Update( &context, &gVariantTestVectors[i].PlainText[k], 1 );
+        }
+        Sha224Finalise( &context, &hash );
+        if( 0 != memcmp( &hash, &gVariantTestVectors[i].Sha224Hash, sizeof(hash) ) )
+        {
+            printf( "TestSha224 - Test vector %u failed [byte by byte]\n", i );
+            success = false;
+        }
+    }
+
+    return success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  TestSha512
 //
@@ -476,6 +729,443 @@ bool
     return success;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha512Variants
+//
+//  Test SHA384, SHA512/224, and SHA512/256 algorithms against test vectors. SHA384 is also checked a byte at a time.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha512Variants
+    (
+        void
+    )
+{
+    uint32_t            i;
+    uint32_t            k;
+    uint32_t            len;
+    Sha384Context       context;
+    SHA384_HASH         hash384;
+    SHA512_224_HASH     hash512_224;
+    SHA512_256_HASH     hash512_256;
+    bool                success = true;
+
+    for( i=0; i<NUM_VARIANT_TEST_VECTORS; i++ )
+    {
+        len = (uint32_t)strlen( gVariantTestVectors[i].PlainText );
+
+        Sha384Calculate( gVariantTestVectors[i].PlainText, len, &hash384 );
+        if( 0 != memcmp( &hash384, &gVariantTestVectors[i].Sha384Hash, sizeof(hash384) ) )
+        {
+            printf( "TestSha384 - Test vector %u failed\n", i );
+            success = false;
+        }
+
+        Sha384Initialise( &context );
+        for( k=0; k<len; k++ )
+        {
+            Sha384Update( &context, &gVariantTestVectors[i].PlainText[k], 1 );
+        }
+        Sha384Finalise( &context, &hash384 );
+        if( 0 != memcmp( &hash384, &gVariantTestVectors[i].Sha384Hash, sizeof(hash384) ) )
+        {
+            printf( "TestSha384 - Test vector %u failed [byte by byte]\n", i );
+            success = false;
+        }
+
+        Sha512_224Calculate( gVariantTestVectors[i].PlainText, len, &hash512_224 );
+        if( 0 != memcmp( &hash512_224, &gVariantTestVectors[i].Sha512_224Hash, sizeof(hash512_224) ) )
+        {
+            printf( "TestSha512_224 - Test vector %u failed\n", i );
+            success = false;
+        }
+
+        Sha512_256Calculate( gVariantTestVectors[i].PlainText, len, &hash512_256 );
+        if( 0 != memcmp( &hash512_256, &gVariantTestVectors[i].Sha512_256Hash, sizeof(hash512_256) ) )
+        {
+            printf( "TestSha512_256 - Test vector %u failed\n", i );
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha512Implementations
+//
+//  Runs the SHA512 and variant tests with each implementation available on this processor, including one million
+//  'a' characters (FIPS 180 example) hashed in uneven chunks. Sha512CalculateMultiple is compared against
+//  Sha512Calculate using the portable implementation, over buffers covering every padding case and a mix of long and short buffers.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha512Implementations
+    (
+        void
+    )
+{
+    #define NUM_BUFFERS     300
+    #define DATA_SIZE       5000
+    uint32_t const      implementations [] = { SHA512_IMPLEMENTATION_PORTABLE, SHA512_IMPLEMENTATION_AVX2,
+                                               SHA512_IMPLEMENTATION_AVX512 };
+    uint32_t const      numBuffersToTest [] = { NUM_BUFFERS, 5, 1, 0 };
+    SHA512_HASH const   millionAHash = {{ 0xe7,0x18,0x48,0x3d,0x0c,0xe7,0x69,0x64,0x4e,0x2e,0x42,0xc7,0xbc,0x15,0xb4,0x63,
+                                          0x8e,0x1f,0x98,0xb1,0x3b,0x20,0x44,0x28,0x56,0x32,0xa8,0x03,0xaf,0xa9,0x73,0xeb,
+                                          0xde,0x0f,0xf2,0x44,0x87,0x7e,0xa6,0x0a,0x4c,0xb0,0x43,0x2c,0xe5,0x77,0xc3,0x1b,
+                                          0xeb,0x00,0x9c,0x5c,0x2c,0x49,0xaa,0x2e,0x4e,0xad,0xb2,0x17,0xad,0x8c,0xc0,0x9b }};
+    static uint8_t      data [DATA_SIZE];
+    static uint8_t      letterA [1000];
+    static SHA512_HASH  expected [NUM_BUFFERS];
+    static SHA512_HASH  digests [NUM_BUFFERS];
+    void const*         buffers [NUM_BUFFERS];
+    uint32_t            sizes [NUM_BUFFERS];
+    uint32_t            i;
+    uint32_t            n;
+    uint32_t            k;
+    uint32_t            amountLeft;
+    uint32_t            chunkSize;
+    Sha512Context       context;
+    SHA512_HASH         hash;
+    bool                success = true;
+
+    for( i=0; i<DATA_SIZE; i++ )
+    {
+        data[i] = (uint8_t)( i * 13 + (i >> 8) );
+    }
+    memset( letterA, 'a', sizeof(letterA) );
+
+    Sha512SetImplementation( SHA512_IMPLEMENTATION_PORTABLE );
+    for( i=0; i<NUM_BUFFERS; i++ )
+    {
+        // Lengths 0 to 259 in order, then a few long ones in amongst short ones.
+        sizes[i] = ( i < 260 ) ? i : ( (i % 2) ? (DATA_SIZE - i) : (i - 250) );
+        buffers[i] = data + (i % 7);
+        Sha512Calculate( buffers[i], sizes[i], &expected[i] );
+    }
+
+    for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+    {
+        if( 0 != Sha512SetImplementation( implementations[i] ) )
+        {
+            // Not supported on this processor
+            continue;
+        }
+
+        if( !TestSha512( ) || !TestSha512Variants( ) )
+        {
+            printf( "TestSha512 - Implementation %u failed\n", implementations[i] );
+            success = false;
+        }
+
+        Sha512Initialise( &context );
+        for( amountLeft=1000000, chunkSize=1; amountLeft>0; chunkSize=(chunkSize*7+3)%1000 )
+        {
+            chunkSize = chunkSize < amountLeft ? chunkSize : amountLeft;
+            Sha512Update( &context, letterA, chunkSize );
+            amountLeft -= chunkSize;
+        }
+        Sha512Finalise( &context, &hash );
+        if( 0 != memcmp( &hash, &millionAHash, sizeof(hash) ) )
+        {
+            printf( "TestSha512 - Implementation %u failed [million a]\n", implementations[i] );
+            success = false;
+        }
+
+        for( n=0; n<sizeof(numBuffersToTest)/sizeof(numBuffersToTest[0]); n++ )
+        {
+            uint32_t first = NUM_BUFFERS - numBuffersToTest[n];
+
+            memset( digests, 0, sizeof(digests) );
+            Sha512CalculateMultiple( buffers + first, sizes + first, numBuffersToTest[n], digests );
+            for( k=0; k<numBuffersToTest[n]; k++ )
+            {
+                if( 0 != memcmp( &digests[k], &expected[first + k], sizeof(SHA512_HASH) ) )
+                {
+                    printf( "TestSha512 - Implementation %u buffer %u of %u failed [Multiple]\n",
+                        implementations[i], first + k, numBuffersToTest[n] );
+                    success = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if( 0 != Sha512SetImplementation( SHA512_IMPLEMENTATION_AUTO ) )
+    {
+        success = false;
+    }
+
+    #undef NUM_BUFFERS
+    #undef DATA_SIZE
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ReferenceSha2
+//
+//  A direct transcription of FIPS 180-4 used as an independent reference for differential testing of the optimised
+//  SHA256 and SHA512 transforms. WordSize is 4 for SHA256 or 8 for SHA512. Every word is held in a uint64_t and
+//  masked to the word size. The digest is written to Digest (32 or 64 bytes). Slow, but simple to check by eye.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    ReferenceSha2
+    (
+        uint32_t            WordSize,       // [in]
+        uint8_t const*      Buffer,         // [in]
+        uint32_t            BufferSize,     // [in]
+        uint8_t*            Digest          // [out]
+    )
+{
+    static const uint64_t K512 [80] = {
+        0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+        0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+        0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+        0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+        0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+        0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+        0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+        0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+        0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+        0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+        0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+        0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+        0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+        0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+        0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+        0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+        0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+        0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+        0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+        0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL };
+    static const uint64_t H512 [8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL };
+    // Rotation amounts of Sigma0, Sigma1, sigma0, and sigma1 (the last of each shifts instead)
+    static const uint32_t rot256 [4][3] = { { 2, 13, 22 }, { 6, 11, 25 }, { 7, 18, 3 }, { 17, 19, 10 } };
+    static const uint32_t rot512 [4][3] = { { 28, 34, 39 }, { 14, 18, 41 }, { 1, 8, 7 }, { 19, 61, 6 } };
+    uint32_t const      bits = WordSize * 8;
+    uint32_t const      blockSize = WordSize * 16;
+    uint32_t const      rounds = ( 4 == WordSize ) ? 64 : 80;
+    uint32_t const      (*r)[3] = ( 4 == WordSize ) ? rot256 : rot512;
+    uint64_t const      mask = ( 4 == WordSize ) ? 0xffffffffULL : ~0ULL;
+    static uint8_t      message [2 * 128 + 10000];
+    uint32_t            messageSize;
+    uint64_t            H [8];
+    uint64_t            W [80];
+    uint64_t            v [8];
+    uint64_t            k;
+    uint64_t            t1;
+    uint64_t            t2;
+    uint32_t            i;
+    uint32_t            j;
+    uint32_t            n;
+
+    #define ROTR( x, n )    ( ( ((x) >> (n)) | ((x) << (bits - (n))) ) & mask )
+    #define BSIG( x, m )    ( ROTR( x, r[m][0] ) ^ ROTR( x, r[m][1] ) ^ ROTR( x, r[m][2] ) )
+    #define SSIG( x, m )    ( ROTR( x, r[m][0] ) ^ ROTR( x, r[m][1] ) ^ ( (x) >> r[m][2] ) )
+
+    // Pad: 0x80, zeros, then the bit length in the last 8 bytes (the upper 8 bytes of SHA512's 16 byte length are 0)
+    memcpy( message, Buffer, BufferSize );
+    messageSize = ( ( BufferSize + 1 + (2 * WordSize) + blockSize - 1 ) / blockSize ) * blockSize;
+    memset( message + BufferSize, 0, messageSize - BufferSize );
+    message[BufferSize] = 0x80;
+    for( i=0; i<8; i++ )
+    {
+        message[messageSize - 1 - i] = (uint8_t)( ( (uint64_t)BufferSize * 8 ) >> (8 * i) );
+    }
+
+    // The SHA256 initial values and constants are the top 32 bits of the SHA512 ones
+    for( i=0; i<8; i++ )
+    {
+        H[i] = ( 4 == WordSize ) ? ( H512[i] >> 32 ) : H512[i];
+    }
+
+    for( n=0; n<messageSize; n+=blockSize )
+    {
+        for( i=0; i<rounds; i++ )
+        {
+            if( i < 16 )
+            {
+                W[i] = 0;
+                for( j=0; j<WordSize; j++ )
+                {
+                    W[i] = ( W[i] << 8 ) | message[n + (i * WordSize) + j];
+                }
+            }
+            else
+            {
+                W[i] = ( SSIG( W[i-2], 3 ) + W[i-7] + SSIG( W[i-15], 2 ) + W[i-16] ) & mask;
+            }
+        }
+
+        memcpy( v, H, sizeof(v) );
+        for( i=0; i<rounds; i++ )
+        {
+            k = ( 4 == WordSize ) ? ( K512[i] >> 32 ) : K512[i];
+            t1 = ( v[7] + BSIG( v[4], 1 ) + ( (v[4] & v[5]) ^ (~v[4] & v[6]) ) + k + W[i] ) & mask;
+            t2 = ( BSIG( v[0], 0 ) + ( (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]) ) ) & mask;
+            memmove( &v[1], &v[0], 7 * sizeof(v[0]) );
+            v[4] = ( v[4] + t1 ) & mask;
+            v[0] = ( t1 + t2 ) & mask;
+        }
+
+        for( i=0; i<8; i++ )
+        {
+            H[i] = ( H[i] + v[i] ) & mask;
+        }
+    }
+
+    for( i=0; i<8*WordSize; i++ )
+    {
+        Digest[i] = (uint8_t)( H[i / WordSize] >> ( 8 * (WordSize - 1 - (i % WordSize)) ) );
+    }
+
+    #undef ROTR
+    #undef BSIG
+    #undef SSIG
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha2Differential
+//
+//  Compares Sha256Calculate and Sha512Calculate (with each SHA512 implementation available) against ReferenceSha2
+//  over pseudo random messages of every length up to several blocks, and some longer ones.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha2Differential
+    (
+        void
+    )
+{
+    #define DATA_SIZE       10000
+    uint32_t const      implementations [] = { SHA512_IMPLEMENTATION_PORTABLE, SHA512_IMPLEMENTATION_AVX2,
+                                               SHA512_IMPLEMENTATION_AVX512 };
+    static uint8_t      data [DATA_SIZE];
+    uint32_t            random = 1;
+    uint32_t            len;
+    uint32_t            i;
+    uint8_t             expected [SHA512_HASH_SIZE];
+    SHA256_HASH         sha256Hash;
+    SHA512_HASH         sha512Hash;
+    bool                success = true;
+
+    for( i=0; i<DATA_SIZE; i++ )
+    {
+        random = random * 1103515245 + 12345;
+        data[i] = (uint8_t)( random >> 16 );
+    }
+
+    for( len=0; len<DATA_SIZE; len = ( len < 600 ) ? len + 1 : len * 3 / 2 )
+    {
+        ReferenceSha2( 4, data, len, expected );
+        Sha256Calculate( data, len, &sha256Hash );
+        if( 0 != memcmp( &sha256Hash, expected, sizeof(sha256Hash) ) )
+        {
+            printf( "TestSha2Differential - SHA256 length %u failed\n", len );
+            success = false;
+        }
+
+        ReferenceSha2( 8, data, len, expected );
+        for( i=0; i<sizeof(implementations)/sizeof(implementations[0]); i++ )
+        {
+            if( 0 != Sha512SetImplementation( implementations[i] ) )
+            {
+                // Not supported on this processor
+                continue;
+            }
+            Sha512Calculate( data, len, &sha512Hash );
+            if( 0 != memcmp( &sha512Hash, expected, sizeof(sha512Hash) ) )
+            {
+                printf( "TestSha2Differential - SHA512 implementation %u length %u failed\n", implementations[i], len );
+                success = false;
+            }
+        }
+    }
+
+    Sha512SetImplementation( SHA512_IMPLEMENTATION_AUTO );
+
+    #undef DATA_SIZE
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestHashChunking
+//
+//  Hashes the same data with each hash in one call and in chunks of varying sizes, so that updates start and end at
+//  every offset within a block and some updates span several whole blocks, and checks the digests match.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestHashChunking
+    (
+        void
+    )
+{
+    #define DATA_SIZE       5000
+    static uint8_t  data [DATA_SIZE];
+    uint32_t        i;
+    uint32_t        step;
+    uint32_t        offset;
+    uint32_t        chunkSize;
+    Md5Context      md5Context;
+    Sha1Context     sha1Context;
+    Sha256Context   sha256Context;
+    Sha512Context   sha512Context;
+    MD5_HASH        md5Hash [2];
+    SHA1_HASH       sha1Hash [2];
+    SHA256_HASH     sha256Hash [2];
+    SHA512_HASH     sha512Hash [2];
+    bool            success = true;
+
+    for( i=0; i<DATA_SIZE; i++ )
+    {
+        data[i] = (uint8_t)( i * 7 + (i >> 9) );
+    }
+
+    Md5Calculate( data, DATA_SIZE, &md5Hash[0] );
+    Sha1Calculate( data, DATA_SIZE, &sha1Hash[0] );
+    Sha256Calculate( data, DATA_SIZE, &sha256Hash[0] );
+    Sha512Calculate( data, DATA_SIZE, &sha512Hash[0] );
+
+    for( step=1; step<400; step+=37 )
+    {
+        Md5Initialise( &md5Context );
+        Sha1Initialise( &sha1Context );
+        Sha256Initialise( &sha256Context );
+        Sha512Initialise( &sha512Context );
+        for( offset=0, chunkSize=step; offset<DATA_SIZE; offset+=chunkSize, chunkSize=(chunkSize*5+step)%700 )
+        {
+            chunkSize = ( chunkSize < DATA_SIZE - offset ) ? chunkSize : ( DATA_SIZE - offset );
+            Md5Update( &md5Context, data + offset, chunkSize );
+            Sha1Update( &sha1Context, data + offset, chunkSize );
+            Sha256Update( &sha256Context, data + offset, chunkSize );
+            Sha512Update( &sha512Context, data + offset, chunkSize );
+        }
+        Md5Finalise( &md5Context, &md5Hash[1] );
+        Sha1Finalise( &sha1Context, &sha1Hash[1] );
+        Sha256Finalise( &sha256Context, &sha256Hash[1] );
+        Sha512Finalise( &sha512Context, &sha512Hash[1] );
+
+        if(     0 != memcmp( &md5Hash[0], &md5Hash[1], sizeof(md5Hash[0]) )
+            ||  0 != memcmp( &sha1Hash[0], &sha1Hash[1], sizeof(sha1Hash[0]) )
+            ||  0 != memcmp( &sha256Hash[0], &sha256Hash[1], sizeof(sha256Hash[0]) )
+            ||  0 != memcmp( &sha512Hash[0], &sha512Hash[1], sizeof(sha512Hash[0]) ) )
+        {
+            printf( "TestHashChunking - Step %u failed\n", step );
+            success = false;
+        }
+    }
+
+    #undef DATA_SIZE
+
+    return success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -495,20 +1185,39 @@ bool
     bool    allSuccess = true;
 
     success = TestMd5( );
+    if( !TestMd5Multiple( ) ) { success = false; }
     if( !success ) { allSuccess = false; }
     printf( "Test MD5     - %s\n", success?"Pass":"Fail" );
 
     success = TestSha1( );
+    if( !TestSha1Implementations( ) ) { success = false; }
     if( !success ) { allSuccess = false; }
     printf( "Test SHA1    - %s\n", success?"Pass":"Fail" );
 
+    success = TestSha224( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test SHA224  - %s\n", success?"Pass":"Fail" );
+
     success = TestSha256( );
     if( !success ) { allSuccess = false; }
     printf( "Test SHA256  - %s\n", success?"Pass":"Fail" );
 
+    success = TestSha512Variants( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test SHA384, SHA512/224, SHA512/256 - %s\n", success?"Pass":"Fail" );
+
     success = TestSha512( );
+    if( !TestSha512Implementations( ) ) { success = false; }
     if( !success ) { allSuccess = false; }
     printf( "Test SHA512  - %s\n", success?"Pass":"Fail" );
 
+    success = TestSha2Differential( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test SHA2 differential - %s\n", success?"Pass":"Fail" );
+
+    success = TestHashChunking( );
+    if( !success ) { allSuccess = false; }
+    printf( "Test hash chunking - %s\n", success?"Pass":"Fail" );
+
     return allSuccess;
 }
@@ -0,0 +1,520 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_Hkdf
+//
+//  Tests the cryptography functions against known test vectors to verify algorithms are correct.
+//  Tests the following:
+//     HKDF-SHA256
+//     HKDF-SHA512
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "WjCryptLib_Hkdf.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_TEST_DATA_SIZE      96
+
+typedef struct
+{
+    char*           IkmHex;
+    char*           SaltHex;
+    char*           InfoHex;
+    char*           PrkHex;
+    char*           OkmHex;
+} TestVector;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Test vectors from RFC 5869 test cases 1, 2, and 3
+static TestVector gSha256TestVectors [] =
+{
+    {
+        "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+        "000102030405060708090a0b0c",
+        "f0f1f2f3f4f5f6f7f8f9",
+        "077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5",
+        "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865"
+    },
+    {
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f"
+        "303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f",
+        "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f"
+        "909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+        "b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+        "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+        "06a6b88c5853361a06104c9ceb35b45cef760014904671014a193f40c15fc244",
+        "b11e398dc80327a1c8e7f78c596a49344f012eda2d4efad8a050cc4c19afa97c59045a99cac7827271cb41c65e590e09"
+        "da3275600c2f09b8367793a9aca3db71cc30c58179ec3e87c14c01d5c1f3434f1d87"
+    },
+    {
+        "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+        "",
+        "",
+        "19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04",
+        "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8"
+    },
+};
+
+// The inputs of RFC 5869 test cases 1, 2, and 3 with HKDF-SHA512
+static TestVector gSha512TestVectors [] =
+{
+    {
+        "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+        "000102030405060708090a0b0c",
+        "f0f1f2f3f4f5f6f7f8f9",
+        "665799823737ded04a88e47e54a5890bb2c3d247c7a4254a8e61350723590a26c36238127d8661b88cf80ef802d57e2f"
+        "7cebcf1e00e083848be19929c61b4237",
+        "832390086cda71fb47625bb5ceb168e4c8e26a1a16ed34d9fc7fe92c1481579338da362cb8d9f925d7cb"
+    },
+    {
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f"
+        "303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f",
+        "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f"
+        "909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+        "b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+        "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+        "35672542907d4e142c00e84499e74e1de08be86535f924e022804ad775dde27ec86cd1e5b7d178c74489bdbeb30712be"
+        "b82d4f97416c5a94ea81ebdf3e629e4a",
+        "ce6c97192805b346e6161e821ed165673b84f400a2b514b2fe23d84cd189ddf1b695b48cbd1c8388441137b3ce28f16a"
+        "a64ba33ba466b24df6cfcb021ecff235f6a2056ce3af1de44d572097a8505d9e7a93"
+    },
+    {
+        "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+        "",
+        "",
+        "fd200c4987ac491313bd4a2a13287121247239e11c9ef82802044b66ef357e5b194498d0682611382348572a7b1611de"
+        "54764094286320578a863f36562b0df6",
+        "f5fa02b18298a72a8c23898a8703472c6eb179dc204c03425c970e3b164bf90fff22d04836d0e2343bac"
+    },
+};
+
+#define NUM_SHA256_TEST_VECTORS ( sizeof(gSha256TestVectors) / sizeof(gSha256TestVectors[0]) )
+#define NUM_SHA512_TEST_VECTORS ( sizeof(gSha512TestVectors) / sizeof(gSha512TestVectors[0]) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  HexToBytes
+//
+//  Reads a string as hex and places it in Data. The number of bytes represented in the input string must not exceed
+//  MaxDataSize, otherwise the function returns false without writing anything. On success *pDataSize is set to the
+//  number of bytes written.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    HexToBytes
+    (
+        char const*         HexString,              // [in]
+        uint8_t*            Data,                   // [out]
+        uint32_t            MaxDataSize,            // [in]
+        uint32_t*           pDataSize               // [out optional]
+    )
+{
+    uint32_t        i;
+    char            holdingBuffer [3] = {0};
+    unsigned        hexToNumber;
+    uint32_t        numBytes = (uint32_t)( strlen(HexString) / 2 );
+
+    if( numBytes > MaxDataSize )
+    {
+        return false;
+    }
+
+    for( i=0; i<numBytes; i++ )
+    {
+        holdingBuffer[0] = HexString[i*2 + 0];
+        holdingBuffer[1] = HexString[i*2 + 1];
+        sscanf( holdingBuffer, "%x", &hexToNumber );
+        Data[i] = (uint8_t) hexToNumber;
+    }
+
+    if( NULL != pDataSize )
+    {
+        *pDataSize = numBytes;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha256Vectors
+//
+//  Tests HKDF-SHA256 against fixed test vectors, using the one call function, extract then expand, and expand from
+//  the given PRK. Each context is expanded twice to check that expanding does not change it.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha256Vectors
+    (
+        void
+    )
+{
+    uint32_t            vectorIndex;
+    TestVector*         vector;
+    uint8_t             ikm [MAX_TEST_DATA_SIZE];
+    uint32_t            ikmSize = 0;
+    uint8_t             salt [MAX_TEST_DATA_SIZE];
+    uint32_t            saltSize = 0;
+    uint8_t             info [MAX_TEST_DATA_SIZE];
+    uint32_t            infoSize = 0;
+    uint8_t             prk [MAX_TEST_DATA_SIZE];
+    uint32_t            prkSize = 0;
+    uint8_t             okm [MAX_TEST_DATA_SIZE];
+    uint32_t            okmSize = 0;
+    uint8_t             output [MAX_TEST_DATA_SIZE];
+    HkdfSha256Context   extracted;
+    HkdfSha256Context   fromPrk;
+    uint32_t            pass;
+
+    for( vectorIndex=0; vectorIndex<NUM_SHA256_TEST_VECTORS; vectorIndex++ )
+    {
+        vector = &gSha256TestVectors[vectorIndex];
+        if( !HexToBytes( vector->IkmHex,  ikm,  sizeof(ikm),  &ikmSize )
+         || !HexToBytes( vector->SaltHex, salt, sizeof(salt), &saltSize )
+         || !HexToBytes( vector->InfoHex, info, sizeof(info), &infoSize )
+         || !HexToBytes( vector->PrkHex,  prk,  sizeof(prk),  &prkSize )
+         || !HexToBytes( vector->OkmHex,  okm,  sizeof(okm),  &okmSize ) )
+        {
+            printf( "HKDF-SHA256 test vector (index:%u) has a hex string too large for its buffer\n", vectorIndex );
+            return false;
+        }
+
+        memset( output, 0, sizeof(output) );
+        if(     0 != HkdfSha256( salt, saltSize, ikm, ikmSize, info, infoSize, output, okmSize )
+            ||  0 != memcmp( output, okm, okmSize ) )
+        {
+            printf( "HKDF-SHA256 test vector (index:%u) failed\n", vectorIndex );
+            return false;
+        }
+
+        HkdfSha256Extract( &extracted, salt, saltSize, ikm, ikmSize );
+        HkdfSha256InitialiseWithPrk( &fromPrk, prk, prkSize );
+        for( pass=0; pass<2; pass++ )
+        {
+            memset( output, 0, sizeof(output) );
+            if(     0 != HkdfSha256Expand( &extracted, info, infoSize, output, okmSize )
+                ||  0 != memcmp( output, okm, okmSize ) )
+            {
+                printf( "HKDF-SHA256 test vector (index:%u) failed extract and expand\n", vectorIndex );
+                return false;
+            }
+
+            memset( output, 0, sizeof(output) );
+            if(     0 != HkdfSha256Expand( &fromPrk, info, infoSize, output, okmSize )
+                ||  0 != memcmp( output, okm, okmSize ) )
+            {
+                printf( "HKDF-SHA256 test vector (index:%u) failed expand from PRK\n", vectorIndex );
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha256Batch
+//
+//  Verifies HkdfSha256ExtractBatch and HkdfSha256ExpandBatch produce the same keys as deriving each session's keys
+//  individually. The sessions have input keying material of different lengths and the key size is not a multiple of
+//  the hash size.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha256Batch
+    (
+        void
+    )
+{
+    uint8_t const       salt [] = { 's', 'a', 'l', 't' };
+    uint8_t const       info0 [] = { 'k', 'e', 'y', ' ', 'e', 'n', 'c' };
+    uint8_t const       info1 [] = { 'k', 'e', 'y', ' ', 'm', 'a', 'c' };
+    void const*         infos [] = { info0, info1, NULL };
+    uint32_t const      infoSizes [] = { sizeof(info0), sizeof(info1), 0 };
+    uint32_t const      numInfos = sizeof(infos) / sizeof(infos[0]);
+    uint32_t const      numSessions = 13;
+    uint32_t const      keySize = 70;
+    uint8_t             ikmData [13 * 40];
+    void const*         ikms [13];
+    uint32_t            ikmSizes [13];
+    HkdfSha256Context   contexts [13];
+    HkdfSha256Context   context;
+    uint8_t*            keys = malloc( numSessions * numInfos * keySize );
+    uint8_t             key [70];
+    uint32_t            i;
+    uint32_t            j;
+    bool                success = true;
+
+    for( i=0; i<sizeof(ikmData); i++ )
+    {
+        ikmData[i] = (uint8_t)( i * 13 );
+    }
+    for( i=0; i<numSessions; i++ )
+    {
+        ikms[i] = ikmData + ( i * 40 );
+        ikmSizes[i] = 1 + ( i * 3 );
+    }
+
+    HkdfSha256ExtractBatch( salt, sizeof(salt), ikms, ikmSizes, numSessions, contexts );
+    if( 0 != HkdfSha256ExpandBatch( contexts, numSessions, infos, infoSizes, numInfos, keys, keySize ) )
+    {
+        printf( "HKDF-SHA256 batch expand failed\n" );
+        success = false;
+    }
+
+    for( i=0; i<numSessions && success; i++ )
+    {
+        HkdfSha256Extract( &context, salt, sizeof(salt), ikms[i], ikmSizes[i] );
+        for( j=0; j<numInfos; j++ )
+        {
+            HkdfSha256Expand( &context, infos[j], infoSizes[j], key, keySize );
+            if( 0 != memcmp( key, keys + ( ( i * numInfos + j ) * keySize ), keySize ) )
+            {
+                printf( "HKDF-SHA256 batch key (session:%u info:%u) differs from single derivation\n", i, j );
+                success = false;
+            }
+        }
+    }
+
+    free( keys );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha512Vectors
+//
+//  Tests HKDF-SHA512 against fixed test vectors, using the one call function, extract then expand, and expand from
+//  the given PRK. Each context is expanded twice to check that expanding does not change it.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha512Vectors
+    (
+        void
+    )
+{
+    uint32_t            vectorIndex;
+    TestVector*         vector;
+    uint8_t             ikm [MAX_TEST_DATA_SIZE];
+    uint32_t            ikmSize = 0;
+    uint8_t             salt [MAX_TEST_DATA_SIZE];
+    uint32_t            saltSize = 0;
+    uint8_t             info [MAX_TEST_DATA_SIZE];
+    uint32_t            infoSize = 0;
+    uint8_t             prk [MAX_TEST_DATA_SIZE];
+    uint32_t            prkSize = 0;
+    uint8_t             okm [MAX_TEST_DATA_SIZE];
+    uint32_t            okmSize = 0;
+    uint8_t             output [MAX_TEST_DATA_SIZE];
+    HkdfSha512Context   extracted;
+    HkdfSha512Context   fromPrk;
+    uint32_t            pass;
+
+    for( vectorIndex=0; vectorIndex<NUM_SHA512_TEST_VECTORS; vectorIndex++ )
+    {
+        vector = &gSha512TestVectors[vectorIndex];
+        if( !HexToBytes( vector->IkmHex,  ikm,  sizeof(ikm),  &ikmSize )
+         || !HexToBytes( vector->SaltHex, salt, sizeof(salt), &saltSize )
+         || !HexToBytes( vector->InfoHex, info, sizeof(info), &infoSize )
+         || !HexToBytes( vector->PrkHex,  prk,  sizeof(prk),  &prkSize )
+         || !HexToBytes( vector->OkmHex,  okm,  sizeof(okm),  &okmSize ) )
+        {
+            printf( "HKDF-SHA512 test vector (index:%u) has a hex string too large for its buffer\n", vectorIndex );
+            return false;
+        }
+
+        memset( output, 0, sizeof(output) );
+        if(     0 != HkdfSha512( salt, saltSize, ikm, ikmSize, info, infoSize, output, okmSize )
+            ||  0 != memcmp( output, okm, okmSize ) )
+        {
+            printf( "HKDF-SHA512 test vector (index:%u) failed\n", vectorIndex );
+            return false;
+        }
+
+        HkdfSha512Extract( &extracted, salt, saltSize, ikm, ikmSize );
+        HkdfSha512InitialiseWithPrk( &fromPrk, prk, prkSize );
+        for( pass=0; pass<2; pass++ )
+        {
+            memset( output, 0, sizeof(output) );
+            if(     0 != HkdfSha512Expand( &extracted, info, infoSize, output, okmSize )
+                ||  0 != memcmp( output, okm, okmSize ) )
+            {
+                printf( "HKDF-SHA512 test vector (index:%u) failed extract and expand\n", vectorIndex );
+                return false;
+            }
+
+            memset( output, 0, sizeof(output) );
+            if(     0 != HkdfSha512Expand( &fromPrk, info, infoSize, output, okmSize )
+                ||  0 != memcmp( output, okm, okmSize ) )
+            {
+                printf( "HKDF-SHA512 test vector (index:%u) failed expand from PRK\n", vectorIndex );
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestSha512Batch
+//
+//  Verifies HkdfSha512ExtractBatch and HkdfSha512ExpandBatch produce the same keys as deriving each session's keys
+//  individually. The sessions have input keying material of different lengths and the key size is not a multiple of
+//  the hash size.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestSha512Batch
+    (
+        void
+    )
+{
+    uint8_t const       salt [] = { 's', 'a', 'l', 't' };
+    uint8_t const       info0 [] = { 'k', 'e', 'y', ' ', 'e', 'n', 'c' };
+    uint8_t const       info1 [] = { 'k', 'e', 'y', ' ', 'm', 'a', 'c' };
+    void const*         infos [] = { info0, info1, NULL };
+    uint32_t const      infoSizes [] = { sizeof(info0), sizeof(info1), 0 };
+    uint32_t const      numInfos = sizeof(infos) / sizeof(infos[0]);
+    uint32_t const      numSessions = 13;
+    uint32_t const      keySize = 70;
+    uint8_t             ikmData [13 * 40];
+    void const*         ikms [13];
+    uint32_t            ikmSizes [13];
+    HkdfSha512Context   contexts [13];
+    HkdfSha512Context   context;
+    uint8_t*            keys = malloc( numSessions * numInfos * keySize );
+    uint8_t             key [70];
+    uint32_t            i;
+    uint32_t            j;
+    bool                success = true;
+
+    for( i=0; i<sizeof(ikmData); i++ )
+    {
+        ikmData[i] = (uint8_t)( i * 13 );
+    }
+    for( i=0; i<numSessions; i++ )
+    {
+        ikms[i] = ikmData + ( i * 40 );
+        ikmSizes[i] = 1 + ( i * 3 );
+    }
+
+    HkdfSha512ExtractBatch( salt, sizeof(salt), ikms, ikmSizes, numSessions, contexts );
+    if( 0 != HkdfSha512ExpandBatch( contexts, numSessions, infos, infoSizes, numInfos, keys, keySize ) )
+    {
+        printf( "HKDF-SHA512 batch expand failed\n" );
+        success = false;
+    }
+
+    for( i=0; i<numSessions && success; i++ )
+    {
+        HkdfSha512Extract( &context, salt, sizeof(salt), ikms[i], ikmSizes[i] );
+        for( j=0; j<numInfos; j++ )
+        {
+            HkdfSha512Expand( &context, infos[j], infoSizes[j], key, keySize );
+            if( 0 != memcmp( key, keys + ( ( i * numInfos + j ) * keySize ), keySize ) )
+            {
+                printf( "HKDF-SHA512 batch key (session:%u info:%u) differs from single derivation\n", i, j );
+                success = false;
+            }
+        }
+    }
+
+    free( keys );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestInvalidParameters
+//
+//  Verifies that output sizes larger than RFC 5869 allows are rejected, and that the largest allowed size is not.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestInvalidParameters
+    (
+        void
+    )
+{
+    uint8_t const       ikm [16] = {0};
+    uint8_t*            okm = malloc( HKDF_SHA512_MAX_OUTPUT_SIZE + 1 );
+    HkdfSha256Context   context256;
+    HkdfSha512Context   context512;
+    bool                success = true;
+
+    HkdfSha256Extract( &context256, NULL, 0, ikm, sizeof(ikm) );
+    HkdfSha512Extract( &context512, NULL, 0, ikm, sizeof(ikm) );
+
+    if(     0 == HkdfSha256Expand( &context256, NULL, 0, okm, HKDF_SHA256_MAX_OUTPUT_SIZE + 1 )
+        ||  0 == HkdfSha512Expand( &context512, NULL, 0, okm, HKDF_SHA512_MAX_OUTPUT_SIZE + 1 )
+        ||  0 == HkdfSha256( NULL, 0, ikm, sizeof(ikm), NULL, 0, okm, HKDF_SHA256_MAX_OUTPUT_SIZE + 1 )
+        ||  0 == HkdfSha512( NULL, 0, ikm, sizeof(ikm), NULL, 0, okm, HKDF_SHA512_MAX_OUTPUT_SIZE + 1 )
+        ||  0 == HkdfSha256ExpandBatch( &context256, 1, NULL, NULL, 0, okm, HKDF_SHA256_MAX_OUTPUT_SIZE + 1 )
+        ||  0 == HkdfSha512ExpandBatch( &context512, 1, NULL, NULL, 0, okm, HKDF_SHA512_MAX_OUTPUT_SIZE + 1 ) )
+    {
+        printf( "HKDF accepted an output size that is too large\n" );
+        success = false;
+    }
+
+    if(     0 != HkdfSha256Expand( &context256, NULL, 0, okm, HKDF_SHA256_MAX_OUTPUT_SIZE )
+        ||  0 != HkdfSha512Expand( &context512, NULL, 0, okm, HKDF_SHA512_MAX_OUTPUT_SIZE ) )
+    {
+        printf( "HKDF rejected the largest output size\n" );
+        success = false;
+    }
+
+    free( okm );
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestHkdf
+//
+//  Test HKDF algorithms
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestHkdf
+    (
+        void
+    )
+{
+    bool        totalSuccess = true;
+    bool        success;
+
+    success = TestSha256Vectors( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestSha512Vectors( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestSha256Batch( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestSha512Batch( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestInvalidParameters( );
+    if( !success ) { totalSuccess = false; }
+
+    return totalSuccess;
+}
\ No newline at end of file
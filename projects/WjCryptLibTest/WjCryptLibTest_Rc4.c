@@ -17,6 +17,310 @@
 #include <stdbool.h>
 #include "WjCryptLib_Rc4.h"
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestMultipleStreams
+//
+//  Tests that Rc4XorMultiple produces the same output as Rc4Xor on each stream. The streams have different keys and
+//  start at different positions, and the number of streams is not a multiple of the group size.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestMultipleStreams
+    (
+        void
+    )
+{
+    bool            success = true;
+    #define NUM_STREAMS     19
+    #define STREAMSIZE      600
+    uint8_t         key [16];
+    Rc4Context      contexts [NUM_STREAMS];
+    Rc4Context      singleContexts [NUM_STREAMS];
+    Rc4Context*     contextPointers [NUM_STREAMS];
+    uint8_t         inputs [NUM_STREAMS][STREAMSIZE];
+    uint8_t         outputs [NUM_STREAMS][STREAMSIZE];
+    uint8_t         expected [STREAMSIZE];
+    void const*     inPointers [NUM_STREAMS];
+    void*           outPointers [NUM_STREAMS];
+    uint32_t const  sizes [] = { 0, 1, 7, 8, 9, 300, 5, 100 };
+    uint32_t        stream;
+    uint32_t        i;
+    uint32_t        offset;
+
+    for( stream=0; stream<NUM_STREAMS; stream++ )
+    {
+        for( i=0; i<sizeof(key); i++ ) { key[i] = (uint8_t)( stream * 7 + i ); }
+        for( i=0; i<STREAMSIZE; i++ ) { inputs[stream][i] = (uint8_t)( stream + i ); }
+
+        Rc4Initialise( &contexts[stream], key, 5 + stream % 12, stream );
+        singleContexts[stream] = contexts[stream];
+
+        contextPointers[stream] = &contexts[stream];
+        inPointers[stream] = inputs[stream];
+        outPointers[stream] = outputs[stream];
+    }
+
+    offset = 0;
+    for( i=0; i<(sizeof(sizes)/sizeof(sizes[0])) && success; i++ )
+    {
+        Rc4XorMultiple( contextPointers, inPointers, outPointers, NUM_STREAMS, sizes[i] );
+
+        for( stream=0; stream<NUM_STREAMS; stream++ )
+        {
+            Rc4Xor( &singleContexts[stream], inputs[stream] + offset, expected, sizes[i] );
+            if( 0 != memcmp( expected, outputs[stream], sizes[i] ) )
+            {
+                printf( "TestRc4 - Rc4XorMultiple stream %u differs from Rc4Xor\n", stream );
+                success = false;
+                break;
+            }
+            inPointers[stream] = inputs[stream] + offset + sizes[i];
+        }
+        offset += sizes[i];
+    }
+
+    // A single stream, and a group of fewer than eight streams.
+    if( success )
+    {
+        Rc4XorMultiple( contextPointers, inPointers, outPointers, 1, 40 );
+        Rc4Xor( &singleContexts[0], inPointers[0], expected, 40 );
+        Rc4XorMultiple( contextPointers + 1, inPointers + 1, outPointers + 1, 5, 40 );
+        for( stream=0; stream<6; stream++ )
+        {
+            if( stream > 0 )
+            {
+                Rc4Xor( &singleContexts[stream], inPointers[stream], expected, 40 );
+            }
+            if( 0 != memcmp( expected, outputs[stream], 40 ) )
+            {
+                printf( "TestRc4 - Rc4XorMultiple stream %u differs from Rc4Xor\n", stream );
+                success = false;
+                break;
+            }
+        }
+    }
+
+    #undef NUM_STREAMS
+    #undef STREAMSIZE
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestXorWithKeyMultiple
+//
+//  Tests that Rc4XorWithKeyMultiple produces the same output as Rc4XorWithKey for each (key, buffer) pair when the
+//  buffers have different sizes, including in place and empty buffers, and that a zero length key is rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestXorWithKeyMultiple
+    (
+        void
+    )
+{
+    bool            success = true;
+    #define NUM_BUFFERS     21
+    #define MAXSIZE         1100
+    uint8_t         keys [NUM_BUFFERS][32];
+    uint8_t const*  keyPointers [NUM_BUFFERS];
+    uint32_t        keySizes [NUM_BUFFERS];
+    uint8_t         inputs [NUM_BUFFERS][MAXSIZE];
+    uint8_t         outputs [NUM_BUFFERS][MAXSIZE];
+    uint8_t         expected [MAXSIZE];
+    void const*     inPointers [NUM_BUFFERS];
+    void*           outPointers [NUM_BUFFERS];
+    uint32_t        bufferSizes [NUM_BUFFERS];
+    uint32_t        buffer;
+    uint32_t        i;
+
+    for( buffer=0; buffer<NUM_BUFFERS; buffer++ )
+    {
+        for( i=0; i<sizeof(keys[0]); i++ ) { keys[buffer][i] = (uint8_t)( buffer * 11 + i * 3 ); }
+        for( i=0; i<MAXSIZE; i++ ) { inputs[buffer][i] = (uint8_t)( buffer * 5 + i ); }
+
+        keyPointers[buffer] = keys[buffer];
+        keySizes[buffer] = 1 + ( buffer * 5 ) % 32;
+        bufferSizes[buffer] = ( buffer * 397 ) % MAXSIZE;
+        inPointers[buffer] = inputs[buffer];
+        // Every third buffer is processed in place
+        outPointers[buffer] = ( 0 == buffer % 3 ) ? inputs[buffer] : outputs[buffer];
+    }
+
+    if( 0 != Rc4XorWithKeyMultiple( keyPointers, keySizes, 768, inPointers, outPointers, bufferSizes, NUM_BUFFERS ) )
+    {
+        printf( "TestRc4 - Rc4XorWithKeyMultiple failed\n" );
+        success = false;
+    }
+
+    for( buffer=0; buffer<NUM_BUFFERS && success; buffer++ )
+    {
+        for( i=0; i<MAXSIZE; i++ ) { expected[i] = (uint8_t)( buffer * 5 + i ); }
+        Rc4XorWithKey( keys[buffer], keySizes[buffer], 768, expected, expected, bufferSizes[buffer] );
+        if( 0 != memcmp( expected, outPointers[buffer], bufferSizes[buffer] ) )
+        {
+            printf( "TestRc4 - Rc4XorWithKeyMultiple buffer %u differs from Rc4XorWithKey\n", buffer );
+            success = false;
+        }
+    }
+
+    // A zero length key anywhere in the batch rejects the whole batch
+    keySizes[NUM_BUFFERS-1] = 0;
+    memcpy( expected, outputs[1], bufferSizes[1] );
+    if( -1 != Rc4XorWithKeyMultiple( keyPointers, keySizes, 0, inPointers, outPointers, bufferSizes, NUM_BUFFERS )
+        || 0 != memcmp( expected, outputs[1], bufferSizes[1] ) )
+    {
+        printf( "TestRc4 - Rc4XorWithKeyMultiple did not reject KeySize=0\n" );
+        success = false;
+    }
+
+    #undef NUM_BUFFERS
+    #undef MAXSIZE
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestInitialiseMultiple
+//
+//  Tests that Rc4InitialiseMultiple gives the same contexts as Rc4Initialise for keys of different sizes (including
+//  ones longer than RC4_MAX_KEY_SIZE), for a number of contexts that is not a multiple of the group size.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestInitialiseMultiple
+    (
+        void
+    )
+{
+    bool            success = true;
+    #define NUM_KEYS        21
+    #define MAXKEYSIZE      300
+    uint8_t         keys [NUM_KEYS][MAXKEYSIZE];
+    uint8_t const*  keyPointers [NUM_KEYS];
+    uint32_t        keySizes [NUM_KEYS];
+    Rc4Context      contexts [NUM_KEYS];
+    Rc4Context*     contextPointers [NUM_KEYS];
+    Rc4Context      expected;
+    uint32_t const  drops [] = { 0, 1, 3072 };
+    uint32_t        d;
+    uint32_t        k;
+    uint32_t        i;
+
+    for( k=0; k<NUM_KEYS; k++ )
+    {
+        for( i=0; i<MAXKEYSIZE; i++ ) { keys[k][i] = (uint8_t)( k * 13 + i * 7 ); }
+        keyPointers[k] = keys[k];
+        keySizes[k] = ( 0 == k % 5 ) ? MAXKEYSIZE : 1 + ( k * 17 ) % 40;
+        contextPointers[k] = &contexts[k];
+    }
+
+    for( d=0; d<(sizeof(drops)/sizeof(drops[0])); d++ )
+    {
+        if( 0 != Rc4InitialiseMultiple( contextPointers, keyPointers, keySizes, drops[d], NUM_KEYS ) )
+        {
+            printf( "TestRc4 - Rc4InitialiseMultiple failed\n" );
+            success = false;
+            break;
+        }
+        for( k=0; k<NUM_KEYS; k++ )
+        {
+            Rc4Initialise( &expected, keys[k], keySizes[k], drops[d] );
+            if( 0 != memcmp( &expected, &contexts[k], sizeof(expected) ) )
+            {
+                printf( "TestRc4 - Rc4InitialiseMultiple context %u (drop %u) differs\n", k, drops[d] );
+                success = false;
+            }
+        }
+    }
+
+    keySizes[3] = 0;
+    if( -1 != Rc4InitialiseMultiple( contextPointers, keyPointers, keySizes, 0, NUM_KEYS ) )
+    {
+        printf( "TestRc4 - Rc4InitialiseMultiple did not reject KeySize=0\n" );
+        success = false;
+    }
+
+    #undef NUM_KEYS
+    #undef MAXKEYSIZE
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestStateCache
+//
+//  Tests that Rc4InitialiseWithCache gives the same contexts as Rc4Initialise whether or not the key is cached,
+//  including when keys collide in a small table and for keys of the same bytes but different lengths.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestStateCache
+    (
+        void
+    )
+{
+    bool                    success = true;
+    Rc4StateCacheEntry      entries [3];
+    Rc4StateCache           cache;
+    uint8_t                 key [RC4_MAX_KEY_SIZE + 10];
+    uint32_t const          keySizes [] = { 5, 16, 5, 6, 16, RC4_MAX_KEY_SIZE + 10, RC4_MAX_KEY_SIZE, 1, 5 };
+    Rc4Context              context;
+    Rc4Context              expected;
+    uint32_t                round;
+    uint32_t                k;
+    uint32_t                i;
+
+    for( i=0; i<sizeof(key); i++ ) { key[i] = (uint8_t)( i * 3 + 1 ); }
+
+    if( -1 != Rc4StateCacheInitialise( &cache, entries, 0, 768 )
+        || -1 != Rc4StateCacheInitialise( &cache, NULL, 3, 768 )
+        || 0 != Rc4StateCacheInitialise( &cache, entries, 3, 768 ) )
+    {
+        printf( "TestRc4 - Rc4StateCacheInitialise parameter checks failed\n" );
+        return false;
+    }
+
+    // The first round fills the cache, the second mostly hits it
+    for( round=0; round<2; round++ )
+    {
+        for( k=0; k<(sizeof(keySizes)/sizeof(keySizes[0])); k++ )
+        {
+            Rc4Initialise( &expected, key, keySizes[k], 768 );
+            memset( &context, 0, sizeof(context) );
+            if(     0 != Rc4InitialiseWithCache( &cache, &context, key, keySizes[k] )
+                ||  0 != memcmp( &expected, &context, sizeof(expected) ) )
+            {
+                printf( "TestRc4 - Rc4InitialiseWithCache key size %u (round %u) differs\n", keySizes[k], round );
+                success = false;
+            }
+        }
+    }
+
+    if( -1 != Rc4InitialiseWithCache( &cache, &context, key, 0 ) )
+    {
+        printf( "TestRc4 - Rc4InitialiseWithCache did not reject KeySize=0\n" );
+        success = false;
+    }
+
+    Rc4StateCacheUninitialise( &cache );
+    for( i=0; i<sizeof(entries); i++ )
+    {
+        if( 0 != ((uint8_t*)entries)[i] )
+        {
+            printf( "TestRc4 - Rc4StateCacheUninitialise did not wipe the entries\n" );
+            success = false;
+            break;
+        }
+    }
+
+    return success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -104,5 +408,25 @@ bool
         }
     }
 
+    if( !TestMultipleStreams( ) )
+    {
+        success = false;
+    }
+
+    if( !TestXorWithKeyMultiple( ) )
+    {
+        success = false;
+    }
+
+    if( !TestInitialiseMultiple( ) )
+    {
+        success = false;
+    }
+
+    if( !TestStateCache( ) )
+    {
+        success = false;
+    }
+
     return success;
 }
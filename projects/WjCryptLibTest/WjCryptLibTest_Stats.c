@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTest_Stats
+//
+//  Tests the optional performance counters. When the library is built without WJCRYPTLIB_STATS only the names are
+//  tested.
+//  Tests the following:
+//     Stats
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "WjCryptLib_Stats.h"
+#include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_Cpu.h"
+#include "WjCryptLib_Md5.h"
+#include "WjCryptLib_Rc4.h"
+#include "WjCryptLib_Sha1.h"
+#include "WjCryptLib_Sha256.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TYPES
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Totals gathered by the test callback
+typedef struct
+{
+    uint64_t        Calls [STATS_NUM_PRIMITIVES];
+    uint64_t        Bytes [STATS_NUM_PRIMITIVES];
+} CallbackTotals;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CountOperation
+//
+//  Stats callback that adds each operation to a CallbackTotals.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+void
+    CountOperation
+    (
+        uint32_t        Primitive,          // [in]
+        uint64_t        Bytes,              // [in]
+        uint64_t        Cycles,             // [in]
+        void*           CallbackContext     // [in]
+    )
+{
+    CallbackTotals*     totals = (CallbackTotals*)CallbackContext;
+
+    (void)Cycles;
+    if( Primitive < STATS_NUM_PRIMITIVES )
+    {
+        totals->Calls[Primitive] += 1;
+        totals->Bytes[Primitive] += Bytes;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestNames
+//
+//  Tests that every primitive has a name and that invalid primitives are rejected.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestNames
+    (
+        void
+    )
+{
+    bool            success = true;
+    uint32_t        primitive;
+    StatsCounter    counter;
+
+    for( primitive=0; primitive<STATS_NUM_PRIMITIVES; primitive++ )
+    {
+        if( NULL == StatsGetPrimitiveName( primitive ) )
+        {
+            printf( "Stats primitive %u has no name\n", primitive );
+            success = false;
+        }
+    }
+    if( NULL != StatsGetPrimitiveName( STATS_NUM_PRIMITIVES ) || -1 != StatsGet( STATS_NUM_PRIMITIVES, &counter ) )
+    {
+        printf( "Stats accepted an invalid primitive\n" );
+        success = false;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCounting
+//
+//  Tests that operations are counted with the right number of bytes, including those that end part way through a
+//  block, and that each is passed to the callback.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestCounting
+    (
+        void
+    )
+{
+    bool                success = true;
+    static uint8_t      buffer [1000];
+    void const*         buffers [4] = { buffer, buffer + 100, buffer + 200, buffer + 300 };
+    uint32_t const      bufferSizes [4] = { 100, 200, 300, 400 };
+    MD5_HASH            md5Hashes [4];
+    SHA256_HASH         sha256Hash;
+    Sha256Context       sha256Context;
+    Md5Context          md5Context;
+    AesCtrContext       aesCtrContext;
+    Rc4Context          rc4Context;
+    CallbackTotals      totals;
+    StatsCounter        counter;
+    uint32_t            primitive;
+
+    // Expected calls and bytes of each primitive used, in STATS_ order. Calls of 0 are not checked.
+    static uint64_t const expected [STATS_NUM_PRIMITIVES][2] =
+    {
+        { 1, 16 },          // AES key setup
+        { 0, 0 },
+        { 1, 1000 },        // AES-CTR
+        { 0, 0 },
+        { 0, 0 },
+        { 0, 0 },
+        { 0, 0 },
+        { 0, 1203 },        // MD5 (the multi-buffer calls may be counted as one or as four)
+        { 0, 0 },
+        { 4, 2000 },        // SHA256
+        { 0, 0 },
+        { 1, 16 },          // RC4 key setup
+        { 1, 100 },         // RC4
+    };
+
+    if( -1 == StatsGet( STATS_SHA256, &counter ) )
+    {
+        // Built without WJCRYPTLIB_STATS
+        return true;
+    }
+
+    memset( &totals, 0, sizeof(totals) );
+    StatsReset( );
+    StatsSetCallback( CountOperation, &totals );
+
+    Sha256Calculate( buffer, sizeof(buffer), &sha256Hash );
+    Sha256Initialise( &sha256Context );
+    Sha256Update( &sha256Context, buffer, 10 );
+    Sha256Update( &sha256Context, buffer, 100 );
+    Sha256Update( &sha256Context, buffer, 890 );
+    Sha256Finalise( &sha256Context, &sha256Hash );
+
+    Md5Initialise( &md5Context );
+    Md5Update( &md5Context, buffer, 3 );
+    Md5Update( &md5Context, buffer, 200 );
+    Md5Finalise( &md5Context, &md5Hashes[0] );
+    Md5CalculateMultiple( buffers, bufferSizes, 4, md5Hashes );
+
+    AesCtrInitialiseWithKey( &aesCtrContext, buffer, 16, buffer );
+    AesCtrXor( &aesCtrContext, buffer, buffer, sizeof(buffer) );
+
+    Rc4Initialise( &rc4Context, buffer, 16, 0 );
+    Rc4Xor( &rc4Context, buffer, buffer, 100 );
+
+    StatsSetCallback( NULL, NULL );
+
+    for( primitive=0; primitive<STATS_NUM_PRIMITIVES; primitive++ )
+    {
+        if(     0 != StatsGet( primitive, &counter )
+            ||  NULL == counter.Backend
+            ||  expected[primitive][1] != counter.Bytes
+            ||  ( 0 != expected[primitive][0] && expected[primitive][0] != counter.Calls )
+            ||  ( 0 == expected[primitive][1] && 0 != counter.Calls ) )
+        {
+            printf( "Stats wrong for %s\n", StatsGetPrimitiveName( primitive ) );
+            success = false;
+        }
+        else if( counter.Calls != totals.Calls[primitive] || counter.Bytes != totals.Bytes[primitive] )
+        {
+            printf( "Stats callback totals wrong for %s\n", StatsGetPrimitiveName( primitive ) );
+            success = false;
+        }
+    }
+
+    StatsReset( );
+    if( 0 != StatsGet( STATS_SHA256, &counter ) || 0 != counter.Calls || 0 != counter.Bytes || 0 != counter.Cycles )
+    {
+        printf( "Stats not reset\n" );
+        success = false;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestBackends
+//
+//  Tests that SHA-1 and SHA-256 report the copy of their portable code that was chosen for the instruction set level
+//  when the library is built with WJCRYPTLIB_ISA_VARIANTS, and "portable" otherwise. SHA-1 may use the SHA extensions
+//  instead.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+bool
+    TestBackends
+    (
+        void
+    )
+{
+    bool            success = true;
+    char const*     expected = "portable";
+    StatsCounter    counter;
+    SHA1_HASH       sha1Hash;
+    SHA256_HASH     sha256Hash;
+
+#ifdef WJCRYPTLIB_ISA_VARIANTS
+    switch( CpuGetIsaLevel( ) )
+    {
+    case CPU_ISA_AVX512:    expected = "avx512";    break;
+    case CPU_ISA_AVX2:      expected = "avx2";      break;
+    default:                break;
+    }
+#endif
+
+    if( -1 == StatsGet( STATS_SHA256, &counter ) )
+    {
+        // Built without WJCRYPTLIB_STATS
+        return true;
+    }
+
+    Sha1Calculate( "", 0, &sha1Hash );
+    Sha256Calculate( "", 0, &sha256Hash );
+
+    if( 0 != StatsGet( STATS_SHA256, &counter ) || 0 != strcmp( expected, counter.Backend ) )
+    {
+        printf( "Stats backend wrong for %s\n", StatsGetPrimitiveName( STATS_SHA256 ) );
+        success = false;
+    }
+    if(     0 != StatsGet( STATS_SHA1, &counter )
+        ||  ( 0 != strcmp( expected, counter.Backend ) && 0 != strcmp( "shani", counter.Backend ) ) )
+    {
+        printf( "Stats backend wrong for %s\n", StatsGetPrimitiveName( STATS_SHA1 ) );
+        success = false;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestStats
+//
+//  Test the performance counters
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+    TestStats
+    (
+        void
+    )
+{
+    bool        totalSuccess = true;
+    bool        success;
+
+    success = TestNames( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestCounting( );
+    if( !success ) { totalSuccess = false; }
+
+    success = TestBackends( );
+    if( !success ) { totalSuccess = false; }
+
+    return totalSuccess;
+}
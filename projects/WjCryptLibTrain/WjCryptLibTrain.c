@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  WjCryptLibTrain
+//
+//  Representative workload for profile guided optimisation (the CMake option WJCRYPTLIB_PGO). Protects and
+//  authenticates a stream of messages whose sizes follow a typical network mix: mostly small, some around a packet,
+//  and a few large. Each message goes through every primitive with the implementations chosen automatically, as an
+//  application would use them, and the decryptions are checked so that a miscompiled build is noticed.
+//
+//  WjCryptLibTrain [NumMessages]
+//
+//  This is free and unencumbered software released into the public domain - October 2026 waterjuice.org
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  IMPORTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "WjCryptLib_AesCbc.h"
+#include "WjCryptLib_AesCcm.h"
+#include "WjCryptLib_AesCtr.h"
+#include "WjCryptLib_AesGcmSiv.h"
+#include "WjCryptLib_Hkdf.h"
+#include "WjCryptLib_Hmac.h"
+#include "WjCryptLib_Md5.h"
+#include "WjCryptLib_Rc4.h"
+#include "WjCryptLib_Sha1.h"
+#include "WjCryptLib_Sha256.h"
+#include "WjCryptLib_Sha512.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CONSTANTS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_MESSAGE_SIZE            ( 64 * 1024 )
+#define DEFAULT_NUM_MESSAGES        20000
+
+// A fresh key is derived for every this many messages
+#define MESSAGES_PER_KEY            64
+
+#define CCM_NONCE_SIZE              12
+#define CCM_TAG_SIZE                16
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  GLOBALS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t      gMessage [MAX_MESSAGE_SIZE];
+static uint8_t      gCipherText [MAX_MESSAGE_SIZE];
+static uint8_t      gPlainText [MAX_MESSAGE_SIZE];
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERNAL FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Random
+//
+//  Returns the next value of a xorshift64 generator. State must not be zero.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    Random
+    (
+        uint64_t*       pState          // [in out]
+    )
+{
+    uint64_t    x = *pState;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *pState = x;
+
+    return (uint32_t)( x >> 32 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MessageSize
+//
+//  Returns the size of the next message: 60% up to 256 bytes, 30% up to 1500, and 10% up to MAX_MESSAGE_SIZE.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+uint32_t
+    MessageSize
+    (
+        uint64_t*       pState          // [in out]
+    )
+{
+    uint32_t    percent = Random( pState ) % 100;
+
+    if( percent < 60 )
+    {
+        return 1 + Random( pState ) % 256;
+    }
+    else if( percent < 90 )
+    {
+        return 1 + Random( pState ) % 1500;
+    }
+    else
+    {
+        return 1 + Random( pState ) % MAX_MESSAGE_SIZE;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ProcessMessage
+//
+//  Runs Size bytes of gMessage through every primitive.
+//  Returns 0 if successful, or -1 if a decryption did not give back the message
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static
+int
+    ProcessMessage
+    (
+        uint8_t const   Key [AES_KEY_SIZE_256],     // [in]
+        uint64_t        Sequence,                   // [in]
+        uint32_t        Size                        // [in]
+    )
+{
+    uint8_t         nonce [AES_GCM_SIV_NONCE_SIZE] = {0};
+    uint8_t         iv [AES_CBC_IV_SIZE] = {0};
+    uint8_t         tag [AES_GCM_SIV_TAG_SIZE];
+    uint32_t        blocksSize = Size & ~( AES_BLOCK_SIZE - 1 );
+    SHA256_HASH     sha256Hash;
+    SHA512_HASH     sha512Hash;
+    SHA1_HASH       sha1Hash;
+    MD5_HASH        md5Hash;
+    int             error = 0;
+
+    memcpy( nonce, &Sequence, sizeof(Sequence) );
+    memcpy( iv, &Sequence, sizeof(Sequence) );
+
+    // Hashes and MAC
+    Sha256Calculate( gMessage, Size, &sha256Hash );
+    Sha512Calculate( gMessage, Size, &sha512Hash );
+    Sha1Calculate( gMessage, Size, &sha1Hash );
+    Md5Calculate( gMessage, Size, &md5Hash );
+    HmacSha256Calculate( Key, AES_KEY_SIZE_256, gMessage, Size, &sha256Hash );
+
+    // Authenticated encryption
+    error |= AesGcmSivEncryptWithKey( Key, AES_KEY_SIZE_256, nonce, &Sequence, sizeof(Sequence),
+        gMessage, gCipherText, Size, tag );
+    error |= AesGcmSivDecryptWithKey( Key, AES_KEY_SIZE_256, nonce, &Sequence, sizeof(Sequence),
+        gCipherText, gPlainText, Size, tag );
+    error |= memcmp( gMessage, gPlainText, Size );
+
+    error |= AesCcmEncryptWithKey( Key, AES_KEY_SIZE_256, nonce, CCM_NONCE_SIZE, NULL, 0,
+        gMessage, gCipherText, Size, tag, CCM_TAG_SIZE );
+    error |= AesCcmDecryptWithKey( Key, AES_KEY_SIZE_256, nonce, CCM_NONCE_SIZE, NULL, 0,
+        gCipherText, gPlainText, Size, tag, CCM_TAG_SIZE );
+    error |= memcmp( gMessage, gPlainText, Size );
+
+    // Unauthenticated modes
+    error |= AesCtrXorWithKey( Key, AES_KEY_SIZE_256, iv, gMessage, gCipherText, Size );
+    error |= AesCtrXorWithKey( Key, AES_KEY_SIZE_256, iv, gCipherText, gPlainText, Size );
+    error |= memcmp( gMessage, gPlainText, Size );
+
+    if( blocksSize > 0 )
+    {
+        error |= AesCbcEncryptWithKey( Key, AES_KEY_SIZE_256, iv, gMessage, gCipherText, blocksSize );
+        error |= AesCbcDecryptWithKey( Key, AES_KEY_SIZE_256, iv, gCipherText, gPlainText, blocksSize );
+        error |= memcmp( gMessage, gPlainText, blocksSize );
+    }
+
+    error |= Rc4XorWithKey( Key, AES_KEY_SIZE_256, 3072, gMessage, gCipherText, Size );
+
+    return ( 0 == error ) ? 0 : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  PUBLIC FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  main
+//
+//  Program entry point
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+    main
+    (
+        int             ArgC,
+        char**          ArgV
+    )
+{
+    uint32_t        numMessages = DEFAULT_NUM_MESSAGES;
+    uint64_t        state = 1;
+    uint8_t         masterKey [AES_KEY_SIZE_256] = {0};
+    uint8_t         key [AES_KEY_SIZE_256];
+    uint64_t        totalSize = 0;
+    uint32_t        size;
+    uint32_t        i;
+
+    if( ArgC > 2 || ( 2 == ArgC && '-' == ArgV[1][0] ) )
+    {
+        printf(
+            "Syntax\n"
+            "   WjCryptLibTrain [NumMessages]\n" );
+        return 1;
+    }
+    if( 2 == ArgC )
+    {
+        numMessages = (uint32_t)strtoul( ArgV[1], NULL, 10 );
+    }
+
+    for( i=0; i<sizeof(gMessage); i++ )
+    {
+        gMessage[i] = (uint8_t)Random( &state );
+    }
+
+    for( i=0; i<numMessages; i++ )
+    {
+        if( 0 == i % MESSAGES_PER_KEY )
+        {
+            HkdfSha256( NULL, 0, masterKey, sizeof(masterKey), &i, sizeof(i), key, sizeof(key) );
+        }
+
+        size = MessageSize( &state );
+        if( 0 != ProcessMessage( key, i, size ) )
+        {
+            printf( "Message %u (%u bytes) did not decrypt correctly\n", i, size );
+            return 1;
+        }
+        totalSize += size;
+    }
+
+    printf( "Processed %u messages, %llu bytes\n", numMessages, (unsigned long long)totalSize );
+    return 0;
+}